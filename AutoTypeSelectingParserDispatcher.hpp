@@ -3,6 +3,7 @@
 #include "JSONStreamParser.hpp"
 #include "JSONViewParser.hpp"
 #include "PivotMemberTypeSelector.hpp"
+#include "moped/ParseEventTape.hpp"
 
 #include <tuple>
 
@@ -24,6 +25,11 @@ class AutoTypeSelectingParserDispatcher {
       PivotMemberTypeSelector<ParserHandlerT, PivotMapTypesT>{
           _parserHandler}...};
 
+  ParseEventTape _eventTape;
+  std::size_t _objectDepth{0};
+  bool _useEventTape{false};
+  bool _recording{false};
+
 public:
   template <typename... Args>
   AutoTypeSelectingParserDispatcher(Args &&...args)
@@ -31,8 +37,16 @@ public:
         _pivotSelectors{PivotMemberTypeSelector<ParserHandlerT, PivotMapTypesT>{
             _parserHandler}...} {}
 
+  // With the event tape enabled, events preceding the pivot value are
+  // recorded rather than parsed speculatively by every candidate. Once a
+  // pivot selects a type the tape is replayed into that candidate alone and
+  // the rest of the document streams straight to it. Documents without a
+  // selecting pivot are replayed into all candidates at the root finish.
+  void useEventTape(bool enabled) { _useEventTape = enabled; }
+
   Expected parseAndDispatchJSONSteam(std::istream &jsonStream,
                                      auto &&handlerFunction) {
+    _eventTape.setCopiesText(true);
     JSONStreamParser<AutoTypeSelectingParserDispatcher> parser{*this};
     if (auto result = parser.parse(jsonStream); !result) {
       return std::unexpected(result.error());
@@ -48,6 +62,7 @@ public:
   Expected parseAndDispatchJSONView(std::string_view jsonView,
                                     auto &&handlerFunction) {
 
+    _eventTape.setCopiesText(false);
     JSONViewParser<AutoTypeSelectingParserDispatcher> parser{*this};
     if (auto result = parser.parse(jsonView); !result) {
       return std::unexpected(result.error());
@@ -62,44 +77,97 @@ public:
   template <typename... Args> void reset(Args &&...args) {
     _parserHandler.reset(std::forward<Args>(args)...);
     applyToPivotSelectors([](auto &selector) { selector.reset(); });
+    _eventTape.clear();
+    _recording = false;
+    _objectDepth = 0;
   }
 
   Expected onMember(std::string_view memberName) {
     applyToPivotSelectors(
         [&](auto &selector) { selector.onMember(memberName); });
-    return _parserHandler.onMember(memberName);
+    return routeEvent(
+        [&] { return _eventTape.onMember(memberName); },
+        [&](auto &handler) { return handler.onMember(memberName); });
   }
 
   Expected onStringValue(std::string_view value) {
     applyToPivotSelectors(
         [&](auto &selector) { selector.onStringValue(value); });
-    return _parserHandler.onStringValue(value);
+    return routeEvent(
+        [&] { return _eventTape.onStringValue(value); },
+        [&](auto &handler) { return handler.onStringValue(value); });
   }
 
   Expected onNumericValue(std::string_view value) {
     applyToPivotSelectors(
         [&](auto &selector) { selector.onNumericValue(value); });
-    return _parserHandler.onNumericValue(value);
+    return routeEvent(
+        [&] { return _eventTape.onNumericValue(value); },
+        [&](auto &handler) { return handler.onNumericValue(value); });
   }
 
   Expected onObjectStart() {
+    if (_objectDepth++ == 0) {
+      _recording = kHasPivotSelectors && _useEventTape;
+      _eventTape.clear();
+    }
     applyToPivotSelectors([](auto &selector) { selector.onObjectStart(); });
-    return _parserHandler.onObjectStart();
+    return routeEvent([&] { return _eventTape.onObjectStart(); },
+                      [](auto &handler) { return handler.onObjectStart(); });
   }
 
   Expected onObjectFinish() {
-    auto result = _parserHandler.onObjectFinish();
+    if (_objectDepth > 0 && --_objectDepth == 0 && _recording) {
+      // No pivot selected a type, fall back to speculative parsing of the
+      // recorded document by every candidate
+      if (auto result = stopRecording(); !result) {
+        return result;
+      }
+    }
+    auto result =
+        routeEvent([&] { return _eventTape.onObjectFinish(); },
+                   [](auto &handler) { return handler.onObjectFinish(); });
     applyToPivotSelectors([](auto &selector) { selector.onObjectFinish(); });
     return result;
   }
-  Expected onArrayStart() { return _parserHandler.onArrayStart(); }
-  Expected onArrayFinish() { return _parserHandler.onArrayFinish(); }
+  Expected onArrayStart() {
+    return routeEvent([&] { return _eventTape.onArrayStart(); },
+                      [](auto &handler) { return handler.onArrayStart(); });
+  }
+  Expected onArrayFinish() {
+    return routeEvent([&] { return _eventTape.onArrayFinish(); },
+                      [](auto &handler) { return handler.onArrayFinish(); });
+  }
   Expected onBooleanValue(bool value) {
-    return _parserHandler.onBooleanValue(value);
+    return routeEvent(
+        [&] { return _eventTape.onBooleanValue(value); },
+        [&](auto &handler) { return handler.onBooleanValue(value); });
+  }
+  Expected onNullValue() {
+    return routeEvent([&] { return _eventTape.onNullValue(); },
+                      [](auto &handler) { return handler.onNullValue(); });
   }
-  Expected onNullValue() { return _parserHandler.onNullValue(); }
 
 private:
+  Expected routeEvent(auto &&recordEvent, auto &&forwardEvent) {
+    if (_recording) {
+      if (!_parserHandler.compositeSet()) {
+        return recordEvent();
+      }
+      if (auto result = stopRecording(); !result) {
+        return result;
+      }
+    }
+    return forwardEvent(_parserHandler);
+  }
+
+  Expected stopRecording() {
+    _recording = false;
+    auto result = _eventTape.replay(_parserHandler);
+    _eventTape.clear();
+    return result;
+  }
+
   template <typename CallableT>
   void applyToPivotSelectors(CallableT &&callable) {
     if constexpr (!kHasPivotSelectors) {
@@ -5,10 +5,68 @@
 #include "moped/CompositeParseEventDispatcher.hpp"
 #include "moped/concepts.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <type_traits>
+#include <vector>
 
 namespace moped {
 
+// One bit per candidate type in declaration order
+using CandidateMask = std::uint64_t;
+
+template <std::size_t Index> constexpr CandidateMask candidateBit() {
+  static_assert(Index < 64, "At most 64 candidate types are supported");
+  return CandidateMask{1} << Index;
+}
+
+// Maps each top level member id to the candidates that declare it, built once
+// per harness type. Candidates with an embedded composite accept members the
+// table cannot see so they match every member id.
+template <DecodingTraitsC DecodingTraits> class CandidateMemberTable {
+public:
+  using MemberIdT = typename DecodingTraits::MemberIdType;
+
+  void addMember(CandidateMask candidate, MemberIdT memberId) {
+    if (memberId == DecodingTraits::EmbeddingMemberId) {
+      _embeddingCandidates |= candidate;
+      return;
+    }
+    _entries.emplace_back(memberId, candidate);
+  }
+
+  void finalize() {
+    std::sort(_entries.begin(), _entries.end(),
+              [](auto &lhs, auto &rhs) { return lhs.first < rhs.first; });
+    auto merged = _entries.begin();
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+      if (merged != it && merged->first == it->first) {
+        merged->second |= it->second;
+      } else if (merged != it) {
+        *++merged = *it;
+      }
+    }
+    if (!_entries.empty()) {
+      _entries.erase(merged + 1, _entries.end());
+    }
+  }
+
+  CandidateMask candidatesFor(MemberIdT memberId) const {
+    auto it = std::lower_bound(
+        _entries.begin(), _entries.end(), memberId,
+        [](auto &entry, const MemberIdT &id) { return entry.first < id; });
+    if (it != _entries.end() && it->first == memberId) {
+      return it->second | _embeddingCandidates;
+    }
+    return _embeddingCandidates;
+  }
+
+private:
+  std::vector<std::pair<MemberIdT, CandidateMask>> _entries;
+  CandidateMask _embeddingCandidates{0};
+};
+
 template <DecodingTraitsC DecodingTraits, typename... T>
 struct CandidateTypeHarness {};
 
@@ -28,15 +86,17 @@ template <DecodingTraitsC DecodingTraits, typename T> struct LastHarness {
     _candidateMopedHandler.reset(std::forward<Args>(args)...);
   }
 
+  static constexpr std::size_t CandidateCount = 1;
+
   Expected applyParseEvent(auto &&parseEvent, int &activeParticipants,
-                           std::vector<ParseError> &errors) {
+                           std::optional<ParseError> &firstError) {
     if (!_participating) {
       return std::unexpected("No active  candidate type at the moment");
     }
     auto result = parseEvent(_candidateMopedHandler);
     if (!result) {
-      if (activeParticipants == 0) {
-        errors.push_back(result.error());
+      if (activeParticipants == 0 && !firstError) {
+        firstError = result.error();
       }
       _participating = false;
 
@@ -46,6 +106,22 @@ template <DecodingTraitsC DecodingTraits, typename T> struct LastHarness {
     return {};
   }
 
+  template <std::size_t Index> void applyCandidateMask(CandidateMask mask) {
+    if (!(mask & candidateBit<Index>())) {
+      _participating = false;
+    }
+  }
+
+  template <std::size_t Index> CandidateMask participatingMask() const {
+    return _participating ? candidateBit<Index>() : CandidateMask{0};
+  }
+
+  template <std::size_t Index>
+  void collectMemberIds(CandidateMemberTable<DecodingTraits> &table) {
+    _candidateMopedHandler.getMopedHandler().forEachMemberId(
+        [&](auto memberId) { table.addMember(candidateBit<Index>(), memberId); });
+  }
+
   inline Expected applyParseEvent(auto &&parseEvent) {
     if (!_participating) {
       return std::unexpected("No active candidate type at the moment");
@@ -117,23 +193,45 @@ struct CandidateTypeHarness<DecodingTraits, T, TailTypes...> {
     _tailingCandidates.template setActiveComposite<SetT>();
   }
 
+  static constexpr std::size_t CandidateCount =
+      1 + TailingCandidateHarness::CandidateCount;
+
   Expected applyParseEvent(auto &&parseEvent, int &activeParticipants,
-                           std::vector<ParseError> &errors) {
+                           std::optional<ParseError> &firstError) {
     if (!_participating) {
       return _tailingCandidates.applyParseEvent(parseEvent, activeParticipants,
-                                                errors);
+                                                firstError);
     }
     auto result = parseEvent(_candidateMopedHandler);
     if (!result) {
-      if (activeParticipants == 0) {
-        errors.push_back(result.error());
+      if (activeParticipants == 0 && !firstError) {
+        firstError = result.error();
       }
       _participating = false;
     } else {
       activeParticipants++;
     }
     return _tailingCandidates.applyParseEvent(parseEvent, activeParticipants,
-                                              errors);
+                                              firstError);
+  }
+
+  template <std::size_t Index> void applyCandidateMask(CandidateMask mask) {
+    if (!(mask & candidateBit<Index>())) {
+      _participating = false;
+    }
+    _tailingCandidates.template applyCandidateMask<Index + 1>(mask);
+  }
+
+  template <std::size_t Index> CandidateMask participatingMask() const {
+    return (_participating ? candidateBit<Index>() : CandidateMask{0}) |
+           _tailingCandidates.template participatingMask<Index + 1>();
+  }
+
+  template <std::size_t Index>
+  void collectMemberIds(CandidateMemberTable<DecodingTraits> &table) {
+    _candidateMopedHandler.getMopedHandler().forEachMemberId(
+        [&](auto memberId) { table.addMember(candidateBit<Index>(), memberId); });
+    _tailingCandidates.template collectMemberIds<Index + 1>(table);
   }
 
   inline Expected applyParseEvent(auto &&parseEvent) {
@@ -172,47 +270,40 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onMember(memberName); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    auto result = _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onMember(memberName); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
+    if (_objectDepth == 1) {
+      // Top level members rule out every candidate that doesn't declare them
+      // before any candidate handler runs
+      _candidateHarness.template applyCandidateMask<0>(
+          memberTable().candidatesFor(DecodingTraits::getMemberId(memberName)));
+      if (_candidateHarness.template participatingMask<0>() == 0) {
+        return std::unexpected(ParseError{
+            "Member not declared by any candidate type", memberName});
+      }
     }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onMember(memberName); });
   }
 
   Expected onObjectStart() {
+    ++_objectDepth;
     if (_compositeSet) {
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onObjectStart(); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onObjectStart(); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onObjectStart(); });
   }
 
   Expected onObjectFinish() {
+    if (_objectDepth > 0) {
+      --_objectDepth;
+    }
     if (_compositeSet) {
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onObjectFinish(); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onObjectFinish(); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onObjectFinish(); });
   }
 
   Expected onArrayStart() {
@@ -220,15 +311,8 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onArrayStart(); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    auto result = _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onArrayStart(); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onArrayStart(); });
   }
 
   Expected onArrayFinish() {
@@ -236,15 +320,8 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onArrayFinish(); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onArrayFinish(); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onArrayFinish(); });
   }
 
   Expected onStringValue(std::string_view value) {
@@ -252,15 +329,8 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onStringValue(value); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onStringValue(value); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onStringValue(value); });
   }
 
   Expected onNumericValue(std::string_view value) {
@@ -268,15 +338,8 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onNumericValue(value); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onNumericValue(value); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onNumericValue(value); });
   }
 
   Expected onBooleanValue(bool value) {
@@ -284,15 +347,8 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onBooleanValue(value); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onBooleanValue(value); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onBooleanValue(value); });
   }
 
   Expected onNullValue() {
@@ -300,21 +356,14 @@ public:
       return _candidateHarness.applyParseEvent(
           [&](auto &handler) { return handler.onNullValue(); });
     }
-    _errors.clear();
-    int activeParticipants = 0;
-    _candidateHarness.applyParseEvent(
-        [&](auto &handler) { return handler.onNullValue(); },
-        activeParticipants, _errors);
-    if ((activeParticipants == 0) && (!_errors.empty())) {
-      return std::unexpected(_errors.front());
-    }
-    return {};
+    return applyToCandidates(
+        [&](auto &handler) { return handler.onNullValue(); });
   }
 
   template <typename... Args> void reset(Args &&...args) {
     _candidateHarness.reset(std::forward<Args>(args)...);
-    _errors.clear();
     _compositeSet = false;
+    _objectDepth = 0;
   }
 
   auto applyHandler(auto &&handlerFunc) {
@@ -326,6 +375,8 @@ public:
     _compositeSet = true;
   }
 
+  bool compositeSet() const { return _compositeSet; }
+
   auto applyParseEvent(auto &&parseEvent) {
     return _candidateHarness.applyParseEvent(parseEvent);
   }
@@ -340,8 +391,30 @@ public:
   }
 
 private:
+  // Errors are only kept when every remaining candidate rejects the event
+  Expected applyToCandidates(auto &&parseEvent) {
+    int activeParticipants = 0;
+    std::optional<ParseError> firstError;
+    _candidateHarness.applyParseEvent(parseEvent, activeParticipants,
+                                      firstError);
+    if ((activeParticipants == 0) && firstError) {
+      return std::unexpected(*firstError);
+    }
+    return {};
+  }
+
+  const CandidateMemberTable<DecodingTraits> &memberTable() {
+    static const CandidateMemberTable<DecodingTraits> table = [this] {
+      CandidateMemberTable<DecodingTraits> candidateTable;
+      _candidateHarness.template collectMemberIds<0>(candidateTable);
+      candidateTable.finalize();
+      return candidateTable;
+    }();
+    return table;
+  }
+
   bool _compositeSet{false};
-  std::vector<ParseError> _errors;
+  std::size_t _objectDepth{0};
   CandidateHarnessT _candidateHarness;
 };
 
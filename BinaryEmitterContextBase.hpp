@@ -0,0 +1,169 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moped {
+
+// Emitter context plumbing shared by binary formats whose maps and arrays
+// are prefixed with their element count. Counts are only known once a
+// container finishes, so each container is written with a placeholder
+// header of MaxHeaderSize bytes. When the root container finishes the
+// buffer is compacted in one pass, rewriting every header through
+// EncoderT::writeContainerHeader in its smallest encoding.
+//
+// EncoderT supplies:
+//   static constexpr std::size_t MaxHeaderSize;
+//   static std::size_t writeContainerHeader(char *, std::uint32_t, bool);
+//   void writeString(std::string_view);
+//   void writeNull();
+//   void writeEncodedValue(const auto &);
+template <typename EncoderT> class BinaryEmitterContextBase {
+  static constexpr std::size_t ElidedHeader =
+      std::numeric_limits<std::size_t>::max();
+
+  struct Header {
+    std::size_t offset;
+    std::uint32_t count;
+    bool isMap;
+  };
+
+  struct Container {
+    std::size_t headerIndex;
+    bool isMap;
+  };
+
+public:
+  BinaryEmitterContextBase(std::string &output) : _output(output) {}
+
+  void onObjectStart(std::optional<std::string_view> memberId = std::nullopt) {
+    if (!_containers.empty() && memberId && memberId->empty()) {
+      // Embedded composites and root maps publish their members into the
+      // enclosing map
+      _containers.push_back(_containers.back());
+      return;
+    }
+    writeEntryKey(memberId);
+    openContainer(true);
+  }
+
+  void onObjectFinish() { closeContainer(); }
+
+  void onArrayStart(std::optional<std::string_view> memberId) {
+    if (_containers.size() == 1 && memberId && memberId->empty() &&
+        _headers.size() == 1 && _headers.back().count == 0) {
+      // Root array convention, the array replaces the root map
+      _output.resize(_headers.back().offset);
+      _headers.pop_back();
+      _containers.back().headerIndex = ElidedHeader;
+    } else {
+      writeEntryKey(memberId);
+    }
+    openContainer(false);
+  }
+
+  void onArrayValueEntry(const auto &value) {
+    writeEntryKey(std::nullopt);
+    encoder().writeEncodedValue(value);
+  }
+
+  void onArrayFinish() { closeContainer(); }
+
+  void onObjectValueEntry(const std::string_view memberId, const auto &value) {
+    writeEntryKey(memberId);
+    encoder().writeEncodedValue(value);
+  }
+
+  void onObjectNullEntry(const std::string_view memberId) {
+    writeEntryKey(memberId);
+    encoder().writeNull();
+  }
+
+  template <typename T>
+  void onObjectValueEntry(const std::string_view memberId,
+                          const std::optional<T> &value) {
+    if (!value.has_value()) {
+      return; // Skip null values
+    }
+    onObjectValueEntry(memberId, value.value());
+  }
+
+protected:
+  static void storeBigEndian(char *target, std::uint64_t value,
+                             std::size_t size) {
+    for (std::size_t index = 0; index < size; ++index) {
+      target[index] =
+          static_cast<char>(value >> (8 * (size - 1 - index)) & 0xff);
+    }
+  }
+
+  void appendBigEndian(std::uint8_t initialByte, std::uint64_t value,
+                       std::size_t size) {
+    _output.push_back(static_cast<char>(initialByte));
+    auto position = _output.size();
+    _output.resize(position + size);
+    storeBigEndian(&_output[position], value, size);
+  }
+
+  std::string &_output;
+
+private:
+  EncoderT &encoder() { return static_cast<EncoderT &>(*this); }
+
+  void openContainer(bool isMap) {
+    if (_containers.empty()) {
+      _documentStart = _output.size();
+    }
+    _containers.push_back(Container{_headers.size(), isMap});
+    _headers.push_back(Header{_output.size(), 0, isMap});
+    _output.append(EncoderT::MaxHeaderSize, '\0');
+  }
+
+  void closeContainer() {
+    _containers.pop_back();
+    if (_containers.empty()) {
+      compactHeaders();
+    }
+  }
+
+  void writeEntryKey(std::optional<std::string_view> memberId) {
+    if (_containers.empty()) {
+      return;
+    }
+    auto &container = _containers.back();
+    if (container.headerIndex != ElidedHeader) {
+      ++_headers[container.headerIndex].count;
+    }
+    if (container.isMap && memberId) {
+      encoder().writeString(*memberId);
+    }
+  }
+
+  // Headers never grow, so the write position can't overtake the read
+  // position and the document is compacted in place
+  void compactHeaders() {
+    auto write = _documentStart;
+    auto read = _documentStart;
+    for (auto &header : _headers) {
+      std::memmove(&_output[write], &_output[read], header.offset - read);
+      write += header.offset - read;
+      write += EncoderT::writeContainerHeader(&_output[write], header.count,
+                                              header.isMap);
+      read = header.offset + EncoderT::MaxHeaderSize;
+    }
+    std::memmove(&_output[write], &_output[read], _output.size() - read);
+    write += _output.size() - read;
+    _output.resize(write);
+    _headers.clear();
+  }
+
+  std::size_t _documentStart{0};
+  std::vector<Container> _containers;
+  std::vector<Header> _headers;
+};
+
+} // namespace moped
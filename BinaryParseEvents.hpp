@@ -0,0 +1,72 @@
+#pragma once
+
+#include "moped/concepts.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <string_view>
+#include <type_traits>
+
+namespace moped {
+
+// Delivery of values decoded by binary parsers. Dispatchers with typed events
+// receive the values directly, all others receive the text a JSON parser
+// would have produced for the same value.
+
+template <typename T>
+Expected dispatchNumericValue(IParserEventDispatchC auto &eventDispatch,
+                              T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if constexpr (requires { eventDispatch.onFloatValue(double{}); }) {
+      return eventDispatch.onFloatValue(value);
+    }
+  } else if constexpr (std::is_signed_v<T>) {
+    if constexpr (requires { eventDispatch.onIntegerValue(std::int64_t{}); }) {
+      return eventDispatch.onIntegerValue(value);
+    }
+  } else if constexpr (requires {
+                         eventDispatch.onUnsignedValue(std::uint64_t{});
+                       }) {
+    return eventDispatch.onUnsignedValue(value);
+  }
+  char buffer[32];
+  auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return eventDispatch.onNumericValue(
+      std::string_view{buffer, static_cast<std::size_t>(end - buffer)});
+}
+
+// Text fallback uses whole epoch seconds, or microseconds when fractional,
+// digit counts epoch time formatters recognize
+inline Expected dispatchTimeValue(IParserEventDispatchC auto &eventDispatch,
+                                  TimePoint value) {
+  if constexpr (requires { eventDispatch.onTimeValue(value); }) {
+    return eventDispatch.onTimeValue(value);
+  } else {
+    using namespace std::chrono;
+    auto sinceEpoch = value.time_since_epoch();
+    if (sinceEpoch % seconds{1} == sinceEpoch.zero()) {
+      return dispatchNumericValue(eventDispatch,
+                                  static_cast<std::int64_t>(
+                                      duration_cast<seconds>(sinceEpoch)
+                                          .count()));
+    }
+    return dispatchNumericValue(
+        eventDispatch, static_cast<std::int64_t>(
+                           duration_cast<microseconds>(sinceEpoch).count()));
+  }
+}
+
+inline Expected dispatchDecimalValue(IParserEventDispatchC auto &eventDispatch,
+                                     DecimalFraction value) {
+  if constexpr (requires { eventDispatch.onDecimalValue(value); }) {
+    return eventDispatch.onDecimalValue(value);
+  } else {
+    char buffer[48];
+    auto end = std::format_to(buffer, "{}", value);
+    return eventDispatch.onNumericValue(
+        std::string_view{buffer, static_cast<std::size_t>(end - buffer)});
+  }
+}
+
+} // namespace moped
@@ -0,0 +1,174 @@
+#pragma once
+#include "moped/BinaryEmitterContextBase.hpp"
+#include "moped/CBORTypes.hpp"
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include "moped/moped.hpp"
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace moped {
+
+// Emitter context producing RFC 8949 CBOR with definite length maps and
+// arrays. Time points are written as tag 1 epoch seconds, an integer for
+// whole seconds and a double otherwise. Scaled integers are written as tag 4
+// decimal fractions so they decode without loss.
+template <typename TimePointFormatter = DurationSinceEpochFormatter<>>
+class CBOREmitterContext
+    : public BinaryEmitterContextBase<CBOREmitterContext<TimePointFormatter>> {
+  using BaseT =
+      BinaryEmitterContextBase<CBOREmitterContext<TimePointFormatter>>;
+  friend BaseT;
+
+public:
+  static constexpr std::size_t MaxHeaderSize = 5;
+
+  CBOREmitterContext(std::string &output) : BaseT(output) {}
+
+private:
+  using BaseT::_output;
+  using BaseT::appendBigEndian;
+  using BaseT::storeBigEndian;
+
+  static std::uint8_t initialByte(CBORMajorType majorType,
+                                  std::uint8_t additional) {
+    return static_cast<std::uint8_t>(static_cast<std::uint8_t>(majorType) << 5 |
+                                     additional);
+  }
+
+  static std::size_t writeContainerHeader(char *target, std::uint32_t count,
+                                          bool isMap) {
+    auto majorType = isMap ? CBORMajorType::Map : CBORMajorType::Array;
+    if (count < 24) {
+      target[0] = static_cast<char>(initialByte(majorType, count));
+      return 1;
+    }
+    std::size_t size = count <= 0xff ? 1 : count <= 0xffff ? 2 : 4;
+    target[0] = static_cast<char>(
+        initialByte(majorType, size == 1 ? 24 : size == 2 ? 25 : 26));
+    storeBigEndian(target + 1, count, size);
+    return size + 1;
+  }
+
+  void writeHead(CBORMajorType majorType, std::uint64_t argument) {
+    if (argument < 24) {
+      _output.push_back(static_cast<char>(initialByte(majorType, argument)));
+    } else if (argument <= 0xff) {
+      appendBigEndian(initialByte(majorType, 24), argument, 1);
+    } else if (argument <= 0xffff) {
+      appendBigEndian(initialByte(majorType, 25), argument, 2);
+    } else if (argument <= 0xffffffff) {
+      appendBigEndian(initialByte(majorType, 26), argument, 4);
+    } else {
+      appendBigEndian(initialByte(majorType, 27), argument, 8);
+    }
+  }
+
+  void writeString(std::string_view text) {
+    writeHead(CBORMajorType::TextString, text.size());
+    _output.append(text);
+  }
+
+  void writeNull() {
+    _output.push_back(
+        static_cast<char>(initialByte(CBORMajorType::Simple, 22)));
+  }
+
+  void writeInteger(std::int64_t value) {
+    if (value >= 0) {
+      writeHead(CBORMajorType::Unsigned, static_cast<std::uint64_t>(value));
+    } else {
+      writeHead(CBORMajorType::Negative,
+                static_cast<std::uint64_t>(-1 - value));
+    }
+  }
+
+  void writeDouble(double value) {
+    appendBigEndian(initialByte(CBORMajorType::Simple, 27),
+                    std::bit_cast<std::uint64_t>(value), 8);
+  }
+
+  void writeEncodedValue(moped::TimePoint value) {
+    using namespace std::chrono;
+    auto sinceEpoch = value.time_since_epoch();
+    writeHead(CBORMajorType::Tag, cbor::EpochTimeTag);
+    if (sinceEpoch % seconds{1} == sinceEpoch.zero()) {
+      writeInteger(duration_cast<seconds>(sinceEpoch).count());
+    } else {
+      writeDouble(duration<double>(sinceEpoch).count());
+    }
+  }
+
+  template <is_allowed_itegral I, std::uint8_t Scale10V>
+  void writeEncodedValue(const ScaledInteger<I, Scale10V> &value) {
+    // Trailing zeros are folded into the exponent to keep mantissas short.
+    // Mantissas beyond 64 bit signed range, which decimal fractions are
+    // decoded into, are written as the value's exact decimal text
+    auto mantissa = value.getRawIntegerValue();
+    std::int64_t exponent = -static_cast<std::int64_t>(Scale10V);
+    while (mantissa != 0 && mantissa % 10 == 0 && exponent < 0) {
+      mantissa /= 10;
+      ++exponent;
+    }
+    if (!fitsIntegral<std::int64_t>(mantissa)) {
+      writeString(value.toString());
+      return;
+    }
+    writeHead(CBORMajorType::Tag, cbor::DecimalFractionTag);
+    writeHead(CBORMajorType::Array, 2);
+    writeInteger(exponent);
+    writeInteger(static_cast<std::int64_t>(mantissa));
+  }
+
+  template <typename T> void writeEncodedValue(const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      _output.push_back(static_cast<char>(
+          initialByte(CBORMajorType::Simple, value ? 21 : 20)));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      writeDouble(value);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+      writeInteger(value);
+    } else if constexpr (std::is_integral_v<T>) {
+      writeHead(CBORMajorType::Unsigned, value);
+    } else if constexpr (std::convertible_to<T, std::string_view>) {
+      writeString(value);
+    } else {
+      std::ostringstream text;
+      text << value;
+      writeString(text.view());
+    }
+  }
+};
+
+template <typename T, typename... FormatArgs>
+void encodeToCBOR(const T &mopedObject, std::string &output, FormatArgs...) {
+  CBOREmitterContext<FormatArgs...> context(output);
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<FormatArgs...>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+}
+
+template <typename T, typename... FormatArgs>
+void encodeToCBORStream(const T &mopedObject, std::ostream &output,
+                        FormatArgs... args) {
+  std::string encoded;
+  encodeToCBOR(mopedObject, encoded, args...);
+  output.write(encoded.data(), encoded.size());
+}
+
+template <typename T, typename... FormatArgs>
+std::string encodeToCBORString(const T &mopedObject, FormatArgs... args) {
+  std::string encoded;
+  encodeToCBOR(mopedObject, encoded, args...);
+  return encoded;
+}
+
+} // namespace moped
@@ -0,0 +1,483 @@
+#pragma once
+
+#include "moped/BinaryParseEvents.hpp"
+#include "moped/CBORTypes.hpp"
+#include "moped/concepts.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moped {
+
+namespace cbor {
+
+// Byte sources for CBORParser. Text read from a view source references the
+// document, text read from a stream source references a buffer reused for
+// the next string.
+
+class ViewSource {
+public:
+  ViewSource(std::string_view document) : _document(document) {}
+
+  int peek() const {
+    return _position < _document.size()
+               ? static_cast<std::uint8_t>(_document[_position])
+               : -1;
+  }
+
+  bool read(std::uint8_t *target, std::size_t size) {
+    if (_document.size() - _position < size) {
+      return false;
+    }
+    std::memcpy(target, _document.data() + _position, size);
+    _position += size;
+    return true;
+  }
+
+  std::expected<std::string_view, ParseError> readText(std::size_t size) {
+    if (_document.size() - _position < size) {
+      return std::unexpected("Truncated CBOR text string");
+    }
+    auto text = _document.substr(_position, size);
+    _position += size;
+    return text;
+  }
+
+  bool atEnd() const { return _position == _document.size(); }
+
+private:
+  std::string_view _document;
+  std::size_t _position{0};
+};
+
+class StreamSource {
+public:
+  StreamSource(std::istream &stream) : _stream(stream) {}
+
+  int peek() {
+    auto next = _stream.peek();
+    return next == std::istream::traits_type::eof() ? -1 : next;
+  }
+
+  bool read(std::uint8_t *target, std::size_t size) {
+    _stream.read(reinterpret_cast<char *>(target), size);
+    return static_cast<std::size_t>(_stream.gcount()) == size;
+  }
+
+  // The length comes from the document, so the buffer grows a chunk at a
+  // time as text arrives rather than being sized up front
+  std::expected<std::string_view, ParseError> readText(std::size_t size) {
+    constexpr std::size_t ChunkSize = 64 * 1024;
+    _buffer.clear();
+    while (_buffer.size() < size) {
+      auto offset = _buffer.size();
+      auto chunk = std::min(ChunkSize, size - offset);
+      _buffer.resize(offset + chunk);
+      _stream.read(_buffer.data() + offset, chunk);
+      if (static_cast<std::size_t>(_stream.gcount()) != chunk) {
+        return std::unexpected("Truncated CBOR text string");
+      }
+    }
+    return std::string_view{_buffer};
+  }
+
+  bool atEnd() { return peek() == -1; }
+
+private:
+  std::istream &_stream;
+  std::string _buffer;
+};
+
+} // namespace cbor
+
+// Decodes RFC 8949 CBOR into moped parse events from a document view or
+// incrementally from a stream. Definite and indefinite length maps, arrays
+// and text strings are supported, map keys must be text.
+//
+// Tag 1 epoch times and tag 4 decimal fractions are delivered through
+// onTimeValue and onDecimalValue, numbers through the typed numeric events,
+// so none of them pass through text on dispatchers supporting those events.
+// Fractional epoch seconds are rounded to microseconds, the precision a
+// double retains for current dates. Other tags are skipped and their content
+// decoded as untagged.
+template <IParserEventDispatchC ParseEventDispatchT> class CBORParser {
+  static constexpr std::uint8_t IndefiniteLength = 31;
+  static constexpr int BreakCode = 0xff;
+
+  struct Head {
+    CBORMajorType majorType;
+    std::uint8_t additional;
+    std::uint64_t argument;
+
+    bool isIndefinite() const { return additional == IndefiniteLength; }
+  };
+
+  struct Container {
+    std::uint64_t remaining;
+    bool isMap;
+    bool isIndefinite;
+  };
+
+  using ExpectedHead = std::expected<Head, ParseError>;
+  using ExpectedText = std::expected<std::string_view, ParseError>;
+
+  ParseEventDispatchT &_eventDispatch;
+  std::vector<Container> _containers;
+  std::string _chunkedText;
+
+  static ExpectedHead readHead(auto &source) {
+    std::uint8_t initialByte;
+    if (!source.read(&initialByte, 1)) {
+      return std::unexpected("Unexpected end of CBOR document");
+    }
+    Head head{static_cast<CBORMajorType>(initialByte >> 5),
+              static_cast<std::uint8_t>(initialByte & 0x1f), 0};
+    if (head.additional < 24) {
+      head.argument = head.additional;
+    } else if (head.additional <= 27) {
+      std::uint8_t bytes[8];
+      std::size_t size = std::size_t{1} << (head.additional - 24);
+      if (!source.read(bytes, size)) {
+        return std::unexpected("Truncated CBOR argument");
+      }
+      for (std::size_t index = 0; index < size; ++index) {
+        head.argument = head.argument << 8 | bytes[index];
+      }
+    } else if (!head.isIndefinite()) {
+      return std::unexpected(ParseError{
+          "Reserved CBOR additional information", char(initialByte)});
+    }
+    return head;
+  }
+
+  // Definite strings from a view source are returned without copying,
+  // chunks of indefinite strings are joined in a reusable buffer
+  ExpectedText readText(auto &source, const Head &head) {
+    if (head.majorType != CBORMajorType::TextString) {
+      return std::unexpected("CBOR map keys must be text strings");
+    }
+    if (!head.isIndefinite()) {
+      return source.readText(head.argument);
+    }
+    _chunkedText.clear();
+    while (source.peek() != BreakCode) {
+      auto chunkHead = readHead(source);
+      if (!chunkHead) {
+        return std::unexpected(chunkHead.error());
+      }
+      if (chunkHead->majorType != CBORMajorType::TextString ||
+          chunkHead->isIndefinite()) {
+        return std::unexpected("Invalid chunk in indefinite CBOR text string");
+      }
+      auto chunk = source.readText(chunkHead->argument);
+      if (!chunk) {
+        return chunk;
+      }
+      _chunkedText.append(*chunk);
+    }
+    std::uint8_t breakCode;
+    source.read(&breakCode, 1);
+    return std::string_view{_chunkedText};
+  }
+
+  static std::expected<std::int64_t, ParseError>
+  readInteger(auto &source) {
+    auto head = readHead(source);
+    if (!head) {
+      return std::unexpected(head.error());
+    }
+    if (head->majorType != CBORMajorType::Unsigned &&
+        head->majorType != CBORMajorType::Negative) {
+      return std::unexpected("Expected CBOR integer");
+    }
+    if (head->argument >
+        static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+      return std::unexpected("CBOR integer exceeds 64 bit signed range");
+    }
+    auto value = static_cast<std::int64_t>(head->argument);
+    return head->majorType == CBORMajorType::Negative ? -1 - value : value;
+  }
+
+  static double halfToDouble(std::uint16_t half) {
+    int exponent = (half >> 10) & 0x1f;
+    double mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+      value = std::ldexp(mantissa, -24);
+    } else if (exponent == 31) {
+      value = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                            : std::numeric_limits<double>::quiet_NaN();
+    } else {
+      value = std::ldexp(mantissa + 1024, exponent - 25);
+    }
+    return (half & 0x8000) ? -value : value;
+  }
+
+  static std::expected<double, ParseError> floatValue(const Head &head) {
+    switch (head.additional) {
+    case 25:
+      return halfToDouble(static_cast<std::uint16_t>(head.argument));
+    case 26:
+      return static_cast<double>(
+          std::bit_cast<float>(static_cast<std::uint32_t>(head.argument)));
+    case 27:
+      return std::bit_cast<double>(head.argument);
+    default:
+      return std::unexpected("Expected CBOR floating point value");
+    }
+  }
+
+  Expected parseEpochTime(auto &source) {
+    using namespace std::chrono;
+    // A second inside the range of the clock's duration, so rounding can't
+    // carry a time past it
+    constexpr auto MinSeconds =
+        duration_cast<seconds>(TimePoint::duration::min()).count() + 1;
+    constexpr auto MaxSeconds =
+        duration_cast<seconds>(TimePoint::duration::max()).count() - 1;
+    auto head = readHead(source);
+    if (!head) {
+      return std::unexpected(head.error());
+    }
+    if (head->majorType == CBORMajorType::Simple) {
+      auto epochSeconds = floatValue(*head);
+      if (!epochSeconds) {
+        return std::unexpected(epochSeconds.error());
+      }
+      if (!std::isfinite(*epochSeconds) ||
+          *epochSeconds < static_cast<double>(MinSeconds) ||
+          *epochSeconds > static_cast<double>(MaxSeconds)) {
+        return std::unexpected(
+            ParseError{"CBOR epoch time outside the range of TimePoint",
+                       std::to_string(*epochSeconds)});
+      }
+      return dispatchTimeValue(
+          _eventDispatch,
+          TimePoint{round<microseconds>(duration<double>{*epochSeconds})});
+    }
+    if (head->majorType != CBORMajorType::Unsigned &&
+        head->majorType != CBORMajorType::Negative) {
+      return std::unexpected("Invalid content for CBOR epoch time tag");
+    }
+    // A negative integer's argument is its magnitude less one
+    if (head->majorType == CBORMajorType::Unsigned
+            ? head->argument > static_cast<std::uint64_t>(MaxSeconds)
+            : head->argument > static_cast<std::uint64_t>(-1 - MinSeconds)) {
+      return std::unexpected(
+          ParseError{"CBOR epoch time outside the range of TimePoint",
+                     std::to_string(head->argument)});
+    }
+    auto epochSeconds = static_cast<std::int64_t>(head->argument);
+    if (head->majorType == CBORMajorType::Negative) {
+      epochSeconds = -1 - epochSeconds;
+    }
+    return dispatchTimeValue(_eventDispatch, TimePoint{seconds{epochSeconds}});
+  }
+
+  Expected parseDecimalFraction(auto &source) {
+    auto head = readHead(source);
+    if (!head) {
+      return std::unexpected(head.error());
+    }
+    if (head->majorType != CBORMajorType::Array || head->argument != 2) {
+      return std::unexpected(
+          "CBOR decimal fraction must be an array of exponent and mantissa");
+    }
+    auto exponent = readInteger(source);
+    if (!exponent) {
+      return std::unexpected(exponent.error());
+    }
+    auto mantissa = readInteger(source);
+    if (!mantissa) {
+      return std::unexpected(mantissa.error());
+    }
+    if (*exponent < std::numeric_limits<std::int32_t>::min() ||
+        *exponent > std::numeric_limits<std::int32_t>::max()) {
+      return std::unexpected("CBOR decimal fraction exponent out of range");
+    }
+    return dispatchDecimalValue(
+        _eventDispatch,
+        DecimalFraction{*mantissa, static_cast<std::int32_t>(*exponent)});
+  }
+
+  Expected openContainer(const Head &head, bool isMap) {
+    auto result =
+        isMap ? _eventDispatch.onObjectStart() : _eventDispatch.onArrayStart();
+    if (!result) {
+      return result;
+    }
+    _containers.push_back(
+        Container{head.argument, isMap, head.isIndefinite()});
+    return {};
+  }
+
+  Expected parseValue(auto &source) {
+    auto head = readHead(source);
+    // Skipped tags are consumed in a loop, a long run of them mustn't
+    // recurse
+    while (head && head->majorType == CBORMajorType::Tag &&
+           head->argument != cbor::EpochTimeTag &&
+           head->argument != cbor::DecimalFractionTag) {
+      head = readHead(source);
+    }
+    if (!head) {
+      return std::unexpected(head.error());
+    }
+    switch (head->majorType) {
+    case CBORMajorType::Unsigned:
+      return dispatchNumericValue(_eventDispatch, head->argument);
+    case CBORMajorType::Negative:
+      if (head->argument > static_cast<std::uint64_t>(
+                               std::numeric_limits<std::int64_t>::max())) {
+        return std::unexpected("CBOR integer exceeds 64 bit signed range");
+      }
+      return dispatchNumericValue(
+          _eventDispatch, -1 - static_cast<std::int64_t>(head->argument));
+    case CBORMajorType::TextString: {
+      auto text = readText(source, *head);
+      if (!text) {
+        return std::unexpected(text.error());
+      }
+      return _eventDispatch.onStringValue(*text);
+    }
+    case CBORMajorType::Array:
+      return openContainer(*head, false);
+    case CBORMajorType::Map:
+      return openContainer(*head, true);
+    case CBORMajorType::Tag:
+      if (head->argument == cbor::EpochTimeTag) {
+        return parseEpochTime(source);
+      }
+      return parseDecimalFraction(source);
+    case CBORMajorType::Simple:
+      switch (head->additional) {
+      case 20:
+        return _eventDispatch.onBooleanValue(false);
+      case 21:
+        return _eventDispatch.onBooleanValue(true);
+      case 22:
+      case 23:
+        return _eventDispatch.onNullValue();
+      case 25:
+      case 26:
+      case 27:
+        return dispatchNumericValue(_eventDispatch, *floatValue(*head));
+      case IndefiniteLength:
+        return std::unexpected("Unexpected CBOR break code");
+      default:
+        return std::unexpected("Unsupported CBOR simple value");
+      }
+    default:
+      return std::unexpected(
+          "CBOR byte strings have no moped mapping and are not supported");
+    }
+  }
+
+  Expected parseDocument(auto &source) {
+    _containers.clear();
+    auto first = source.peek();
+    if (first == -1) {
+      return std::unexpected("Empty CBOR document");
+    }
+    auto majorType = static_cast<CBORMajorType>(first >> 5);
+    bool isRootArray = majorType == CBORMajorType::Array;
+    if (!isRootArray && majorType != CBORMajorType::Map) {
+      return std::unexpected(
+          ParseError{"Expected CBOR map or array document", char(first)});
+    }
+    if (isRootArray) {
+      auto result = _eventDispatch.onObjectStart();
+      if (!result) {
+        return result;
+      }
+      result = _eventDispatch.onMember("");
+      if (!result) {
+        return std::unexpected{
+            "CBOR documents with root arrays require the top level class "
+            "object to map an empty string (\"\") member id to a moped "
+            "collection"};
+      }
+    }
+    if (auto result = parseValue(source); !result) {
+      return result;
+    }
+
+    while (!_containers.empty()) {
+      auto &container = _containers.back();
+      bool finished = container.isIndefinite ? source.peek() == BreakCode
+                                             : container.remaining == 0;
+      if (finished) {
+        if (container.isIndefinite) {
+          std::uint8_t breakCode;
+          source.read(&breakCode, 1);
+        }
+        bool isMap = container.isMap;
+        _containers.pop_back();
+        auto result = isMap ? _eventDispatch.onObjectFinish()
+                            : _eventDispatch.onArrayFinish();
+        if (!result) {
+          return result;
+        }
+        continue;
+      }
+      if (!container.isIndefinite) {
+        --container.remaining;
+      }
+      if (container.isMap) {
+        auto keyHead = readHead(source);
+        if (!keyHead) {
+          return std::unexpected(keyHead.error());
+        }
+        auto memberName = readText(source, *keyHead);
+        if (!memberName) {
+          return std::unexpected(memberName.error());
+        }
+        if (auto result = _eventDispatch.onMember(*memberName); !result) {
+          return result;
+        }
+      }
+      if (auto result = parseValue(source); !result) {
+        return result;
+      }
+    }
+
+    if (isRootArray) {
+      return _eventDispatch.onObjectFinish();
+    }
+    return {};
+  }
+
+public:
+  CBORParser(ParseEventDispatchT &eventDispatch)
+      : _eventDispatch(eventDispatch) {}
+
+  Expected parse(std::string_view document) {
+    cbor::ViewSource source{document};
+    if (auto result = parseDocument(source); !result) {
+      return result;
+    }
+    if (!source.atEnd()) {
+      return std::unexpected("Unexpected data after CBOR document");
+    }
+    return {};
+  }
+
+  // Reads exactly one document, further documents may follow on the stream
+  Expected parse(std::istream &stream) {
+    cbor::StreamSource source{stream};
+    return parseDocument(source);
+  }
+
+  auto &getDispatcher() { return _eventDispatch; }
+};
+
+} // namespace moped
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace moped {
+
+// RFC 8949 major types, the top three bits of every initial byte
+enum class CBORMajorType : std::uint8_t {
+  Unsigned = 0,
+  Negative = 1,
+  ByteString = 2,
+  TextString = 3,
+  Array = 4,
+  Map = 5,
+  Tag = 6,
+  Simple = 7
+};
+
+namespace cbor {
+// Tags with a direct moped mapping
+constexpr std::uint64_t EpochTimeTag = 1;
+constexpr std::uint64_t DecimalFractionTag = 4;
+} // namespace cbor
+
+} // namespace moped
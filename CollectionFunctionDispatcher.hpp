@@ -2,7 +2,10 @@
 
 #include "moped/concepts.hpp"
 
+#include <array>
 #include <optional>
+#include <span>
+#include <utility>
 
 namespace moped {
 
@@ -48,4 +51,113 @@ private:
   HandlerT _handler{};
 };
 
+// Allocation free alternative to CollectionFunctionDispatcher. The handler is
+// a template parameter so calls can be inlined, and a single capture object is
+// recycled across elements, the parsing handler clears its members in place
+// so strings and nested collections retain their capacity between elements.
+// Scalar value types bypass the capture entirely through dispatch().
+
+template <typename ValueT, typename HandlerT>
+class RecyclingCollectionFunctionDispatcher {
+
+public:
+  using value_type = ValueT;
+  static constexpr bool RecyclesCapture = true;
+
+  RecyclingCollectionFunctionDispatcher() = default;
+  RecyclingCollectionFunctionDispatcher(HandlerT handler)
+      : _handler(std::move(handler)) {}
+
+  ValueT &resetCapture() {
+    _capturePending = true;
+    return _captureValue;
+  }
+
+  void setCurrentValue(const ValueT &value) {
+    _captureValue = value;
+    _capturePending = true;
+  }
+
+  Expected dispatchLastCapture() {
+    if (!_capturePending) {
+      return {};
+    }
+    _capturePending = false;
+    return _handler(std::as_const(_captureValue));
+  }
+
+  Expected dispatch(const ValueT &value) { return _handler(value); }
+
+  HandlerT &getHandler() { return _handler; }
+
+private:
+  ValueT _captureValue{};
+  bool _capturePending{false};
+  HandlerT _handler{};
+};
+
+// Accumulates up to BatchSize decoded elements in a reusable buffer and hands
+// them to the handler as a std::span when the buffer fills or the array ends.
+// Buffer slots are recycled like RecyclingCollectionFunctionDispatcher's
+// capture so element storage is retained across batches.
+
+template <typename ValueT, std::size_t BatchSize, typename HandlerT>
+  requires(BatchSize > 0)
+class BatchingCollectionFunctionDispatcher {
+
+public:
+  using value_type = ValueT;
+  static constexpr bool RecyclesCapture = true;
+
+  BatchingCollectionFunctionDispatcher() = default;
+  BatchingCollectionFunctionDispatcher(HandlerT handler)
+      : _handler(std::move(handler)) {}
+
+  ValueT &resetCapture() {
+    _capturePending = true;
+    return _batch[_batchCount];
+  }
+
+  void setCurrentValue(const ValueT &value) {
+    _batch[_batchCount] = value;
+    _capturePending = true;
+  }
+
+  Expected dispatchLastCapture() {
+    if (!_capturePending) {
+      return {};
+    }
+    _capturePending = false;
+    if (++_batchCount == BatchSize) {
+      return flushBatch();
+    }
+    return {};
+  }
+
+  Expected dispatch(const ValueT &value) {
+    _batch[_batchCount] = value;
+    if (++_batchCount == BatchSize) {
+      return flushBatch();
+    }
+    return {};
+  }
+
+  Expected flushBatch() {
+    if (_batchCount == 0) {
+      return {};
+    }
+    std::span<const ValueT> batch{_batch.data(), _batchCount};
+    _batchCount = 0;
+    return _handler(batch);
+  }
+
+  HandlerT &getHandler() { return _handler; }
+
+private:
+  std::array<ValueT, BatchSize> _batch{};
+  std::size_t _batchCount{0};
+  bool _capturePending{false};
+  HandlerT _handler{};
+};
+
 } // namespace moped
\ No newline at end of file
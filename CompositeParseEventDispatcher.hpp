@@ -1,6 +1,7 @@
 #pragma once
 
 #include "moped/concepts.hpp"
+#include <cstdint>
 #include <expected>
 #include <stack>
 #include <type_traits>
@@ -20,11 +21,19 @@ struct CompositeParserEventDispatcher {
         _composite{std::forward<Args>(args)...} {}
 
   Expected onMember(std::string_view memberName) {
-    return _mopedHandlerStack.top()->onMember(_mopedHandlerStack, memberName);
+    return _mopedHandlerStack.top()->onMember(
+        _mopedHandlerStack, DecodingTraits::getMemberId(memberName));
+  }
+  // Member ids resolved by the parser, e.g. FIX tag numbers
+  Expected onMember(typename DecodingTraits::MemberIdType memberId)
+    requires(!std::is_same_v<typename DecodingTraits::MemberIdType,
+                             std::string_view>)
+  {
+    return _mopedHandlerStack.top()->onMember(_mopedHandlerStack, memberId);
   }
   Expected onObjectStart() {
     if (_mopedHandlerStack.empty()) {
-      _compositeMOPEDHandler.setTargetMember(_composite);
+      _compositeMOPEDHandler.setTargetMember(targetComposite());
       return _compositeMOPEDHandler.onObjectStart(_mopedHandlerStack);
     }
     return _mopedHandlerStack.top()->onObjectStart(_mopedHandlerStack);
@@ -40,6 +49,10 @@ struct CompositeParserEventDispatcher {
     return _mopedHandlerStack.top()->onArrayFinish(_mopedHandlerStack);
   }
 
+  Expected onArraySizeHint(std::size_t size) {
+    return _mopedHandlerStack.top()->onArraySizeHint(_mopedHandlerStack, size);
+  }
+
   Expected onStringValue(std::string_view value) {
     return _mopedHandlerStack.top()->onStringValue(value);
   }
@@ -48,14 +61,44 @@ struct CompositeParserEventDispatcher {
     return _mopedHandlerStack.top()->onNumericValue(value);
   }
 
+  Expected onIntegerValue(std::int64_t value) {
+    return _mopedHandlerStack.top()->onIntegerValue(value);
+  }
+
+  Expected onUnsignedValue(std::uint64_t value) {
+    return _mopedHandlerStack.top()->onUnsignedValue(value);
+  }
+
+  Expected onFloatValue(double value) {
+    return _mopedHandlerStack.top()->onFloatValue(value);
+  }
+
+  Expected onTimeValue(TimePoint value) {
+    return _mopedHandlerStack.top()->onTimeValue(value);
+  }
+
+  Expected onDecimalValue(DecimalFraction value) {
+    return _mopedHandlerStack.top()->onDecimalValue(value);
+  }
+
   Expected onBooleanValue(bool value) {
     return _mopedHandlerStack.top()->onBooleanValue(value);
   }
 
   Expected onNullValue() { return _mopedHandlerStack.top()->onNullValue(); }
-  auto &&moveComposite() { return std::move(_composite); }
+  auto &&moveComposite() { return std::move(targetComposite()); }
+
+  auto &getComposite() { return targetComposite(); }
 
-  auto &getComposite() { return _composite; }
+  // Decode subsequent documents into storage owned elsewhere, such as a
+  // pipeline ring slot, rather than the dispatcher's own composite.
+  void setTargetComposite(CompositeT &composite) {
+    _compositeMOPEDHandler.reset();
+    _externalComposite = &composite;
+    while (!_mopedHandlerStack.empty()) {
+      _mopedHandlerStack.pop();
+    }
+  }
 
   auto &getMopedHandler() { return _compositeMOPEDHandler; }
 
@@ -64,14 +107,20 @@ struct CompositeParserEventDispatcher {
     std::destroy_at(&_composite);
     std::construct_at(&_composite,
                       std::forward<Args>(args)...); // Reconstruct with new args
+    _externalComposite = nullptr;
     while (!_mopedHandlerStack.empty()) {
       _mopedHandlerStack.pop();
     }
   }
 
 private:
+  CompositeT &targetComposite() {
+    return _externalComposite ? *_externalComposite : _composite;
+  }
+
   CompositeMOPEDHandler _compositeMOPEDHandler;
   CompositeT _composite;
+  CompositeT *_externalComposite{nullptr};
   MOPEDHandlerStack _mopedHandlerStack;
 };
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "moped/CompositeParseEventDispatcher.hpp"
+#include "moped/CompositeSlotRing.hpp"
+#include "moped/JSONViewParser.hpp"
+#include "moped/concepts.hpp"
+
+namespace moped {
+
+// Producer half of a parse to consumer pipeline. The stage owns a composite
+// parser event dispatcher whose decode target is redirected to a free ring
+// slot for each document, the slot is cleared in place, filled by the parser
+// and published. Each producing thread owns its own stage, the ring is shared
+// with the consumer (and other producers for RingProducers::Multiple).
+
+template <typename CompositeT, DecodingTraitsC DecodingTraits,
+          std::size_t Capacity,
+          RingProducers Producers = RingProducers::Single>
+class CompositePipelineStage {
+public:
+  using RingT = CompositeSlotRing<CompositeT, Capacity, Producers>;
+  using DispatcherT = CompositeParserEventDispatcher<CompositeT, DecodingTraits>;
+
+  CompositePipelineStage(RingT &ring) : _ring(ring) {}
+
+  // Decodes one document into a ring slot via the supplied parse function,
+  // which receives the dispatcher to drive, and publishes it on success. A
+  // slot whose decode failed is kept and reused for the next document.
+  Expected produce(auto &&parseFunction) {
+    if (!_pendingSlot) {
+      _pendingSlot = &_ring.acquire();
+    }
+    auto &compositeHandler = _dispatcher.getMopedHandler();
+    compositeHandler.setTargetMember(_pendingSlot->value);
+    compositeHandler.clearMembers();
+    _dispatcher.setTargetComposite(_pendingSlot->value);
+
+    if (auto result = parseFunction(_dispatcher); !result) {
+      return result;
+    }
+    _ring.publish(*_pendingSlot);
+    _pendingSlot = nullptr;
+    return {};
+  }
+
+  Expected produceFromJSONView(std::string_view jsonView) {
+    return produce([jsonView](DispatcherT &dispatcher) {
+      JSONViewParser<DispatcherT> parser{dispatcher};
+      return parser.parse(jsonView);
+    });
+  }
+
+  RingT &getRing() { return _ring; }
+
+private:
+  RingT &_ring;
+  DispatcherT _dispatcher{};
+  typename RingT::Slot *_pendingSlot{nullptr};
+};
+
+} // namespace moped
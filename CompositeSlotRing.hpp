@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace moped {
+
+enum class RingProducers { Single, Multiple };
+
+// Bounded lock free ring of pre-allocated value slots used to hand decoded
+// composites from a parsing thread to a consuming thread without copies.
+// Producers acquire a free slot, decode directly into it and publish it, the
+// single consumer takes published slots in order and releases them back for
+// reuse. Slot objects are never destroyed so storage held by their members
+// (strings, vectors ...) is retained across cycles.
+//
+// Sequencing follows the bounded MPMC queue design by D. Vyukov, every slot
+// carries a sequence number that tells producers and the consumer whether it
+// is free, published or still in use. With RingProducers::Single the
+// producer side claims positions with a plain store instead of a CAS.
+
+template <typename T, std::size_t Capacity,
+          RingProducers Producers = RingProducers::Single>
+  requires(Capacity > 1 && (Capacity & (Capacity - 1)) == 0)
+class CompositeSlotRing {
+  static constexpr std::size_t CacheLine = 64;
+
+public:
+  struct Slot {
+    T value{};
+
+  private:
+    friend class CompositeSlotRing;
+    alignas(CacheLine) std::atomic<std::size_t> _sequence{0};
+    std::size_t _position{0};
+  };
+
+  CompositeSlotRing() {
+    for (std::size_t index = 0; index < Capacity; ++index) {
+      _slots[index]._sequence.store(index, std::memory_order_relaxed);
+    }
+  }
+
+  CompositeSlotRing(const CompositeSlotRing &) = delete;
+  CompositeSlotRing &operator=(const CompositeSlotRing &) = delete;
+
+  // Producer side, returns nullptr when every slot is published or in use
+  Slot *tryAcquire() {
+    std::size_t position = _producerPosition.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = _slots[position & (Capacity - 1)];
+      auto sequence = slot._sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(position);
+      if (difference < 0) {
+        return nullptr;
+      }
+      if (difference > 0) {
+        position = _producerPosition.load(std::memory_order_relaxed);
+        continue;
+      }
+      if constexpr (Producers == RingProducers::Single) {
+        _producerPosition.store(position + 1, std::memory_order_relaxed);
+      } else if (!_producerPosition.compare_exchange_weak(
+                     position, position + 1, std::memory_order_relaxed)) {
+        continue;
+      }
+      slot._position = position;
+      return &slot;
+    }
+  }
+
+  // Spins until the consumer releases a slot, this is the ring's back
+  // pressure so it must not be called from the consuming thread.
+  Slot &acquire() {
+    for (;;) {
+      if (auto *slot = tryAcquire()) {
+        return *slot;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  void publish(Slot &slot) {
+    slot._sequence.store(slot._position + 1, std::memory_order_release);
+  }
+
+  // Consumer side, returns the oldest published slot or nullptr
+  Slot *consume() {
+    Slot &slot = _slots[_consumerPosition & (Capacity - 1)];
+    if (slot._sequence.load(std::memory_order_acquire) !=
+        _consumerPosition + 1) {
+      return nullptr;
+    }
+    slot._position = _consumerPosition++;
+    return &slot;
+  }
+
+  // Slots may be released in any order, but producers reuse them in ring
+  // order, so a slot held back delays reuse of the slots after it
+  void release(Slot &slot) {
+    slot._sequence.store(slot._position + Capacity, std::memory_order_release);
+  }
+
+  // Hands every currently published value to the handler and releases it
+  std::size_t consumeAll(auto &&handler) {
+    std::size_t consumed = 0;
+    while (auto *slot = consume()) {
+      handler(std::as_const(slot->value));
+      release(*slot);
+      ++consumed;
+    }
+    return consumed;
+  }
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+  std::array<Slot, Capacity> _slots;
+  alignas(CacheLine) std::atomic<std::size_t> _producerPosition{0};
+  alignas(CacheLine) std::size_t _consumerPosition{0};
+};
+
+} // namespace moped
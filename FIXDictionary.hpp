@@ -0,0 +1,146 @@
+#pragma once
+
+#include "moped/FIXTypes.hpp"
+#include "moped/concepts.hpp"
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <type_traits>
+#include <vector>
+
+namespace moped {
+
+namespace fix {
+
+// Tags known to the message or to one repeating group, indexed directly by
+// tag number
+struct Scope {
+  static constexpr std::int32_t NotInScope = -1;
+  static constexpr std::int32_t Field = 0;
+
+  // NotInScope, Field, or the index of the group scope a NoXXX count tag
+  // opens
+  std::int32_t lookup(std::uint32_t tag) const {
+    return tag < tags.size() ? tags[tag] : NotInScope;
+  }
+
+  std::vector<std::int32_t> tags;
+  // First tag of every group entry, it starts the next entry
+  std::uint32_t delimiterTag{0};
+  std::int32_t parent{NotInScope};
+};
+
+// Tag layout of a moped mapping under FIXDecodingTraits. Scope 0 holds the
+// message fields, every collection of composites becomes a repeating group
+// scope entered through the collection's count tag. Embedded components
+// contribute their tags to the enclosing scope.
+class Dictionary {
+public:
+  const Scope &scope(std::int32_t index) const { return _scopes[index]; }
+
+  // Nearest enclosing scope of 'scopeIndex' that knows 'tag', NotInScope if
+  // none does
+  std::int32_t findEnclosingScope(std::int32_t scopeIndex,
+                                  std::uint32_t tag) const {
+    for (auto index = _scopes[scopeIndex].parent; index != Scope::NotInScope;
+         index = _scopes[index].parent) {
+      if (_scopes[index].lookup(tag) != Scope::NotInScope) {
+        return index;
+      }
+    }
+    return Scope::NotInScope;
+  }
+
+  template <typename CompositeT, DecodingTraitsC DecodingTraits>
+  static std::expected<Dictionary, ParseError> create() {
+    Dictionary dictionary;
+    dictionary._scopes.emplace_back();
+    if (auto result =
+            dictionary.addComposite<CompositeT, DecodingTraits>(0);
+        !result) {
+      return std::unexpected(result.error());
+    }
+    return dictionary;
+  }
+
+private:
+  Expected addTag(std::int32_t scopeIndex, std::uint32_t tag,
+                  std::int32_t kind) {
+    auto &tags = _scopes[scopeIndex].tags;
+    if (tag >= tags.size()) {
+      tags.resize(tag + 1, Scope::NotInScope);
+    }
+    if (tags[tag] != Scope::NotInScope) {
+      return std::unexpected(ParseError{"FIX tag mapped more than once",
+                                        std::format("{}", tag)});
+    }
+    tags[tag] = kind;
+    if (_scopes[scopeIndex].delimiterTag == 0) {
+      _scopes[scopeIndex].delimiterTag = tag;
+    }
+    return {};
+  }
+
+  template <typename CompositeT, DecodingTraitsC DecodingTraits>
+  Expected addComposite(std::int32_t scopeIndex) {
+    auto mopedHandler = getMOPEDHandlerForParser<CompositeT, DecodingTraits>();
+    Expected result;
+    mopedHandler.forEachMemberMapping([&](auto, const auto &mapping) {
+      if (result) {
+        result = addMember<typename std::decay_t<decltype(mapping)>::MemberT,
+                           DecodingTraits>(scopeIndex, mapping.memberId);
+      }
+    });
+    return result;
+  }
+
+  template <typename MemberT, DecodingTraitsC DecodingTraits>
+  Expected addMember(std::int32_t scopeIndex, std::uint32_t tag) {
+    if (tag == DecodingTraits::EmbeddingMemberId) {
+      if constexpr (IsMOPEDCompositeC<MemberT, DecodingTraits>) {
+        return addComposite<MemberT, DecodingTraits>(scopeIndex);
+      } else {
+        return std::unexpected("Embedded members must be a composite type");
+      }
+    }
+    if (tag == InvalidTag) {
+      return std::unexpected(
+          "FIX member names must be tag numbers greater than zero");
+    }
+    if constexpr (IsMOPEDCompositeDispatcherC<MemberT> ||
+                  IsMOPEDPushCollectionC<MemberT>) {
+      if constexpr (IsMOPEDCompositeC<typename MemberT::value_type,
+                                      DecodingTraits>) {
+        auto groupIndex = static_cast<std::int32_t>(_scopes.size());
+        if (auto result = addTag(scopeIndex, tag, groupIndex); !result) {
+          return result;
+        }
+        _scopes.emplace_back().parent = scopeIndex;
+        if (auto result =
+                addComposite<typename MemberT::value_type, DecodingTraits>(
+                    groupIndex);
+            !result) {
+          return result;
+        }
+        if (_scopes[groupIndex].delimiterTag == 0) {
+          return std::unexpected(ParseError{
+              "FIX repeating group maps no fields", std::format("{}", tag)});
+        }
+        return {};
+      }
+    }
+    if constexpr (IsMOPEDCompositeC<MemberT, DecodingTraits>) {
+      return std::unexpected(ParseError{
+          "FIX composite members must be embedded or repeating groups",
+          std::format("{}", tag)});
+    } else {
+      return addTag(scopeIndex, tag, Scope::Field);
+    }
+  }
+
+  std::vector<Scope> _scopes;
+};
+
+} // namespace fix
+
+} // namespace moped
@@ -0,0 +1,492 @@
+#pragma once
+#include "moped/FIXTypes.hpp"
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include "moped/scaledIntParseUtils.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace moped {
+
+namespace fix {
+
+// Growable message buffer keeping the byte sum of what is written to it, so
+// the CheckSum is known as soon as the body is complete. Space skipped for
+// values rendered later is excluded from the sum until addToSum.
+class FieldBuffer {
+public:
+  static std::uint32_t byteSum(std::string_view text) {
+    std::uint32_t sum = 0;
+    for (unsigned char c : text) {
+      sum += c;
+    }
+    return sum;
+  }
+
+  const char *data() const { return _data.data(); }
+  char *at(std::size_t offset) { return _data.data() + offset; }
+  std::size_t size() const { return _size; }
+  std::uint32_t sum() const { return _sum; }
+  std::string_view view() const { return {_data.data(), _size}; }
+
+  void clear() {
+    _size = 0;
+    _sum = 0;
+  }
+
+  // Writable space for up to 'count' bytes at the end, bytes written are
+  // published with commit()
+  char *reserve(std::size_t count) {
+    if (_data.size() - _size < count) {
+      _data.resize(std::max(_data.size() * 2, _size + count));
+    }
+    return _data.data() + _size;
+  }
+
+  void commit(char *end) {
+    auto begin = _data.data() + _size;
+    _sum += byteSum({begin, static_cast<std::size_t>(end - begin)});
+    _size = end - _data.data();
+  }
+
+  void append(std::string_view text, std::uint32_t sum) {
+    std::memcpy(reserve(text.size()), text.data(), text.size());
+    _size += text.size();
+    _sum += sum;
+  }
+
+  void append(std::string_view text) { append(text, byteSum(text)); }
+
+  void append(char c) {
+    *reserve(1) = c;
+    ++_size;
+    _sum += static_cast<unsigned char>(c);
+  }
+
+  void skip(std::size_t count) {
+    reserve(count);
+    _size += count;
+  }
+
+  // Drops 'count' skipped bytes at 'offset', moving what follows them
+  void compact(std::size_t offset, std::size_t count) {
+    std::memmove(at(offset), at(offset + count), _size - offset - count);
+    _size -= count;
+  }
+
+  void addToSum(std::uint32_t sum) { _sum += sum; }
+
+private:
+  std::string _data;
+  std::size_t _size{0};
+  std::uint32_t _sum{0};
+};
+
+// Renders integral digits at 'target' and returns their byte sum
+inline std::uint32_t writeDigits(char *target, std::uint64_t value,
+                                 std::size_t width) {
+  std::uint32_t sum = 0;
+  for (auto index = width; index > 0; --index) {
+    target[index - 1] = static_cast<char>('0' + value % 10);
+    sum += static_cast<unsigned char>(target[index - 1]);
+    value /= 10;
+  }
+  return sum;
+}
+
+inline std::size_t digitCount(std::uint64_t value) {
+  std::size_t digits = 1;
+  for (; value >= 10; value /= 10) {
+    ++digits;
+  }
+  return digits;
+}
+
+// Prices and quantities are written without trailing fractional zeros
+template <typename ScaledT>
+void appendScaledInteger(FieldBuffer &buffer, const ScaledT &value) {
+  using IntegralT = typename ScaledT::IntegralT;
+  if constexpr (sizeof(IntegralT) > sizeof(std::uint64_t)) {
+    char text[64];
+    scaledIntToString(value.getRawIntegerValue(), ScaledT::Scale, text);
+    buffer.append(std::string_view{text});
+  } else {
+    using UnsignedT = std::make_unsigned_t<IntegralT>;
+    auto raw = value.getRawIntegerValue();
+    UnsignedT magnitude = raw < 0 ? UnsignedT(0) - static_cast<UnsignedT>(raw)
+                                  : static_cast<UnsignedT>(raw);
+    auto divisor = static_cast<UnsignedT>(ScaledT::Divisor);
+    char *out = buffer.reserve(48);
+    if (raw < 0) {
+      *out++ = '-';
+    }
+    out = std::to_chars(out, out + 24, magnitude / divisor).ptr;
+    if (auto fraction = magnitude % divisor; fraction != 0) {
+      *out++ = '.';
+      writeDigits(out, fraction, ScaledT::Scale);
+      out += ScaledT::Scale;
+      while (out[-1] == '0') {
+        --out;
+      }
+    }
+    buffer.commit(out);
+  }
+}
+
+template <typename TimePointFormatter>
+Expected appendValue(FieldBuffer &buffer, const auto &value) {
+  using ValueT = std::decay_t<decltype(value)>;
+  if constexpr (std::is_same_v<ValueT, bool>) {
+    buffer.append(value ? 'Y' : 'N');
+  } else if constexpr (std::is_same_v<ValueT, char>) {
+    buffer.append(value);
+  } else if constexpr (std::convertible_to<ValueT, std::string_view>) {
+    std::string_view text{value};
+    if (text.find(SOH) != std::string_view::npos) {
+      return std::unexpected(
+          ParseError{"FIX values can not contain the SOH delimiter", text});
+    }
+    buffer.append(text);
+  } else if constexpr (std::is_same_v<ValueT, TimePoint>) {
+    if constexpr (requires {
+                    TimePointFormatter::write(std::declval<char *>(), value);
+                  }) {
+      buffer.commit(TimePointFormatter::write(
+          buffer.reserve(TimePointFormatter::Length), value));
+    } else {
+      buffer.append(TimePointFormatter::format(value));
+    }
+  } else if constexpr (is_scaled_int<ValueT>) {
+    appendScaledInteger(buffer, value);
+  } else if constexpr (std::is_integral_v<ValueT>) {
+    constexpr std::size_t MaxNumberLength = 32;
+    char *out = buffer.reserve(MaxNumberLength);
+    auto [end, ec] = std::to_chars(out, out + MaxNumberLength, value);
+    if (ec != std::errc{}) {
+      return std::unexpected("Integral value could not be written as FIX");
+    }
+    buffer.commit(end);
+  } else if constexpr (std::is_floating_point_v<ValueT>) {
+    // FIX float fields have no exponent, the shortest fixed notation spans
+    // every integer digit and, for subnormals, every fraction digit
+    using Limits = std::numeric_limits<ValueT>;
+    constexpr std::size_t MaxFixedLength = 3 + Limits::max_exponent10 -
+                                           Limits::min_exponent10 +
+                                           Limits::max_digits10;
+    if (!std::isfinite(value)) {
+      return std::unexpected(
+          ParseError{"FIX float fields can't represent the value",
+                     std::format("{}", value)});
+    }
+    char *out = buffer.reserve(MaxFixedLength);
+    auto [end, ec] = std::to_chars(out, out + MaxFixedLength, value,
+                                   std::chars_format::fixed);
+    if (ec != std::errc{}) {
+      return std::unexpected(
+          ParseError{"FIX float fields can't represent the value",
+                     std::format("{}", value)});
+    }
+    buffer.commit(end);
+  } else {
+    return std::unexpected("Member type has no FIX representation");
+  }
+  return {};
+}
+
+// Header and session fields repeated across messages, such as MsgType,
+// SenderCompID and TargetCompID. A field is rendered when it is set and the
+// rendered text is copied into each message along with its byte sum, so
+// per message work is limited to the fields that changed, e.g. MsgSeqNum.
+// Fields are written in the order they were first set.
+template <typename TimePointFormatter = UTCTimestampFormatter<>>
+class MessageTemplate {
+public:
+  MessageTemplate(std::string_view beginString)
+      : _beginString(std::format("8={}\x01" "9=", beginString)),
+        _beginStringSum(FieldBuffer::byteSum(_beginString)) {}
+
+  Expected setField(std::uint32_t tag, const auto &value) {
+    auto field = std::ranges::find(_fields, tag, &Field::tag);
+    if (field == _fields.end()) {
+      field = _fields.insert(_fields.end(), Field{tag, {}});
+    }
+    auto &text = field->text;
+    text.clear();
+    char *out = text.reserve(16);
+    out = std::to_chars(out, out + 10, tag).ptr;
+    *out++ = '=';
+    text.commit(out);
+    if (auto result = appendValue<TimePointFormatter>(text, value); !result) {
+      _fields.erase(field); // Not left half rendered
+      return result;
+    }
+    text.append(SOH);
+    return {};
+  }
+
+  // BeginString and the BodyLength tag preceding the length digits
+  std::string_view beginString() const { return _beginString; }
+  std::uint32_t beginStringSum() const { return _beginStringSum; }
+
+  void appendFields(FieldBuffer &buffer) const {
+    for (auto &field : _fields) {
+      buffer.append(field.text.view(), field.text.sum());
+    }
+  }
+
+private:
+  struct Field {
+    std::uint32_t tag;
+    FieldBuffer text;
+  };
+
+  std::string _beginString;
+  std::uint32_t _beginStringSum;
+  std::vector<Field> _fields;
+};
+
+} // namespace fix
+
+// Emitter context encoding moped composites mapped with FIXDecodingTraits
+// as tag=value messages. A message opens with space reserved for the
+// BeginString and BodyLength fields followed by the template's fields. Once
+// the body is complete BodyLength is written immediately ahead of it, so
+// the message starts part way into the buffer rather than being moved, and
+// the CheckSum comes from the byte sum kept while writing. "tag=" prefixes
+// of tags up to MaxCachedPrefixTag are rendered once and reused, repeating
+// group counts are back-patched when the group finishes. The context owns
+// its buffer and is intended to be reused for every message of a session.
+template <typename TimePointFormatter = UTCTimestampFormatter<>>
+class FIXEmitterContext {
+public:
+  using MessageTemplateT = fix::MessageTemplate<TimePointFormatter>;
+  static constexpr std::size_t MaxBodyLengthDigits = 7;
+  static constexpr std::size_t MaxGroupCountDigits = 5;
+  // Prefixes of tags up to this one are cached, covering the standard and
+  // user defined ranges, others are rendered for each field
+  static constexpr std::uint32_t MaxCachedPrefixTag = 9999;
+
+  FIXEmitterContext(const MessageTemplateT &messageTemplate)
+      : _template(messageTemplate) {}
+
+  void onObjectStart(std::optional<std::uint32_t> memberId = std::nullopt) {
+    if (_frames.empty()) {
+      beginMessage();
+    } else if (_frames.back().isGroup) {
+      ++_frames.back().count;
+    } else if (memberId.value_or(fix::InvalidTag) !=
+               FIXDecodingTraits<>::EmbeddingMemberId) {
+      fail("FIX composite members must be embedded or repeating groups",
+           memberId.value_or(0));
+    }
+    _frames.push_back(Frame{});
+  }
+
+  void onObjectFinish() {
+    _frames.pop_back();
+    if (_frames.empty()) {
+      finishMessage();
+    }
+  }
+
+  void onArrayStart(std::optional<std::uint32_t> memberId) {
+    auto tag = memberId.value_or(fix::InvalidTag);
+    if (_frames.empty()) {
+      fail("FIX messages must be encoded from a composite");
+    } else if (_frames.back().isGroup) {
+      fail("FIX repeating groups can not directly contain groups", tag);
+    } else if (tag == fix::InvalidTag) {
+      fail("FIX member names must be numeric tags");
+    }
+    if (_error) {
+      // Keeps onArrayFinish balanced, nothing more is written
+      _frames.push_back(Frame{true});
+      return;
+    }
+    writePrefix(tag);
+    _frames.push_back(Frame{true, _buffer.size()});
+    _buffer.skip(MaxGroupCountDigits);
+    _buffer.append(fix::SOH);
+  }
+
+  void onArrayValueEntry(const auto &) {
+    fail("FIX repeating group entries must be composites");
+  }
+
+  void onArrayFinish() {
+    auto frame = _frames.back();
+    _frames.pop_back();
+    if (_error) {
+      return;
+    }
+    auto digits = fix::digitCount(frame.count);
+    if (digits > MaxGroupCountDigits) {
+      return fail("FIX repeating group has too many entries",
+                  static_cast<std::uint32_t>(frame.count));
+    }
+    _buffer.addToSum(
+        fix::writeDigits(_buffer.at(frame.countOffset), frame.count, digits));
+    _buffer.compact(frame.countOffset + digits, MaxGroupCountDigits - digits);
+  }
+
+  void onObjectValueEntry(std::uint32_t memberId, const auto &value) {
+    if (_error) {
+      return;
+    }
+    if (memberId == fix::InvalidTag) {
+      return fail("FIX member names must be numeric tags");
+    }
+    writePrefix(memberId);
+    if (auto result = fix::appendValue<TimePointFormatter>(_buffer, value);
+        !result) {
+      _error = ParseError{result.error().message,
+                          std::format("{}", memberId)};
+      return;
+    }
+    _buffer.append(fix::SOH);
+  }
+
+  template <typename T>
+  void onObjectValueEntry(std::uint32_t memberId,
+                          const std::optional<T> &value) {
+    if (!value.has_value()) {
+      return; // Absent fields are omitted
+    }
+    onObjectValueEntry(memberId, value.value());
+  }
+
+  // The last encoded message, valid until the next message is started
+  std::expected<std::string_view, ParseError> getMessage() const {
+    if (_error) {
+      return std::unexpected(*_error);
+    }
+    if (!_frames.empty() || _message.empty()) {
+      return std::unexpected(ParseError{"FIX message encoding incomplete"});
+    }
+    return _message;
+  }
+
+private:
+  // Groups track the offset of their count digits and their entry count
+  struct Frame {
+    bool isGroup{false};
+    std::size_t countOffset{0};
+    std::size_t count{0};
+  };
+
+  struct TagPrefix {
+    std::array<char, 12> text;
+    std::uint8_t length{0};
+    std::uint32_t sum{0};
+  };
+
+  void fail(const char *message) {
+    if (!_error) {
+      _error = ParseError{message};
+    }
+  }
+
+  void fail(const char *message, std::uint32_t tag) {
+    if (!_error) {
+      _error = ParseError{message, std::format("{}", tag)};
+    }
+  }
+
+  static void renderPrefix(TagPrefix &prefix, std::uint32_t tag) {
+    auto end = std::to_chars(prefix.text.data(),
+                             prefix.text.data() + prefix.text.size(), tag)
+                   .ptr;
+    *end++ = '=';
+    prefix.length = static_cast<std::uint8_t>(end - prefix.text.data());
+    prefix.sum =
+        fix::FieldBuffer::byteSum({prefix.text.data(), prefix.length});
+  }
+
+  void writePrefix(std::uint32_t tag) {
+    if (tag > MaxCachedPrefixTag) {
+      TagPrefix prefix;
+      renderPrefix(prefix, tag);
+      _buffer.append({prefix.text.data(), prefix.length}, prefix.sum);
+      return;
+    }
+    if (tag >= _prefixes.size()) {
+      _prefixes.resize(tag + 1);
+    }
+    auto &prefix = _prefixes[tag];
+    if (prefix.length == 0) {
+      renderPrefix(prefix, tag);
+    }
+    _buffer.append({prefix.text.data(), prefix.length}, prefix.sum);
+  }
+
+  void beginMessage() {
+    _buffer.clear();
+    _error.reset();
+    _message = {};
+    _bodyStart = _template.beginString().size() + MaxBodyLengthDigits + 1;
+    _buffer.skip(_bodyStart);
+    _template.appendFields(_buffer);
+  }
+
+  void finishMessage() {
+    if (_error) {
+      return;
+    }
+    auto bodyLength = _buffer.size() - _bodyStart;
+    auto digits = fix::digitCount(bodyLength);
+    if (digits > MaxBodyLengthDigits) {
+      return fail("FIX message body too long",
+                  static_cast<std::uint32_t>(bodyLength));
+    }
+    auto beginString = _template.beginString();
+    auto messageStart = _bodyStart - 1 - digits - beginString.size();
+    char *header = _buffer.at(messageStart);
+    std::memcpy(header, beginString.data(), beginString.size());
+    auto lengthSum =
+        fix::writeDigits(header + beginString.size(), bodyLength, digits);
+    header[beginString.size() + digits] = fix::SOH;
+    _buffer.addToSum(_template.beginStringSum() + lengthSum +
+                     static_cast<unsigned char>(fix::SOH));
+
+    char trailer[] = "10=000\x01";
+    fix::writeDigits(trailer + 3, _buffer.sum() % 256, 3);
+    _buffer.append(std::string_view{trailer, sizeof(trailer) - 1}, 0);
+    _message = std::string_view{_buffer.data() + messageStart,
+                                _buffer.size() - messageStart};
+  }
+
+  const MessageTemplateT &_template;
+  fix::FieldBuffer _buffer;
+  std::vector<Frame> _frames;
+  std::vector<TagPrefix> _prefixes;
+  std::size_t _bodyStart{0};
+  std::string_view _message;
+  std::optional<ParseError> _error;
+};
+
+template <typename T, typename TimePointFormatter>
+std::expected<std::string_view, ParseError>
+encodeToFIX(const T &mopedObject,
+            FIXEmitterContext<TimePointFormatter> &context) {
+  auto handler =
+      getMOPEDHandlerForParser<T, FIXDecodingTraits<TimePointFormatter>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+  return context.getMessage();
+}
+
+} // namespace moped
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "moped/FIXDictionary.hpp"
+#include "moped/FIXTypes.hpp"
+#include "moped/concepts.hpp"
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace moped {
+
+template <typename T>
+concept IFIXEventDispatchC = requires(T t) {
+  { t.onMember(std::uint32_t{}) } -> std::same_as<Expected>;
+  { t.onObjectStart() } -> std::same_as<Expected>;
+  { t.onObjectFinish() } -> std::same_as<Expected>;
+  { t.onArrayStart() } -> std::same_as<Expected>;
+  { t.onArrayFinish() } -> std::same_as<Expected>;
+  { t.onArraySizeHint(std::size_t{}) } -> std::same_as<Expected>;
+  { t.onStringValue(std::string_view{}) } -> std::same_as<Expected>;
+};
+
+// Parses one tag=value FIX message into parse events with integer member
+// ids. A single pass over the message body finds the field delimiters and
+// sums the checksum, 16 bytes at a time where SSE2 is available. Tags are
+// resolved through the dictionary's per scope tag tables, tags the mapping
+// doesn't know are skipped. A NoXXX count tag opens an array of group
+// entries, each started by the group's delimiter tag and the group ends on
+// the first tag belonging to an enclosing scope.
+template <IFIXEventDispatchC ParseEventDispatchT> class FIXParser {
+  struct OpenGroup {
+    std::int32_t scope;
+    std::size_t count;
+    std::size_t entries{0};
+  };
+
+  // Each group entry holds at least its delimiter field, e.g. "1=" and SOH
+  static constexpr std::size_t MinimalGroupEntryLength = 3;
+
+  static std::expected<std::size_t, ParseError>
+  parseCount(std::string_view text, const char *error) {
+    std::size_t count = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                     count);
+    if (text.empty() || ec != std::errc{} || end != text.data() + text.size()) {
+      return std::unexpected(ParseError{error, text});
+    }
+    return count;
+  }
+
+  std::int32_t currentScope() const {
+    return _groups.empty() ? 0 : _groups.back().scope;
+  }
+
+  Expected closeGroup() {
+    auto &group = _groups.back();
+    if (group.entries != group.count) {
+      return std::unexpected(
+          ParseError{"FIX repeating group entry count differs from its count "
+                     "tag",
+                     std::format("{}", _dictionary.scope(group.scope)
+                                           .delimiterTag)});
+    }
+    if (group.entries > 0) {
+      if (auto result = _eventDispatch.onObjectFinish(); !result) {
+        return result;
+      }
+    }
+    _groups.pop_back();
+    return _eventDispatch.onArrayFinish();
+  }
+
+  // 'remainingLength' is the number of body bytes following the field
+  Expected dispatchField(std::string_view field, std::size_t remainingLength) {
+    auto separator = field.find('=');
+    if (separator == std::string_view::npos) {
+      return std::unexpected(
+          ParseError{"FIX field is not in tag=value form", field});
+    }
+    std::uint32_t tag = 0;
+    auto [end, ec] = std::from_chars(field.data(), field.data() + separator,
+                                     tag);
+    if (ec != std::errc{} || end != field.data() + separator) {
+      return std::unexpected(
+          ParseError{"FIX field is not in tag=value form", field});
+    }
+    auto value = field.substr(separator + 1);
+
+    auto kind = _dictionary.scope(currentScope()).lookup(tag);
+    while (kind == fix::Scope::NotInScope && !_groups.empty()) {
+      auto enclosingScope = _dictionary.findEnclosingScope(currentScope(), tag);
+      if (enclosingScope == fix::Scope::NotInScope) {
+        return {}; // Unmapped anywhere, stays within the group
+      }
+      while (currentScope() != enclosingScope) {
+        if (auto result = closeGroup(); !result) {
+          return result;
+        }
+      }
+      kind = _dictionary.scope(currentScope()).lookup(tag);
+    }
+    if (kind == fix::Scope::NotInScope) {
+      return {};
+    }
+
+    if (!_groups.empty()) {
+      auto &group = _groups.back();
+      if (tag == _dictionary.scope(group.scope).delimiterTag) {
+        if (group.entries == group.count) {
+          return std::unexpected(ParseError{
+              "FIX repeating group has more entries than its count tag",
+              std::format("{}", tag)});
+        }
+        if (group.entries++ > 0) {
+          if (auto result = _eventDispatch.onObjectFinish(); !result) {
+            return result;
+          }
+        }
+        if (auto result = _eventDispatch.onObjectStart(); !result) {
+          return result;
+        }
+      } else if (group.entries == 0) {
+        return std::unexpected(ParseError{
+            "FIX repeating group entry doesn't start with its delimiter tag",
+            std::format("{}", tag)});
+      }
+    }
+
+    if (auto result = _eventDispatch.onMember(tag); !result) {
+      return result;
+    }
+    if (kind == fix::Scope::Field) {
+      return _eventDispatch.onStringValue(value);
+    }
+
+    auto count = parseCount(value, "Invalid FIX repeating group count");
+    if (!count) {
+      return std::unexpected(count.error());
+    }
+    if (*count > remainingLength / MinimalGroupEntryLength) {
+      return std::unexpected(ParseError{
+          "FIX repeating group count exceeds the rest of the message", value});
+    }
+    if (auto result = _eventDispatch.onArraySizeHint(*count); !result) {
+      return result;
+    }
+    if (auto result = _eventDispatch.onArrayStart(); !result) {
+      return result;
+    }
+    _groups.push_back(OpenGroup{kind, *count});
+    return *count == 0 ? closeGroup() : Expected{};
+  }
+
+  // Dispatches each delimited field of [0, bodyEnd) and returns the byte sum
+  // of the range
+  std::expected<std::uint32_t, ParseError>
+  dispatchBody(std::string_view message, std::size_t bodyEnd) {
+    std::uint32_t sum = 0;
+    std::size_t fieldStart = 0;
+    std::size_t position = 0;
+    auto onDelimiter = [&](std::size_t delimiter) {
+      auto field = message.substr(fieldStart, delimiter - fieldStart);
+      fieldStart = delimiter + 1;
+      return dispatchField(field, bodyEnd - fieldStart);
+    };
+
+#if defined(__SSE2__)
+    const __m128i delimiters = _mm_set1_epi8(fix::SOH);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (; position + 16 <= bodyEnd; position += 16) {
+      auto chunk = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(message.data() + position));
+      sums = _mm_add_epi64(sums, _mm_sad_epu8(chunk, zero));
+      auto mask = static_cast<std::uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, delimiters)));
+      while (mask != 0) {
+        if (auto result = onDelimiter(position + std::countr_zero(mask));
+            !result) {
+          return std::unexpected(result.error());
+        }
+        mask &= mask - 1;
+      }
+    }
+    sum += static_cast<std::uint32_t>(_mm_cvtsi128_si32(sums)) +
+           static_cast<std::uint32_t>(
+               _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+#endif
+
+    for (; position < bodyEnd; ++position) {
+      sum += static_cast<std::uint8_t>(message[position]);
+      if (message[position] == fix::SOH) {
+        if (auto result = onDelimiter(position); !result) {
+          return std::unexpected(result.error());
+        }
+      }
+    }
+    return sum;
+  }
+
+public:
+  FIXParser(ParseEventDispatchT &eventDispatch,
+            const fix::Dictionary &dictionary)
+      : _eventDispatch(eventDispatch), _dictionary(dictionary) {}
+
+  // Parses the message at the start of 'message' and returns its length,
+  // further messages may follow it
+  std::expected<std::size_t, ParseError> parse(std::string_view message) {
+    _groups.clear();
+    if (!message.starts_with("8=")) {
+      return std::unexpected("FIX message doesn't start with BeginString");
+    }
+    auto beginStringEnd = message.find(fix::SOH);
+    if (beginStringEnd == std::string_view::npos ||
+        message.substr(beginStringEnd + 1, 2) != "9=") {
+      return std::unexpected("FIX BodyLength must follow BeginString");
+    }
+    auto bodyLengthStart = beginStringEnd + 3;
+    auto bodyStart = message.find(fix::SOH, bodyLengthStart);
+    if (bodyStart == std::string_view::npos) {
+      return std::unexpected("FIX BodyLength field is not terminated");
+    }
+    auto bodyLength =
+        parseCount(message.substr(bodyLengthStart, bodyStart - bodyLengthStart),
+                   "Invalid FIX BodyLength");
+    if (!bodyLength) {
+      return std::unexpected(bodyLength.error());
+    }
+    ++bodyStart;
+
+    // The trailer is "10=ddd" and its delimiter
+    constexpr std::size_t TrailerLength = 7;
+    auto bodyEnd = bodyStart + *bodyLength;
+    if (bodyEnd + TrailerLength > message.size()) {
+      return std::unexpected(ParseError{
+          "FIX message shorter than its BodyLength",
+          std::format("{}", *bodyLength)});
+    }
+    auto trailer = message.substr(bodyEnd, TrailerLength);
+    if (*bodyLength == 0 || message[bodyEnd - 1] != fix::SOH ||
+        !trailer.starts_with("10=") || trailer.back() != fix::SOH) {
+      return std::unexpected(ParseError{
+          "FIX BodyLength doesn't end on the CheckSum field",
+          std::format("{}", *bodyLength)});
+    }
+    auto checkSum = parseCount(trailer.substr(3, 3), "Invalid FIX CheckSum");
+    if (!checkSum) {
+      return std::unexpected(checkSum.error());
+    }
+
+    if (auto result = _eventDispatch.onObjectStart(); !result) {
+      return std::unexpected(result.error());
+    }
+    auto sum = dispatchBody(message, bodyEnd);
+    if (!sum) {
+      return std::unexpected(sum.error());
+    }
+    if (*sum % 256 != *checkSum) {
+      return std::unexpected(ParseError{
+          "FIX CheckSum mismatch, computed",
+          std::format("{:03}", *sum % 256)});
+    }
+    if (auto result =
+            dispatchField(trailer.substr(0, TrailerLength - 1), 0);
+        !result) {
+      return std::unexpected(result.error());
+    }
+    while (!_groups.empty()) {
+      if (auto result = closeGroup(); !result) {
+        return std::unexpected(result.error());
+      }
+    }
+    if (auto result = _eventDispatch.onObjectFinish(); !result) {
+      return std::unexpected(result.error());
+    }
+    return bodyEnd + TrailerLength;
+  }
+
+  auto &getDispatcher() { return _eventDispatch; }
+
+private:
+  ParseEventDispatchT &_eventDispatch;
+  const fix::Dictionary &_dictionary;
+  std::vector<OpenGroup> _groups;
+};
+
+} // namespace moped
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace moped {
+
+namespace fix {
+constexpr char SOH = '\x01';
+
+// Standard header and trailer tags validated by the parser
+constexpr std::uint32_t BeginStringTag = 8;
+constexpr std::uint32_t BodyLengthTag = 9;
+constexpr std::uint32_t CheckSumTag = 10;
+constexpr std::uint32_t MsgTypeTag = 35;
+
+// Member id of mapping names that aren't tag numbers, it never matches a
+// parsed tag
+constexpr std::uint32_t InvalidTag = std::numeric_limits<std::uint32_t>::max();
+} // namespace fix
+
+// Decoding traits for FIX, members are mapped by tag number written as the
+// member name, e.g. "55" for Symbol, and identified by the integer tag so
+// parsed fields are matched without string comparisons.
+template <typename TimePointFormatter = UTCTimestampFormatter<>,
+          typename PivotValueType = std::string_view>
+struct FIXDecodingTraits {
+  using MemberIdType = std::uint32_t;
+  using PivotValueT = PivotValueType;
+  static MemberIdType getMemberId(std::string_view name) {
+    if (name.empty()) {
+      return EmbeddingMemberId;
+    }
+    MemberIdType tag = 0;
+    auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), tag);
+    if (ec != std::errc{} || end != name.data() + name.size() || tag == 0) {
+      return fix::InvalidTag;
+    }
+    return tag;
+  }
+  static std::string getDisplayName(MemberIdType memberId) {
+    return std::to_string(memberId);
+  }
+  static constexpr MemberIdType EmbeddingMemberId = 0;
+  // FIX char fields such as Side are single characters
+  static constexpr bool CharTextValues = true;
+  using TimePointFormaterT = TimePointFormatter;
+};
+
+static_assert(DecodingTraitsC<FIXDecodingTraits<>>,
+              "FIXDecodingTraits should satisfy DecodingTraitsC concept");
+static_assert(UsesCharTextValuesC<FIXDecodingTraits<>>,
+              "FIXDecodingTraits should carry char members as text");
+
+} // namespace moped
@@ -0,0 +1,488 @@
+#pragma once
+
+#include "concepts.hpp"
+#include "moped/ParserBase.hpp"
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace moped {
+
+// Parses the boost property_tree INFO format straight from the input buffer
+// into moped events, without building a tree. Keys and values are
+// dispatched as views into the input, quoted strings are unescaped into a
+// reused buffer only when they hold escapes or "\" continuations.
+//
+// A block whose entries have keys is an object, one whose entries all have
+// the empty key "" is an array. An entry with a block takes the block as its
+// value and its own data is ignored, an entry without data is null.
+// Unquoted data resolves to booleans, null or numbers, quoted data is always
+// a string. #include directives are parsed in place, relative paths resolve
+// against the include directory, or the working directory as boost's
+// read_info does. Errors, including those of the dispatcher, carry the line
+// and file they were raised on.
+template <IParserEventDispatchC ParseEventDispatchT>
+class InfoParser : public ParserBase {
+public:
+  static constexpr std::size_t MaxIncludeDepth = 32;
+
+  InfoParser(ParseEventDispatchT &eventDispatch)
+      : _eventDispatch(eventDispatch) {}
+
+  Expected parse(std::string_view info) {
+    reset();
+    if (auto result = parseSource(info, 0); !result) {
+      return result;
+    }
+    return finish();
+  }
+
+  Expected parseFile(const std::filesystem::path &path) {
+    reset();
+    if (auto result = parseFileSource(path, 0); !result) {
+      return result;
+    }
+    return finish();
+  }
+
+  // Directory relative #include paths resolve against
+  void setIncludeDirectory(std::filesystem::path directory) {
+    _includeDirectory = std::move(directory);
+  }
+
+  auto &getDispatcher() { return _eventDispatch; }
+
+private:
+  // A block's kind is decided by its first entry
+  struct Frame {
+    bool decided;
+    bool array;
+  };
+
+  struct Token {
+    std::string_view text;
+    bool quoted;
+  };
+
+  using ExpectedToken = std::expected<Token, ParseError>;
+
+  // The last key read, held until the next token shows whether a block
+  // follows it
+  struct Entry {
+    std::string_view key;
+    std::string_view value;
+    bool hasValue;
+    bool quoted;
+    std::size_t line;
+  };
+
+  void reset() {
+    _frames.assign(1, Frame{false, false});
+    _pending = false;
+    _sourceName = {};
+    _line = 1;
+  }
+
+  static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+  static bool isWordEnd(char c) {
+    return isSpace(c) || c == '\n' || c == ';' || c == '{' || c == '}';
+  }
+
+  ParseError located(const ParseError &error, std::size_t line) const {
+    auto where = _sourceName.empty()
+                     ? std::format("line {}", line)
+                     : std::format("{} line {}", _sourceName, line);
+    return std::visit(
+        [&](const auto &reference) -> ParseError {
+          using T = std::decay_t<decltype(reference)>;
+          if constexpr (std::is_same_v<T, std::monostate>) {
+            return ParseError{error.message, where};
+          } else {
+            return ParseError{error.message,
+                              std::format("{} at {}", reference, where)};
+          }
+        },
+        error.referenceValue);
+  }
+
+  Expected check(Expected result, std::size_t line) const {
+    if (!result) {
+      return std::unexpected(located(result.error(), line));
+    }
+    return {};
+  }
+
+  Expected error(const char *message) const {
+    return std::unexpected(located(ParseError{message}, _line));
+  }
+
+  Expected parseSource(std::string_view text, std::size_t depth) {
+    std::size_t position = 0;
+    while (true) {
+      while (position < text.size() && isSpace(text[position])) {
+        ++position;
+      }
+      if (position == text.size()) {
+        break;
+      }
+      switch (text[position]) {
+      case '\n':
+        ++_line;
+        ++position;
+        continue;
+      case ';':
+        position = text.find('\n', position);
+        if (position == std::string_view::npos) {
+          position = text.size();
+        }
+        continue;
+      case '{':
+        if (auto result = openBlock(); !result) {
+          return result;
+        }
+        ++position;
+        continue;
+      case '}':
+        if (auto result = closeBlock(); !result) {
+          return result;
+        }
+        ++position;
+        continue;
+      case '#':
+        if (text.substr(position).starts_with("#include") &&
+            (position + 8 == text.size() || isSpace(text[position + 8]) ||
+             text[position + 8] == '"')) {
+          position += 8;
+          if (auto result = include(text, position, depth); !result) {
+            return result;
+          }
+          continue;
+        }
+        break;
+      default:
+        break;
+      }
+      if (auto result = readEntry(text, position); !result) {
+        return result;
+      }
+    }
+    // Views into this source end with it
+    return flushEntry();
+  }
+
+  // Reads a key and the data following it on its line
+  Expected readEntry(std::string_view text, std::size_t &position) {
+    if (auto result = flushEntry(); !result) {
+      return result;
+    }
+    _entry.line = _line;
+    auto key = readToken(text, position, _keyScratch);
+    if (!key) {
+      return std::unexpected(key.error());
+    }
+    _entry.key = key->text;
+    _entry.hasValue = false;
+    while (position < text.size() && isSpace(text[position])) {
+      ++position;
+    }
+    if (position < text.size() && !isWordEnd(text[position])) {
+      auto value = readValue(text, position);
+      if (!value) {
+        return std::unexpected(value.error());
+      }
+      _entry.value = value->text;
+      _entry.quoted = value->quoted;
+      _entry.hasValue = true;
+    }
+    _pending = true;
+    return {};
+  }
+
+  // A quoted string or a word, 'position' is left after it
+  ExpectedToken readToken(std::string_view text, std::size_t &position,
+                          std::string &scratch) {
+    if (text[position] != '"') {
+      auto start = position;
+      while (position < text.size() && !isWordEnd(text[position])) {
+        ++position;
+      }
+      return Token{text.substr(start, position - start), false};
+    }
+    auto start = ++position;
+    bool escaped = false;
+    while (position < text.size() && text[position] != '"' &&
+           text[position] != '\n') {
+      if (text[position] == '\\' && position + 1 < text.size() &&
+          text[position + 1] != '\n') {
+        escaped = true;
+        ++position;
+      }
+      ++position;
+    }
+    if (position >= text.size() || text[position] != '"') {
+      return std::unexpected(
+          located(ParseError{"Unterminated INFO string"}, _line));
+    }
+    auto body = text.substr(start, position - start);
+    ++position;
+    if (!escaped) {
+      return Token{body, true};
+    }
+    scratch.clear();
+    if (auto result = appendUnescaped(body, scratch); !result) {
+      return std::unexpected(result.error());
+    }
+    return Token{scratch, true};
+  }
+
+  // Data, joining quoted strings continued with a trailing "\"
+  ExpectedToken readValue(std::string_view text, std::size_t &position) {
+    auto value = readToken(text, position, _valueScratch);
+    if (!value || !value->quoted) {
+      return value;
+    }
+    while (true) {
+      auto next = position;
+      while (next < text.size() && isSpace(text[next])) {
+        ++next;
+      }
+      if (next == text.size() || text[next] != '\\') {
+        return value;
+      }
+      ++next;
+      while (next < text.size() && isSpace(text[next])) {
+        ++next;
+      }
+      if (next == text.size() || text[next] != '\n') {
+        return std::unexpected(located(
+            ParseError{"INFO line continuation must end its line"}, _line));
+      }
+      ++_line;
+      ++next;
+      while (next < text.size() && isSpace(text[next])) {
+        ++next;
+      }
+      if (next == text.size() || text[next] != '"') {
+        return std::unexpected(located(
+            ParseError{"INFO line continuation must be a string"}, _line));
+      }
+      if (value->text.data() != _valueScratch.data()) {
+        _valueScratch.assign(value->text);
+      }
+      auto part = readToken(text, next, _continuationScratch);
+      if (!part) {
+        return part;
+      }
+      _valueScratch += part->text;
+      value->text = _valueScratch;
+      position = next;
+    }
+  }
+
+  Expected appendUnescaped(std::string_view body, std::string &scratch) {
+    for (std::size_t position = 0; position < body.size(); ++position) {
+      auto c = body[position];
+      if (c != '\\') {
+        scratch += c;
+        continue;
+      }
+      switch (body[++position]) {
+      case '0':
+        scratch += '\0';
+        break;
+      case 'a':
+        scratch += '\a';
+        break;
+      case 'b':
+        scratch += '\b';
+        break;
+      case 'f':
+        scratch += '\f';
+        break;
+      case 'n':
+        scratch += '\n';
+        break;
+      case 'r':
+        scratch += '\r';
+        break;
+      case 't':
+        scratch += '\t';
+        break;
+      case 'v':
+        scratch += '\v';
+        break;
+      case '"':
+      case '\'':
+      case '\\':
+        scratch += body[position];
+        break;
+      default:
+        return error("Invalid INFO escape sequence");
+      }
+    }
+    return {};
+  }
+
+  // Starts the enclosing block on its first entry and announces the key
+  Expected beginEntry(std::string_view key, std::size_t line) {
+    auto &frame = _frames.back();
+    bool unkeyed = key.empty();
+    if (!frame.decided) {
+      frame.decided = true;
+      frame.array = unkeyed;
+      if (auto result = unkeyed ? _eventDispatch.onArrayStart()
+                                : _eventDispatch.onObjectStart();
+          !result) {
+        return check(result, line);
+      }
+    } else if (frame.array != unkeyed) {
+      return std::unexpected(located(
+          ParseError{"INFO block mixes keyed and unkeyed entries", key},
+          line));
+    }
+    if (unkeyed) {
+      return {};
+    }
+    return check(_eventDispatch.onMember(key), line);
+  }
+
+  // Dispatches the pending entry as a key and its data
+  Expected flushEntry() {
+    if (!_pending) {
+      return {};
+    }
+    _pending = false;
+    if (auto result = beginEntry(_entry.key, _entry.line); !result) {
+      return result;
+    }
+    if (!_entry.hasValue) {
+      return check(_eventDispatch.onNullValue(), _entry.line);
+    }
+    if (_entry.quoted) {
+      return check(_eventDispatch.onStringValue(_entry.value), _entry.line);
+    }
+    return check(dispatchWord(_entry.value), _entry.line);
+  }
+
+  Expected dispatchWord(std::string_view word) {
+    if (word == "true" || word == "false") {
+      return _eventDispatch.onBooleanValue(word == "true");
+    }
+    if (word == "null") {
+      return _eventDispatch.onNullValue();
+    }
+    if (isNumericText(word)) {
+      return _eventDispatch.onNumericValue(word);
+    }
+    return _eventDispatch.onStringValue(word);
+  }
+
+  Expected openBlock() {
+    if (!_pending) {
+      return error("INFO block without a key");
+    }
+    _pending = false;
+    if (auto result = beginEntry(_entry.key, _entry.line); !result) {
+      return result;
+    }
+    _frames.push_back(Frame{false, false});
+    return {};
+  }
+
+  // Blocks without entries are empty objects
+  Expected closeFrame() {
+    auto frame = _frames.back();
+    _frames.pop_back();
+    if (!frame.decided) {
+      if (auto result = _eventDispatch.onObjectStart(); !result) {
+        return check(result, _line);
+      }
+    }
+    return check(frame.array ? _eventDispatch.onArrayFinish()
+                             : _eventDispatch.onObjectFinish(),
+                 _line);
+  }
+
+  Expected closeBlock() {
+    if (auto result = flushEntry(); !result) {
+      return result;
+    }
+    if (_frames.size() == 1) {
+      return error("Unbalanced '}' in INFO input");
+    }
+    return closeFrame();
+  }
+
+  Expected finish() {
+    if (_frames.size() > 1) {
+      return error("Unterminated INFO block");
+    }
+    return closeFrame();
+  }
+
+  Expected include(std::string_view text, std::size_t &position,
+                   std::size_t depth) {
+    if (auto result = flushEntry(); !result) {
+      return result;
+    }
+    while (position < text.size() && isSpace(text[position])) {
+      ++position;
+    }
+    if (position == text.size() || isWordEnd(text[position])) {
+      return error("INFO #include without a file name");
+    }
+    auto name = readToken(text, position, _keyScratch);
+    if (!name) {
+      return std::unexpected(name.error());
+    }
+    std::filesystem::path path{name->text};
+    if (path.is_relative() && !_includeDirectory.empty()) {
+      path = _includeDirectory / path;
+    }
+    return parseFileSource(path, depth + 1);
+  }
+
+  Expected parseFileSource(const std::filesystem::path &path,
+                           std::size_t depth) {
+    if (depth > MaxIncludeDepth) {
+      return error("INFO includes nested too deeply");
+    }
+    auto pathText = path.string();
+    std::ifstream input{path, std::ios::binary};
+    if (!input) {
+      return std::unexpected(
+          located(ParseError{"Unable to open INFO file", pathText}, _line));
+    }
+    std::string content{std::istreambuf_iterator<char>{input}, {}};
+    auto sourceName = _sourceName;
+    auto line = _line;
+    _sourceName = pathText;
+    _line = 1;
+    auto result = parseSource(content, depth);
+    _sourceName = sourceName;
+    _line = line;
+    return result;
+  }
+
+  ParseEventDispatchT &_eventDispatch;
+  std::vector<Frame> _frames;
+  Entry _entry{};
+  bool _pending{false};
+  // Name of the file being read, empty for the input view
+  std::string_view _sourceName;
+  std::size_t _line{1};
+  std::filesystem::path _includeDirectory;
+  std::string _keyScratch;
+  std::string _valueScratch;
+  std::string _continuationScratch;
+};
+
+} // namespace moped
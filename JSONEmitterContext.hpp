@@ -5,6 +5,7 @@
 #include "moped/TimeFormatters.hpp"
 #include "moped/concepts.hpp"
 #include "moped/moped.hpp"
+#include <array>
 #include <chrono>
 #include <concepts>
 #include <cstdint>
@@ -13,11 +14,92 @@
 #include <optional>
 #include <ostream>
 #include <stack>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
 namespace moped {
 
+// Length of 'text' once escaped for a JSON string
+constexpr std::size_t escapedJSONSize(std::string_view text) {
+  std::size_t size = 0;
+  for (char c : text) {
+    switch (c) {
+    case '"':
+    case '\\':
+    case '\b':
+    case '\f':
+    case '\n':
+    case '\r':
+    case '\t':
+      size += 2;
+      break;
+    default:
+      size += static_cast<unsigned char>(c) < 0x20 ? 6 : 1;
+    }
+  }
+  return size;
+}
+
+// Writes 'text' escaped for a JSON string at 'target', which has room for
+// escapedJSONSize(text) characters, and returns the end of what was written
+constexpr char *writeEscapedJSON(char *target, std::string_view text) {
+  constexpr char hexDigits[] = "0123456789abcdef";
+  for (char c : text) {
+    char escape = 0;
+    switch (c) {
+    case '"':
+      escape = '"';
+      break;
+    case '\\':
+      escape = '\\';
+      break;
+    case '\b':
+      escape = 'b';
+      break;
+    case '\f':
+      escape = 'f';
+      break;
+    case '\n':
+      escape = 'n';
+      break;
+    case '\r':
+      escape = 'r';
+      break;
+    case '\t':
+      escape = 't';
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        for (char digit : {'\\', 'u', '0', '0', hexDigits[c >> 4],
+                           hexDigits[c & 0xf]}) {
+          *target++ = digit;
+        }
+        continue;
+      }
+      *target++ = c;
+      continue;
+    }
+    *target++ = '\\';
+    *target++ = escape;
+  }
+  return target;
+}
+
+// Mapped enum strings are template arguments, so their quoted JSON form is
+// escaped at compile time and written with a single copy
+template <const char *Text> constexpr auto quotedJSONText() {
+  constexpr std::string_view text{Text};
+  std::array<char, escapedJSONSize(text) + 2> quoted{};
+  quoted.front() = '"';
+  writeEscapedJSON(quoted.data() + 1, text);
+  quoted.back() = '"';
+  return quoted;
+}
+
+template <const char *Text>
+inline constexpr auto QuotedJSONText = quotedJSONText<Text>();
+
 template <typename TimePointFormatter = DurationSinceEpochFormatter<>>
 class JSONEmitterContext {
 public:
@@ -37,7 +119,7 @@ public:
       _output << ",";
     }
     if (memberId && !memberId->empty()) {
-      _output << "\"" << *memberId << "\": ";
+      writeMemberName(*memberId);
     }
     if (_positionNested.size() > 0) {
       _output << "{";
@@ -46,6 +128,9 @@ public:
   }
 
   void onObjectFinish() {
+    if ((_positionNested.size() == 1) && (_positionNested.top() == 0)) {
+      _output << "{"; // Root object without entries
+    }
     _positionNested.pop();
     if (_positionNested.empty() && (_publishingRootArray || _publishingRootMap)) {
       _publishingRootArray = false;
@@ -73,7 +158,7 @@ public:
       _output << ",";
     }
     if (memberId) {
-      _output << "\"" << *memberId << "\": ";
+      writeMemberName(*memberId);
     }
     _output << "[";
     _positionNested.push(0);
@@ -96,17 +181,37 @@ public:
   }
 
   void onObjectValueEntry(const std::string_view memberId, const auto &value) {
-    if ((_positionNested.size() == 1) && (_positionNested.top() == 0)) {
-      _output << "{";
-    }
-    if (_positionNested.top() > 0) {
-      _output << ",";
+    beginObjectEntry();
+    writeMemberName(memberId);
+    writeJSONEncodedValue(value);
+  }
+
+  // Names of mapped members are fixed by their handler, so each member's
+  // "name": fragment is rendered on first use and copied from then on. A
+  // different mapping of the same handler type is caught by the name's
+  // address and written as any other name.
+  template <typename HandlerT, std::size_t MemberIndex>
+  void onObjectValueEntry(MemberSlot<HandlerT, MemberIndex>,
+                          const std::string_view memberId, const auto &value) {
+    static const RenderedMemberName rendered{memberId,
+                                             renderMemberName(memberId)};
+    beginObjectEntry();
+    if (memberId.data() == rendered.memberId.data() &&
+        memberId.size() == rendered.memberId.size()) [[likely]] {
+      _output.write(rendered.fragment.data(), rendered.fragment.size());
+    } else {
+      writeMemberName(memberId);
     }
-    _positionNested.top()++;
-    _output << "\"" << memberId << "\": ";
     writeJSONEncodedValue(value);
   }
 
+  // Written by delta encoding for members cleared since the baseline
+  void onObjectNullEntry(const std::string_view memberId) {
+    beginObjectEntry();
+    writeMemberName(memberId);
+    _output << "null";
+  }
+
   template <typename T>
   void onObjectValueEntry(const std::string_view memberId,
                           const std::optional<T> &value) {
@@ -121,6 +226,68 @@ public:
   // Implementation for a JSON member
 
 private:
+  struct RenderedMemberName {
+    std::string_view memberId;
+    std::string fragment;
+  };
+
+  static std::string renderMemberName(std::string_view memberId) {
+    std::string fragment(escapedJSONSize(memberId) + 4, '"');
+    auto end = writeEscapedJSON(fragment.data() + 1, memberId);
+    std::copy_n("\": ", 3, end);
+    return fragment;
+  }
+
+  void beginObjectEntry() {
+    if ((_positionNested.size() == 1) && (_positionNested.top() == 0)) {
+      _output << "{";
+    }
+    if (_positionNested.top() > 0) {
+      _output << ",";
+    }
+    _positionNested.top()++;
+  }
+
+  void writeMemberName(std::string_view memberId) {
+    if (escapedJSONSize(memberId) != memberId.size()) {
+      auto fragment = renderMemberName(memberId);
+      _output.write(fragment.data(), fragment.size());
+      return;
+    }
+    _output.put('"');
+    _output.write(memberId.data(), memberId.size());
+    _output.write("\": ", 3);
+  }
+
+  // Text needing no escapes, the common case, is written straight through
+  void writeJSONString(std::string_view text) {
+    _output.put('"');
+    if (auto size = escapedJSONSize(text); size == text.size()) {
+      _output.write(text.data(), text.size());
+    } else {
+      std::string escaped(size, '\0');
+      writeEscapedJSON(escaped.data(), text);
+      _output.write(escaped.data(), escaped.size());
+    }
+    _output.put('"');
+  }
+
+  template <is_mapped_enum T> void writeJSONEncodedValue(const T &value) {
+    bool written = false;
+    T::forEachMappedValue(
+        [this, &written, enumValue = value.getEnumValue()](auto entry) {
+          using EntryT = decltype(entry);
+          if (!written && EntryT::value == enumValue) {
+            constexpr auto &quoted = QuotedJSONText<EntryT::stringValue>;
+            _output.write(quoted.data(), quoted.size());
+            written = true;
+          }
+        });
+    if (!written) {
+      throw std::invalid_argument("Invalid enum value");
+    }
+  }
+
   void writeJSONEncodedValue(moped::TimePoint value) {
     _output << "\"" << TimePointFormatter::format(value) << "\"";
   }
@@ -130,42 +297,6 @@ private:
     _output << value.toString();
   }
 
-  std::string escapeJSONString(std::string_view input) {
-    std::string escaped;
-    for (char c : input) {
-      switch (c) {
-      case '\"':
-        escaped += "\\\"";
-        break;
-      case '\\':
-        escaped += "\\\\";
-        break;
-      case '\b':
-        escaped += "\\b";
-        break;
-      case '\f':
-        escaped += "\\f";
-        break;
-      case '\n':
-        escaped += "\\n";
-        break;
-      case '\r':
-        escaped += "\\r";
-        break;
-      case '\t':
-        escaped += "\\t";
-        break;
-      default:
-        if (static_cast<unsigned char>(c) < 0x20) {
-          escaped += "\\u" + std::to_string(static_cast<int>(c));
-        } else {
-          escaped += c;
-        }
-      }
-    }
-    return escaped;
-  }
-
   template <typename T> void writeJSONEncodedValue(const T &value) {
     if constexpr (std::is_same_v<T, bool>) {
       _output << (value ? "true" : "false");
@@ -173,7 +304,7 @@ private:
       _output << value;
     } else {
       if constexpr (std::convertible_to<T, std::string_view>) {
-        _output << "\"" << escapeJSONString(value) << "\"";
+        writeJSONString(value);
       } else {
         _output << "\"" << value << "\"";
       }
@@ -203,4 +334,31 @@ std::string encodeToJSONString(const T &mopedObject, FormatArgs... args) {
   return oss.str();
 }
 
+// Writes only what changed in 'mopedObject' since 'baseline', in the form
+// mergeCompositeFromJSONView applies back onto the baseline. Fails, with
+// partial output written, for changes the members' merge policies can't
+// reproduce.
+template <typename T, typename... FormatArgs>
+Expected encodeDeltaToJSONStream(const T &mopedObject, const T &baseline,
+                                 std::ostream &output, FormatArgs...) {
+  JSONEmitterContext<FormatArgs...> context(output);
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<FormatArgs...>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  return handler.applyDeltaEmitterContext(context, baseline);
+}
+
+template <typename T, typename... FormatArgs>
+std::expected<std::string, ParseError>
+encodeDeltaToJSONString(const T &mopedObject, const T &baseline,
+                        FormatArgs... args) {
+  std::ostringstream oss;
+  auto result = encodeDeltaToJSONStream(mopedObject, baseline, oss,
+                                        std::forward<FormatArgs>(args)...);
+  if (!result) {
+    return std::unexpected(result.error().memorySafe());
+  }
+  return oss.str();
+}
+
 } // namespace moped
\ No newline at end of file
@@ -10,7 +10,12 @@
 
 namespace moped {
 
-template <IParserEventDispatchC ParseEventDispatchT>
+// PrescanArraySizes enables a look-ahead over each array's text to count its
+// elements so dispatchers supporting onArraySizeHint can reserve storage once.
+// The scan revisits nested array text, so it pays off for wide arrays rather
+// than deeply nested ones.
+template <IParserEventDispatchC ParseEventDispatchT,
+          bool PrescanArraySizes = false>
 class JSONViewParser : public ParserBase {
   using Iterator = std::string_view::const_iterator;
   using ExpectedText = std::expected<std::string_view, ParseError>;
@@ -71,6 +76,51 @@ class JSONViewParser : public ParserBase {
     return val;
   }
 
+  // Count the top level elements of the array whose opening bracket
+  // immediately precedes it, stops at the matching close bracket.
+  static std::size_t countArrayElements(Iterator it, Iterator end) {
+    std::size_t depth = 0;
+    std::size_t count = 0;
+    bool hasElement = false;
+    for (; it != end; ++it) {
+      switch (*it) {
+      case '"':
+        for (++it; it != end && *it != '"'; ++it) {
+          if (*it == '\\' && ++it == end) {
+            return count;
+          }
+        }
+        if (it == end) {
+          return count;
+        }
+        hasElement = true;
+        break;
+      case '[':
+      case '{':
+        ++depth;
+        hasElement = true;
+        break;
+      case ']':
+      case '}':
+        if (depth == 0) {
+          return hasElement ? count + 1 : count;
+        }
+        --depth;
+        break;
+      case ',':
+        if (depth == 0) {
+          ++count;
+        }
+        break;
+      default:
+        if (!std::isspace(static_cast<unsigned char>(*it))) {
+          hasElement = true;
+        }
+      }
+    }
+    return count;
+  }
+
 public:
   JSONViewParser(ParseEventDispatchT &eventDispatch)
       : _eventDispatch(eventDispatch) {}
@@ -87,6 +137,8 @@ public:
     skipWhitespace(it, end);
 
     bool usingRootArray = false;
+    // Only a member name directly after '{' may instead close the object
+    bool objectOpened = true;
     if (*it == '[') {
       usingRootArray = true;
       // Root array documents require specialize moped mappings
@@ -133,9 +185,16 @@ public:
 
         vs.push(*it++);
         parseState = ParseState::MemberName;
+        objectOpened = true;
         break;
       }
       case ParseState::MemberName: {
+        if (objectOpened && it != end && *it == '}') {
+          objectOpened = false;
+          parseState = ParseState::CloseValue;
+          break;
+        }
+        objectOpened = false;
         auto expectedText = getMemberText(it, end);
         if (!expectedText)
           return std::unexpected(expectedText.error());
@@ -159,6 +218,14 @@ public:
           continue;
         case '[': {
           vs.push(*it++);
+          if constexpr (PrescanArraySizes &&
+                        requires { _eventDispatch.onArraySizeHint(0); }) {
+            auto hintResult =
+                _eventDispatch.onArraySizeHint(countArrayElements(it, end));
+            if (!hintResult) {
+              return hintResult;
+            }
+          }
           auto arrayStartResult = _eventDispatch.onArrayStart();
           if (!arrayStartResult) {
             return arrayStartResult; // Both are Expected, return directly
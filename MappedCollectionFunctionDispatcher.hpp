@@ -2,50 +2,72 @@
 
 #include "moped/concepts.hpp"
 
-#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace moped {
 
-// These templates are used as alternatives to a c++ vector, list, dequeue ...
-// in class definitions targeted for moped mapping. When parsing types with
-// large collections with a value_type of 'ValueT' this template allows the
-// parsing code dispatch each member of the collection to a handler function
-// when it's parsing is complete versus allocating and storing the entire
-// collection in memory minimizing memory footprint of the parsing operations.
+// Map shaped counterpart of the collection function dispatchers. Used in lieu
+// of std::map, std::unordered_map ... in class definitions targeted for moped
+// mapping, each (key, value) pair is handed to the handler as soon as the
+// value is complete so the mapped object is never materialized in memory.
+// String keys are kept in a reusable buffer and passed as std::string_view,
+// other key types are decoded from the member name. The value capture object
+// is recycled and cleared in place between entries.
 
-template <typename MapType, typename ValueT> class CollectionFunctionDispatcher {
+template <typename KeyT, typename ValueT, typename HandlerT>
+class MappedCollectionFunctionDispatcher {
 
 public:
-  using value_type = ValueT;
-  using HandlerT = std::function<Expected(const ValueT &)>;
-
-  ValueT &resetValueCapture() {
-    _captureValue = ValueT{};
-    return *_captureValue;
-  }
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  static constexpr bool RecyclesCapture = true;
+  // std::string only converts from std::string_view explicitly
+  static constexpr bool HasStringKey =
+      std::is_constructible_v<KeyT, std::string_view> &&
+      std::is_convertible_v<KeyT, std::string_view>;
+  using KeyStorageT = std::conditional_t<HasStringKey, std::string, KeyT>;
+  using KeyViewT =
+      std::conditional_t<HasStringKey, std::string_view, const KeyT &>;
 
   MappedCollectionFunctionDispatcher() = default;
-  MappedCollectionFunctionDispatcher(auto &&handler) : _handler(std::move(handler)) {}
+  MappedCollectionFunctionDispatcher(HandlerT handler)
+      : _handler(std::move(handler)) {}
 
-  void setCurrentValue(const ValueT &value) { _captureValue = value; }
+  // String keys are assigned into the buffer, keeping its capacity
+  void setCurrentKey(KeyViewT key) { _captureKey = key; }
+
+  ValueT &resetCapture() {
+    _capturePending = true;
+    return _captureValue;
+  }
+
+  void setCurrentValue(const ValueT &value) {
+    _captureValue = value;
+    _capturePending = true;
+  }
 
   Expected dispatchLastCapture() {
-    if (!_handler) {
-      return std::unexpected("No function assigned to collection dispatcher");
-    }
-    if (!_captureValue) {
+    if (!_capturePending) {
       return {};
     }
-    auto result = _handler(*_captureValue);
-    _captureValue.reset();
-    return result;
+    _capturePending = false;
+    return _handler(KeyViewT{_captureKey}, std::as_const(_captureValue));
+  }
+
+  Expected dispatch(const ValueT &value) {
+    return _handler(KeyViewT{_captureKey}, value);
   }
 
-  void setHandler(auto &&handler) { _handler = std::move(handler); }
+  HandlerT &getHandler() { return _handler; }
 
 private:
-  std::optional<ValueT> _captureValue{};
+  KeyStorageT _captureKey{};
+  ValueT _captureValue{};
+  bool _capturePending{false};
   HandlerT _handler{};
 };
 
-} // namespace moped
\ No newline at end of file
+} // namespace moped
@@ -1,12 +1,65 @@
 #pragma once
 
 #include "moped/AutoTypeSelectingParserHandler.hpp"
+#include "moped/MemberIndexTable.hpp"
 #include "moped/concepts.hpp"
 #include "moped/getValueFor.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <tuple>
+#include <variant>
 
 namespace moped {
 
+// How a collection member takes on decoded content when decoding into a
+// composite that already holds state. Append adds to what is there, Replace
+// clears the collection when it appears in the input, Upsert updates map
+// entries by key (null erases the key) and sequence elements by position.
+enum class MergePolicy : std::uint8_t { Append, Replace, Upsert };
+
+// Member name carrying a merge policy, see mergeAs
+template <MergePolicy Policy> struct MergePolicyName {
+  std::string_view name;
+  constexpr operator std::string_view() const { return name; }
+};
+
+// Tags a collection member's name in mopedHandler(...) with its merge policy
+// e.g. moped::mergeAs<moped::MergePolicy::Upsert>("levels"), &Book::levels
+template <MergePolicy Policy>
+constexpr MergePolicyName<Policy> mergeAs(std::string_view name) {
+  return {name};
+}
+
+// Names a member mapping by its handler type and position, letting emitter
+// contexts keep state for each member, such as a pre-rendered name, that is
+// built once rather than for every document
+template <typename HandlerT, std::size_t MemberIndex> struct MemberSlot {};
+
+// Compares a value with its baseline through the handler that maps it, so
+// composites compare member by member without needing operator==. Values
+// that can't be compared count as changed.
+template <typename ValueT>
+bool valuesMatch(auto &handler, const ValueT &current, const ValueT &baseline) {
+  if constexpr (is_optional<ValueT>) {
+    return current.has_value() == baseline.has_value() &&
+           (!current.has_value() ||
+            valuesMatch(handler, current.value(), baseline.value()));
+  } else if constexpr (is_pointer_type<ValueT>) {
+    return current == baseline ||
+           (current != nullptr && baseline != nullptr &&
+            valuesMatch(handler, *current, *baseline));
+  } else if constexpr (is_iterator<ValueT>) {
+    return valuesMatch(handler, *current, *baseline);
+  } else if constexpr (requires { handler.valuesEqual(current, baseline); }) {
+    return handler.valuesEqual(current, baseline);
+  } else if constexpr (std::equality_comparable<ValueT>) {
+    return current == baseline;
+  } else {
+    return false;
+  }
+}
+
 template <typename MemberT, DecodingTraitsC DecodingTraits> struct Handler {
   using MemberType = MemberT;
   using MemberIdType = typename DecodingTraits::MemberIdType;
@@ -61,13 +114,12 @@ struct Handler<MemberT, DecodingTraits>
     return std::unexpected{ParseError{
         "Parse error!!! onMember parse event not expected"
         " in collection handler. Failed to push value hander on parse stack",
-        member}};
+        DecodingTraits::getDisplayName(member)}};
   }
 
   Expected onObjectStart(MOPEDHandlerStack &eventHandlerStack) override {
     if constexpr (HasCompositeValueType) {
-      _targetCollection->emplace_back();
-      this->_valueTypeHandler.setTargetMember(_targetCollection->back());
+      this->_valueTypeHandler.setTargetMember(nextElement());
       return this->_valueTypeHandler.onObjectStart(eventHandlerStack);
     }
     return {};
@@ -85,8 +137,14 @@ struct Handler<MemberT, DecodingTraits>
     }
     if (handlerStack.top() == this) {
       if constexpr (is_array<ValueType> || IsMOPEDPushCollectionC<ValueType>) {
-        this->_valueTypeHandler.setTargetMember(
-            _targetCollection->emplace_back());
+        this->_valueTypeHandler.setTargetMember(nextElement());
+        if (_nestedSizeHint) {
+          // Hint arrived while this collection was on top of the stack, it
+          // describes the element collection that was just emplaced
+          this->_valueTypeHandler.onArraySizeHint(handlerStack,
+                                                  *_nestedSizeHint);
+          _nestedSizeHint.reset();
+        }
         return this->_valueTypeHandler.onArrayStart(handlerStack);
       } else {
         return std::unexpected(
@@ -94,14 +152,39 @@ struct Handler<MemberT, DecodingTraits>
             "with non collection value types");
       }
     }
+    beginMerge();
+    if constexpr (UsesAdaptiveCollectionReserveC<DecodingTraits>) {
+      reserveFor(_highWaterSize);
+    }
     handlerStack.push(this);
     return {};
   }
   Expected onArrayFinish(MOPEDHandlerStack &handlerStack) override {
+    if constexpr (UsesAdaptiveCollectionReserveC<DecodingTraits> &&
+                  requires { _targetCollection->size(); }) {
+      _highWaterSize = std::max(_highWaterSize, _targetCollection->size());
+    }
     handlerStack.pop();
     return {};
   }
 
+  Expected onArraySizeHint(MOPEDHandlerStack &handlerStack,
+                           std::size_t size) override {
+    if (!handlerStack.empty() && handlerStack.top() == this) {
+      if constexpr (is_array<ValueType> || IsMOPEDPushCollectionC<ValueType>) {
+        _nestedSizeHint = size;
+      }
+      return {};
+    }
+    if constexpr (requires { _targetCollection->size(); }) {
+      auto current = _targetCollection->size();
+      reserveFor(size > std::numeric_limits<std::size_t>::max() - current
+                     ? std::numeric_limits<std::size_t>::max()
+                     : current + size);
+    }
+    return {};
+  }
+
   Expected onStringValue(std::string_view value) override {
     return HandleScalarValue(value);
   }
@@ -110,6 +193,26 @@ struct Handler<MemberT, DecodingTraits>
     return HandleScalarValue(value);
   }
 
+  Expected onIntegerValue(std::int64_t value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onUnsignedValue(std::uint64_t value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onFloatValue(double value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onTimeValue(TimePoint value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onDecimalValue(DecimalFraction value) override {
+    return HandleScalarValue(value);
+  }
+
   void setTargetMember(MemberT &targetMember) {
     _targetCollection = &targetMember;
   }
@@ -118,6 +221,14 @@ struct Handler<MemberT, DecodingTraits>
     _targetCollection = &const_cast<MemberT &>(targetMember);
   }
 
+  // Nested collection values share the policy of the outer collection
+  void setMergePolicy(MergePolicy policy) {
+    _mergePolicy = policy;
+    if constexpr (requires { this->_valueTypeHandler.setMergePolicy(policy); }) {
+      this->_valueTypeHandler.setMergePolicy(policy);
+    }
+  }
+
   void applyEmitterContext(auto &emitterContext,
                            std::optional<MemberIdType> memberId) {
 
@@ -139,24 +250,127 @@ struct Handler<MemberT, DecodingTraits>
       });
     } else {
       for (auto &item : *_targetCollection) {
-        if constexpr (HasCompositeValueType) {
-          if constexpr (is_pointer_type<ValueType> || is_iterator<ValueType>) {
-            this->_valueTypeHandler.setTargetMember(*item);
-          } else {
-            this->_valueTypeHandler.setTargetMember(item);
+        applyElementEmitterContext(emitterContext, item);
+      }
+    }
+    emitterContext.onArrayFinish();
+  }
+
+  bool valuesEqual(const MemberT &current, const MemberT &baseline) {
+    if constexpr (HasCompositeValueType) {
+      return std::equal(current.begin(), current.end(), baseline.begin(),
+                        baseline.end(),
+                        [this](const auto &item, const auto &baselineItem) {
+                          return elementsMatch(item, baselineItem);
+                        });
+    } else {
+      return current == baseline;
+    }
+  }
+
+  // Sent so the merge decode of the same mapping reproduces the target:
+  // appended sequences send the elements added after their baseline,
+  // upserted sequences send every position, as a delta where the element
+  // supports one, and replaced sequences are sent whole. A change the
+  // member's policy can't reproduce, such as an appended sequence losing
+  // elements, fails the delta.
+  Expected applyDeltaEmitterContext(auto &emitterContext,
+                                    const MemberT &baseline,
+                                    std::optional<MemberIdType> memberId) {
+    if (_mergePolicy == MergePolicy::Replace) {
+      emitterContext.onArrayStart(memberId);
+      if constexpr (is_mapped_enum_flag<MemberT>) {
+        _targetCollection->forEachSetFlag([&](auto entry) {
+          emitterContext.onArrayValueEntry(entry.stringValue);
+        });
+      } else {
+        for (auto &item : *_targetCollection) {
+          applyElementEmitterContext(emitterContext, item);
+        }
+      }
+      emitterContext.onArrayFinish();
+      return {};
+    }
+    if constexpr (is_mapped_enum_flag<MemberT>) {
+      // Decoded flags are added to those already set
+      if ((*_targetCollection & baseline) != baseline) {
+        return unmergeableDelta(memberId);
+      }
+      applyEmitterContext(emitterContext, memberId);
+      return {};
+    } else {
+      auto baselineSize = std::size(baseline);
+      if (std::size(*_targetCollection) < baselineSize) {
+        return unmergeableDelta(memberId);
+      }
+      auto baselineItem = baseline.begin();
+      auto item = _targetCollection->begin();
+      // Sequences without positional access append even when upserted
+      if (_mergePolicy != MergePolicy::Upsert || !IndexedMerge) {
+        for (; baselineItem != baseline.end(); ++baselineItem, ++item) {
+          if (!elementsMatch(*item, *baselineItem)) {
+            return unmergeableDelta(memberId);
+          }
+        }
+      }
+      emitterContext.onArrayStart(memberId);
+      for (; baselineItem != baseline.end(); ++baselineItem, ++item) {
+        if constexpr (requires {
+                        this->_valueTypeHandler.applyDeltaEmitterContext(
+                            emitterContext, *baselineItem, std::nullopt);
+                      }) {
+          this->_valueTypeHandler.setTargetMember(*item);
+          auto result = this->_valueTypeHandler.applyDeltaEmitterContext(
+              emitterContext, *baselineItem, std::nullopt);
+          if (!result) {
+            return result;
           }
-          this->_valueTypeHandler.applyEmitterContext(emitterContext,
-                                                      std::nullopt);
         } else {
-          emitterContext.onArrayValueEntry(item);
+          applyElementEmitterContext(emitterContext, *item);
         }
       }
+      for (; item != _targetCollection->end(); ++item) {
+        applyElementEmitterContext(emitterContext, *item);
+      }
+      emitterContext.onArrayFinish();
+      return {};
     }
-    emitterContext.onArrayFinish();
   }
 
 private:
-  Expected HandleScalarValue(std::string_view value) {
+  Expected unmergeableDelta(std::optional<MemberIdType> memberId) {
+    constexpr const char *message =
+        "Delta can not express the change under the sequence merge policy";
+    if (!memberId) {
+      return std::unexpected(ParseError{message});
+    }
+    return std::unexpected(
+        ParseError{message, DecodingTraits::getDisplayName(*memberId)});
+  }
+
+  bool elementsMatch(const ValueType &item, const ValueType &baselineItem) {
+    if constexpr (HasCompositeValueType) {
+      return valuesMatch(this->_valueTypeHandler, item, baselineItem);
+    } else {
+      return item == baselineItem;
+    }
+  }
+
+  void applyElementEmitterContext(auto &emitterContext, auto &item) {
+    if constexpr (HasCompositeValueType) {
+      if constexpr (is_pointer_type<ValueType> || is_iterator<ValueType>) {
+        this->_valueTypeHandler.setTargetMember(*item);
+      } else {
+        this->_valueTypeHandler.setTargetMember(item);
+      }
+      this->_valueTypeHandler.applyEmitterContext(emitterContext,
+                                                  std::nullopt);
+    } else {
+      emitterContext.onArrayValueEntry(item);
+    }
+  }
+
+  Expected HandleScalarValue(auto value) {
     if constexpr (HasCompositeValueType) {
       return std::unexpected(
           "Parse error!!! No active composite handler to set value");
@@ -165,12 +379,68 @@ private:
       if (!result) {
         return std::unexpected(result.error());
       }
+      if constexpr (IndexedMerge) {
+        if (_mergePolicy == MergePolicy::Upsert &&
+            _mergeIndex < _targetCollection->size()) {
+          (*_targetCollection)[_mergeIndex++] = result.value();
+          return {};
+        }
+      }
       _targetCollection->emplace_back(result.value());
+      ++_mergeIndex;
     }
     return {};
   }
 
+  void beginMerge() {
+    _mergeIndex = 0;
+    if (_mergePolicy == MergePolicy::Replace) {
+      if constexpr (requires { _targetCollection->clear(); }) {
+        _targetCollection->clear();
+      } else {
+        *_targetCollection = MemberT{};
+      }
+    }
+  }
+
+  // Upserted sequences overwrite existing elements in order before
+  // appending, every other policy appends
+  ValueType &nextElement() {
+    if constexpr (IndexedMerge) {
+      if (_mergePolicy == MergePolicy::Upsert &&
+          _mergeIndex < _targetCollection->size()) {
+        return (*_targetCollection)[_mergeIndex++];
+      }
+    }
+    ++_mergeIndex;
+    _targetCollection->emplace_back();
+    return _targetCollection->back();
+  }
+
+  void reserveFor(std::size_t size) {
+    if constexpr (requires {
+                    _targetCollection->reserve(size);
+                    _targetCollection->capacity();
+                  }) {
+      // Size hints come from the input, they never exceed what the
+      // collection can hold
+      size = std::min(size, _targetCollection->max_size());
+      if (size > _targetCollection->capacity()) {
+        _targetCollection->reserve(size);
+      }
+    }
+  }
+
+  static constexpr bool IndexedMerge = requires(MemberT &collection) {
+    collection[std::size_t{}];
+    collection.size();
+  };
+
   MemberT *_targetCollection;
+  std::optional<std::size_t> _nestedSizeHint;
+  std::size_t _highWaterSize{0};
+  std::size_t _mergeIndex{0};
+  MergePolicy _mergePolicy{MergePolicy::Append};
 };
 
 template <IsMOPEDInsertCollectionC MemberT, DecodingTraitsC DecodingTraits>
@@ -189,7 +459,7 @@ struct Handler<MemberT, DecodingTraits>
     return std::unexpected{ParseError{
         "Parse error!!! onMember parse event not expected"
         " in collection handler. Failed to push value hander on parse stack",
-        memberId}};
+        DecodingTraits::getDisplayName(memberId)}};
   }
 
   Expected onObjectStart(MOPEDHandlerStack &eventHandlerStack) override {
@@ -223,6 +493,9 @@ struct Handler<MemberT, DecodingTraits>
             "with non collection value types");
       }
     }
+    if (_mergePolicy == MergePolicy::Replace) {
+      _targetCollection->clear();
+    }
     handlerStack.push(this);
     return {};
   }
@@ -251,6 +524,10 @@ struct Handler<MemberT, DecodingTraits>
     _targetCollection = &const_cast<MemberT &>(targetMember);
   }
 
+  // Inserting an existing element leaves it in place, so upserting a set
+  // is the same as appending to it
+  void setMergePolicy(MergePolicy policy) { _mergePolicy = policy; }
+
   void applyEmitterContext(auto &emitterContext, MemberIdType memberId) {
     emitterContext.onArrayStart(memberId);
 
@@ -266,6 +543,52 @@ struct Handler<MemberT, DecodingTraits>
     emitterContext.onArrayFinish();
   }
 
+  bool valuesEqual(const MemberT &current, const MemberT &baseline) {
+    if constexpr (HasCompositeValueType) {
+      return std::equal(current.begin(), current.end(), baseline.begin(),
+                        baseline.end(),
+                        [this](const auto &item, const auto &baselineItem) {
+                          return valuesMatch(this->_valueTypeHandler, item,
+                                             baselineItem);
+                        });
+    } else {
+      return current == baseline;
+    }
+  }
+
+  // Decoding only ever inserts, so unless the set is replaced the delta is
+  // the elements missing from the baseline and removals can't be sent
+  Expected applyDeltaEmitterContext(auto &emitterContext,
+                                    const MemberT &baseline,
+                                    MemberIdType memberId) {
+    if (_mergePolicy == MergePolicy::Replace) {
+      applyEmitterContext(emitterContext, memberId);
+      return {};
+    }
+    for (auto &baselineItem : baseline) {
+      if (_targetCollection->find(baselineItem) == _targetCollection->end()) {
+        return std::unexpected(
+            ParseError{"Delta can not express elements removed from a set",
+                       DecodingTraits::getDisplayName(memberId)});
+      }
+    }
+    emitterContext.onArrayStart(memberId);
+    for (auto &item : *_targetCollection) {
+      if (baseline.find(item) != baseline.end()) {
+        continue;
+      }
+      if constexpr (HasCompositeValueType) {
+        this->_valueTypeHandler.setTargetMember(item);
+        this->_valueTypeHandler.applyEmitterContext(emitterContext,
+                                                    std::nullopt);
+      } else {
+        emitterContext.onArrayValueEntry(item);
+      }
+    }
+    emitterContext.onArrayFinish();
+    return {};
+  }
+
 private:
   Expected HandleScalarValue(std::string_view value) {
     if constexpr (HasCompositeValueType) {
@@ -282,6 +605,7 @@ private:
   }
   ValueType _reusableValue{};
   MemberT *_targetCollection;
+  MergePolicy _mergePolicy{MergePolicy::Append};
 };
 
 template <IsMOPEDCompositeDispatcherC MemberT, DecodingTraitsC DecodingTraits>
@@ -294,6 +618,8 @@ struct Handler<MemberT, DecodingTraits>
   using ValueType = typename MemberT::value_type;
   static constexpr bool HasCompositeValueType =
       IsMOPEDCompositeC<typename MemberT::value_type, DecodingTraits>;
+  static constexpr bool RecyclesCapture =
+      requires { requires MemberT::RecyclesCapture; };
   using MOPEDHandlerStack = std::stack<IMOPEDHandler<DecodingTraits> *>;
 
   Expected onMember(MOPEDHandlerStack &, MemberIdType) override {
@@ -309,7 +635,7 @@ struct Handler<MemberT, DecodingTraits>
     }
 
     if constexpr (HasCompositeValueType) {
-      this->_valueTypeHandler.setTargetMember(_dispatcher->resetCapture());
+      this->_valueTypeHandler.setTargetMember(nextCapture());
       _currentIndex++;
       return this->_valueTypeHandler.onObjectStart(eventHandlerStack);
     }
@@ -333,7 +659,7 @@ struct Handler<MemberT, DecodingTraits>
         }
       }
       if constexpr (is_array<ValueType> || IsMOPEDPushCollectionC<ValueType>) {
-        this->_valueTypeHandler.setTargetMember(_dispatcher->resetCapture());
+        this->_valueTypeHandler.setTargetMember(nextCapture());
         ++_currentIndex;
         return this->_valueTypeHandler.onArrayStart(handlerStack);
       } else {
@@ -350,6 +676,11 @@ struct Handler<MemberT, DecodingTraits>
     if (auto result = _dispatcher->dispatchLastCapture(); !result) {
       return result;
     }
+    if constexpr (requires { _dispatcher->flushBatch(); }) {
+      if (auto result = _dispatcher->flushBatch(); !result) {
+        return result;
+      }
+    }
     handlerStack.pop();
     _currentIndex = 0;
     return {};
@@ -361,7 +692,9 @@ struct Handler<MemberT, DecodingTraits>
         return result;
       }
     }
-    HandleScalarValue(value);
+    if (auto result = HandleScalarValue(value); !result) {
+      return result;
+    }
     _currentIndex++;
     return {};
   }
@@ -372,7 +705,9 @@ struct Handler<MemberT, DecodingTraits>
         return result;
       }
     }
-    HandleScalarValue(value);
+    if (auto result = HandleScalarValue(value); !result) {
+      return result;
+    }
     _currentIndex++;
     return {};
   }
@@ -398,14 +733,33 @@ private:
       if (!result) {
         return std::unexpected(result.error());
       }
-      _dispatcher->setCurrentValue(result.value());
-      if (auto result = _dispatcher->dispatchLastCapture(); !result) {
-        return result;
+      if constexpr (RecyclesCapture) {
+        return _dispatcher->dispatch(result.value());
+      } else {
+        _dispatcher->setCurrentValue(result.value());
+        if (auto result = _dispatcher->dispatchLastCapture(); !result) {
+          return result;
+        }
       }
     }
     return {};
   }
 
+  // Recycling dispatchers hand back the same capture object for every
+  // element, it is cleared in place so member storage keeps its capacity.
+  ValueType &nextCapture() {
+    auto &capture = _dispatcher->resetCapture();
+    if constexpr (RecyclesCapture) {
+      if constexpr (requires { capture.clear(); }) {
+        capture.clear();
+      } else if constexpr (HasCompositeValueType) {
+        this->_valueTypeHandler.setTargetMember(capture);
+        this->_valueTypeHandler.clearMembers();
+      }
+    }
+    return capture;
+  }
+
   size_t _currentIndex{0};
 
   MemberT *_dispatcher;
@@ -529,6 +883,41 @@ struct Handler<MemberT, DecodingTraits>
     emitterContext.onArrayFinish();
   }
 
+  bool valuesEqual(const MemberT &current, const MemberT &baseline) {
+    if constexpr (HasCompositeValueType) {
+      return std::equal(current.begin(), current.end(), baseline.begin(),
+                        [this](const auto &item, const auto &baselineItem) {
+                          return valuesMatch(this->_valueTypeHandler, item,
+                                             baselineItem);
+                        });
+    } else {
+      return current == baseline;
+    }
+  }
+
+  // Decoding merges composite elements in place by position, so they are
+  // sent as per element deltas. Scalar arrays are sent whole.
+  Expected applyDeltaEmitterContext(auto &emitterContext,
+                                    const MemberT &baseline,
+                                    std::optional<MemberIdT> memberId) {
+    if constexpr (HasCompositeValueType) {
+      emitterContext.onArrayStart(memberId);
+      auto baselineItem = baseline.begin();
+      for (auto &item : *_targetArray) {
+        this->_valueTypeHandler.setTargetMember(item);
+        auto result = this->_valueTypeHandler.applyDeltaEmitterContext(
+            emitterContext, *baselineItem++);
+        if (!result) {
+          return result;
+        }
+      }
+      emitterContext.onArrayFinish();
+    } else {
+      applyEmitterContext(emitterContext, memberId);
+    }
+    return {};
+  }
+
 private:
   Expected HandleScalarValue(std::string_view value) {
     if constexpr (HasCompositeValueType) {
@@ -572,6 +961,9 @@ struct Handler<MemberT, DecodingTraits>
   Expected onObjectStart(MOPEDHandlerStack &eventHandlerStack) override {
     if (!_addingContent) {
       _addingContent = true;
+      if (_mergePolicy == MergePolicy::Replace) {
+        _targetCollection->clear();
+      }
       eventHandlerStack.push(this);
       return {};
     }
@@ -635,6 +1027,14 @@ struct Handler<MemberT, DecodingTraits>
     return HandleScalarValue(value);
   }
 
+  Expected onNullValue() override {
+    if (_mergePolicy != MergePolicy::Upsert) {
+      return IMOPEDHandler<DecodingTraits>::onNullValue();
+    }
+    _targetCollection->erase(_currentKey);
+    return {};
+  }
+
   void setTargetMember(MemberT &targetMember) {
     _targetCollection = &targetMember;
   }
@@ -643,22 +1043,130 @@ struct Handler<MemberT, DecodingTraits>
     _targetCollection = &const_cast<MemberT &>(targetMember);
   }
 
+  // Composite values of an upserted map merge into the existing entry,
+  // collection values take on the policy themselves
+  void setMergePolicy(MergePolicy policy) {
+    _mergePolicy = policy;
+    if constexpr (requires { this->_valueTypeHandler.setMergePolicy(policy); }) {
+      this->_valueTypeHandler.setMergePolicy(policy);
+    }
+  }
+
   void applyEmitterContext(auto &emitterContext,
                            std::optional<MemberIdType> memberId) {
     emitterContext.onObjectStart(memberId);
 
     for (const auto &[key, value] : *_targetCollection) {
-      if constexpr (HasCompositeMappedType) {
+      applyEntryEmitterContext(emitterContext, key, value);
+    }
+    emitterContext.onObjectFinish();
+  }
+
+  bool valuesEqual(const MemberT &current, const MemberT &baseline) {
+    if constexpr (HasCompositeMappedType) {
+      return current.size() == baseline.size() &&
+             std::all_of(current.begin(), current.end(),
+                         [this, &baseline](const auto &entry) {
+                           auto baselineEntry = baseline.find(entry.first);
+                           return baselineEntry != baseline.end() &&
+                                  valuesMatch(this->_valueTypeHandler,
+                                              entry.second,
+                                              baselineEntry->second);
+                         });
+    } else {
+      return current == baseline;
+    }
+  }
+
+  // Upserted maps send added and changed entries, composite values as their
+  // own delta, and removed keys as null. Replaced maps are sent whole.
+  // Appending decodes never overwrite or remove an entry, so such maps send
+  // their added entries and fail the delta for any other change.
+  Expected applyDeltaEmitterContext(auto &emitterContext,
+                                    const MemberT &baseline,
+                                    std::optional<MemberIdType> memberId) {
+    if (_mergePolicy == MergePolicy::Replace) {
+      applyEmitterContext(emitterContext, memberId);
+      return {};
+    }
+    if (_mergePolicy == MergePolicy::Append) {
+      for (const auto &[key, value] : baseline) {
+        auto entry = _targetCollection->find(key);
+        if (entry == _targetCollection->end() ||
+            !entryMatches(entry->second, value)) {
+          constexpr const char *message =
+              "Delta can not express entries changed or removed in an "
+              "appended map";
+          if (!memberId) {
+            return std::unexpected(ParseError{message});
+          }
+          return std::unexpected(
+              ParseError{message, DecodingTraits::getDisplayName(*memberId)});
+        }
+      }
+      emitterContext.onObjectStart(memberId);
+      for (const auto &[key, value] : *_targetCollection) {
+        if (!baseline.contains(key)) {
+          applyEntryEmitterContext(emitterContext, key, value);
+        }
+      }
+      emitterContext.onObjectFinish();
+      return {};
+    }
+    emitterContext.onObjectStart(memberId);
+    for (const auto &[key, value] : *_targetCollection) {
+      auto baselineEntry = baseline.find(key);
+      if (baselineEntry == baseline.end()) {
+        applyEntryEmitterContext(emitterContext, key, value);
+        continue;
+      }
+      if (entryMatches(value, baselineEntry->second)) {
+        continue;
+      }
+      if constexpr (requires {
+                      this->_valueTypeHandler.applyDeltaEmitterContext(
+                          emitterContext, baselineEntry->second, key);
+                    }) {
         this->_valueTypeHandler.setTargetMember(value);
-        this->_valueTypeHandler.applyEmitterContext(emitterContext, key);
-      } else {
-        emitterContext.onObjectValueEntry(key, value);
+        auto result = this->_valueTypeHandler.applyDeltaEmitterContext(
+            emitterContext, baselineEntry->second, key);
+        if (!result) {
+          return result;
+        }
+        continue;
+      }
+      applyEntryEmitterContext(emitterContext, key, value);
+    }
+    if constexpr (requires { emitterContext.onObjectNullEntry(KeyType{}); }) {
+      for (const auto &[key, value] : baseline) {
+        if (!_targetCollection->contains(key)) {
+          emitterContext.onObjectNullEntry(key);
+        }
       }
     }
     emitterContext.onObjectFinish();
+    return {};
   }
 
 private:
+  bool entryMatches(const MappedType &value, const MappedType &baselineValue) {
+    if constexpr (HasCompositeMappedType) {
+      return valuesMatch(this->_valueTypeHandler, value, baselineValue);
+    } else {
+      return value == baselineValue;
+    }
+  }
+
+  void applyEntryEmitterContext(auto &emitterContext, const KeyType &key,
+                                const MappedType &value) {
+    if constexpr (HasCompositeMappedType) {
+      this->_valueTypeHandler.setTargetMember(value);
+      this->_valueTypeHandler.applyEmitterContext(emitterContext, key);
+    } else {
+      emitterContext.onObjectValueEntry(key, value);
+    }
+  }
+
   Expected HandleScalarValue(std::string_view value) {
     if constexpr (HasCompositeMappedType) {
 
@@ -671,7 +1179,11 @@ private:
       if (!result) {
         return std::unexpected(result.error());
       }
-      _targetCollection->emplace(_currentKey, result.value());
+      if (_mergePolicy == MergePolicy::Upsert) {
+        _targetCollection->insert_or_assign(_currentKey, result.value());
+      } else {
+        _targetCollection->emplace(_currentKey, result.value());
+      }
     }
     return {};
   }
@@ -679,6 +1191,149 @@ private:
   MemberT *_targetCollection;
   KeyType _currentKey;
   bool _addingContent{false};
+  MergePolicy _mergePolicy{MergePolicy::Append};
+};
+
+template <IsMOPEDMapDispatcherC MemberT, DecodingTraitsC DecodingTraits>
+struct Handler<MemberT, DecodingTraits>
+    : IMOPEDHandler<DecodingTraits>,
+      ValueHandlerBase<typename MemberT::mapped_type, DecodingTraits> {
+  using MemberIdType = typename DecodingTraits::MemberIdType;
+
+  using MemberType = MemberT;
+  using KeyType = typename MemberT::key_type;
+  using MappedType = typename MemberT::mapped_type;
+  static constexpr bool HasCompositeMappedType =
+      IsMOPEDCompositeC<MappedType, DecodingTraits>;
+
+  using MOPEDHandlerStack = std::stack<IMOPEDHandler<DecodingTraits> *>;
+
+  Expected onMember(MOPEDHandlerStack &, MemberIdType memberId) override {
+    // Reaching the next key completes the previous composite value
+    if (auto result = _dispatcher->dispatchLastCapture(); !result) {
+      return result;
+    }
+    std::string_view keyText;
+    if constexpr (std::is_convertible_v<MemberIdType, std::string_view>) {
+      keyText = memberId;
+    } else {
+      _keyText = DecodingTraits::getDisplayName(memberId);
+      keyText = _keyText;
+    }
+    if constexpr (requires { _dispatcher->setCurrentKey(keyText); }) {
+      _dispatcher->setCurrentKey(keyText);
+    } else if constexpr (std::is_convertible_v<std::string_view, KeyType>) {
+      _dispatcher->setCurrentKey(KeyType{keyText});
+    } else {
+      auto result = getValueFor<KeyType, DecodingTraits>(keyText);
+      if (!result) {
+        return std::unexpected(result.error());
+      }
+      _dispatcher->setCurrentKey(result.value());
+    }
+    return {};
+  }
+
+  Expected onObjectStart(MOPEDHandlerStack &eventHandlerStack) override {
+    if (!_addingContent) {
+      _addingContent = true;
+      eventHandlerStack.push(this);
+      return {};
+    }
+    if constexpr (HasCompositeMappedType) {
+      this->_valueTypeHandler.setTargetMember(nextCapture());
+      return this->_valueTypeHandler.onObjectStart(eventHandlerStack);
+    } else {
+      return std::unexpected("Parse error!!! onObjectStart event not expected "
+                             "in mapped collection dispatcher "
+                             "with scalar value types");
+    }
+  }
+
+  Expected onObjectFinish(MOPEDHandlerStack &handlerStack) override {
+    if (auto result = _dispatcher->dispatchLastCapture(); !result) {
+      return result;
+    }
+    handlerStack.pop();
+    _addingContent = false;
+    return {};
+  }
+
+  Expected onArrayStart(MOPEDHandlerStack &handlerStack) override {
+    if constexpr (IsMOPEDContentCollectionC<MappedType>) {
+      this->_valueTypeHandler.setTargetMember(nextCapture());
+      return this->_valueTypeHandler.onArrayStart(handlerStack);
+    } else {
+      return std::unexpected("Parse error!!! onArrayStart event not expected "
+                             "in mapped collection dispatcher "
+                             "with non collection types");
+    }
+  }
+
+  Expected onArrayFinish(MOPEDHandlerStack &) override {
+    return std::unexpected("Parse error!!! onArrayFinish event not expected"
+                           " in mapped collection dispatcher");
+  }
+
+  Expected onStringValue(std::string_view value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onNumericValue(std::string_view value) override {
+    return HandleScalarValue(value);
+  }
+
+  Expected onBooleanValue(bool value) override {
+    return HandleScalarValue(value);
+  }
+
+  void setTargetMember(MemberT &targetMember) { _dispatcher = &targetMember; }
+
+  void setTargetMember(const MemberT &targetMember) {
+    _dispatcher = &const_cast<MemberT &>(targetMember);
+  }
+
+  void applyEmitterContext(auto &, std::optional<MemberIdType>) {
+    static_assert(false, "Emission not supported for types that use function "
+                         "dispatchers in lieu of mapped collection types");
+  }
+
+private:
+  Expected HandleScalarValue(auto value) {
+    if constexpr (HasCompositeMappedType ||
+                  IsMOPEDContentCollectionC<MappedType>) {
+      return std::unexpected(
+          "Parse error!!! No active composite handler to set value");
+    } else if constexpr (requires {
+                           _dispatcher->dispatch(
+                               getValueFor<MappedType, DecodingTraits>(value)
+                                   .value());
+                         }) {
+      auto result = getValueFor<MappedType, DecodingTraits>(value);
+      if (!result) {
+        return std::unexpected(result.error());
+      }
+      return _dispatcher->dispatch(result.value());
+    } else {
+      return std::unexpected(
+          "Parse error!!! Value not applicable to mapped dispatcher type");
+    }
+  }
+
+  MappedType &nextCapture() {
+    auto &capture = _dispatcher->resetCapture();
+    if constexpr (requires { capture.clear(); }) {
+      capture.clear();
+    } else if constexpr (HasCompositeMappedType) {
+      this->_valueTypeHandler.setTargetMember(capture);
+      this->_valueTypeHandler.clearMembers();
+    }
+    return capture;
+  }
+
+  MemberT *_dispatcher;
+  std::string _keyText;
+  bool _addingContent{false};
 };
 
 template <typename MemberT, DecodingTraitsC DecodingTraits>
@@ -690,8 +1345,12 @@ struct Handler<MemberT, DecodingTraits>
   using MemberIdT = typename DecodingTraits::MemberIdType;
   using ValueType = typename MemberT::value_type;
 
+  // An engaged optional is decoded into in place, so merging a partial
+  // object keeps the members it doesn't mention
   void setTargetMember(MemberT &targetMember) {
-    targetMember = typename MemberT::value_type{};
+    if (!targetMember.has_value()) {
+      targetMember.emplace();
+    }
     Handler<typename MemberT::value_type, DecodingTraits>::setTargetMember(
         targetMember.value());
   }
@@ -857,7 +1516,21 @@ struct Handler<VariantT, DecodingTraits> : IMOPEDHandler<DecodingTraits> {
     _captureVariant = &const_cast<VariantT &>(targetMember);
   }
 
+  // Variants compare only when every alternative has operator==
+  bool valuesEqual(const VariantT &current, const VariantT &baseline) {
+    if constexpr (alternativesComparable(static_cast<VariantT *>(nullptr))) {
+      return current == baseline;
+    } else {
+      return false;
+    }
+  }
+
 private:
+  template <typename... AlternativeTs>
+  static constexpr bool alternativesComparable(std::variant<AlternativeTs...> *) {
+    return (std::equality_comparable<AlternativeTs> && ...);
+  }
+
   int _nestingLevel{0};
   MultiMopedHandlerHarness _handlerHarness;
   VariantT *_captureVariant;
@@ -887,6 +1560,11 @@ struct MemberIdHandlerPair {
   }
 
   void applyEmitterContext(auto &emitterContext, CaptureT &captureTarget) {
+    applyEmitterContext(emitterContext, captureTarget, std::monostate{});
+  }
+
+  void applyEmitterContext(auto &emitterContext, CaptureT &captureTarget,
+                           auto memberSlot) {
     auto &memberValue = captureTarget.*memberPtr;
     if constexpr (is_optional<MemberT>) {
       if (!memberValue.has_value()) {
@@ -896,7 +1574,7 @@ struct MemberIdHandlerPair {
         handler.setTargetMember(*memberValue);
         handler.applyEmitterContext(emitterContext, memberId);
       } else {
-        emitterContext.onObjectValueEntry(memberId, *memberValue);
+        applyValueEntry(emitterContext, *memberValue, memberSlot);
       }
     } else if constexpr (can_dereference<MemberT>) {
 
@@ -910,7 +1588,7 @@ struct MemberIdHandlerPair {
         handler.setTargetMember(*memberValue);
         handler.applyEmitterContext(emitterContext, memberId);
       } else {
-        emitterContext.onObjectValueEntry(memberId, *memberValue);
+        applyValueEntry(emitterContext, *memberValue, memberSlot);
       }
     }
 
@@ -918,13 +1596,101 @@ struct MemberIdHandlerPair {
       handler.setTargetMember(memberValue);
       handler.applyEmitterContext(emitterContext, memberId);
     } else {
-      emitterContext.onObjectValueEntry(memberId, memberValue);
+      applyValueEntry(emitterContext, memberValue, memberSlot);
     }
   }
 
   auto &getMember(CaptureT &getTarget) { return getTarget.*memberPtr; }
 
+  bool memberEqual(const CaptureT &current, const CaptureT &baseline) {
+    return valuesMatch(handler, current.*memberPtr, baseline.*memberPtr);
+  }
+
+  // Emits the member only when it differs from the baseline, as a delta
+  // where its handler supports one, and a cleared optional as null
+  Expected applyDeltaEmitterContext(auto &emitterContext, CaptureT &current,
+                                    const CaptureT &baseline) {
+    if (memberEqual(current, baseline)) {
+      return {};
+    }
+    auto &memberValue = current.*memberPtr;
+    auto &baselineValue = baseline.*memberPtr;
+    if constexpr (is_optional<MemberT>) {
+      if (!memberValue.has_value()) {
+        if constexpr (requires { emitterContext.onObjectNullEntry(memberId); }) {
+          emitterContext.onObjectNullEntry(memberId);
+        }
+        return {};
+      }
+      if (baselineValue.has_value()) {
+        return applyDeltaValue(emitterContext, *memberValue, *baselineValue);
+      }
+    } else if constexpr (!can_dereference<MemberT>) {
+      return applyDeltaValue(emitterContext, memberValue, baselineValue);
+    }
+    applyEmitterContext(emitterContext, current);
+    return {};
+  }
+
+  void setMergePolicy(MergePolicy policy) {
+    static_assert(requires { handler.setMergePolicy(policy); },
+                  "Merge policies apply to collection members");
+    handler.setMergePolicy(policy);
+  }
+
+  // Return the member to its empty state without releasing storage owned by
+  // strings and collections. Function dispatchers are left untouched.
+  void clearMember(CaptureT &captureTarget) {
+    auto &memberValue = captureTarget.*memberPtr;
+    if constexpr (IsMOPEDCompositeDispatcherC<MemberT> ||
+                  IsMOPEDMapDispatcherC<MemberT>) {
+      return;
+    } else if constexpr (can_dereference<MemberT> && !is_optional<MemberT>) {
+      memberValue = MemberT{};
+    } else if constexpr (requires { memberValue.clear(); }) {
+      memberValue.clear();
+    } else if constexpr (is_optional<MemberT>) {
+      memberValue.reset();
+    } else if constexpr (requires { handler.clearMembers(); }) {
+      handler.setTargetMember(memberValue);
+      handler.clearMembers();
+    } else if constexpr (requires { memberValue = MemberT{}; }) {
+      memberValue = MemberT{};
+    }
+  }
+
   Handler<MemberT, DecodingTraits> handler{};
+
+private:
+  void applyValueEntry(auto &emitterContext, const auto &value,
+                       auto memberSlot) {
+    if constexpr (requires {
+                    emitterContext.onObjectValueEntry(memberSlot, memberId,
+                                                      value);
+                  }) {
+      emitterContext.onObjectValueEntry(memberSlot, memberId, value);
+    } else {
+      emitterContext.onObjectValueEntry(memberId, value);
+    }
+  }
+
+  Expected applyDeltaValue(auto &emitterContext, auto &value,
+                           const auto &baselineValue) {
+    if constexpr (requires {
+                    handler.applyDeltaEmitterContext(emitterContext,
+                                                     baselineValue, memberId);
+                  }) {
+      handler.setTargetMember(value);
+      return handler.applyDeltaEmitterContext(emitterContext, baselineValue,
+                                              memberId);
+    } else if constexpr (IMOPEDHandlerC<decltype(handler), DecodingTraits>) {
+      handler.setTargetMember(value);
+      handler.applyEmitterContext(emitterContext, memberId);
+    } else {
+      emitterContext.onObjectValueEntry(memberId, value);
+    }
+    return {};
+  }
 };
 
 template <typename CaptureType, typename MemberEventHandlerTuple,
@@ -943,7 +1709,7 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
       return {};
     }
 
-    return dispatchForActiveMember<0>([&eventHandlerStack](auto &handler) {
+    return dispatchForActiveMember([&eventHandlerStack](auto &handler) {
       return handler.onObjectStart(eventHandlerStack);
     });
   }
@@ -960,29 +1726,67 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
                              "in object handler with a preceding member event");
     }
 
-    return dispatchForActiveMember<0>([&eventHandlerStack](auto &handler) {
+    return dispatchForActiveMember([&eventHandlerStack](auto &handler) {
       return handler.onArrayStart(eventHandlerStack);
     });
   }
 
+  Expected onArraySizeHint(MOPEDHandlerStack &eventHandlerStack,
+                           std::size_t size) override {
+    if (!_activeMemberOffset.has_value()) {
+      return {}; // Hints are advisory, leave reporting to onArrayStart
+    }
+    return dispatchForActiveMember(
+        [&eventHandlerStack, size](auto &handler) {
+          return handler.onArraySizeHint(eventHandlerStack, size);
+        });
+  }
+
   Expected onMember(MOPEDHandlerStack &eventHandlerStack,
                     MemberIdT memberId) override {
+    if constexpr (std::is_integral_v<MemberIdT>) {
+      if (auto memberIndex = findMemberIndex(memberId);
+          memberIndex != MemberIndexTable::NotFound) {
+        _activeMemberOffset = memberIndex;
+        return {};
+      }
+    }
     return setActiveMember<0>(memberId, eventHandlerStack);
   }
 
   Expected onStringValue(std::string_view value) override {
-    return setActiveMemberValue<0>(value);
+    return setActiveMemberValue(value);
   }
 
   Expected onNumericValue(std::string_view value) {
-    return setActiveMemberValue<0>(value);
+    return setActiveMemberValue(value);
+  }
+
+  Expected onIntegerValue(std::int64_t value) override {
+    return setActiveMemberValue(value);
+  }
+
+  Expected onUnsignedValue(std::uint64_t value) override {
+    return setActiveMemberValue(value);
+  }
+
+  Expected onFloatValue(double value) override {
+    return setActiveMemberValue(value);
+  }
+
+  Expected onTimeValue(TimePoint value) override {
+    return setActiveMemberValue(value);
+  }
+
+  Expected onDecimalValue(DecimalFraction value) override {
+    return setActiveMemberValue(value);
   }
 
   Expected onBooleanValue(bool value) override {
-    return setActiveMemberValue<0>(value);
+    return setActiveMemberValue(value);
   }
 
-  Expected onNullValue() override { return applyNullValueToActiveMember<0>(); }
+  Expected onNullValue() override { return applyNullValueToActiveMember(); }
 
   void setTargetMember(CaptureType &targetMember) {
     _captureObject = &targetMember;
@@ -996,6 +1800,13 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
 
   void reset() { _activeMemberOffset.reset(); }
 
+  template <size_t MemberIndex = 0> void clearMembers() {
+    if constexpr (MemberIndex < std::tuple_size_v<MemberEventHandlerTuple>) {
+      std::get<MemberIndex>(_handlerTuple).clearMember(*_captureObject);
+      clearMembers<MemberIndex + 1>();
+    }
+  }
+
   Expected onArrayFinish(MOPEDHandlerStack &) { return {}; }
 
   template <size_t MemberIndex = 0>
@@ -1009,7 +1820,9 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
       return; // No more members to process
     } else {
       std::get<MemberIndex>(_handlerTuple)
-          .applyEmitterContext(emitterContext, *_captureObject);
+          .applyEmitterContext(
+              emitterContext, *_captureObject,
+              MemberSlot<MappedObjectParserEncoderDispatcher, MemberIndex>{});
       // Recursively apply emitter context for all composite members
       applyEmitterContext<MemberIndex + 1>(emitterContext, memberId);
     }
@@ -1019,6 +1832,41 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
     }
   }
 
+  template <size_t MemberIndex = 0>
+  bool valuesEqual(const CaptureType &current, const CaptureType &baseline) {
+    if constexpr (MemberIndex == std::tuple_size_v<MemberEventHandlerTuple>) {
+      return true;
+    } else {
+      return std::get<MemberIndex>(_handlerTuple)
+                 .memberEqual(current, baseline) &&
+             valuesEqual<MemberIndex + 1>(current, baseline);
+    }
+  }
+
+  // Emits only the members of the target that differ from 'baseline', an
+  // unchanged composite is written as an empty object. Fails, leaving the
+  // output incomplete, when a member changed in a way its merge policy
+  // can't reproduce.
+  Expected applyDeltaEmitterContext(
+      auto &emitterContext, const CaptureType &baseline,
+      std::optional<MemberIdT> memberId = std::nullopt) {
+    auto &current = *_captureObject;
+    Expected result;
+    emitterContext.onObjectStart(memberId);
+    std::apply(
+        [&](auto &...mappings) {
+          ((result = mappings.applyDeltaEmitterContext(emitterContext, current,
+                                                       baseline)) &&
+           ...);
+        },
+        _handlerTuple);
+    if (!result) {
+      return result;
+    }
+    emitterContext.onObjectFinish();
+    return {};
+  }
+
   template <typename BaseCaptureType, typename BaseMemberEventHandlerTuple>
   auto operator+(MappedObjectParserEncoderDispatcher<
                  BaseCaptureType, BaseMemberEventHandlerTuple, DecodingTraits>
@@ -1037,6 +1885,28 @@ struct MappedObjectParserEncoderDispatcher : IMOPEDHandler<DecodingTraits> {
 
   auto getHandlerTuple() { return _handlerTuple; }
 
+  void forEachMemberId(auto &&memberIdFunction) const {
+    std::apply(
+        [&](const auto &...nameHandlers) {
+          (memberIdFunction(nameHandlers.memberId), ...);
+        },
+        _handlerTuple);
+  }
+
+  // Visits each member mapping along with its tuple index so fixed layout
+  // codecs can resolve member ids once up front rather than per event
+  void forEachMemberMapping(auto &&mappingFunction) const {
+    [&]<std::size_t... MemberIndex>(std::index_sequence<MemberIndex...>) {
+      (mappingFunction(std::integral_constant<std::size_t, MemberIndex>{},
+                       std::get<MemberIndex>(_handlerTuple)),
+       ...);
+    }(std::make_index_sequence<std::tuple_size_v<MemberEventHandlerTuple>>{});
+  }
+
+  template <std::size_t MemberIndex> const auto &getMemberMapping() const {
+    return std::get<MemberIndex>(_handlerTuple);
+  }
+
 private:
   std::string_view _activeMemberName;
   template <size_t MemberIndex>
@@ -1046,7 +1916,8 @@ private:
       // Failed parse ... no member found
       _activeMemberOffset.reset();
       return std::unexpected(
-          ParseError{"Member not found in MOPED handler", memberId});
+          ParseError{"Member not found in MOPED handler",
+                     DecodingTraits::getDisplayName(memberId)});
     } else {
       auto &nameHandler = std::get<MemberIndex>(_handlerTuple);
       if (nameHandler.memberId == memberId) {
@@ -1077,96 +1948,147 @@ private:
     }
   }
 
-  template <size_t MemberIndex> Expected setActiveMemberValue(auto value) {
-    if constexpr (MemberIndex == std::tuple_size_v<MemberEventHandlerTuple>) {
+  // Resolves integral ids through a table built on first use, so handlers
+  // created only for encoding never pay for it. Ids of members mapped after
+  // an embedding member aren't tabled, the linear search hands those off to
+  // the embedded handler first.
+  std::uint16_t findMemberIndex(MemberIdT memberId) {
+    if (!_memberIndexBuilt) {
+      static_assert(std::tuple_size_v<MemberEventHandlerTuple> <
+                        MemberIndexTable::NotFound,
+                    "Too many members for the member index table");
+      bool embeddingSeen = false;
+      forEachMemberMapping([&](auto memberIndex, const auto &mapping) {
+        embeddingSeen = embeddingSeen ||
+                        mapping.memberId == DecodingTraits::EmbeddingMemberId;
+        if (!embeddingSeen) {
+          _memberIndex.add(mapping.memberId,
+                           static_cast<std::uint16_t>(memberIndex.value));
+        }
+      });
+      _memberIndexBuilt = true;
+    }
+    return _memberIndex.find(memberId);
+  }
+
+  // Calls memberAction with the active member's mapping through a table of
+  // one function per member, indexed by the active member offset
+  template <typename ActionT>
+  Expected visitActiveMember(ActionT &memberAction) {
+    using MemberActionFn = Expected (*)(MappedObjectParserEncoderDispatcher &,
+                                        ActionT &);
+    static constexpr auto memberActions =
+        []<std::size_t... MemberIndex>(std::index_sequence<MemberIndex...>) {
+          return std::array<MemberActionFn, sizeof...(MemberIndex)>{
+              [](MappedObjectParserEncoderDispatcher &self,
+                 ActionT &action) -> Expected {
+                return action(std::get<MemberIndex>(self._handlerTuple));
+              }...};
+        }(std::make_index_sequence<
+            std::tuple_size_v<MemberEventHandlerTuple>>{});
+    if (*_activeMemberOffset >= memberActions.size()) {
       return std::unexpected("Parse error ... no active member available");
-    } else {
-      if (!_activeMemberOffset.has_value()) {
-        return std::unexpected(
-            ParseError{"No active member available for current value",
-                       std::format("{}", value)});
-      }
-      if (MemberIndex == *_activeMemberOffset) {
-        return std::get<MemberIndex>(_handlerTuple)
-            .setValue(*_captureObject, value);
-      }
-      return setActiveMemberValue<MemberIndex + 1>(value);
     }
+    return memberActions[*_activeMemberOffset](*this, memberAction);
   }
 
-  template <size_t MemberIndex> Expected applyNullValueToActiveMember() {
-    if constexpr (MemberIndex == std::tuple_size_v<MemberEventHandlerTuple>) {
-      return std::unexpected("Parse error ... no active member available");
-    } else {
-      if (!_activeMemberOffset.has_value()) {
-        return std::unexpected("Parse error ... no active member available for "
-                               "current value null");
-      }
-      if (MemberIndex == *_activeMemberOffset) {
-        auto &memberValue =
-            std::get<MemberIndex>(_handlerTuple).getMember(*_captureObject);
-        if constexpr (is_optional<std::decay_t<decltype(memberValue)>>) {
-          memberValue.reset();
-          return {};
-        } else {
-          auto memberId = std::get<MemberIndex>(_handlerTuple).memberId;
-          return std::unexpected(
-              ParseError{"Parse error ... null value not applicable "
-                         "for non-optional member",
-                         memberId});
-        }
-      }
-      return applyNullValueToActiveMember<MemberIndex + 1>();
+  Expected setActiveMemberValue(auto value) {
+    if (!_activeMemberOffset.has_value()) {
+      return std::unexpected(
+          ParseError{"No active member available for current value",
+                     std::format("{}", value)});
     }
+    auto setValue = [this, value](auto &mapping) {
+      return mapping.setValue(*_captureObject, value);
+    };
+    return visitActiveMember(setValue);
   }
 
-  template <size_t MemberIndex, typename H>
-  Expected dispatchForActiveMember(H &&handlerActionFunction) {
-    if constexpr (MemberIndex == std::tuple_size_v<MemberEventHandlerTuple>) {
-      return std::unexpected("Parse error ... no active member available");
-    } else {
-      if (!_activeMemberOffset.has_value()) {
+  Expected applyNullValueToActiveMember() {
+    if (!_activeMemberOffset.has_value()) {
+      return std::unexpected("Parse error ... no active member available for "
+                             "current value null");
+    }
+    auto applyNull = [this](auto &mapping) -> Expected {
+      auto &memberValue = mapping.getMember(*_captureObject);
+      if constexpr (is_optional<std::decay_t<decltype(memberValue)>>) {
+        memberValue.reset();
+        return {};
+      } else {
         return std::unexpected(
-            "Parse error ... no active member available for current object");
+            ParseError{"Parse error ... null value not applicable "
+                       "for non-optional member",
+                       DecodingTraits::getDisplayName(mapping.memberId)});
       }
-      if (MemberIndex == *_activeMemberOffset) {
-        auto &nameHandler = std::get<MemberIndex>(_handlerTuple);
-        if constexpr (IMOPEDHandlerC<
-                          std::decay_t<decltype(nameHandler.handler)>,
-                          DecodingTraits>) {
+    };
+    return visitActiveMember(applyNull);
+  }
 
-          nameHandler.handler.setTargetMember(
-              _captureObject->*(nameHandler.memberPtr));
-          return handlerActionFunction(nameHandler.handler);
-        } else {
-          return std::unexpected(ParseError{
-              "Expected composite handler for member:", nameHandler.memberId});
-        }
-      }
-      return dispatchForActiveMember<MemberIndex + 1>(
-          std::forward<H>(handlerActionFunction));
+  template <typename H>
+  Expected dispatchForActiveMember(H &&handlerActionFunction) {
+    if (!_activeMemberOffset.has_value()) {
+      return std::unexpected(
+          "Parse error ... no active member available for current object");
     }
+    auto dispatch = [this, &handlerActionFunction](auto &nameHandler)
+        -> Expected {
+      if constexpr (IMOPEDHandlerC<std::decay_t<decltype(nameHandler.handler)>,
+                                   DecodingTraits>) {
+        nameHandler.handler.setTargetMember(
+            _captureObject->*(nameHandler.memberPtr));
+        return handlerActionFunction(nameHandler.handler);
+      } else {
+        return std::unexpected(
+            ParseError{"Expected composite handler for member:",
+                       DecodingTraits::getDisplayName(nameHandler.memberId)});
+      }
+    };
+    return visitActiveMember(dispatch);
   }
 
   CaptureType *_captureObject;
   MemberEventHandlerTuple _handlerTuple;
   std::optional<std::uint32_t> _activeMemberOffset;
+  MemberIndexTable _memberIndex;
+  bool _memberIndexBuilt{false};
 };
 
-template <DecodingTraitsC DecodingTraits, typename CaptureT>
-constexpr auto mopedTuple() {
-  return std::tuple<>{};
+// Member names given through mergeAs carry a merge policy for their mapping
+template <typename NameT> void applyMergePolicy(const NameT &, auto &) {}
+
+template <MergePolicy Policy>
+void applyMergePolicy(const MergePolicyName<Policy> &, auto &mapping) {
+  mapping.setMergePolicy(Policy);
+}
+
+// Builds the mapping tuple from alternating member name and member pointer
+// arguments in one expansion, rather than concatenating a tuple per member,
+// which keeps instantiation cost linear for wide messages
+template <DecodingTraitsC DecodingTraits, typename CaptureT,
+          typename ArgsTuple, std::size_t... MemberIndex>
+constexpr auto mopedTupleFromArgs(ArgsTuple &&args,
+                                  std::index_sequence<MemberIndex...>) {
+  auto mappings = std::make_tuple(
+      MemberIdHandlerPair<
+          CaptureT,
+          std::decay_t<std::tuple_element_t<MemberIndex * 2 + 1,
+                                            std::decay_t<ArgsTuple>>>,
+          DecodingTraits>{DecodingTraits::getMemberId(
+                              std::string_view{std::get<MemberIndex * 2>(args)}),
+                          std::get<MemberIndex * 2 + 1>(args)}...);
+  (applyMergePolicy(std::get<MemberIndex * 2>(args),
+                    std::get<MemberIndex>(mappings)),
+   ...);
+  return mappings;
 }
 
 template <DecodingTraitsC DecodingTraits, typename CaptureT, typename... Args>
-constexpr auto mopedTuple(std::string_view name, auto memberPtr,
-                          Args &&...args) {
-  using MemberPtrT = decltype(memberPtr);
-  auto handlerTuple =
-      std::make_tuple(MemberIdHandlerPair<CaptureT, MemberPtrT, DecodingTraits>{
-          DecodingTraits::getMemberId(name), memberPtr});
-  return std::tuple_cat(handlerTuple, mopedTuple<DecodingTraits, CaptureT>(
-                                          std::forward<Args>(args)...));
+constexpr auto mopedTuple(Args &&...args) {
+  static_assert(sizeof...(Args) % 2 == 0,
+                "Member mappings are pairs of member name and member pointer");
+  return mopedTupleFromArgs<DecodingTraits, CaptureT>(
+      std::forward_as_tuple(std::forward<Args>(args)...),
+      std::make_index_sequence<sizeof...(Args) / 2>{});
 }
 
 template <DecodingTraitsC DecodingTraits, typename CaptureT, typename... Args>
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace moped {
+
+// Maps integral member ids to their mapping index in O(1) for traits whose
+// ids are small integers, such as FIX tags or protobuf field numbers. Ids
+// index a two level table of fixed size pages, pages only exist for id
+// ranges holding members and every unused range shares one empty page, so
+// sparse ids cost memory per populated range rather than per id. Ids above
+// MaxTableId aren't tabled and are left for the caller to resolve. Nothing
+// is allocated until the first id is added.
+class MemberIndexTable {
+  static constexpr std::uint32_t PageBits = 6;
+  static constexpr std::uint32_t PageSize = 1u << PageBits;
+
+public:
+  static constexpr std::uint16_t NotFound = 0xffff;
+  static constexpr std::uint64_t MaxTableId = (1u << 20) - 1;
+
+  // Keeps the first index added for an id, matching the first match
+  // semantics of a linear search over the mapping
+  template <typename IdT>
+    requires std::is_integral_v<IdT>
+  bool add(IdT id, std::uint16_t memberIndex) {
+    if (isNegative(id) || static_cast<std::uint64_t>(id) > MaxTableId) {
+      return false;
+    }
+    if (_entries.empty()) {
+      _entries.resize(PageSize, NotFound);
+    }
+    auto tableId = static_cast<std::uint32_t>(id);
+    auto page = tableId >> PageBits;
+    if (page >= _pages.size()) {
+      _pages.resize(page + 1, 0);
+    }
+    if (_pages[page] == 0) {
+      _pages[page] = static_cast<std::uint32_t>(_entries.size());
+      _entries.resize(_entries.size() + PageSize, NotFound);
+    }
+    auto &entry = _entries[_pages[page] + (tableId & (PageSize - 1))];
+    if (entry == NotFound) {
+      entry = memberIndex;
+    }
+    return true;
+  }
+
+  template <typename IdT>
+    requires std::is_integral_v<IdT>
+  std::uint16_t find(IdT id) const {
+    auto page = static_cast<std::uint64_t>(id) >> PageBits;
+    if (isNegative(id) || page >= _pages.size()) {
+      return NotFound;
+    }
+    return _entries[_pages[page] +
+                    (static_cast<std::uint32_t>(id) & (PageSize - 1))];
+  }
+
+private:
+  template <typename IdT> static bool isNegative(IdT id) {
+    if constexpr (std::is_signed_v<IdT>) {
+      return id < 0;
+    } else {
+      return false;
+    }
+  }
+
+  // Offsets of each page within _entries, 0 is the shared empty page
+  std::vector<std::uint32_t> _pages;
+  std::vector<std::uint16_t> _entries;
+};
+
+} // namespace moped
@@ -0,0 +1,194 @@
+#pragma once
+#include "moped/BinaryEmitterContextBase.hpp"
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include "moped/moped.hpp"
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace moped {
+
+// Emitter context producing MessagePack, container lengths are resolved by
+// BinaryEmitterContextBase once the root container finishes.
+template <typename TimePointFormatter = DurationSinceEpochFormatter<>>
+class MsgPackEmitterContext
+    : public BinaryEmitterContextBase<
+          MsgPackEmitterContext<TimePointFormatter>> {
+  using BaseT =
+      BinaryEmitterContextBase<MsgPackEmitterContext<TimePointFormatter>>;
+  friend BaseT;
+
+public:
+  static constexpr std::size_t MaxHeaderSize = 5;
+
+  MsgPackEmitterContext(std::string &output) : BaseT(output) {}
+
+private:
+  using BaseT::_output;
+  using BaseT::appendBigEndian;
+  using BaseT::storeBigEndian;
+
+  static std::size_t writeContainerHeader(char *target, std::uint32_t count,
+                                          bool isMap) {
+    if (count < 16) {
+      target[0] = static_cast<char>((isMap ? 0x80 : 0x90) | count);
+      return 1;
+    }
+    if (count <= 0xffff) {
+      target[0] = static_cast<char>(isMap ? 0xde : 0xdc);
+      storeBigEndian(target + 1, count, 2);
+      return 3;
+    }
+    target[0] = static_cast<char>(isMap ? 0xdf : 0xdd);
+    storeBigEndian(target + 1, count, 4);
+    return 5;
+  }
+
+  void writeString(std::string_view text) {
+    auto size = text.size();
+    if (size < 32) {
+      _output.push_back(static_cast<char>(0xa0 | size));
+    } else if (size <= 0xff) {
+      appendBigEndian(0xd9, size, 1);
+    } else if (size <= 0xffff) {
+      appendBigEndian(0xda, size, 2);
+    } else {
+      appendBigEndian(0xdb, size, 4);
+    }
+    _output.append(text);
+  }
+
+  void writeNull() { _output.push_back(static_cast<char>(0xc0)); }
+
+  void writeUnsigned(std::uint64_t value) {
+    if (value < 128) {
+      _output.push_back(static_cast<char>(value));
+    } else if (value <= 0xff) {
+      appendBigEndian(0xcc, value, 1);
+    } else if (value <= 0xffff) {
+      appendBigEndian(0xcd, value, 2);
+    } else if (value <= 0xffffffff) {
+      appendBigEndian(0xce, value, 4);
+    } else {
+      appendBigEndian(0xcf, value, 8);
+    }
+  }
+
+  void writeInteger(std::int64_t value) {
+    if (value >= 0) {
+      writeUnsigned(static_cast<std::uint64_t>(value));
+    } else if (value >= -32) {
+      _output.push_back(static_cast<char>(value));
+    } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+      appendBigEndian(0xd0, static_cast<std::uint8_t>(value), 1);
+    } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+      appendBigEndian(0xd1, static_cast<std::uint16_t>(value), 2);
+    } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+      appendBigEndian(0xd2, static_cast<std::uint32_t>(value), 4);
+    } else {
+      appendBigEndian(0xd3, static_cast<std::uint64_t>(value), 8);
+    }
+  }
+
+  void writeEncodedValue(moped::TimePoint value) {
+    if constexpr (requires { TimePointFormatter::getTimeUnits(value); }) {
+      writeInteger(TimePointFormatter::getTimeUnits(value));
+    } else {
+      writeString(TimePointFormatter::format(value));
+    }
+  }
+
+  // Whole values are written as integers, fractional ones and those beyond
+  // the 64 bit integer formats as their exact decimal text
+  template <is_allowed_itegral I, std::uint8_t Scale10V>
+  void writeEncodedValue(const ScaledInteger<I, Scale10V> &value) {
+    using ScaledT = ScaledInteger<I, Scale10V>;
+    auto rawValue = value.getRawIntegerValue();
+    if (rawValue % ScaledT::Divisor == 0) {
+      auto wholeValue = rawValue / ScaledT::Divisor;
+      if (fitsIntegral<std::int64_t>(wholeValue)) {
+        writeInteger(static_cast<std::int64_t>(wholeValue));
+        return;
+      }
+      if (fitsIntegral<std::uint64_t>(wholeValue)) {
+        writeUnsigned(static_cast<std::uint64_t>(wholeValue));
+        return;
+      }
+    }
+    writeString(value.toString());
+  }
+
+  template <typename T> void writeEncodedValue(const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      _output.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      appendBigEndian(0xcb, std::bit_cast<std::uint64_t>(double(value)), 8);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+      writeInteger(value);
+    } else if constexpr (std::is_integral_v<T>) {
+      writeUnsigned(value);
+    } else if constexpr (std::convertible_to<T, std::string_view>) {
+      writeString(value);
+    } else {
+      std::ostringstream text;
+      text << value;
+      writeString(text.view());
+    }
+  }
+
+};
+
+template <typename T, typename... FormatArgs>
+void encodeToMsgPack(const T &mopedObject, std::string &output,
+                     FormatArgs...) {
+  MsgPackEmitterContext<FormatArgs...> context(output);
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<FormatArgs...>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+}
+
+template <typename T, typename... FormatArgs>
+void encodeToMsgPackStream(const T &mopedObject, std::ostream &output,
+                           FormatArgs... args) {
+  std::string encoded;
+  encodeToMsgPack(mopedObject, encoded, args...);
+  output.write(encoded.data(), encoded.size());
+}
+
+template <typename T, typename... FormatArgs>
+std::string encodeToMsgPackString(const T &mopedObject, FormatArgs... args) {
+  std::string encoded;
+  encodeToMsgPack(mopedObject, encoded, args...);
+  return encoded;
+}
+
+// Appends only what changed in 'mopedObject' since 'baseline', in the form
+// mergeCompositeFromMsgPack applies back onto the baseline. On failure, for
+// changes the members' merge policies can't reproduce, 'output' is left as
+// it was.
+template <typename T, typename... FormatArgs>
+Expected encodeDeltaToMsgPack(const T &mopedObject, const T &baseline,
+                              std::string &output, FormatArgs...) {
+  auto initialSize = output.size();
+  MsgPackEmitterContext<FormatArgs...> context(output);
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<FormatArgs...>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  auto result = handler.applyDeltaEmitterContext(context, baseline);
+  if (!result) {
+    output.resize(initialSize);
+    return std::unexpected(result.error().memorySafe());
+  }
+  return {};
+}
+
+} // namespace moped
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "moped/BinaryParseEvents.hpp"
+#include "moped/concepts.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace moped {
+
+// Decodes MessagePack documents into the same parse events produced by the
+// JSON parsers. Maps become objects and must use string keys, strings are
+// delivered as views into the source buffer. Numbers are delivered already
+// decoded to dispatchers supporting onIntegerValue/onUnsignedValue/
+// onFloatValue and as text through onNumericValue to all others.
+//
+// Root arrays follow the JSON parser convention, the top level mapping must
+// map an empty string member id to a collection.
+template <IParserEventDispatchC ParseEventDispatchT> class MsgPackParser {
+  using ExpectedSize = std::expected<std::uint32_t, ParseError>;
+
+  struct Container {
+    std::uint32_t remaining;
+    bool isMap;
+  };
+
+  ParseEventDispatchT &_eventDispatch;
+  std::vector<Container> _containers;
+  const std::uint8_t *_position{nullptr};
+  const std::uint8_t *_end{nullptr};
+
+  bool available(std::size_t size) const {
+    return static_cast<std::size_t>(_end - _position) >= size;
+  }
+
+  template <typename T> T readBigEndian() {
+    using UnsignedT = std::conditional_t<
+        sizeof(T) == 8, std::uint64_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                           std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                                              std::uint8_t>>>;
+    UnsignedT value = 0;
+    for (std::size_t index = 0; index < sizeof(T); ++index) {
+      value = static_cast<UnsignedT>((value << 8) | *_position++);
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+      return std::bit_cast<T>(value);
+    } else {
+      return static_cast<T>(value);
+    }
+  }
+
+  template <typename SizeT> ExpectedSize readSize() {
+    if (!available(sizeof(SizeT))) {
+      return std::unexpected("Truncated MessagePack length");
+    }
+    return readBigEndian<SizeT>();
+  }
+
+  std::expected<std::string_view, ParseError> readText(std::uint32_t size) {
+    if (!available(size)) {
+      return std::unexpected("Truncated MessagePack string");
+    }
+    std::string_view text{reinterpret_cast<const char *>(_position), size};
+    _position += size;
+    return text;
+  }
+
+  // Reads the string following a str marker
+  std::expected<std::string_view, ParseError> readString(std::uint8_t marker) {
+    ExpectedSize size = static_cast<std::uint32_t>(marker & 0x1f);
+    switch (marker) {
+    case 0xd9:
+      size = readSize<std::uint8_t>();
+      break;
+    case 0xda:
+      size = readSize<std::uint16_t>();
+      break;
+    case 0xdb:
+      size = readSize<std::uint32_t>();
+      break;
+    default:
+      if ((marker & 0xe0) != 0xa0) {
+        return std::unexpected(
+            ParseError{"MessagePack map keys must be strings", char(marker)});
+      }
+    }
+    if (!size) {
+      return std::unexpected(size.error());
+    }
+    return readText(*size);
+  }
+
+  template <typename T> Expected readNumber() {
+    if (!available(sizeof(T))) {
+      return std::unexpected("Truncated MessagePack number");
+    }
+    auto value = readBigEndian<T>();
+    if constexpr (std::is_floating_point_v<T>) {
+      return dispatchNumericValue(_eventDispatch, static_cast<double>(value));
+    } else if constexpr (std::is_signed_v<T>) {
+      return dispatchNumericValue(_eventDispatch,
+                                  static_cast<std::int64_t>(value));
+    } else {
+      return dispatchNumericValue(_eventDispatch,
+                                  static_cast<std::uint64_t>(value));
+    }
+  }
+
+  Expected openContainer(ExpectedSize size, bool isMap) {
+    if (!size) {
+      return std::unexpected(size.error());
+    }
+    auto result =
+        isMap ? _eventDispatch.onObjectStart() : _eventDispatch.onArrayStart();
+    if (!result) {
+      return result;
+    }
+    _containers.push_back(Container{*size, isMap});
+    return {};
+  }
+
+  Expected parseValue() {
+    if (!available(1)) {
+      return std::unexpected("Unexpected end of MessagePack document");
+    }
+    std::uint8_t marker = *_position++;
+    if (marker <= 0x7f) {
+      return dispatchNumericValue(_eventDispatch,
+                                  static_cast<std::uint64_t>(marker));
+    }
+    if (marker >= 0xe0) {
+      return dispatchNumericValue(
+          _eventDispatch,
+          static_cast<std::int64_t>(static_cast<std::int8_t>(marker)));
+    }
+    if ((marker & 0xf0) == 0x80) {
+      return openContainer(static_cast<std::uint32_t>(marker & 0x0f), true);
+    }
+    if ((marker & 0xf0) == 0x90) {
+      return openContainer(static_cast<std::uint32_t>(marker & 0x0f), false);
+    }
+    switch (marker) {
+    case 0xc0:
+      return _eventDispatch.onNullValue();
+    case 0xc2:
+      return _eventDispatch.onBooleanValue(false);
+    case 0xc3:
+      return _eventDispatch.onBooleanValue(true);
+    case 0xca:
+      return readNumber<float>();
+    case 0xcb:
+      return readNumber<double>();
+    case 0xcc:
+      return readNumber<std::uint8_t>();
+    case 0xcd:
+      return readNumber<std::uint16_t>();
+    case 0xce:
+      return readNumber<std::uint32_t>();
+    case 0xcf:
+      return readNumber<std::uint64_t>();
+    case 0xd0:
+      return readNumber<std::int8_t>();
+    case 0xd1:
+      return readNumber<std::int16_t>();
+    case 0xd2:
+      return readNumber<std::int32_t>();
+    case 0xd3:
+      return readNumber<std::int64_t>();
+    case 0xdc:
+      return openContainer(readSize<std::uint16_t>(), false);
+    case 0xdd:
+      return openContainer(readSize<std::uint32_t>(), false);
+    case 0xde:
+      return openContainer(readSize<std::uint16_t>(), true);
+    case 0xdf:
+      return openContainer(readSize<std::uint32_t>(), true);
+    default:
+      break;
+    }
+    if ((marker & 0xe0) == 0xa0 || (marker >= 0xd9 && marker <= 0xdb)) {
+      auto text = readString(marker);
+      if (!text) {
+        return std::unexpected(text.error());
+      }
+      return _eventDispatch.onStringValue(*text);
+    }
+    return std::unexpected(ParseError{
+        "Unsupported MessagePack type, binary and extension values have no "
+        "moped mapping",
+        char(marker)});
+  }
+
+public:
+  MsgPackParser(ParseEventDispatchT &eventDispatch)
+      : _eventDispatch(eventDispatch) {}
+
+  Expected parse(std::string_view document) {
+    _position = reinterpret_cast<const std::uint8_t *>(document.data());
+    _end = _position + document.size();
+    _containers.clear();
+
+    if (!available(1)) {
+      return std::unexpected("Empty MessagePack document");
+    }
+    std::uint8_t marker = *_position;
+    bool isRootArray = (marker & 0xf0) == 0x90 || marker == 0xdc ||
+                       marker == 0xdd;
+    bool isRootMap = (marker & 0xf0) == 0x80 || marker == 0xde ||
+                     marker == 0xdf;
+    if (!isRootArray && !isRootMap) {
+      return std::unexpected(ParseError{
+          "Expected MessagePack map or array document", char(marker)});
+    }
+    if (isRootArray) {
+      auto result = _eventDispatch.onObjectStart();
+      if (!result) {
+        return result;
+      }
+      result = _eventDispatch.onMember("");
+      if (!result) {
+        return std::unexpected{
+            "MessagePack documents with root arrays require the top level "
+            "class object to map an empty string (\"\") member id to a moped "
+            "collection"};
+      }
+    }
+    if (auto result = parseValue(); !result) {
+      return result;
+    }
+
+    while (!_containers.empty()) {
+      auto &container = _containers.back();
+      if (container.remaining == 0) {
+        bool isMap = container.isMap;
+        _containers.pop_back();
+        auto result = isMap ? _eventDispatch.onObjectFinish()
+                            : _eventDispatch.onArrayFinish();
+        if (!result) {
+          return result;
+        }
+        continue;
+      }
+      --container.remaining;
+      if (container.isMap) {
+        if (!available(1)) {
+          return std::unexpected("Unexpected end of MessagePack document");
+        }
+        auto memberName = readString(*_position++);
+        if (!memberName) {
+          return std::unexpected(memberName.error());
+        }
+        if (auto result = _eventDispatch.onMember(*memberName); !result) {
+          return result;
+        }
+      }
+      if (auto result = parseValue(); !result) {
+        return result;
+      }
+    }
+
+    if (isRootArray) {
+      if (auto result = _eventDispatch.onObjectFinish(); !result) {
+        return result;
+      }
+    }
+    if (_position != _end) {
+      return std::unexpected("Unexpected data after MessagePack document");
+    }
+    return {};
+  }
+
+  auto &getDispatcher() { return _eventDispatch; }
+};
+
+} // namespace moped
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "moped/concepts.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace moped {
+
+enum class ParseEventKind : std::uint8_t {
+  Member,
+  ObjectStart,
+  ObjectFinish,
+  ArrayStart,
+  ArrayFinish,
+  StringValue,
+  NumericValue,
+  BooleanValue,
+  NullValue
+};
+
+// Compact binary record of parser events. The tape is itself a parser event
+// dispatcher so any parser can write to it, and it replays into any number of
+// dispatchers in a single pass, letting one tokenization feed several
+// composite types.
+//
+// Events are stored back to back in one flat buffer as [kind] for structural
+// events, [kind][bool] for booleans and [kind][u32 length][bytes] for text.
+// Text normally is copied into the buffer which makes the tape self contained
+// and suitable for bytes()/loadBytes() storage. Tapes that don't copy text
+// instead store [kind|ExternalText][u32 length][pointer] referencing the
+// parser's source, which is only valid while that source is alive and cannot
+// be exported. Lengths are little endian so exported tapes load on any host.
+// clear() keeps the buffer's capacity.
+
+class ParseEventTape {
+  static constexpr std::uint8_t ExternalText = 0x80;
+  static constexpr std::uint8_t LastKind =
+      static_cast<std::uint8_t>(ParseEventKind::NullValue);
+
+public:
+  explicit ParseEventTape(bool copiesText = true) : _copiesText(copiesText) {}
+
+  void setCopiesText(bool copiesText) { _copiesText = copiesText; }
+
+  Expected onMember(std::string_view memberName) {
+    return recordText(ParseEventKind::Member, memberName);
+  }
+  Expected onObjectStart() { return record(ParseEventKind::ObjectStart); }
+  Expected onObjectFinish() { return record(ParseEventKind::ObjectFinish); }
+  Expected onArrayStart() { return record(ParseEventKind::ArrayStart); }
+  Expected onArrayFinish() { return record(ParseEventKind::ArrayFinish); }
+  Expected onStringValue(std::string_view value) {
+    return recordText(ParseEventKind::StringValue, value);
+  }
+  Expected onNumericValue(std::string_view value) {
+    return recordText(ParseEventKind::NumericValue, value);
+  }
+  Expected onBooleanValue(bool value) {
+    record(ParseEventKind::BooleanValue);
+    _buffer.push_back(value ? 1 : 0);
+    return {};
+  }
+  Expected onNullValue() { return record(ParseEventKind::NullValue); }
+
+  // Drives every dispatcher with each event before moving to the next one,
+  // stops at the first dispatcher error.
+  template <IParserEventDispatchC... ParseEventDispatchT>
+  Expected replay(ParseEventDispatchT &...eventDispatch) const {
+    std::size_t position = 0;
+    while (position < _buffer.size()) {
+      auto kind = static_cast<ParseEventKind>(
+          static_cast<std::uint8_t>(_buffer[position]) & ~ExternalText);
+      bool external = static_cast<std::uint8_t>(_buffer[position]) &
+                      ExternalText;
+      ++position;
+
+      Expected result;
+      switch (kind) {
+      case ParseEventKind::Member:
+      case ParseEventKind::StringValue:
+      case ParseEventKind::NumericValue: {
+        auto text = readText(position, external);
+        result = dispatchTextEvent(kind, text, eventDispatch...);
+        break;
+      }
+      case ParseEventKind::BooleanValue: {
+        bool value = _buffer[position++] != 0;
+        result = dispatchEvent([value](auto &dispatch) {
+          return dispatch.onBooleanValue(value);
+        }, eventDispatch...);
+        break;
+      }
+      default:
+        result = dispatchStructuralEvent(kind, eventDispatch...);
+      }
+      if (!result) {
+        return result;
+      }
+    }
+    return {};
+  }
+
+  void clear() {
+    _buffer.clear();
+    _eventCount = 0;
+    _hasExternalText = false;
+  }
+
+  bool empty() const { return _buffer.empty(); }
+  std::size_t eventCount() const { return _eventCount; }
+
+  // Flat encoding of a self contained tape, empty when events reference text
+  // outside the tape
+  std::span<const char> bytes() const {
+    if (_hasExternalText) {
+      return {};
+    }
+    return {_buffer.data(), _buffer.size()};
+  }
+
+  // Replaces the tape content with a previously exported encoding after
+  // validating every record
+  Expected loadBytes(std::span<const char> encoded) {
+    std::size_t eventCount = 0;
+    for (std::size_t position = 0; position < encoded.size(); ++eventCount) {
+      auto kind = static_cast<std::uint8_t>(encoded[position++]);
+      if (kind > LastKind) {
+        return std::unexpected(ParseError{
+            "Invalid event kind in encoded parse event tape", char(kind)});
+      }
+      switch (static_cast<ParseEventKind>(kind)) {
+      case ParseEventKind::Member:
+      case ParseEventKind::StringValue:
+      case ParseEventKind::NumericValue: {
+        if (encoded.size() - position < sizeof(std::uint32_t)) {
+          return std::unexpected("Truncated text length in parse event tape");
+        }
+        auto length = loadLength(encoded.data() + position);
+        position += sizeof(length);
+        if (encoded.size() - position < length) {
+          return std::unexpected("Truncated text in parse event tape");
+        }
+        position += length;
+        break;
+      }
+      case ParseEventKind::BooleanValue:
+        if (position++ == encoded.size()) {
+          return std::unexpected("Truncated boolean in parse event tape");
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    _buffer.assign(encoded.begin(), encoded.end());
+    _eventCount = eventCount;
+    _hasExternalText = false;
+    return {};
+  }
+
+private:
+  Expected record(ParseEventKind kind) {
+    _buffer.push_back(static_cast<char>(kind));
+    ++_eventCount;
+    return {};
+  }
+
+  Expected recordText(ParseEventKind kind, std::string_view text) {
+    auto length = static_cast<std::uint32_t>(text.size());
+    auto position = _buffer.size();
+    if (!_copiesText) {
+      const char *source = text.data();
+      _buffer.resize(position + 1 + sizeof(length) + sizeof(source));
+      _buffer[position] = static_cast<char>(
+          static_cast<std::uint8_t>(kind) | ExternalText);
+      storeLength(&_buffer[position + 1], length);
+      std::memcpy(&_buffer[position + 1 + sizeof(length)], &source,
+                  sizeof(source));
+      _hasExternalText = true;
+    } else {
+      _buffer.resize(position + 1 + sizeof(length) + length);
+      _buffer[position] = static_cast<char>(kind);
+      storeLength(&_buffer[position + 1], length);
+      std::memcpy(&_buffer[position + 1 + sizeof(length)], text.data(),
+                  length);
+    }
+    ++_eventCount;
+    return {};
+  }
+
+  static void storeLength(char *target, std::uint32_t length) {
+    if constexpr (std::endian::native == std::endian::big) {
+      length = std::byteswap(length);
+    }
+    std::memcpy(target, &length, sizeof(length));
+  }
+
+  static std::uint32_t loadLength(const char *source) {
+    std::uint32_t length;
+    std::memcpy(&length, source, sizeof(length));
+    if constexpr (std::endian::native == std::endian::big) {
+      length = std::byteswap(length);
+    }
+    return length;
+  }
+
+  std::string_view readText(std::size_t &position, bool external) const {
+    auto length = loadLength(&_buffer[position]);
+    position += sizeof(length);
+    if (external) {
+      const char *source;
+      std::memcpy(&source, &_buffer[position], sizeof(source));
+      position += sizeof(source);
+      return {source, length};
+    }
+    std::string_view text{&_buffer[position], length};
+    position += length;
+    return text;
+  }
+
+  static Expected dispatchEvent(auto &&event, auto &...eventDispatch) {
+    Expected result;
+    ((result = event(eventDispatch)) && ...);
+    return result;
+  }
+
+  static Expected dispatchTextEvent(ParseEventKind kind, std::string_view text,
+                                    auto &...eventDispatch) {
+    switch (kind) {
+    case ParseEventKind::Member:
+      return dispatchEvent(
+          [text](auto &dispatch) { return dispatch.onMember(text); },
+          eventDispatch...);
+    case ParseEventKind::StringValue:
+      return dispatchEvent(
+          [text](auto &dispatch) { return dispatch.onStringValue(text); },
+          eventDispatch...);
+    default:
+      return dispatchEvent(
+          [text](auto &dispatch) { return dispatch.onNumericValue(text); },
+          eventDispatch...);
+    }
+  }
+
+  static Expected dispatchStructuralEvent(ParseEventKind kind,
+                                          auto &...eventDispatch) {
+    switch (kind) {
+    case ParseEventKind::ObjectStart:
+      return dispatchEvent(
+          [](auto &dispatch) { return dispatch.onObjectStart(); },
+          eventDispatch...);
+    case ParseEventKind::ObjectFinish:
+      return dispatchEvent(
+          [](auto &dispatch) { return dispatch.onObjectFinish(); },
+          eventDispatch...);
+    case ParseEventKind::ArrayStart:
+      return dispatchEvent(
+          [](auto &dispatch) { return dispatch.onArrayStart(); },
+          eventDispatch...);
+    case ParseEventKind::ArrayFinish:
+      return dispatchEvent(
+          [](auto &dispatch) { return dispatch.onArrayFinish(); },
+          eventDispatch...);
+    case ParseEventKind::NullValue:
+      return dispatchEvent(
+          [](auto &dispatch) { return dispatch.onNullValue(); },
+          eventDispatch...);
+    default:
+      return std::unexpected(
+          "Parse error!!! Corrupt event on parse event tape");
+    }
+  }
+
+  std::vector<char> _buffer;
+  std::size_t _eventCount{0};
+  bool _copiesText;
+  bool _hasExternalText{false};
+};
+
+static_assert(IParserEventDispatchC<ParseEventTape>,
+              "ParseEventTape should satisfy IParserEventDispatchC concept");
+
+} // namespace moped
@@ -1,6 +1,7 @@
 #pragma once
 #include <regex>
 #include <string>
+#include <string_view>
 
 namespace moped {
 
@@ -28,6 +29,47 @@ protected:
            std::regex_match(text, floatPattern);
   }
 
+  // Matches the same integer and decimal forms as isNumeric without
+  // allocating, for scalars already delimited in the input
+  static bool isNumericText(std::string_view text) {
+    std::size_t position = 0;
+    auto digits = [&]() {
+      auto start = position;
+      while (position < text.size() && text[position] >= '0' &&
+             text[position] <= '9') {
+        ++position;
+      }
+      return position - start;
+    };
+    if (position < text.size() &&
+        (text[position] == '+' || text[position] == '-')) {
+      ++position;
+    }
+    auto integerDigits = digits();
+    if (position == text.size()) {
+      return integerDigits > 0;
+    }
+    if (text[position] != '.') {
+      return false;
+    }
+    ++position;
+    if (digits() == 0) {
+      return false;
+    }
+    if (position < text.size() &&
+        (text[position] == 'e' || text[position] == 'E')) {
+      ++position;
+      if (position < text.size() &&
+          (text[position] == '+' || text[position] == '-')) {
+        ++position;
+      }
+      if (digits() == 0) {
+        return false;
+      }
+    }
+    return position == text.size();
+  }
+
   static bool isIdentifier(const std::string &text) {
     return std::regex_match(text, identifierPattern);
   }
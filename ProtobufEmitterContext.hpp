@@ -0,0 +1,335 @@
+#pragma once
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/ProtobufTypes.hpp"
+#include "moped/concepts.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moped {
+
+// Emitter context encoding moped composites mapped with
+// ProtobufDecodingTraits in the protobuf wire format. Repeated scalars are
+// written packed, other repeated members as one record per element.
+// Lengths of nested messages and packed fields are only known once they
+// finish, so each is written with a placeholder of MaxLengthSize bytes. As
+// each finishes its final length is recorded, net of the bytes its own
+// nested placeholders will give back, and when the root message finishes
+// the buffer is compacted in one pass writing every length in its shortest
+// varint. Every mapped value is written, including zero values. The context
+// owns its buffer and is intended to be reused for every message.
+class ProtobufEmitterContext {
+public:
+  static constexpr std::size_t MaxLengthSize = 5;
+
+  void onObjectStart(std::optional<std::uint32_t> memberId = std::nullopt) {
+    if (_frames.empty()) {
+      beginMessage();
+      _frames.push_back(Frame{FrameKind::Message});
+    } else if (_frames.back().kind == FrameKind::Array) {
+      if (_frames.back().header == NoHeader) {
+        openLength(_frames.back().memberId);
+        _frames.push_back(Frame{FrameKind::Message, 0, _headers.size() - 1});
+      } else {
+        fail("Protobuf repeated fields can't mix messages and scalars",
+             _frames.back().memberId);
+        _frames.push_back(Frame{FrameKind::Embedded});
+      }
+    } else if (memberId.value_or(protobuf::InvalidMemberId) ==
+               ProtobufDecodingTraits<>::EmbeddingMemberId) {
+      _frames.push_back(Frame{FrameKind::Embedded});
+    } else {
+      openLength(memberId.value_or(protobuf::InvalidMemberId));
+      _frames.push_back(Frame{FrameKind::Message, 0, _headers.size() - 1});
+    }
+  }
+
+  void onObjectFinish() {
+    closeFrame();
+    if (_frames.empty()) {
+      finishMessage();
+    }
+  }
+
+  void onArrayStart(std::optional<std::uint32_t> memberId) {
+    _frames.push_back(
+        Frame{FrameKind::Array, memberId.value_or(protobuf::InvalidMemberId)});
+  }
+
+  void onArrayValueEntry(const auto &value) {
+    auto &frame = _frames.back();
+    auto kind = valueKind(frame.memberId, value);
+    if (!kind) {
+      return;
+    }
+    if (protobuf::isPackable(*kind)) {
+      if (frame.header == NoHeader) {
+        openLength(frame.memberId);
+        frame.header = _headers.size() - 1;
+      }
+    } else {
+      writeKey(frame.memberId, protobuf::wireType(*kind));
+    }
+    writePayload(*kind, value);
+  }
+
+  void onArrayFinish() { closeFrame(); }
+
+  void onObjectValueEntry(std::uint32_t memberId, const auto &value) {
+    auto kind = valueKind(memberId, value);
+    if (!kind) {
+      return;
+    }
+    writeKey(memberId, protobuf::wireType(*kind));
+    writePayload(*kind, value);
+  }
+
+  template <typename T>
+  void onObjectValueEntry(std::uint32_t memberId,
+                          const std::optional<T> &value) {
+    if (!value.has_value()) {
+      return; // Absent fields are omitted
+    }
+    onObjectValueEntry(memberId, value.value());
+  }
+
+  // The last encoded message, valid until the next message is started
+  std::expected<std::string_view, ParseError> getMessage() const {
+    if (_error) {
+      return std::unexpected(*_error);
+    }
+    if (!_frames.empty() || !_complete) {
+      return std::unexpected(
+          ParseError{"Protobuf message encoding incomplete"});
+    }
+    return std::string_view{_buffer.data(), _size};
+  }
+
+private:
+  static constexpr std::size_t NoHeader = static_cast<std::size_t>(-1);
+
+  enum class FrameKind : std::uint8_t { Message, Embedded, Array };
+
+  // Messages and packed arrays own a length placeholder, 'shrink' sums the
+  // bytes their nested placeholders give back when compacted
+  struct Frame {
+    FrameKind kind;
+    std::uint32_t memberId{0};
+    std::size_t header{NoHeader};
+    std::size_t shrink{0};
+  };
+
+  struct Header {
+    std::size_t offset;
+    std::size_t length{0};
+  };
+
+  void fail(const char *message, std::uint32_t memberId) {
+    if (!_error) {
+      _error = ParseError{
+          message, ProtobufDecodingTraits<>::getDisplayName(memberId)};
+    }
+  }
+
+  template <typename T>
+  std::optional<protobuf::ValueKind> valueKind(std::uint32_t memberId,
+                                               const T &) {
+    if (_error) {
+      return std::nullopt;
+    }
+    if (memberId == protobuf::InvalidMemberId) {
+      fail("Protobuf member names must be field numbers", memberId);
+      return std::nullopt;
+    }
+    auto kind = protobuf::valueKind<T>(protobuf::encoding(memberId));
+    if (!kind) {
+      fail(kind.error().message, memberId);
+      return std::nullopt;
+    }
+    return *kind;
+  }
+
+  char *reserve(std::size_t size) {
+    if (_size + size > _buffer.size()) {
+      _buffer.resize(std::max(_buffer.size() * 2, _size + size));
+    }
+    return _buffer.data() + _size;
+  }
+
+  void commit(char *end) {
+    _size = static_cast<std::size_t>(end - _buffer.data());
+  }
+
+  void writeVarint(std::uint64_t value) {
+    commit(protobuf::writeVarint(reserve(protobuf::MaxVarintSize), value));
+  }
+
+  void writeKey(std::uint32_t memberId, protobuf::WireType wireType) {
+    writeVarint(static_cast<std::uint64_t>(protobuf::fieldNumber(memberId))
+                    << 3 |
+                static_cast<std::uint64_t>(wireType));
+  }
+
+  template <typename T> void writeFixed(T value) {
+    if constexpr (std::endian::native == std::endian::big) {
+      value = std::byteswap(value);
+    }
+    char *target = reserve(sizeof(T));
+    std::memcpy(target, &value, sizeof(T));
+    commit(target + sizeof(T));
+  }
+
+  void writeText(std::string_view text) {
+    writeVarint(text.size());
+    char *target = reserve(text.size());
+    std::memcpy(target, text.data(), text.size());
+    commit(target + text.size());
+  }
+
+  template <typename IntegralT>
+  void writeInteger(protobuf::ValueKind kind, IntegralT value) {
+    switch (kind) {
+    case protobuf::ValueKind::SInt:
+      return writeVarint(
+          protobuf::zigzagEncode(static_cast<std::int64_t>(value)));
+    case protobuf::ValueKind::Fixed32:
+    case protobuf::ValueKind::SFixed32:
+      return writeFixed(static_cast<std::uint32_t>(value));
+    case protobuf::ValueKind::Fixed64:
+    case protobuf::ValueKind::SFixed64:
+      return writeFixed(static_cast<std::uint64_t>(value));
+    default:
+      // Negative values are sign extended to ten bytes, as int32 requires
+      return writeVarint(static_cast<std::uint64_t>(
+          static_cast<std::conditional_t<std::is_signed_v<IntegralT>,
+                                         std::int64_t, std::uint64_t>>(
+              value)));
+    }
+  }
+
+  // google.protobuf.Timestamp, zero fields are omitted
+  void writeTimestamp(TimePoint value) {
+    using namespace std::chrono;
+    auto sinceEpoch = duration_cast<nanoseconds>(value.time_since_epoch());
+    auto epochSeconds = floor<seconds>(sinceEpoch);
+    auto nanos = (sinceEpoch - epochSeconds).count();
+    auto secondsValue = static_cast<std::uint64_t>(epochSeconds.count());
+    std::size_t length =
+        (secondsValue != 0 ? 1 + protobuf::varintSize(secondsValue) : 0) +
+        (nanos != 0 ? 1 + protobuf::varintSize(nanos) : 0);
+    writeVarint(length);
+    if (secondsValue != 0) {
+      writeVarint(1 << 3);
+      writeVarint(secondsValue);
+    }
+    if (nanos != 0) {
+      writeVarint(2 << 3);
+      writeVarint(static_cast<std::uint64_t>(nanos));
+    }
+  }
+
+  template <typename T>
+  void writePayload(protobuf::ValueKind kind, const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      writeVarint(value ? 1 : 0);
+    } else if constexpr (is_mapped_enum<T>) {
+      writeInteger(kind, static_cast<typename protobuf::WireIntegral<T>::type>(
+                             value.getEnumValue()));
+    } else if constexpr (std::is_integral_v<T>) {
+      writeInteger(kind, value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      if (kind == protobuf::ValueKind::Float) {
+        writeFixed(std::bit_cast<std::uint32_t>(static_cast<float>(value)));
+      } else {
+        writeFixed(std::bit_cast<std::uint64_t>(static_cast<double>(value)));
+      }
+    } else if constexpr (std::is_same_v<T, TimePoint>) {
+      writeTimestamp(value);
+    } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+      writeText(value);
+    } else {
+      std::ostringstream text;
+      text << value;
+      writeText(text.view());
+    }
+  }
+
+  void openLength(std::uint32_t memberId) {
+    if (!_error && memberId == protobuf::InvalidMemberId) {
+      fail("Protobuf member names must be field numbers", memberId);
+    }
+    writeKey(memberId, protobuf::WireType::Len);
+    _headers.push_back(Header{_size});
+    commit(reserve(MaxLengthSize) + MaxLengthSize);
+  }
+
+  void closeFrame() {
+    auto frame = _frames.back();
+    _frames.pop_back();
+    auto shrink = frame.shrink;
+    if (frame.header != NoHeader) {
+      auto &header = _headers[frame.header];
+      header.length = _size - header.offset - MaxLengthSize - frame.shrink;
+      shrink += MaxLengthSize - protobuf::varintSize(header.length);
+    }
+    if (!_frames.empty()) {
+      _frames.back().shrink += shrink;
+    }
+  }
+
+  void beginMessage() {
+    _size = 0;
+    _headers.clear();
+    _error.reset();
+    _complete = false;
+  }
+
+  // Lengths never grow, so the write position can't overtake the read
+  // position and the message is compacted in place
+  void finishMessage() {
+    _complete = true;
+    if (_error || _headers.empty()) {
+      return;
+    }
+    auto write = _headers.front().offset;
+    auto read = write;
+    for (auto &header : _headers) {
+      std::memmove(&_buffer[write], &_buffer[read], header.offset - read);
+      write += header.offset - read;
+      write = static_cast<std::size_t>(
+          protobuf::writeVarint(&_buffer[write], header.length) -
+          _buffer.data());
+      read = header.offset + MaxLengthSize;
+    }
+    std::memmove(&_buffer[write], &_buffer[read], _size - read);
+    _size = write + _size - read;
+  }
+
+  std::string _buffer;
+  std::size_t _size{0};
+  std::vector<Frame> _frames;
+  std::vector<Header> _headers;
+  std::optional<ParseError> _error;
+  bool _complete{false};
+};
+
+// Time points are written as Timestamp messages, so the time point
+// formatter of the decoding traits doesn't take part in encoding
+template <typename T>
+std::expected<std::string_view, ParseError>
+encodeToProtobuf(const T &mopedObject, ProtobufEmitterContext &context) {
+  auto handler = getMOPEDHandlerForParser<T, ProtobufDecodingTraits<>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+  return context.getMessage();
+}
+
+} // namespace moped
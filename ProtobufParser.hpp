@@ -0,0 +1,467 @@
+#pragma once
+
+#include "moped/BinaryParseEvents.hpp"
+#include "moped/ProtobufSchema.hpp"
+#include "moped/ProtobufTypes.hpp"
+#include "moped/concepts.hpp"
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace moped {
+
+template <typename T>
+concept IProtobufEventDispatchC =
+    IParserEventDispatchC<T> && requires(T t) {
+      { t.onMember(std::uint32_t{}) } -> std::same_as<Expected>;
+      { t.onArraySizeHint(std::size_t{}) } -> std::same_as<Expected>;
+    };
+
+// Parses one protobuf wire format message into parse events with integer
+// member ids. Fields are resolved by number through the schema's per message
+// tables and decoded according to the mapped member rather than the wire
+// alone, e.g. zigzag varints and fixed width integers. Fields the mapping
+// doesn't know are skipped by wire type. Repeated scalars are accepted
+// packed or one record per value, consecutive records of one repeated field
+// are delivered as a single array, packed arrays are preceded by their
+// element count as a size hint.
+template <IProtobufEventDispatchC ParseEventDispatchT> class ProtobufParser {
+  using Field = protobuf::Field;
+  using ValueKind = protobuf::ValueKind;
+  using WireType = protobuf::WireType;
+
+  // Nested messages are parsed recursively, bounded for hostile input
+  static constexpr int MaxDepth = 100;
+
+  static Expected truncated() {
+    return std::unexpected("Truncated protobuf message");
+  }
+
+  static Expected wireTypeMismatch(const Field &field) {
+    return std::unexpected(
+        ParseError{"Protobuf wire type doesn't match the mapped member",
+                   std::to_string(field.number)});
+  }
+
+  static std::expected<std::string_view, ParseError>
+  readLength(const char *&position, const char *end) {
+    std::uint64_t length;
+    if (!protobuf::readVarint(position, end, length) ||
+        length > static_cast<std::uint64_t>(end - position)) {
+      return std::unexpected("Truncated protobuf length delimited field");
+    }
+    std::string_view content{position, static_cast<std::size_t>(length)};
+    position += length;
+    return content;
+  }
+
+  template <typename T> static T loadFixed(const char *source) {
+    T value;
+    std::memcpy(&value, source, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+      using BitsT = std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                       std::uint64_t>;
+      value = std::bit_cast<T>(std::byteswap(std::bit_cast<BitsT>(value)));
+    }
+    return value;
+  }
+
+  static Expected skipField(const char *&position, const char *end,
+                            WireType wireType, int depth = 0) {
+    std::uint64_t value;
+    switch (wireType) {
+    case WireType::Varint:
+      return protobuf::readVarint(position, end, value) ? Expected{}
+                                                         : truncated();
+    case WireType::I64:
+      if (end - position < 8) {
+        return truncated();
+      }
+      position += 8;
+      return {};
+    case WireType::I32:
+      if (end - position < 4) {
+        return truncated();
+      }
+      position += 4;
+      return {};
+    case WireType::Len: {
+      auto content = readLength(position, end);
+      return content ? Expected{} : std::unexpected(content.error());
+    }
+    case WireType::StartGroup:
+      // Deprecated groups are skipped up to their matching end group key
+      if (depth == MaxDepth) {
+        return std::unexpected("Protobuf message nested too deeply");
+      }
+      while (position != end) {
+        std::uint64_t key;
+        if (!protobuf::readVarint(position, end, key)) {
+          return truncated();
+        }
+        auto nestedWireType = static_cast<WireType>(key & 7);
+        if (nestedWireType == WireType::EndGroup) {
+          return {};
+        }
+        if (auto result = skipField(position, end, nestedWireType, depth + 1);
+            !result) {
+          return result;
+        }
+      }
+      return truncated();
+    default:
+      return std::unexpected(ParseError{"Invalid protobuf wire type",
+                                        static_cast<char>('0' + int(wireType))});
+    }
+  }
+
+  Expected dispatchVarint(ValueKind kind, std::uint64_t value) {
+    switch (kind) {
+    case ValueKind::Bool:
+      return _eventDispatch.onBooleanValue(value != 0);
+    case ValueKind::Int:
+      return dispatchNumericValue(_eventDispatch,
+                                  static_cast<std::int64_t>(value));
+    case ValueKind::SInt:
+      return dispatchNumericValue(_eventDispatch,
+                                  protobuf::zigzagDecode(value));
+    default:
+      return dispatchNumericValue(_eventDispatch, value);
+    }
+  }
+
+  Expected dispatchFixed(ValueKind kind, const char *source) {
+    switch (kind) {
+    case ValueKind::Fixed32:
+      return dispatchNumericValue(_eventDispatch,
+                                  loadFixed<std::uint32_t>(source));
+    case ValueKind::SFixed32:
+      return dispatchNumericValue(_eventDispatch,
+                                  loadFixed<std::int32_t>(source));
+    case ValueKind::Float:
+      return dispatchNumericValue(_eventDispatch,
+                                  double{loadFixed<float>(source)});
+    case ValueKind::Fixed64:
+      return dispatchNumericValue(_eventDispatch,
+                                  loadFixed<std::uint64_t>(source));
+    case ValueKind::SFixed64:
+      return dispatchNumericValue(_eventDispatch,
+                                  loadFixed<std::int64_t>(source));
+    default:
+      return dispatchNumericValue(_eventDispatch, loadFixed<double>(source));
+    }
+  }
+
+  // google.protobuf.Timestamp, seconds and non negative nanoseconds
+  Expected dispatchTimestamp(std::string_view content) {
+    std::int64_t epochSeconds = 0;
+    std::int64_t nanos = 0;
+    const char *position = content.data();
+    const char *end = position + content.size();
+    while (position != end) {
+      std::uint64_t key;
+      if (!protobuf::readVarint(position, end, key)) {
+        return truncated();
+      }
+      auto wireType = static_cast<WireType>(key & 7);
+      if ((key >> 3 == 1 || key >> 3 == 2) && wireType == WireType::Varint) {
+        std::uint64_t value;
+        if (!protobuf::readVarint(position, end, value)) {
+          return truncated();
+        }
+        (key >> 3 == 1 ? epochSeconds : nanos) =
+            static_cast<std::int64_t>(value);
+      } else if (auto result = skipField(position, end, wireType); !result) {
+        return result;
+      }
+    }
+    // Seconds are kept a second inside the range of the clock's duration so
+    // adding the nanoseconds can't overflow it
+    using Duration = TimePoint::duration;
+    constexpr auto MinSeconds =
+        std::chrono::duration_cast<std::chrono::seconds>(Duration::min())
+            .count() + 1;
+    constexpr auto MaxSeconds =
+        std::chrono::duration_cast<std::chrono::seconds>(Duration::max())
+            .count() - 1;
+    if (nanos < 0 || nanos > 999'999'999) {
+      return std::unexpected(ParseError{
+          "Protobuf Timestamp nanos outside [0, 999999999]",
+          std::to_string(nanos)});
+    }
+    if (epochSeconds < MinSeconds || epochSeconds > MaxSeconds) {
+      return std::unexpected(ParseError{
+          "Protobuf Timestamp seconds outside the range of TimePoint",
+          std::to_string(epochSeconds)});
+    }
+    return dispatchTimeValue(
+        _eventDispatch,
+        TimePoint{std::chrono::duration_cast<Duration>(
+                      std::chrono::seconds{epochSeconds}) +
+                  std::chrono::duration_cast<Duration>(
+                      std::chrono::nanoseconds{nanos})});
+  }
+
+  // Counts the varints of a packed field by their final bytes, the bytes
+  // with the continuation bit clear
+  static std::size_t countVarints(std::string_view content) {
+    std::size_t count = 0;
+    std::size_t position = 0;
+#if defined(__SSE2__)
+    for (; position + 16 <= content.size(); position += 16) {
+      auto chunk = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(content.data() + position));
+      count += 16 - std::popcount(static_cast<std::uint32_t>(
+                        _mm_movemask_epi8(chunk)));
+    }
+#endif
+    for (; position < content.size(); ++position) {
+      count += static_cast<std::uint8_t>(content[position]) < 0x80;
+    }
+    return count;
+  }
+
+  // Decodes one varint of up to eight bytes from an eight byte load, the
+  // length comes from the first clear continuation bit and the 7 bit groups
+  // are gathered in three shift and mask steps
+  static bool readShortVarint(const char *&position, std::uint64_t &value) {
+    std::uint64_t word;
+    std::memcpy(&word, position, sizeof(word));
+    auto stops = ~word & 0x8080808080808080ull;
+    if (stops == 0) {
+      return false;
+    }
+    auto length = static_cast<unsigned>(std::countr_zero(stops)) / 8 + 1;
+    if (length < 8) {
+      word &= (std::uint64_t{1} << (8 * length)) - 1;
+    }
+#if defined(__BMI2__)
+    value = _pext_u64(word, 0x7f7f7f7f7f7f7f7full);
+#else
+    word &= 0x7f7f7f7f7f7f7f7full;
+    word = (word & 0x007f007f007f007full) |
+           ((word & 0x7f007f007f007f00ull) >> 1);
+    word = (word & 0x00003fff00003fffull) |
+           ((word & 0x3fff00003fff0000ull) >> 2);
+    value = (word & 0x000000000fffffffull) |
+            ((word & 0x0fffffff00000000ull) >> 4);
+#endif
+    position += length;
+    return true;
+  }
+
+  Expected dispatchPackedVarints(ValueKind kind, std::string_view content) {
+    const char *position = content.data();
+    const char *end = position + content.size();
+    std::uint64_t value;
+    if constexpr (std::endian::native == std::endian::little) {
+      while (end - position >= 16) {
+#if defined(__SSE2__)
+        // Runs of single byte varints, small values, need no decoding
+        auto chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+        if (_mm_movemask_epi8(chunk) == 0) {
+          for (int index = 0; index < 16; ++index) {
+            if (auto result = dispatchVarint(
+                    kind, static_cast<std::uint8_t>(position[index]));
+                !result) {
+              return result;
+            }
+          }
+          position += 16;
+          continue;
+        }
+#endif
+        if (!readShortVarint(position, value) &&
+            !protobuf::readVarint(position, end, value)) {
+          return truncated();
+        }
+        if (auto result = dispatchVarint(kind, value); !result) {
+          return result;
+        }
+      }
+    }
+    while (position != end) {
+      if (!protobuf::readVarint(position, end, value)) {
+        return truncated();
+      }
+      if (auto result = dispatchVarint(kind, value); !result) {
+        return result;
+      }
+    }
+    return {};
+  }
+
+  Expected dispatchPacked(const Field &field, std::string_view content) {
+    auto wireType = protobuf::wireType(field.kind);
+    if (wireType == WireType::Varint) {
+      if (auto result = _eventDispatch.onArraySizeHint(countVarints(content));
+          !result) {
+        return result;
+      }
+      return dispatchPackedVarints(field.kind, content);
+    }
+    std::size_t size = wireType == WireType::I32 ? 4 : 8;
+    if (content.size() % size != 0) {
+      return std::unexpected(
+          ParseError{"Protobuf packed field length isn't a multiple of its "
+                     "element size",
+                     std::to_string(field.number)});
+    }
+    if (auto result = _eventDispatch.onArraySizeHint(content.size() / size);
+        !result) {
+      return result;
+    }
+    for (std::size_t offset = 0; offset < content.size(); offset += size) {
+      if (auto result = dispatchFixed(field.kind, content.data() + offset);
+          !result) {
+        return result;
+      }
+    }
+    return {};
+  }
+
+  Expected dispatchValue(const Field &field, WireType wireType,
+                         const char *&position, const char *end, int depth) {
+    if (wireType != protobuf::wireType(field.kind)) {
+      return wireTypeMismatch(field);
+    }
+    switch (wireType) {
+    case WireType::Varint: {
+      std::uint64_t value;
+      if (!protobuf::readVarint(position, end, value)) {
+        return truncated();
+      }
+      return dispatchVarint(field.kind, value);
+    }
+    case WireType::I32:
+    case WireType::I64: {
+      std::ptrdiff_t size = wireType == WireType::I32 ? 4 : 8;
+      if (end - position < size) {
+        return truncated();
+      }
+      position += size;
+      return dispatchFixed(field.kind, position - size);
+    }
+    default:
+      break;
+    }
+    auto content = readLength(position, end);
+    if (!content) {
+      return std::unexpected(content.error());
+    }
+    if (field.kind == ValueKind::Text) {
+      return _eventDispatch.onStringValue(*content);
+    }
+    if (field.kind == ValueKind::Timestamp) {
+      return dispatchTimestamp(*content);
+    }
+    if (auto result = _eventDispatch.onObjectStart(); !result) {
+      return result;
+    }
+    if (auto result = parseMessage(*content, field.message, depth + 1);
+        !result) {
+      return result;
+    }
+    return _eventDispatch.onObjectFinish();
+  }
+
+  Expected parseMessage(std::string_view content, std::int32_t messageIndex,
+                        int depth) {
+    if (depth == MaxDepth) {
+      return std::unexpected("Protobuf message nested too deeply");
+    }
+    auto &message = _schema.message(messageIndex);
+    const Field *openArray = nullptr;
+    const char *position = content.data();
+    const char *end = position + content.size();
+    while (position != end) {
+      std::uint64_t key;
+      if (!protobuf::readVarint(position, end, key)) {
+        return truncated();
+      }
+      auto number = key >> 3;
+      auto wireType = static_cast<WireType>(key & 7);
+      if (number == 0 || number > protobuf::MaxFieldNumber) {
+        return std::unexpected("Invalid protobuf field number");
+      }
+      auto field = message.find(static_cast<std::uint32_t>(number));
+      if (openArray != nullptr && field != openArray) {
+        openArray = nullptr;
+        if (auto result = _eventDispatch.onArrayFinish(); !result) {
+          return result;
+        }
+      }
+      if (field == nullptr) {
+        if (auto result = skipField(position, end, wireType); !result) {
+          return result;
+        }
+        continue;
+      }
+      if (openArray == nullptr) {
+        if (auto result = _eventDispatch.onMember(field->memberId); !result) {
+          return result;
+        }
+        if (field->repeated) {
+          if (auto result = _eventDispatch.onArrayStart(); !result) {
+            return result;
+          }
+          openArray = field;
+        }
+      }
+      if (field->repeated && wireType == WireType::Len &&
+          protobuf::isPackable(field->kind)) {
+        auto packed = readLength(position, end);
+        if (!packed) {
+          return std::unexpected(packed.error());
+        }
+        if (auto result = dispatchPacked(*field, *packed); !result) {
+          return result;
+        }
+      } else if (auto result =
+                     dispatchValue(*field, wireType, position, end, depth);
+                 !result) {
+        return result;
+      }
+    }
+    if (openArray != nullptr) {
+      return _eventDispatch.onArrayFinish();
+    }
+    return {};
+  }
+
+public:
+  ProtobufParser(ParseEventDispatchT &eventDispatch,
+                 const protobuf::Schema &schema)
+      : _eventDispatch(eventDispatch), _schema(schema) {}
+
+  // Protobuf messages aren't self delimiting, 'message' holds exactly one
+  Expected parse(std::string_view message) {
+    if (auto result = _eventDispatch.onObjectStart(); !result) {
+      return result;
+    }
+    if (auto result = parseMessage(message, 0, 0); !result) {
+      return result;
+    }
+    return _eventDispatch.onObjectFinish();
+  }
+
+  auto &getDispatcher() { return _eventDispatch; }
+
+private:
+  ParseEventDispatchT &_eventDispatch;
+  const protobuf::Schema &_schema;
+};
+
+} // namespace moped
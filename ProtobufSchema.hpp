@@ -0,0 +1,216 @@
+#pragma once
+
+#include "moped/MemberIndexTable.hpp"
+#include "moped/ProtobufTypes.hpp"
+#include "moped/concepts.hpp"
+#include <cstdint>
+#include <expected>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace moped {
+
+namespace protobuf {
+
+// Element type of a repeated member, mapped enum flags travel as the names
+// of the set flags
+template <typename T> struct RepeatedValue {
+  using type = typename T::value_type;
+};
+
+template <typename T>
+  requires std::is_array_v<T>
+struct RepeatedValue<T> {
+  using type = std::remove_extent_t<T>;
+};
+
+template <is_mapped_enum_flag T> struct RepeatedValue<T> {
+  using type = std::string_view;
+};
+
+// A mapped member as seen on the wire. Repeated fields are collections of
+// 'kind' values, message fields refer to the schema message describing
+// their content.
+struct Field {
+  std::uint32_t number;
+  std::uint32_t memberId;
+  ValueKind kind;
+  bool repeated{false};
+  std::int32_t message{-1};
+};
+
+// The fields of one message type, found by field number through a member
+// index table, field numbers beyond the table are searched linearly
+class Message {
+public:
+  const Field *find(std::uint32_t number) const {
+    auto index = _index.find(number);
+    if (index != MemberIndexTable::NotFound) {
+      return &_fields[index];
+    }
+    if (number > MemberIndexTable::MaxTableId) {
+      for (auto &field : _fields) {
+        if (field.number == number) {
+          return &field;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  bool add(const Field &field) {
+    if (find(field.number) != nullptr) {
+      return false;
+    }
+    _index.add(field.number, static_cast<std::uint16_t>(_fields.size()));
+    _fields.push_back(field);
+    return true;
+  }
+
+  const std::vector<Field> &fields() const { return _fields; }
+
+private:
+  std::vector<Field> _fields;
+  MemberIndexTable _index;
+};
+
+// Message types of a composite's moped mapping resolved once, message 0
+// describes the composite itself. Composite members and collections of
+// composites become nested messages, embedded members ("") publish their
+// fields into the enclosing message. Each composite type is described once,
+// so recursive types refer back to their own message.
+class Schema {
+public:
+  const Message &message(std::int32_t index) const { return _messages[index]; }
+
+  template <typename CompositeT, DecodingTraitsC DecodingTraits>
+  static std::expected<Schema, ParseError> create() {
+    Schema schema;
+    if (auto result = schema.messageFor<CompositeT, DecodingTraits>();
+        !result) {
+      return std::unexpected(result.error());
+    }
+    return schema;
+  }
+
+private:
+  template <typename T> static const void *typeKey() {
+    static const char key{};
+    return &key;
+  }
+
+  template <typename CompositeT, DecodingTraitsC DecodingTraits>
+  std::expected<std::int32_t, ParseError> messageFor() {
+    for (auto &[key, index] : _messageTypes) {
+      if (key == typeKey<CompositeT>()) {
+        return index;
+      }
+    }
+    auto index = static_cast<std::int32_t>(_messages.size());
+    _messages.emplace_back();
+    _messageTypes.emplace_back(typeKey<CompositeT>(), index);
+    if (auto result = addComposite<CompositeT, DecodingTraits>(index);
+        !result) {
+      return std::unexpected(result.error());
+    }
+    return index;
+  }
+
+  template <typename CompositeT, DecodingTraitsC DecodingTraits>
+  Expected addComposite(std::int32_t messageIndex) {
+    auto mopedHandler = getMOPEDHandlerForParser<CompositeT, DecodingTraits>();
+    Expected result;
+    mopedHandler.forEachMemberMapping([&](auto, const auto &mapping) {
+      if (result) {
+        result = addMember<typename std::decay_t<decltype(mapping)>::MemberT,
+                           DecodingTraits>(messageIndex, mapping.memberId);
+      }
+    });
+    return result;
+  }
+
+  Expected addField(std::int32_t messageIndex, Field field) {
+    if (!_messages[messageIndex].add(field)) {
+      return std::unexpected(
+          ParseError{"Protobuf field number mapped more than once",
+                     std::to_string(field.number)});
+    }
+    return {};
+  }
+
+  template <typename ValueT, DecodingTraitsC DecodingTraits>
+  Expected addValue(std::int32_t messageIndex, std::uint32_t memberId,
+                    bool repeated) {
+    Field field{fieldNumber(memberId), memberId, ValueKind::Message,
+                repeated};
+    if constexpr (is_optional<ValueT>) {
+      return addValue<typename ValueT::value_type, DecodingTraits>(
+          messageIndex, memberId, repeated);
+    } else if constexpr (IsMOPEDCompositeC<ValueT, DecodingTraits>) {
+      if (encoding(memberId) != Encoding::Default) {
+        return std::unexpected(ParseError{
+            "Protobuf encoding annotation doesn't apply to the member type",
+            DecodingTraits::getDisplayName(memberId)});
+      }
+      auto nested = messageFor<ValueT, DecodingTraits>();
+      if (!nested) {
+        return std::unexpected(nested.error());
+      }
+      field.message = *nested;
+      return addField(messageIndex, field);
+    } else {
+      auto kind = valueKind<ValueT>(encoding(memberId));
+      if (!kind) {
+        return std::unexpected(ParseError{
+            kind.error().message, DecodingTraits::getDisplayName(memberId)});
+      }
+      field.kind = *kind;
+      return addField(messageIndex, field);
+    }
+  }
+
+  template <typename MemberT, DecodingTraitsC DecodingTraits>
+  Expected addMember(std::int32_t messageIndex, std::uint32_t memberId) {
+    if (memberId == DecodingTraits::EmbeddingMemberId) {
+      if constexpr (IsMOPEDCompositeC<MemberT, DecodingTraits>) {
+        return addComposite<MemberT, DecodingTraits>(messageIndex);
+      } else {
+        return std::unexpected("Embedded members must be a composite type");
+      }
+    }
+    if (memberId == InvalidMemberId) {
+      return std::unexpected(
+          "Protobuf member names must be field numbers, optionally "
+          "annotated with :sint or :fixed");
+    }
+    if constexpr (std::is_convertible_v<MemberT, std::string_view>) {
+      return addValue<MemberT, DecodingTraits>(messageIndex, memberId, false);
+    } else if constexpr (IsMOPEDMapCollectionC<MemberT> ||
+                         IsMOPEDMapDispatcherC<MemberT>) {
+      return std::unexpected(
+          ParseError{"Protobuf map fields are not supported",
+                     DecodingTraits::getDisplayName(memberId)});
+    } else if constexpr (IsMOPEDContentCollectionC<MemberT> ||
+                         IsMOPEDCompositeDispatcherC<MemberT>) {
+      using ValueT = typename RepeatedValue<MemberT>::type;
+      if constexpr (IsMOPEDContentCollectionC<ValueT> &&
+                    !std::is_convertible_v<ValueT, std::string_view>) {
+        return std::unexpected(
+            ParseError{"Protobuf repeated fields can not nest collections",
+                       DecodingTraits::getDisplayName(memberId)});
+      } else {
+        return addValue<ValueT, DecodingTraits>(messageIndex, memberId, true);
+      }
+    } else {
+      return addValue<MemberT, DecodingTraits>(messageIndex, memberId, false);
+    }
+  }
+
+  std::vector<Message> _messages;
+  std::vector<std::pair<const void *, std::int32_t>> _messageTypes;
+};
+
+} // namespace protobuf
+
+} // namespace moped
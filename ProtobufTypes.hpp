@@ -0,0 +1,247 @@
+#pragma once
+
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace moped {
+
+namespace protobuf {
+
+enum class WireType : std::uint8_t {
+  Varint = 0,
+  I64 = 1,
+  Len = 2,
+  StartGroup = 3,
+  EndGroup = 4,
+  I32 = 5
+};
+
+// Scalar encoding chosen by a member name annotation, "7:sint" for zigzag
+// varints (sint32, sint64) and "7:fixed" for fixed width integers (fixed32,
+// sfixed32, fixed64, sfixed64). Unannotated integers are plain varints.
+enum class Encoding : std::uint8_t { Default = 0, ZigZag = 1, Fixed = 2 };
+
+constexpr std::uint32_t MaxFieldNumber = (1u << 29) - 1;
+
+// Member ids carry the field number above the two encoding bits, so ids of
+// small field numbers stay small enough for the member index table
+constexpr std::uint32_t makeMemberId(std::uint32_t fieldNumber,
+                                     Encoding encoding) {
+  return fieldNumber << 2 | static_cast<std::uint32_t>(encoding);
+}
+
+constexpr std::uint32_t fieldNumber(std::uint32_t memberId) {
+  return memberId >> 2;
+}
+
+constexpr Encoding encoding(std::uint32_t memberId) {
+  return static_cast<Encoding>(memberId & 3);
+}
+
+// Member id of mapping names that aren't field numbers, it never matches a
+// parsed field
+constexpr std::uint32_t InvalidMemberId =
+    std::numeric_limits<std::uint32_t>::max();
+
+// How a member's values travel on the wire, derived from its C++ type and
+// the encoding annotation of its member name
+enum class ValueKind : std::uint8_t {
+  Bool,
+  Int,
+  UInt,
+  SInt,
+  Fixed32,
+  SFixed32,
+  Fixed64,
+  SFixed64,
+  Float,
+  Double,
+  Text,
+  Timestamp,
+  Message
+};
+
+constexpr WireType wireType(ValueKind kind) {
+  switch (kind) {
+  case ValueKind::Bool:
+  case ValueKind::Int:
+  case ValueKind::UInt:
+  case ValueKind::SInt:
+    return WireType::Varint;
+  case ValueKind::Fixed32:
+  case ValueKind::SFixed32:
+  case ValueKind::Float:
+    return WireType::I32;
+  case ValueKind::Fixed64:
+  case ValueKind::SFixed64:
+  case ValueKind::Double:
+    return WireType::I64;
+  default:
+    return WireType::Len;
+  }
+}
+
+// Repeated fields of these kinds are written packed
+constexpr bool isPackable(ValueKind kind) {
+  return wireType(kind) != WireType::Len;
+}
+
+template <typename T> struct WireIntegral {
+  using type = T;
+};
+
+template <is_mapped_enum T> struct WireIntegral<T> {
+  using type = std::underlying_type_t<typename T::EnumType>;
+};
+
+// Time points travel as google.protobuf.Timestamp messages, strings, scaled
+// integers and other text convertible types as length delimited text and
+// mapped enums as the varint of their enum value
+template <typename T>
+std::expected<ValueKind, ParseError> valueKind(Encoding encoding) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (encoding == Encoding::Default) {
+      return ValueKind::Bool;
+    }
+  } else if constexpr (std::is_integral_v<T> || is_mapped_enum<T>) {
+    using IntegralT = typename WireIntegral<T>::type;
+    constexpr bool IsSigned = std::is_signed_v<IntegralT>;
+    switch (encoding) {
+    case Encoding::Default:
+      return IsSigned ? ValueKind::Int : ValueKind::UInt;
+    case Encoding::ZigZag:
+      if (IsSigned) {
+        return ValueKind::SInt;
+      }
+      break;
+    case Encoding::Fixed:
+      if constexpr (sizeof(IntegralT) <= 4) {
+        return IsSigned ? ValueKind::SFixed32 : ValueKind::Fixed32;
+      } else {
+        return IsSigned ? ValueKind::SFixed64 : ValueKind::Fixed64;
+      }
+    }
+  } else if constexpr (std::is_floating_point_v<T>) {
+    if (encoding != Encoding::ZigZag) {
+      return sizeof(T) <= 4 ? ValueKind::Float : ValueKind::Double;
+    }
+  } else if constexpr (std::is_same_v<T, TimePoint>) {
+    if (encoding == Encoding::Default) {
+      return ValueKind::Timestamp;
+    }
+  } else {
+    if (encoding == Encoding::Default) {
+      return ValueKind::Text;
+    }
+  }
+  return std::unexpected(
+      "Protobuf encoding annotation doesn't apply to the member type");
+}
+
+constexpr std::size_t MaxVarintSize = 10;
+
+constexpr std::size_t varintSize(std::uint64_t value) {
+  return static_cast<std::size_t>((std::bit_width(value | 1) + 6) / 7);
+}
+
+inline char *writeVarint(char *target, std::uint64_t value) {
+  while (value >= 0x80) {
+    *target++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *target++ = static_cast<char>(value);
+  return target;
+}
+
+// Reads a varint at 'position', advancing it past the varint. Returns false
+// for truncated or over long varints.
+inline bool readVarint(const char *&position, const char *end,
+                       std::uint64_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64 && position != end; shift += 7) {
+    auto byte = static_cast<std::uint8_t>(*position++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
+constexpr std::uint64_t zigzagEncode(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t zigzagDecode(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+} // namespace protobuf
+
+// Decoding traits for the protobuf wire format, members are mapped by field
+// number written as the member name, e.g. "3" or "3:sint" with an encoding
+// annotation, and identified by integer ids combining both.
+template <typename TimePointFormatter = DurationSinceEpochFormatter<>,
+          typename PivotValueType = std::string_view>
+struct ProtobufDecodingTraits {
+  using MemberIdType = std::uint32_t;
+  using PivotValueT = PivotValueType;
+  static MemberIdType getMemberId(std::string_view name) {
+    if (name.empty()) {
+      return EmbeddingMemberId;
+    }
+    auto separator = name.find(':');
+    auto number = name.substr(0, separator);
+    std::uint32_t fieldNumber = 0;
+    auto [end, ec] = std::from_chars(number.data(),
+                                     number.data() + number.size(),
+                                     fieldNumber);
+    if (ec != std::errc{} || end != number.data() + number.size() ||
+        fieldNumber == 0 || fieldNumber > protobuf::MaxFieldNumber) {
+      return protobuf::InvalidMemberId;
+    }
+    auto encoding = protobuf::Encoding::Default;
+    if (separator != std::string_view::npos) {
+      auto annotation = name.substr(separator + 1);
+      if (annotation == "sint") {
+        encoding = protobuf::Encoding::ZigZag;
+      } else if (annotation == "fixed") {
+        encoding = protobuf::Encoding::Fixed;
+      } else {
+        return protobuf::InvalidMemberId;
+      }
+    }
+    return protobuf::makeMemberId(fieldNumber, encoding);
+  }
+  static std::string getDisplayName(MemberIdType memberId) {
+    if (memberId == protobuf::InvalidMemberId) {
+      return "invalid";
+    }
+    auto name = std::to_string(protobuf::fieldNumber(memberId));
+    switch (protobuf::encoding(memberId)) {
+    case protobuf::Encoding::ZigZag:
+      return name + ":sint";
+    case protobuf::Encoding::Fixed:
+      return name + ":fixed";
+    default:
+      return name;
+    }
+  }
+  static constexpr MemberIdType EmbeddingMemberId = 0;
+  using TimePointFormaterT = TimePointFormatter;
+};
+
+static_assert(DecodingTraitsC<ProtobufDecodingTraits<>>,
+              "ProtobufDecodingTraits should satisfy DecodingTraitsC concept");
+
+} // namespace moped
@@ -0,0 +1,483 @@
+#pragma once
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/SBESchema.hpp"
+#include "moped/concepts.hpp"
+#include "moped/getValueFor.hpp"
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace moped {
+
+namespace sbe {
+
+// Bounds checked read position over a receive buffer
+class BufferCursor {
+public:
+  BufferCursor(std::string_view buffer) : _buffer(buffer) {}
+
+  const char *current() const { return _buffer.data() + _position; }
+  std::size_t position() const { return _position; }
+  std::size_t remaining() const { return _buffer.size() - _position; }
+  void advance(std::size_t count) { _position += count; }
+
+  Expected require(std::size_t count, std::string_view section) const {
+    if (remaining() < count) {
+      return std::unexpected(
+          ParseError{"SBE buffer truncated while reading", section});
+    }
+    return {};
+  }
+
+private:
+  std::string_view _buffer;
+  std::size_t _position{0};
+};
+
+inline std::expected<MessageHeader, ParseError>
+readMessageHeader(std::string_view buffer) {
+  if (buffer.size() < MessageHeaderSize) {
+    return std::unexpected(
+        ParseError{"SBE buffer truncated while reading", "message header"});
+  }
+  return MessageHeader{loadLittleEndian<std::uint16_t>(buffer.data()),
+                       loadLittleEndian<std::uint16_t>(buffer.data() + 2),
+                       loadLittleEndian<std::uint16_t>(buffer.data() + 4),
+                       loadLittleEndian<std::uint16_t>(buffer.data() + 6)};
+}
+
+} // namespace sbe
+
+template <typename CompositeT> struct SBEGroupDecoder {
+  virtual ~SBEGroupDecoder() = default;
+  virtual Expected build(const sbe::BlockLayout &layout) = 0;
+  virtual Expected decode(CompositeT &target,
+                          sbe::BufferCursor &cursor) const = 0;
+};
+
+template <typename CompositeT, typename MemberPtrT,
+          DecodingTraitsC DecodingTraits>
+class SBEGroupMemberDecoder;
+
+// Decodes one block layout into a composite. Building the decoder matches
+// every layout entry to a member of the composite's moped mapping and picks
+// a decode function instantiated for that member and wire type, so decoding
+// a block is a pass over fixed offsets with no member name dispatch. Fields
+// whose wire type matches the member type are copied directly, all others
+// convert through getValueFor.
+template <typename CompositeT, DecodingTraitsC DecodingTraits>
+class SBEBlockDecoder {
+  using MopedHandlerT =
+      decltype(getMOPEDHandlerForParser<CompositeT, DecodingTraits>());
+
+  template <std::size_t MemberIndex>
+  using MemberMappingT = std::decay_t<decltype(std::declval<const MopedHandlerT &>()
+                                                   .template getMemberMapping<
+                                                       MemberIndex>())>;
+
+  template <std::size_t MemberIndex>
+  using MappedMemberT = typename MemberMappingT<MemberIndex>::MemberT;
+
+  using FieldDecodeFn = Expected (*)(const MopedHandlerT &, CompositeT &,
+                                     const char *, const sbe::FieldLayout &);
+  using VarDataDecodeFn = Expected (*)(const MopedHandlerT &, CompositeT &,
+                                       std::string_view);
+
+  struct FieldEntry {
+    sbe::FieldLayout layout;
+    FieldDecodeFn decode;
+  };
+
+  struct VarDataEntry {
+    sbe::VarDataLayout layout;
+    VarDataDecodeFn decode;
+  };
+
+public:
+  Expected build(const sbe::BlockLayout &layout) {
+    _minimumBlockLength = layout.blockLength();
+    for (auto &field : layout.fields) {
+      auto decode = resolveMember(field.name, [&](auto memberIndex) {
+        return selectFieldDecoder<decltype(memberIndex)::value>(field);
+      });
+      if (!decode) {
+        return std::unexpected(
+            ParseError{"SBE field not found in moped mapping", field.name});
+      }
+      if (!*decode) {
+        return std::unexpected(ParseError{
+            "SBE field type not applicable to mapped member", field.name});
+      }
+      _fields.push_back(FieldEntry{field, *decode});
+    }
+
+    for (auto &group : layout.groups) {
+      auto decoder = resolveMember(group.name, [&](auto memberIndex) {
+        return selectGroupDecoder<decltype(memberIndex)::value>();
+      });
+      if (!decoder) {
+        return std::unexpected(
+            ParseError{"SBE group not found in moped mapping", group.name});
+      }
+      if (!*decoder) {
+        return std::unexpected(ParseError{
+            "SBE group requires a composite collection member", group.name});
+      }
+      if (auto result = (*decoder)->build(group.block); !result) {
+        return result;
+      }
+      _groups.push_back(std::move(*decoder));
+    }
+
+    for (auto &varData : layout.varData) {
+      auto decode = resolveMember(varData.name, [&](auto memberIndex) {
+        return selectVarDataDecoder<decltype(memberIndex)::value>();
+      });
+      if (!decode) {
+        return std::unexpected(
+            ParseError{"SBE var data not found in moped mapping", varData.name});
+      }
+      if (!*decode) {
+        return std::unexpected(ParseError{
+            "SBE var data requires a text member", varData.name});
+      }
+      _varData.push_back(VarDataEntry{varData, *decode});
+    }
+    return {};
+  }
+
+  // Reads a block of 'blockLength' bytes at the cursor followed by its
+  // groups and var data. Blocks longer than the layout are extensions from
+  // a newer schema version and their trailing bytes are skipped.
+  Expected decode(CompositeT &target, sbe::BufferCursor &cursor,
+                  std::size_t blockLength) const {
+    if (blockLength < _minimumBlockLength) {
+      return std::unexpected(ParseError{
+          "SBE block length shorter than its layout",
+          std::format("{}", blockLength)});
+    }
+    if (auto result = cursor.require(blockLength, "block"); !result) {
+      return result;
+    }
+    const char *block = cursor.current();
+    for (auto &field : _fields) {
+      auto result = field.decode(_mopedHandler, target,
+                                 block + field.layout.offset, field.layout);
+      if (!result) {
+        return result;
+      }
+    }
+    cursor.advance(blockLength);
+
+    for (auto &group : _groups) {
+      if (auto result = group->decode(target, cursor); !result) {
+        return result;
+      }
+    }
+
+    for (auto &varData : _varData) {
+      auto lengthSize = sbe::primitiveSize(varData.layout.lengthType);
+      if (auto result = cursor.require(lengthSize, varData.layout.name);
+          !result) {
+        return result;
+      }
+      auto length = sbe::visitPrimitive(
+          varData.layout.lengthType, [&](auto wireValue) -> std::size_t {
+            using WireT = decltype(wireValue);
+            return static_cast<std::size_t>(
+                sbe::loadLittleEndian<WireT>(cursor.current()));
+          });
+      cursor.advance(lengthSize);
+      if (auto result = cursor.require(length, varData.layout.name);
+          !result) {
+        return result;
+      }
+      auto result = varData.decode(_mopedHandler, target,
+                                   std::string_view{cursor.current(), length});
+      if (!result) {
+        return result;
+      }
+      cursor.advance(length);
+    }
+    return {};
+  }
+
+private:
+  // Returns nullopt when no member carries 'name', otherwise the result of
+  // 'select' for the matching member
+  auto resolveMember(std::string_view name, auto &&select) const {
+    using SelectedT = decltype(select(std::integral_constant<std::size_t, 0>{}));
+    std::optional<SelectedT> selected;
+    auto memberId = DecodingTraits::getMemberId(name);
+    _mopedHandler.forEachMemberMapping(
+        [&](auto memberIndex, const auto &mapping) {
+          if (!selected && mapping.memberId == memberId) {
+            selected = select(memberIndex);
+          }
+        });
+    return selected;
+  }
+
+  template <std::size_t MemberIndex>
+  static FieldDecodeFn selectFieldDecoder(const sbe::FieldLayout &layout) {
+    using MemberT = MappedMemberT<MemberIndex>;
+    if constexpr (!IsSettableC<MemberT, DecodingTraits>) {
+      return nullptr;
+    } else {
+      return sbe::visitPrimitive(
+          layout.type, [&](auto wireValue) -> FieldDecodeFn {
+            using WireT = decltype(wireValue);
+            if constexpr (std::is_same_v<WireT, char>) {
+              if constexpr (std::is_same_v<MemberT, char>) {
+                return layout.length == 1 ? &decodeDirect<MemberIndex, char>
+                                          : nullptr;
+              } else {
+                return &decodeText<MemberIndex>;
+              }
+            } else {
+              if (layout.length != 1 ||
+                  (layout.exponent != 0 && std::is_floating_point_v<WireT>)) {
+                return nullptr;
+              }
+              if constexpr (std::is_same_v<MemberT, WireT>) {
+                if (layout.exponent == 0 && !layout.optional) {
+                  return &decodeDirect<MemberIndex, WireT>;
+                }
+              }
+              return &decodeField<MemberIndex, WireT>;
+            }
+          });
+    }
+  }
+
+  template <std::size_t MemberIndex>
+  std::unique_ptr<SBEGroupDecoder<CompositeT>> selectGroupDecoder() const {
+    using MemberT = MappedMemberT<MemberIndex>;
+    if constexpr (IsMOPEDCompositeDispatcherC<MemberT> ||
+                  IsMOPEDPushCollectionC<MemberT>) {
+      if constexpr (IsMOPEDCompositeC<typename MemberT::value_type,
+                                      DecodingTraits>) {
+        auto &mapping = _mopedHandler.template getMemberMapping<MemberIndex>();
+        return std::make_unique<SBEGroupMemberDecoder<
+            CompositeT, std::decay_t<decltype(mapping.memberPtr)>,
+            DecodingTraits>>(mapping.memberPtr);
+      }
+    }
+    return nullptr;
+  }
+
+  template <std::size_t MemberIndex>
+  static VarDataDecodeFn selectVarDataDecoder() {
+    if constexpr (IsSettableC<MappedMemberT<MemberIndex>, DecodingTraits>) {
+      return &decodeText<MemberIndex>;
+    } else {
+      return nullptr;
+    }
+  }
+
+  template <std::size_t MemberIndex>
+  static auto &memberOf(const MopedHandlerT &mopedHandler,
+                        CompositeT &target) {
+    return target.*(mopedHandler.template getMemberMapping<MemberIndex>()
+                        .memberPtr);
+  }
+
+  template <std::size_t MemberIndex, typename WireT>
+  static Expected decodeDirect(const MopedHandlerT &mopedHandler,
+                               CompositeT &target, const char *source,
+                               const sbe::FieldLayout &) {
+    memberOf<MemberIndex>(mopedHandler, target) =
+        sbe::loadLittleEndian<WireT>(source);
+    return {};
+  }
+
+  template <std::size_t MemberIndex, typename WireT>
+  static Expected decodeField(const MopedHandlerT &mopedHandler,
+                              CompositeT &target, const char *source,
+                              const sbe::FieldLayout &layout) {
+    using MemberT = MappedMemberT<MemberIndex>;
+    auto &member = memberOf<MemberIndex>(mopedHandler, target);
+    auto value = sbe::loadLittleEndian<WireT>(source);
+    if (layout.optional && sbe::isNullValue(value)) {
+      if constexpr (is_optional<MemberT>) {
+        member.reset();
+      }
+      return {};
+    }
+    auto result = [&] {
+      if constexpr (std::is_integral_v<WireT>) {
+        if (layout.exponent != 0) {
+          return getValueFor<MemberT, DecodingTraits>(DecimalFraction{
+              static_cast<std::int64_t>(value), layout.exponent});
+        }
+      }
+      return getValueFor<MemberT, DecodingTraits>(value);
+    }();
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    member = std::move(result.value());
+    return {};
+  }
+
+  // Text is handed to the member as a view of the receive buffer, so
+  // string_view members reference it without copying
+  template <std::size_t MemberIndex>
+  static Expected decodeText(const MopedHandlerT &mopedHandler,
+                             CompositeT &target, std::string_view text) {
+    using MemberT = MappedMemberT<MemberIndex>;
+    auto &member = memberOf<MemberIndex>(mopedHandler, target);
+    if constexpr (is_optional<MemberT>) {
+      if (text.empty()) {
+        member.reset();
+        return {};
+      }
+    }
+    auto result = getValueFor<MemberT, DecodingTraits>(text);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    member = std::move(result.value());
+    return {};
+  }
+
+  template <std::size_t MemberIndex>
+  static Expected decodeText(const MopedHandlerT &mopedHandler,
+                             CompositeT &target, const char *source,
+                             const sbe::FieldLayout &layout) {
+    std::string_view text{source, layout.length};
+    return decodeText<MemberIndex>(mopedHandler, target,
+                                   text.substr(0, text.find('\0')));
+  }
+
+  MopedHandlerT _mopedHandler{
+      getMOPEDHandlerForParser<CompositeT, DecodingTraits>()};
+  std::size_t _minimumBlockLength{0};
+  std::vector<FieldEntry> _fields;
+  std::vector<std::unique_ptr<SBEGroupDecoder<CompositeT>>> _groups;
+  std::vector<VarDataEntry> _varData;
+};
+
+// Repeating group decoded into a push collection, cleared first, or into a
+// collection dispatcher with each entry dispatched once decoded
+template <typename CompositeT, typename MemberPtrT,
+          DecodingTraitsC DecodingTraits>
+class SBEGroupMemberDecoder : public SBEGroupDecoder<CompositeT> {
+  using MemberT = std::decay_t<decltype(std::declval<CompositeT &>().*
+                                        std::declval<MemberPtrT>())>;
+  using EntryT = typename MemberT::value_type;
+
+public:
+  SBEGroupMemberDecoder(MemberPtrT memberPtr) : _memberPtr(memberPtr) {}
+
+  Expected build(const sbe::BlockLayout &layout) override {
+    return _entryDecoder.build(layout);
+  }
+
+  Expected decode(CompositeT &target,
+                  sbe::BufferCursor &cursor) const override {
+    if (auto result = cursor.require(sbe::GroupHeaderSize, "group header");
+        !result) {
+      return result;
+    }
+    auto blockLength = sbe::loadLittleEndian<std::uint16_t>(cursor.current());
+    auto count = sbe::loadLittleEndian<std::uint16_t>(cursor.current() + 2);
+    cursor.advance(sbe::GroupHeaderSize);
+
+    auto &member = target.*_memberPtr;
+    if constexpr (IsMOPEDCompositeDispatcherC<MemberT>) {
+      for (std::uint16_t index = 0; index < count; ++index) {
+        auto &entry = member.resetCapture();
+        if (auto result = _entryDecoder.decode(entry, cursor, blockLength);
+            !result) {
+          return result;
+        }
+        if (auto result = member.dispatchLastCapture(); !result) {
+          return result;
+        }
+      }
+    } else {
+      member.clear();
+      if constexpr (requires { member.reserve(count); }) {
+        member.reserve(count);
+      }
+      for (std::uint16_t index = 0; index < count; ++index) {
+        auto &entry = member.emplace_back();
+        if (auto result = _entryDecoder.decode(entry, cursor, blockLength);
+            !result) {
+          return result;
+        }
+      }
+    }
+    return {};
+  }
+
+private:
+  MemberPtrT _memberPtr;
+  SBEBlockDecoder<EntryT, DecodingTraits> _entryDecoder;
+};
+
+// Decodes SBE messages of a single template into CompositeT. String view
+// members of the decoded composite reference the receive buffer.
+template <typename CompositeT, DecodingTraitsC DecodingTraits>
+class SBEDecoder {
+public:
+  static std::expected<SBEDecoder, ParseError>
+  create(const sbe::MessageLayout &layout) {
+    SBEDecoder decoder;
+    decoder._templateId = layout.templateId;
+    decoder._schemaId = layout.schemaId;
+    if (auto result = decoder._blockDecoder.build(layout.block); !result) {
+      return std::unexpected(result.error());
+    }
+    return decoder;
+  }
+
+  std::uint16_t getTemplateId() const { return _templateId; }
+
+  // Decodes the message at the front of 'buffer' returning the number of
+  // bytes it spans, allowing a buffer of consecutive messages to be walked
+  std::expected<std::size_t, ParseError>
+  decode(std::string_view buffer, CompositeT &target) const {
+    auto header = sbe::readMessageHeader(buffer);
+    if (!header) {
+      return std::unexpected(header.error());
+    }
+    if (header->templateId != _templateId || header->schemaId != _schemaId) {
+      return std::unexpected(
+          ParseError{"SBE message template does not match decoder",
+                     std::format("{}:{}", header->schemaId,
+                                 header->templateId)});
+    }
+    sbe::BufferCursor cursor{buffer};
+    cursor.advance(sbe::MessageHeaderSize);
+    auto result = _blockDecoder.decode(target, cursor, header->blockLength);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    return cursor.position();
+  }
+
+  std::expected<CompositeT, ParseError> decode(std::string_view buffer) const {
+    CompositeT target{};
+    if (auto result = decode(buffer, target); !result) {
+      return std::unexpected(result.error());
+    }
+    return target;
+  }
+
+private:
+  SBEDecoder() = default;
+
+  std::uint16_t _templateId{0};
+  std::uint16_t _schemaId{0};
+  SBEBlockDecoder<CompositeT, DecodingTraits> _blockDecoder;
+};
+
+} // namespace moped
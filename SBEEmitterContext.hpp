@@ -0,0 +1,458 @@
+#pragma once
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/SBESchema.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include "moped/moped.hpp"
+#include "moped/scaledIntParseUtils.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace moped {
+
+// Emitter context writing a single SBE message into a caller provided
+// buffer. Fixed fields are stored at their layout offsets in whatever order
+// the mapping emits them, blocks are first filled with zeros and the null
+// values of their optional fields so disengaged members need no events.
+// Groups and var data are appended in layout order, empty collections are
+// skipped by the emitter and written here as empty groups. Nesting is
+// tracked in a fixed depth frame stack so encoding never allocates.
+template <typename TimePointFormatter = DurationSinceEpochFormatter<>>
+class SBEEmitterContext {
+public:
+  static constexpr std::size_t MaxDepth = 16;
+
+  SBEEmitterContext(const sbe::MessageEncoding &encoding,
+                    std::span<char> buffer)
+      : _encoding(encoding), _buffer(buffer) {}
+
+  void onObjectStart(std::optional<std::string_view> memberId = std::nullopt) {
+    if (_error) {
+      return;
+    }
+    if (_depth == 0) {
+      if (_position != 0) {
+        return fail("SBE emitter context encodes a single message");
+      }
+      if (!require(sbe::MessageHeaderSize + _encoding.block.blockLength)) {
+        return;
+      }
+      auto &header = _encoding.header;
+      sbe::storeLittleEndian(&_buffer[0], header.blockLength);
+      sbe::storeLittleEndian(&_buffer[2], header.templateId);
+      sbe::storeLittleEndian(&_buffer[4], header.schemaId);
+      sbe::storeLittleEndian(&_buffer[6], header.version);
+      _position = sbe::MessageHeaderSize;
+      openBlock(_encoding.block);
+      return;
+    }
+    auto &frame = top();
+    if (!frame.isGroup) {
+      return fail("SBE layouts do not support nested composite member",
+                  memberId.value_or(""));
+    }
+    if (!require(frame.block->blockLength)) {
+      return;
+    }
+    ++frame.count;
+    openBlock(*frame.block);
+  }
+
+  void onObjectFinish() {
+    if (_error) {
+      return;
+    }
+    if (!finishBlock(top())) {
+      return;
+    }
+    --_depth;
+  }
+
+  void onArrayStart(std::optional<std::string_view> memberId) {
+    if (_error) {
+      return;
+    }
+    auto name = memberId.value_or("");
+    if (_depth == 0) {
+      return fail("SBE messages must be encoded from a composite", name);
+    }
+    auto &frame = top();
+    if (frame.isGroup) {
+      return fail("SBE groups can not directly contain groups", name);
+    }
+    auto &groups = frame.block->groups;
+    auto group = std::ranges::find(groups, name, &sbe::BlockEncoding::name);
+    if (group == groups.end()) {
+      return fail("Member not found in SBE layout", name);
+    }
+    auto groupIndex = static_cast<std::size_t>(group - groups.begin());
+    if (groupIndex < frame.nextGroup || frame.nextVarData != 0) {
+      return fail("SBE group emitted out of layout order", name);
+    }
+    if (!writeEmptyGroups(frame, groupIndex) ||
+        !require(sbe::GroupHeaderSize) || !pushFrame()) {
+      return;
+    }
+    frame.nextGroup = groupIndex + 1;
+    sbe::storeLittleEndian(&_buffer[_position], group->blockLength);
+    top() = Frame{&*group, _position + 2, 0, true};
+    _position += sbe::GroupHeaderSize;
+  }
+
+  void onArrayValueEntry(const auto &) {
+    if (!_error) {
+      fail("SBE group entries must be composites", top().block->name);
+    }
+  }
+
+  void onArrayFinish() {
+    if (_error) {
+      return;
+    }
+    auto &frame = top();
+    if (frame.count > std::numeric_limits<std::uint16_t>::max()) {
+      return fail("SBE group entry count exceeds uint16",
+                  std::format("{}", frame.count));
+    }
+    sbe::storeLittleEndian(&_buffer[frame.offset],
+                           static_cast<std::uint16_t>(frame.count));
+    --_depth;
+  }
+
+  void onObjectValueEntry(const std::string_view memberId, const auto &value) {
+    if (_error) {
+      return;
+    }
+    auto &frame = top();
+    auto &fields = frame.block->fields;
+    // Mappings usually list members in layout order, so the field after the
+    // previous one is tried before searching
+    auto field = frame.nextField < fields.size() &&
+                         fields[frame.nextField].name == memberId
+                     ? fields.begin() + frame.nextField
+                     : std::ranges::find(fields, memberId,
+                                         &sbe::FieldLayout::name);
+    if (field != fields.end()) {
+      frame.nextField = static_cast<std::size_t>(field - fields.begin()) + 1;
+      writeField(*field, &_buffer[frame.offset + field->offset], value);
+      return;
+    }
+
+    auto &varData = frame.block->varData;
+    auto entry = std::ranges::find(varData, memberId,
+                                   &sbe::VarDataLayout::name);
+    if (entry == varData.end()) {
+      return fail("Member not found in SBE layout", memberId);
+    }
+    auto varDataIndex = static_cast<std::size_t>(entry - varData.begin());
+    if (varDataIndex < frame.nextVarData) {
+      return fail("SBE var data emitted out of layout order", memberId);
+    }
+    if (!writeEmptyGroups(frame, frame.block->groups.size()) ||
+        !writeEmptyVarData(frame, varDataIndex)) {
+      return;
+    }
+    frame.nextVarData = varDataIndex + 1;
+    if constexpr (std::convertible_to<decltype(value), std::string_view>) {
+      writeVarData(*entry, value);
+    } else {
+      fail("SBE var data requires a text member", memberId);
+    }
+  }
+
+  template <typename T>
+  void onObjectValueEntry(const std::string_view memberId,
+                          const std::optional<T> &value) {
+    if (!value.has_value()) {
+      return; // Left as the null value written when the block opened
+    }
+    onObjectValueEntry(memberId, value.value());
+  }
+
+  // Number of bytes of the encoded message, or the first error met while
+  // encoding it
+  std::expected<std::size_t, ParseError> getEncodedLength() const {
+    if (_error) {
+      return std::unexpected(*_error);
+    }
+    if (_depth != 0 || _position == 0) {
+      return std::unexpected(
+          ParseError{"SBE message encoding incomplete"});
+    }
+    return _position;
+  }
+
+private:
+  // Blocks track their next expected group, var data and field, groups
+  // their header offset and entry count
+  struct Frame {
+    const sbe::BlockEncoding *block;
+    std::size_t offset;
+    std::size_t count{0};
+    bool isGroup{false};
+    std::size_t nextGroup{0};
+    std::size_t nextVarData{0};
+    std::size_t nextField{0};
+  };
+
+  Frame &top() { return _frames[_depth - 1]; }
+
+  void fail(const char *message) { _error = ParseError{message}; }
+
+  void fail(const char *message, const auto &detail) {
+    _error = ParseError{message, detail};
+  }
+
+  bool require(std::size_t count) {
+    if (_buffer.size() - _position < count) {
+      fail("SBE buffer too small for message",
+           std::format("{}", _position + count));
+      return false;
+    }
+    return true;
+  }
+
+  bool pushFrame() {
+    if (_depth == MaxDepth) {
+      fail("SBE message nesting exceeds emitter depth",
+           std::format("{}", MaxDepth));
+      return false;
+    }
+    ++_depth;
+    return true;
+  }
+
+  void openBlock(const sbe::BlockEncoding &block) {
+    if (!pushFrame()) {
+      return;
+    }
+    top() = Frame{&block, _position};
+    char *start = &_buffer[_position];
+    std::memset(start, 0, block.blockLength);
+    for (auto &field : block.fields) {
+      if (field.optional) {
+        sbe::visitPrimitive(field.type, [&](auto wireValue) {
+          using WireT = decltype(wireValue);
+          for (std::size_t index = 0; index < field.length; ++index) {
+            sbe::storeLittleEndian(start + field.offset +
+                                       index * sizeof(WireT),
+                                   sbe::nullValue<WireT>());
+          }
+        });
+      }
+    }
+    _position += block.blockLength;
+  }
+
+  bool finishBlock(Frame &frame) {
+    return writeEmptyGroups(frame, frame.block->groups.size()) &&
+           writeEmptyVarData(frame, frame.block->varData.size());
+  }
+
+  bool writeEmptyGroups(Frame &frame, std::size_t endIndex) {
+    for (; frame.nextGroup < endIndex; ++frame.nextGroup) {
+      if (!require(sbe::GroupHeaderSize)) {
+        return false;
+      }
+      sbe::storeLittleEndian(&_buffer[_position],
+                             frame.block->groups[frame.nextGroup].blockLength);
+      sbe::storeLittleEndian(&_buffer[_position + 2], std::uint16_t{0});
+      _position += sbe::GroupHeaderSize;
+    }
+    return true;
+  }
+
+  bool writeEmptyVarData(Frame &frame, std::size_t endIndex) {
+    for (; frame.nextVarData < endIndex; ++frame.nextVarData) {
+      if (!writeVarData(frame.block->varData[frame.nextVarData], "")) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool writeVarData(const sbe::VarDataLayout &layout, std::string_view data) {
+    auto lengthSize = sbe::primitiveSize(layout.lengthType);
+    if (!require(lengthSize + data.size())) {
+      return false;
+    }
+    return sbe::visitPrimitive(layout.lengthType, [&](auto wireValue) {
+      using WireT = decltype(wireValue);
+      if constexpr (std::is_integral_v<WireT> && !std::is_same_v<WireT, char>) {
+        if (std::in_range<WireT>(data.size())) {
+          sbe::storeLittleEndian(&_buffer[_position],
+                                 static_cast<WireT>(data.size()));
+          _position += lengthSize;
+          std::memcpy(&_buffer[_position], data.data(), data.size());
+          _position += data.size();
+          return true;
+        }
+      }
+      fail("SBE var data length not representable", layout.name);
+      return false;
+    });
+  }
+
+  // Fixed width text is copied into the field, the remainder stays NUL
+  // padded from when the block was opened
+  void writeField(const sbe::FieldLayout &field, char *target,
+                  const auto &value) {
+    using ValueT = std::decay_t<decltype(value)>;
+    if constexpr (std::convertible_to<ValueT, std::string_view> &&
+                  !is_mapped_enum<ValueT>) {
+      std::string_view text{value};
+      if (field.type != sbe::PrimitiveType::Char) {
+        return fail("Text member mapped to numeric SBE field", field.name);
+      }
+      if (text.size() > field.length) {
+        return fail("Text exceeds SBE field length", field.name);
+      }
+      std::memcpy(target, text.data(), text.size());
+    } else {
+      if (field.length != 1) {
+        return fail("SBE array fields require a text member", field.name);
+      }
+      sbe::visitPrimitive(field.type, [&](auto wireValue) {
+        using WireT = decltype(wireValue);
+        auto wire = toWireValue<WireT>(field, value);
+        if (!wire) {
+          return fail(wire.error().message, field.name);
+        }
+        sbe::storeLittleEndian(target, *wire);
+      });
+    }
+  }
+
+  template <typename WireT>
+  using WireValue = std::expected<WireT, ParseError>;
+
+  static std::unexpected<ParseError> outOfRange() {
+    return std::unexpected(ParseError{"Value out of range for SBE field"});
+  }
+
+  // Converts a member value to the field's wire type, ScaledInteger and
+  // MappedEnum members are written as their raw integral values
+  template <typename WireT, typename ValueT>
+  static WireValue<WireT> toWireValue(const sbe::FieldLayout &field,
+                                      const ValueT &value) {
+    if constexpr (std::is_same_v<WireT, char>) {
+      if constexpr (std::is_same_v<ValueT, char>) {
+        return value;
+      } else {
+        return std::unexpected(
+            ParseError{"Char SBE field requires a char or text member"});
+      }
+    } else if constexpr (std::is_same_v<ValueT, char>) {
+      return toWireValue<WireT>(field, static_cast<int>(value));
+    } else if constexpr (is_mapped_enum<ValueT>) {
+      return toWireValue<WireT>(field,
+                                std::to_underlying(value.getEnumValue()));
+    } else if constexpr (std::is_same_v<ValueT, TimePoint>) {
+      if constexpr (requires { TimePointFormatter::getTimeUnits(value); }) {
+        return toWireValue<WireT>(field,
+                                  TimePointFormatter::getTimeUnits(value));
+      } else {
+        return std::unexpected(ParseError{
+            "Time point formatter has no integral SBE representation"});
+      }
+    } else if constexpr (is_scaled_int<ValueT>) {
+      // Rescaling is done in 64 bits, wider raw values must fit them first
+      auto rawValue = value.getRawIntegerValue();
+      if (!fitsIntegral<std::int64_t>(rawValue)) {
+        return outOfRange();
+      }
+      return scaleToWire<WireT>(field, static_cast<std::int64_t>(rawValue),
+                                -static_cast<int>(ValueT::Scale));
+    } else if constexpr (std::is_same_v<ValueT, bool>) {
+      return static_cast<WireT>(value);
+    } else if constexpr (std::is_integral_v<ValueT>) {
+      return scaleToWire<WireT>(field, value, 0);
+    } else if constexpr (std::is_floating_point_v<ValueT>) {
+      if constexpr (std::is_floating_point_v<WireT>) {
+        return static_cast<WireT>(value);
+      } else {
+        auto mantissa = std::llround(value * std::pow(10.0, -field.exponent));
+        if (!std::in_range<WireT>(mantissa)) {
+          return outOfRange();
+        }
+        return static_cast<WireT>(mantissa);
+      }
+    } else {
+      return std::unexpected(
+          ParseError{"Member type has no SBE wire representation"});
+    }
+  }
+
+  // Rescales an integral value carrying 'exponent' to the field's exponent,
+  // digits below the field's precision are truncated
+  template <typename WireT, typename IntegralT>
+  static WireValue<WireT> scaleToWire(const sbe::FieldLayout &field,
+                                      IntegralT value, int exponent) {
+    if constexpr (std::is_floating_point_v<WireT>) {
+      return static_cast<WireT>(value * std::pow(10.0, exponent));
+    } else {
+      auto shift = exponent - field.exponent;
+      if (shift == 0) {
+        if (!std::in_range<WireT>(value)) {
+          return outOfRange();
+        }
+        return static_cast<WireT>(value);
+      }
+      if (std::abs(shift) > std::numeric_limits<std::int64_t>::digits10) {
+        return outOfRange();
+      }
+      if (!fitsIntegral<std::int64_t>(value)) {
+        return outOfRange();
+      }
+      auto factor = scale10<std::int64_t>(std::abs(shift));
+      auto scaled = static_cast<std::int64_t>(value);
+      if (shift > 0) {
+        if (scaled > std::numeric_limits<std::int64_t>::max() / factor ||
+            scaled < std::numeric_limits<std::int64_t>::min() / factor) {
+          return outOfRange();
+        }
+        scaled *= factor;
+      } else {
+        scaled /= factor;
+      }
+      if (!std::in_range<WireT>(scaled)) {
+        return outOfRange();
+      }
+      return static_cast<WireT>(scaled);
+    }
+  }
+
+  const sbe::MessageEncoding &_encoding;
+  std::span<char> _buffer;
+  std::size_t _position{0};
+  std::array<Frame, MaxDepth> _frames{};
+  std::size_t _depth{0};
+  std::optional<ParseError> _error;
+};
+
+// Encodes 'mopedObject' as one SBE message at the front of 'buffer'
+// returning its length
+template <typename T, typename... FormatArgs>
+std::expected<std::size_t, ParseError>
+encodeToSBE(const T &mopedObject, const sbe::MessageEncoding &encoding,
+            std::span<char> buffer, FormatArgs...) {
+  SBEEmitterContext<FormatArgs...> context(encoding, buffer);
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<FormatArgs...>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+  return context.getEncodedLength();
+}
+
+} // namespace moped
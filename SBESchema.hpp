@@ -0,0 +1,225 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace moped::sbe {
+
+// Fixed layout description of Simple Binary Encoding messages. Layouts are
+// resolved once against a composite's moped mapping by name, after which
+// fields are read and written at their offsets without any name lookups.
+
+enum class PrimitiveType : std::uint8_t {
+  Char,
+  Int8,
+  Int16,
+  Int32,
+  Int64,
+  UInt8,
+  UInt16,
+  UInt32,
+  UInt64,
+  Float,
+  Double
+};
+
+constexpr std::size_t primitiveSize(PrimitiveType type) {
+  switch (type) {
+  case PrimitiveType::Char:
+  case PrimitiveType::Int8:
+  case PrimitiveType::UInt8:
+    return 1;
+  case PrimitiveType::Int16:
+  case PrimitiveType::UInt16:
+    return 2;
+  case PrimitiveType::Int32:
+  case PrimitiveType::UInt32:
+  case PrimitiveType::Float:
+    return 4;
+  case PrimitiveType::Int64:
+  case PrimitiveType::UInt64:
+  case PrimitiveType::Double:
+    return 8;
+  }
+  return 0;
+}
+
+// A field at 'offset' within its block. Char fields longer than one are
+// fixed width text padded with NUL characters. A non zero exponent marks an
+// integer field as the mantissa of a decimal with a constant exponent.
+// Optional fields treat the primitive's null value as absent.
+struct FieldLayout {
+  std::string_view name;
+  PrimitiveType type;
+  std::uint16_t offset;
+  std::uint16_t length{1};
+  std::int8_t exponent{0};
+  bool optional{false};
+
+  std::size_t size() const { return primitiveSize(type) * length; }
+};
+
+// Variable length data follows the groups of its block as a length prefix
+// of 'lengthType' followed by the raw bytes
+struct VarDataLayout {
+  std::string_view name;
+  PrimitiveType lengthType{PrimitiveType::UInt16};
+};
+
+struct GroupLayout;
+
+struct BlockLayout {
+  std::vector<FieldLayout> fields;
+  std::vector<GroupLayout> groups;
+  std::vector<VarDataLayout> varData;
+
+  std::size_t blockLength() const {
+    std::size_t length = 0;
+    for (auto &field : fields) {
+      length = std::max(length, field.offset + field.size());
+    }
+    return length;
+  }
+};
+
+// Repeating groups are prefixed with the standard groupSizeEncoding, a
+// uint16 block length followed by a uint16 entry count
+struct GroupLayout {
+  std::string_view name;
+  BlockLayout block;
+};
+
+struct MessageLayout {
+  std::uint16_t templateId;
+  std::uint16_t schemaId;
+  std::uint16_t version{0};
+  BlockLayout block;
+};
+
+// Standard messageHeader composite preceding each message
+struct MessageHeader {
+  std::uint16_t blockLength;
+  std::uint16_t templateId;
+  std::uint16_t schemaId;
+  std::uint16_t version;
+};
+
+constexpr std::size_t MessageHeaderSize = 8;
+constexpr std::size_t GroupHeaderSize = 4;
+
+// Block layout resolved for encoding. Block lengths of the message and of
+// every group are computed once here rather than for each encoded message.
+struct BlockEncoding {
+  std::string_view name;
+  std::uint16_t blockLength;
+  std::vector<FieldLayout> fields;
+  std::vector<BlockEncoding> groups;
+  std::vector<VarDataLayout> varData;
+};
+
+inline BlockEncoding makeBlockEncoding(const BlockLayout &layout,
+                                       std::string_view name = {}) {
+  BlockEncoding encoding{name,
+                         static_cast<std::uint16_t>(layout.blockLength()),
+                         layout.fields,
+                         {},
+                         layout.varData};
+  for (auto &group : layout.groups) {
+    encoding.groups.push_back(makeBlockEncoding(group.block, group.name));
+  }
+  return encoding;
+}
+
+struct MessageEncoding {
+  MessageHeader header;
+  BlockEncoding block;
+};
+
+inline MessageEncoding makeMessageEncoding(const MessageLayout &layout) {
+  auto block = makeBlockEncoding(layout.block);
+  return MessageEncoding{MessageHeader{block.blockLength, layout.templateId,
+                                       layout.schemaId, layout.version},
+                         std::move(block)};
+}
+
+// Calls 'function' with a value of the C++ type carrying 'type' on the wire
+template <typename F>
+decltype(auto) visitPrimitive(PrimitiveType type, F &&function) {
+  switch (type) {
+  case PrimitiveType::Char:
+    return function(char{});
+  case PrimitiveType::Int8:
+    return function(std::int8_t{});
+  case PrimitiveType::Int16:
+    return function(std::int16_t{});
+  case PrimitiveType::Int32:
+    return function(std::int32_t{});
+  case PrimitiveType::Int64:
+    return function(std::int64_t{});
+  case PrimitiveType::UInt8:
+    return function(std::uint8_t{});
+  case PrimitiveType::UInt16:
+    return function(std::uint16_t{});
+  case PrimitiveType::UInt32:
+    return function(std::uint32_t{});
+  case PrimitiveType::UInt64:
+    return function(std::uint64_t{});
+  case PrimitiveType::Float:
+    return function(float{});
+  case PrimitiveType::Double:
+    break;
+  }
+  return function(double{});
+}
+
+template <typename T> T toWireOrder(T value) {
+  if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+    return value;
+  } else {
+    using BitsT = std::conditional_t<
+        sizeof(T) == 2, std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>;
+    return std::bit_cast<T>(std::byteswap(std::bit_cast<BitsT>(value)));
+  }
+}
+
+template <typename T> T loadLittleEndian(const char *source) {
+  T value;
+  std::memcpy(&value, source, sizeof(T));
+  return toWireOrder(value);
+}
+
+template <typename T> void storeLittleEndian(char *target, T value) {
+  value = toWireOrder(value);
+  std::memcpy(target, &value, sizeof(T));
+}
+
+// Null values of optional fields per the specification
+template <typename T> constexpr T nullValue() {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::numeric_limits<T>::quiet_NaN();
+  } else if constexpr (std::is_same_v<T, char>) {
+    return '\0';
+  } else if constexpr (std::is_signed_v<T>) {
+    return std::numeric_limits<T>::min();
+  } else {
+    return std::numeric_limits<T>::max();
+  }
+}
+
+template <typename T> bool isNullValue(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(value);
+  } else {
+    return value == nullValue<T>();
+  }
+}
+
+} // namespace moped::sbe
@@ -59,6 +59,10 @@ public:
     }
   }
 
+  static ScaledInteger fromRawIntegerValue(I rawIntegerValue) {
+    return ScaledInteger{rawIntegerValue};
+  }
+
   ScaledInteger(const ScaledInteger &other) = default;
   ScaledInteger &operator=(const ScaledInteger &other) = default;
 
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "moped/CompositeSlotRing.hpp"
+#include "moped/concepts.hpp"
+
+namespace moped {
+
+// Publishes each decoded collection element to a CompositeSlotRing so a
+// consumer thread can process elements while the document is still being
+// parsed. Elements are decoded directly into ring slots, acquiring a slot
+// waits for the consumer when the ring is full.
+
+template <typename ValueT, std::size_t Capacity,
+          RingProducers Producers = RingProducers::Single>
+class SlotPublishingCollectionDispatcher {
+
+public:
+  using value_type = ValueT;
+  using RingT = CompositeSlotRing<ValueT, Capacity, Producers>;
+  static constexpr bool RecyclesCapture = true;
+
+  // Always bound to a ring, composites holding one construct it from theirs
+  SlotPublishingCollectionDispatcher(RingT &ring) : _ring(&ring) {}
+
+  ValueT &resetCapture() {
+    if (!_captureSlot) {
+      _captureSlot = &_ring->acquire();
+    }
+    return _captureSlot->value;
+  }
+
+  void setCurrentValue(const ValueT &value) { resetCapture() = value; }
+
+  Expected dispatchLastCapture() {
+    if (!_captureSlot) {
+      return {};
+    }
+    _ring->publish(*_captureSlot);
+    _captureSlot = nullptr;
+    return {};
+  }
+
+  Expected dispatch(const ValueT &value) {
+    setCurrentValue(value);
+    return dispatchLastCapture();
+  }
+
+  void setRing(RingT &ring) { _ring = &ring; }
+
+private:
+  RingT *_ring;
+  typename RingT::Slot *_captureSlot{nullptr};
+};
+
+} // namespace moped
@@ -15,9 +15,13 @@ template <typename FractionalDurationT = std::chrono::milliseconds>
 class DurationSinceEpochFormatter {
 public:
   static std::string format(moped::TimePoint value) {
-    auto fractionalUnits = std::chrono::duration_cast<FractionalDurationT>(
-        value.time_since_epoch());
-    return std::to_string(fractionalUnits.count());
+    return std::to_string(getTimeUnits(value));
+  }
+
+  static std::int64_t getTimeUnits(moped::TimePoint value) {
+    return std::chrono::duration_cast<FractionalDurationT>(
+               value.time_since_epoch())
+        .count();
   }
 
   static std::expected<TimePoint, ParseError>
@@ -199,4 +203,108 @@ public:
   }
 };
 
+// FIX UTCTimestamp, YYYYMMDD-HH:MM:SS followed by as many fractional digits
+// as FractionalDurationT resolves. write() renders straight into a caller's
+// buffer from calendar arithmetic, avoiding gmtime and strftime on the
+// encode path. Parsing accepts any fractional precision up to nanoseconds.
+template <typename FractionalDurationT = std::chrono::milliseconds>
+class UTCTimestampFormatter {
+  static constexpr int fractionalDigits() {
+    int digits = 0;
+    for (auto den = FractionalDurationT::period::den; den > 1; den /= 10) {
+      ++digits;
+    }
+    return digits;
+  }
+
+  static char *writeDigits(char *target, std::uint32_t value, int width) {
+    for (int index = width - 1; index >= 0; --index) {
+      target[index] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    return target + width;
+  }
+
+  static bool readDigits(std::string_view input, std::size_t offset,
+                         int width, int &value) {
+    value = 0;
+    for (int index = 0; index < width; ++index) {
+      char c = input[offset + index];
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      value = value * 10 + (c - '0');
+    }
+    return true;
+  }
+
+public:
+  static constexpr int FractionalDigits = fractionalDigits();
+  static_assert(FractionalDigits <= 9,
+                "UTCTimestamp precision is limited to nanoseconds");
+  static constexpr std::size_t Length =
+      17 + (FractionalDigits > 0 ? FractionalDigits + 1 : 0);
+
+  static char *write(char *target, moped::TimePoint value) {
+    using namespace std::chrono;
+    auto units = duration_cast<FractionalDurationT>(value.time_since_epoch());
+    auto day = floor<days>(units);
+    year_month_day date{sys_days{day}};
+    hh_mm_ss time{units - day};
+    target = writeDigits(target, static_cast<int>(date.year()), 4);
+    target = writeDigits(target, static_cast<unsigned>(date.month()), 2);
+    target = writeDigits(target, static_cast<unsigned>(date.day()), 2);
+    *target++ = '-';
+    target = writeDigits(target, time.hours().count(), 2);
+    *target++ = ':';
+    target = writeDigits(target, time.minutes().count(), 2);
+    *target++ = ':';
+    target = writeDigits(target, time.seconds().count(), 2);
+    if constexpr (FractionalDigits > 0) {
+      *target++ = '.';
+      target = writeDigits(target, time.subseconds().count(), FractionalDigits);
+    }
+    return target;
+  }
+
+  static std::string format(moped::TimePoint value) {
+    std::string text(Length, '\0');
+    write(text.data(), value);
+    return text;
+  }
+
+  static std::expected<TimePoint, ParseError> getTimeValue(auto src) {
+    using namespace std::chrono;
+    auto input = std::string_view{src};
+    int year, month, day, hour, minute, second;
+    if (input.size() < 17 || input[8] != '-' || input[11] != ':' ||
+        input[14] != ':' || !readDigits(input, 0, 4, year) ||
+        !readDigits(input, 4, 2, month) || !readDigits(input, 6, 2, day) ||
+        !readDigits(input, 9, 2, hour) || !readDigits(input, 12, 2, minute) ||
+        !readDigits(input, 15, 2, second)) {
+      return std::unexpected(ParseError{"Invalid UTCTimestamp", input});
+    }
+    year_month_day date{std::chrono::year{year},
+                        std::chrono::month{static_cast<unsigned>(month)},
+                        std::chrono::day{static_cast<unsigned>(day)}};
+    if (!date.ok() || hour > 23 || minute > 59 || second > 60) {
+      return std::unexpected(ParseError{"Invalid UTCTimestamp", input});
+    }
+    nanoseconds fraction{0};
+    if (input.size() > 17) {
+      auto digits = input.substr(18);
+      int value = 0;
+      if (input[17] != '.' || digits.empty() || digits.size() > 9 ||
+          !readDigits(digits, 0, static_cast<int>(digits.size()), value)) {
+        return std::unexpected(ParseError{"Invalid UTCTimestamp", input});
+      }
+      fraction = nanoseconds{value * scale10<std::int64_t>(
+                                         9 - static_cast<int>(digits.size()))};
+    }
+    return TimePoint{duration_cast<TimePoint::duration>(
+        sys_days{date}.time_since_epoch() + hours{hour} + minutes{minute} +
+        seconds{second} + fraction)};
+  }
+};
+
 } // namespace moped
\ No newline at end of file
@@ -0,0 +1,346 @@
+#pragma once
+#include "moped/MappedObjectParseEncoderDispatcher.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/TimeFormatters.hpp"
+#include "moped/concepts.hpp"
+#include "moped/moped.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moped {
+
+// Emitter context writing block style YAML into a buffer owned by the
+// context and reused for every document. Nested composites and maps become
+// indented mappings, collections become "- " sequences, and a composite in a
+// sequence starts on its dash line. Each string scalar is scanned once to
+// choose between writing it plain or double quoted, quoting whatever a YAML
+// reader would otherwise take for another type, an indicator or a comment.
+// Composites with nothing to emit are written as {}.
+template <typename TimePointFormatter = DurationSinceEpochFormatter<>>
+class YAMLEmitterContext {
+public:
+  static constexpr std::size_t IndentWidth = 2;
+
+  void onObjectStart(std::optional<std::string_view> memberId = std::nullopt) {
+    if (_frames.empty()) {
+      _buffer.clear();
+      _pending = Pending::None;
+      _frames.push_back(Frame{false, 0});
+      return;
+    }
+    if (memberId && memberId->empty() && !_frames.back().sequence) {
+      // Embedded members publish into the enclosing mapping
+      _frames.push_back(Frame{false, _frames.back().indent, true});
+      return;
+    }
+    openNode(memberId, false);
+  }
+
+  void onObjectFinish() { closeFrame("{}"); }
+
+  void onArrayStart(std::optional<std::string_view> memberId) {
+    if (memberId && memberId->empty() && _frames.size() == 1 &&
+        _frames.back().entries == 0) {
+      // A root composite publishing a single embedded collection is the
+      // sequence itself
+      _frames.back().entries = 1;
+      _frames.push_back(Frame{true, 0, true});
+      return;
+    }
+    openNode(memberId, true);
+  }
+
+  void onArrayValueEntry(const auto &value) {
+    beginSequenceEntry();
+    writeScalar(value);
+    endScalar();
+  }
+
+  void onArrayFinish() { closeFrame("[]"); }
+
+  void onObjectValueEntry(const auto &memberId, const auto &value) {
+    beginMappingEntry(memberId);
+    _buffer += ' ';
+    writeScalar(value);
+    endScalar();
+  }
+
+  template <typename T>
+  void onObjectValueEntry(const auto &memberId,
+                          const std::optional<T> &value) {
+    if (!value.has_value()) {
+      return; // Absent members are omitted
+    }
+    onObjectValueEntry(memberId, value.value());
+  }
+
+  // The last document written, valid until the next document is started
+  std::string_view getDocument() const { return _buffer; }
+
+private:
+  // Output owed before the next token: a line break and indentation after
+  // "key:", nothing after a "- " that the entry continues
+  enum class Pending : std::uint8_t { None, AfterKey, AfterDash };
+
+  // 'indent' is the column of the frame's keys or dashes, embedded frames
+  // share their parent's lines and are never written as {} or []
+  struct Frame {
+    bool sequence;
+    std::size_t indent;
+    bool embedded{false};
+    std::size_t entries{0};
+  };
+
+  // Counts the entry against its frame and the embedded frames it passes
+  // through, returning the frame whose lines it is written on
+  Frame &entryFrame() {
+    for (auto frame = _frames.rbegin(); frame != _frames.rend(); ++frame) {
+      ++frame->entries;
+      if (!frame->embedded) {
+        return *frame;
+      }
+    }
+    return _frames.front();
+  }
+
+  void writeIndent(std::size_t indent) {
+    if (_pending == Pending::AfterDash) {
+      _pending = Pending::None;
+      return; // The entry continues on the dash line
+    }
+    if (_pending == Pending::AfterKey) {
+      _buffer += '\n';
+      _pending = Pending::None;
+    }
+    _buffer.append(indent, ' ');
+  }
+
+  std::size_t beginMappingEntry(const auto &key) {
+    auto indent = entryFrame().indent;
+    writeIndent(indent);
+    writeScalar(key);
+    _buffer += ':';
+    return indent;
+  }
+
+  std::size_t beginSequenceEntry() {
+    auto indent = entryFrame().indent;
+    writeIndent(indent);
+    _buffer += "- ";
+    return indent;
+  }
+
+  void endScalar() {
+    _buffer += '\n';
+    _pending = Pending::None;
+  }
+
+  // Sequence entries open on their dash line, member values on the lines
+  // following their key
+  void openNode(std::optional<std::string_view> memberId, bool sequence) {
+    std::size_t indent;
+    if (_frames.back().sequence || !memberId) {
+      indent = beginSequenceEntry();
+      _pending = Pending::AfterDash;
+    } else {
+      indent = beginMappingEntry(*memberId);
+      _pending = Pending::AfterKey;
+    }
+    _frames.push_back(Frame{sequence, indent + IndentWidth});
+  }
+
+  void closeFrame(std::string_view emptyNode) {
+    auto frame = _frames.back();
+    _frames.pop_back();
+    if (frame.entries == 0 && !frame.embedded) {
+      if (_pending == Pending::AfterKey) {
+        _buffer += ' ';
+      }
+      _buffer += emptyNode;
+      endScalar();
+    }
+  }
+
+  template <typename IntegralT> void writeInteger(IntegralT value) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    _buffer.append(digits, end);
+  }
+
+  template <typename FloatT> void writeFloat(FloatT value) {
+    if (std::isnan(value)) {
+      _buffer += ".nan";
+    } else if (std::isinf(value)) {
+      _buffer += value < 0 ? "-.inf" : ".inf";
+    } else {
+      char digits[32];
+      auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+      _buffer.append(digits, end);
+    }
+  }
+
+  static bool isIndicator(char c) {
+    switch (c) {
+    case '-':
+    case '?':
+    case ':':
+    case ',':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case '#':
+    case '&':
+    case '*':
+    case '!':
+    case '|':
+    case '>':
+    case '\'':
+    case '"':
+    case '%':
+    case '@':
+    case '`':
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // Plain scalars YAML resolves to booleans or null
+  static bool isReservedWord(std::string_view text) {
+    if (text.size() > 5) {
+      return false;
+    }
+    char lower[5];
+    for (std::size_t index = 0; index < text.size(); ++index) {
+      auto c = text[index];
+      lower[index] = c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
+    }
+    std::string_view word{lower, text.size()};
+    return word == "true" || word == "false" || word == "null" ||
+           word == "~" || word == "yes" || word == "no" || word == "on" ||
+           word == "off";
+  }
+
+  // One pass decides whether the text can be written plain and, if not,
+  // whether the quoted form needs any escapes. Leading digits, signs and
+  // dots are quoted so numeric looking text stays a string.
+  void writeText(std::string_view text) {
+    bool quote = text.empty() || isIndicator(text.front()) ||
+                 (text.front() >= '0' && text.front() <= '9') ||
+                 text.front() == '+' || text.front() == '.' ||
+                 text.front() == ' ' || text.back() == ' ' ||
+                 text.back() == ':';
+    bool escape = false;
+    char previous = ' ';
+    for (char c : text) {
+      auto byte = static_cast<unsigned char>(c);
+      if (byte < 0x20 || byte == 0x7f || c == '"' || c == '\\') {
+        escape = true;
+      } else if ((c == ' ' && previous == ':') ||
+                 (c == '#' && previous == ' ')) {
+        quote = true;
+      }
+      previous = c;
+    }
+    if (!quote && !escape && !isReservedWord(text)) {
+      _buffer += text;
+      return;
+    }
+    _buffer += '"';
+    if (!escape) {
+      _buffer += text;
+    } else {
+      for (char c : text) {
+        switch (c) {
+        case '"':
+          _buffer += "\\\"";
+          break;
+        case '\\':
+          _buffer += "\\\\";
+          break;
+        case '\n':
+          _buffer += "\\n";
+          break;
+        case '\r':
+          _buffer += "\\r";
+          break;
+        case '\t':
+          _buffer += "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+            std::format_to(std::back_inserter(_buffer), "\\x{:02x}",
+                           static_cast<unsigned char>(c));
+          } else {
+            _buffer += c;
+          }
+        }
+      }
+    }
+    _buffer += '"';
+  }
+
+  template <is_allowed_itegral I, std::uint8_t Scale10V>
+  void writeScalar(const ScaledInteger<I, Scale10V> &value) {
+    std::format_to(std::back_inserter(_buffer), "{}", value);
+  }
+
+  template <typename T> void writeScalar(const T &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      _buffer += value ? "true" : "false";
+    } else if constexpr (std::is_same_v<T, char>) {
+      writeText(std::string_view{&value, 1});
+    } else if constexpr (std::is_integral_v<T>) {
+      writeInteger(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      writeFloat(value);
+    } else if constexpr (std::is_same_v<T, TimePoint>) {
+      writeText(TimePointFormatter::format(value));
+    } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+      writeText(std::string_view{value});
+    } else {
+      std::ostringstream text;
+      text << value;
+      writeText(text.view());
+    }
+  }
+
+  std::string _buffer;
+  std::vector<Frame> _frames;
+  Pending _pending{Pending::None};
+};
+
+template <typename T, typename TimePointFormatter>
+std::string_view encodeToYAML(const T &mopedObject,
+                              YAMLEmitterContext<TimePointFormatter> &context) {
+  auto handler =
+      getMOPEDHandlerForParser<T, StringDecodingTraits<TimePointFormatter>>();
+  handler.setTargetMember(const_cast<T &>(mopedObject));
+  handler.applyEmitterContext(context);
+  return context.getDocument();
+}
+
+template <typename T, typename... FormatArgs>
+std::string encodeToYAMLString(const T &mopedObject, FormatArgs...) {
+  YAMLEmitterContext<FormatArgs...> context;
+  return std::string{encodeToYAML(mopedObject, context)};
+}
+
+template <typename T, typename... FormatArgs>
+void encodeToYAMLStream(const T &mopedObject, std::ostream &output,
+                        FormatArgs... args) {
+  YAMLEmitterContext<FormatArgs...> context;
+  output << encodeToYAML(mopedObject, context);
+}
+
+} // namespace moped
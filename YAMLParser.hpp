@@ -2,159 +2,622 @@
 
 #include <yaml.h>
 
-#include "ParserBase.hpp"
+#include "YAMLParserBase.hpp"
 #include "concepts.hpp"
+#include <cerrno>
+#include <cstdint>
 #include <format>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
 
 namespace moped {
 
+// Parses YAML through libyaml into parse events. Input is either a view of
+// a whole document or read on demand from a stream or file descriptor, in
+// the chunks libyaml asks for, so large files never have to be held in
+// memory. Scalars are passed to the dispatcher straight from libyaml's
+// event, which is released once dispatched, and classified without
+// allocating.
+//
+// Anchored nodes are recorded once, as they are dispatched, into a compact
+// tape of events and replayed into the dispatcher for each alias. Merge keys
+// ("<<") are resolved when their mapping ends, so the mapping's own keys
+// take precedence over merged ones wherever they appear. The total number
+// of replayed events is bounded to guard against alias bombs.
 template <IParserEventDispatchC ParseEventDispatchT>
-class YAMLParser : public ParserBase {
+class YAMLParser : public YAMLParserBase {
 public:
   using ExpectedText = std::expected<std::string_view, ParseError>;
 
-  YAMLParser() {
-    yaml_parser_initialize(&_parser);
-    _parser.read_handler = nullptr;
-    _parser.read_handler_data = nullptr;
-  }
+  static constexpr std::size_t DefaultAliasExpansionLimit = 1 << 20;
+
+  YAMLParser() { yaml_parser_initialize(&_parser); }
 
   ~YAMLParser() { yaml_parser_delete(&_parser); }
 
+  YAMLParser(const YAMLParser &) = delete;
+  YAMLParser &operator=(const YAMLParser &) = delete;
+
   auto &getDispatcher() { return _eventDispatch; }
 
+  // Bounds the number of events replayed for aliases in one document
+  void setAliasExpansionLimit(std::size_t limit) {
+    _aliasExpansionLimit = limit;
+  }
+
   Expected parseInputView(std::string_view input) {
-    enum class Context { MappingKey, MappingValue, Sequence, None };
-    std::stack<Context> contextStack;
-    std::optional<std::string_view> lastKey;
-
-    auto parseYAMLEvent = [this]() {
-      return yaml_parser_parse(&_parser, &_event) &&
-             _parser.error == YAML_NO_ERROR &&
-             _parser.state != YAML_PARSE_END_STATE;
-    };
+    setInputView(input);
+    return parseDocument();
+  }
 
+  Expected parse(std::istream &input) {
+    setInput(input);
+    return parseDocument();
+  }
+
+  // Starts a stream of documents read with parseNextDocument, 'input' must
+  // outlive the stream
+  void setInputView(std::string_view input) {
+    resetParser();
     yaml_parser_set_input_string(
         &_parser, reinterpret_cast<const unsigned char *>(input.data()),
         input.size());
-    while (true) {
-      if (!parseYAMLEvent()) {
-        return std::unexpected(ParseError{getErrorText()});
+  }
+
+  void setInput(std::istream &input) {
+    resetParser();
+    yaml_parser_set_input(&_parser, &readStream, &input);
+  }
+
+  // The descriptor is held by the parser, libyaml reads through it for as
+  // long as the stream is parsed. It is left open.
+  void setInputFileDescriptor(int fileDescriptor) {
+    resetParser();
+    _fileDescriptor = fileDescriptor;
+    yaml_parser_set_input(&_parser, &readFileDescriptor, &_fileDescriptor);
+  }
+
+  // Dispatches the next non-empty document of the stream, false once the
+  // stream ends. Anchors are scoped to their document.
+  std::expected<bool, ParseError> parseNextDocument() {
+    resetDocument();
+    bool dispatched = false;
+    while (!_streamEnded) {
+      if (!yaml_parser_parse(&_parser, &_event)) {
+        return std::unexpected(parseError());
       }
+      EventGuard guard{_event};
       switch (_event.type) {
       case YAML_STREAM_START_EVENT:
-      case YAML_STREAM_END_EVENT:
-      case YAML_NO_EVENT:
-      case YAML_ALIAS_EVENT:
       case YAML_DOCUMENT_START_EVENT:
-      case YAML_DOCUMENT_END_EVENT: {
-        // No-op for these events
         break;
-      }
-      case YAML_MAPPING_START_EVENT: {
-        auto objectStartResult = _eventDispatch.onObjectStart();
-        if (!objectStartResult) {
-          return objectStartResult; // Both are Expected, return directly
+      case YAML_STREAM_END_EVENT:
+        _streamEnded = true;
+        break;
+      case YAML_DOCUMENT_END_EVENT:
+        if (dispatched) {
+          return true;
         }
-        contextStack.push(Context::MappingKey);
         break;
-      }
-      case YAML_MAPPING_END_EVENT: {
-        auto objectFinishResult = _eventDispatch.onObjectFinish();
-        if (!objectFinishResult) {
-          return objectFinishResult; // Both are Expected, return directly
+      case YAML_SCALAR_EVENT:
+        // An empty document holds a lone empty plain scalar
+        if (_nesting == 0 && _event.data.scalar.length == 0 &&
+            _event.data.scalar.style == YAML_PLAIN_SCALAR_STYLE &&
+            _event.data.scalar.anchor == nullptr) {
+          break;
         }
-        if (!contextStack.empty())
-          contextStack.pop();
-        if ((!contextStack.empty()) &&
-            (contextStack.top() == Context::MappingValue)) {
-          contextStack.pop();
+        [[fallthrough]];
+      default:
+        if (auto result = onParsedEvent(); !result) {
+          return std::unexpected(result.error());
         }
-        break;
+        dispatched = true;
       }
+    }
+    return false;
+  }
 
-      case YAML_SEQUENCE_START_EVENT: {
-        auto arrayStartResult = _eventDispatch.onArrayStart();
-        if (!arrayStartResult) {
-          return arrayStartResult; // Both are Expected, return directly
-        }
-        contextStack.push(Context::Sequence);
-        break;
+  // Reads from 'fileDescriptor' until the document ends, the descriptor is
+  // left open
+  Expected parseFileDescriptor(int fileDescriptor) {
+    setInputFileDescriptor(fileDescriptor);
+    return parseDocument();
+  }
+
+private:
+  enum class NodeEvent : std::uint8_t {
+    MappingStart,
+    MappingEnd,
+    SequenceStart,
+    SequenceEnd,
+    Scalar,
+    Alias
+  };
+
+  // A recorded event, scalar text is held in _tapeText at 'offset', alias
+  // events refer to their anchor by index in 'offset'
+  struct TapeEvent {
+    NodeEvent kind;
+    bool plain;
+    std::uint32_t offset;
+    std::uint32_t length;
+  };
+
+  // Tape range of an anchored node, 'end' is Recording until the node ends
+  struct Anchor {
+    std::string name;
+    std::uint32_t begin;
+    std::uint32_t end;
+    std::uint32_t nesting;
+  };
+
+  static constexpr std::uint32_t Recording = ~std::uint32_t{0};
+
+  // A key of an open mapping, its text is held in _keyText at 'offset' and
+  // the hash only screens candidates before the text is compared
+  struct MappingKey {
+    std::uint64_t hash;
+    std::uint32_t offset;
+    std::uint32_t length;
+  };
+
+  // Mappings track their keys in _mappingKeys and the tape positions of
+  // their merge values in _merges from the given offsets
+  struct Frame {
+    bool mapping;
+    bool expectingValue;
+    std::uint32_t keysBegin;
+    std::uint32_t mergesBegin;
+  };
+
+  // Releases libyaml's allocations for the event once it's dispatched
+  struct EventGuard {
+    yaml_event_t &event;
+    ~EventGuard() { yaml_event_delete(&event); }
+  };
+
+  static int readStream(void *data, unsigned char *buffer, size_t size,
+                        size_t *sizeRead) {
+    auto &input = *static_cast<std::istream *>(data);
+    input.read(reinterpret_cast<char *>(buffer),
+               static_cast<std::streamsize>(size));
+    *sizeRead = static_cast<size_t>(input.gcount());
+    return input.bad() ? 0 : 1;
+  }
+
+  static int readFileDescriptor(void *data, unsigned char *buffer,
+                                size_t size, size_t *sizeRead) {
+    auto fileDescriptor = *static_cast<int *>(data);
+    ssize_t result;
+    do {
+      result = ::read(fileDescriptor, buffer, size);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+      return 0;
+    }
+    *sizeRead = static_cast<size_t>(result);
+    return 1;
+  }
+
+  // libyaml parsers take their input once, each parse starts afresh
+  void resetParser() {
+    if (_inputSet) {
+      yaml_parser_delete(&_parser);
+      yaml_parser_initialize(&_parser);
+    }
+    _inputSet = true;
+    _streamEnded = false;
+    resetDocument();
+  }
+
+  void resetDocument() {
+    _frames.clear();
+    _mappingKeys.clear();
+    _keyText.clear();
+    _merges.clear();
+    _tape.clear();
+    _tapeText.clear();
+    _anchors.clear();
+    _openAnchors.clear();
+    _nesting = 0;
+    _capturing = false;
+    _replayedEvents = 0;
+  }
+
+  static bool isMergeKey(std::string_view value, bool plain) {
+    return plain && value == "<<";
+  }
+
+  static std::uint64_t hashKey(std::string_view key) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : key) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  std::string_view tapeText(const TapeEvent &event) const {
+    if (event.kind != NodeEvent::Scalar) {
+      return {};
+    }
+    return std::string_view{_tapeText}.substr(event.offset, event.length);
+  }
+
+  // Replayed scalars already live in _tapeText and are referenced in place
+  void appendTape(NodeEvent kind, std::string_view value, bool plain,
+                  std::uint32_t anchorIndex) {
+    TapeEvent event{kind, plain, anchorIndex, 0};
+    if (kind == NodeEvent::Scalar) {
+      event.length = static_cast<std::uint32_t>(value.size());
+      if (!value.empty() && value.data() >= _tapeText.data() &&
+          value.data() < _tapeText.data() + _tapeText.size()) {
+        event.offset = static_cast<std::uint32_t>(value.data() -
+                                                  _tapeText.data());
+      } else {
+        event.offset = static_cast<std::uint32_t>(_tapeText.size());
+        _tapeText.append(value);
       }
-      case YAML_SEQUENCE_END_EVENT: {
-        auto arrayFinishResult = _eventDispatch.onArrayFinish();
-        if (!arrayFinishResult) {
-          return arrayFinishResult; // Both are Expected, return directly
-        }
-        if (!contextStack.empty())
-          contextStack.pop();
-        if ((!contextStack.empty()) &&
-            (contextStack.top() == Context::MappingValue)) {
-          contextStack.pop();
-        }
+    }
+    _tape.push_back(event);
+  }
+
+  // One past the tape node starting at 'index'
+  std::uint32_t nodeEnd(std::uint32_t index) const {
+    int depth = 0;
+    do {
+      switch (_tape[index].kind) {
+      case NodeEvent::MappingStart:
+      case NodeEvent::SequenceStart:
+        ++depth;
+        break;
+      case NodeEvent::MappingEnd:
+      case NodeEvent::SequenceEnd:
+        --depth;
+        break;
+      default:
         break;
       }
-      case YAML_SCALAR_EVENT: {
-        std::string_view value(
-            reinterpret_cast<const char *>(_event.data.scalar.value),
-            _event.data.scalar.length);
-
-        // Are we in a mapping and expecting a key?
-        if (!contextStack.empty() &&
-            contextStack.top() == Context::MappingKey) {
-          lastKey = value;
-          auto memberResult = _eventDispatch.onMember(value);
-          if (!memberResult) {
-            return memberResult; // Both are Expected, return directly
-          }
-          contextStack.push(Context::MappingValue);
-        } else {
-          // Value position (either mapping value or sequence element)
-          std::string value_str(value);
-          if (value == "true" || value == "false") {
-            auto boolResult = _eventDispatch.onBooleanValue(value == "true");
-            if (!boolResult) {
-              return boolResult; // Both are Expected, return directly
-            }
-          } else if (value == "null") {
-            auto nullResult = _eventDispatch.onNullValue();
-            if (!nullResult) {
-              return nullResult; // Both are Expected, return directly
-            }
-          } else if (ParserBase::isNumeric(value_str)) {
-            auto numericResult = _eventDispatch.onNumericValue(value);
-            if (!numericResult) {
-              return numericResult; // Both are Expected, return directly
-            }
-          } else {
-            auto stringResult = _eventDispatch.onStringValue(value);
-            if (!stringResult) {
-              return stringResult; // Both are Expected, return directly
+      ++index;
+    } while (depth > 0);
+    return index;
+  }
+
+  void valueComplete() {
+    if (!_frames.empty() && _frames.back().mapping) {
+      _frames.back().expectingValue = false;
+    }
+  }
+
+  // The value of a merge key is recorded, rather than dispatched, and
+  // merged once its mapping ends
+  void captureEvent(NodeEvent kind, std::string_view value, bool plain,
+                    std::uint32_t anchorIndex) {
+    appendTape(kind, value, plain, anchorIndex);
+    if (kind == NodeEvent::MappingStart || kind == NodeEvent::SequenceStart) {
+      ++_captureNesting;
+    } else if (kind == NodeEvent::MappingEnd ||
+               kind == NodeEvent::SequenceEnd) {
+      --_captureNesting;
+    }
+    if (_captureNesting == 0) {
+      _capturing = false;
+      valueComplete();
+    }
+  }
+
+  Expected replayRange(std::uint32_t begin, std::uint32_t end) {
+    for (auto index = begin; index < end; ++index) {
+      if (++_replayedEvents > _aliasExpansionLimit) {
+        return std::unexpected("YAML alias expansion exceeds its limit");
+      }
+      auto event = _tape[index];
+      if (auto result = dispatchEvent(event.kind, tapeText(event),
+                                      event.plain, event.offset);
+          !result) {
+        return result;
+      }
+    }
+    return {};
+  }
+
+  // Merges the entries of the mapping at 'index' that the mapping being
+  // finished doesn't already hold, the merged mapping's own merge keys
+  // rank below its explicit keys
+  Expected mergeMapping(std::uint32_t index, std::size_t frameIndex) {
+    auto end = nodeEnd(index) - 1;
+    for (int pass = 0; pass < 2; ++pass) {
+      auto entry = index + 1;
+      while (entry < end) {
+        auto key = _tape[entry];
+        auto valueBegin = entry + 1;
+        auto valueEnd = nodeEnd(valueBegin);
+        entry = valueEnd;
+        if (key.kind != NodeEvent::Scalar) {
+          continue;
+        }
+        auto keyText = tapeText(key);
+        if (isMergeKey(keyText, key.plain)) {
+          if (pass == 1) {
+            if (auto result = mergeNode(valueBegin, frameIndex); !result) {
+              return result;
             }
           }
-          // If we just finished a mapping value, expect a key next
-          if (!contextStack.empty() &&
-              contextStack.top() == Context::MappingValue) {
-            contextStack.pop();
-          }
+          continue;
+        }
+        if (pass == 1 || hasKey(frameIndex, keyText)) {
+          continue;
+        }
+        addKey(keyText);
+        _frames.back().expectingValue = true;
+        if (auto result = _eventDispatch.onMember(keyText); !result) {
+          return result;
+        }
+        if (auto result = replayRange(valueBegin, valueEnd); !result) {
+          return result;
         }
-        break;
       }
-      };
-      // End of YAML document or stream
-      if (_event.type == YAML_STREAM_END_EVENT ||
-          _event.type == YAML_DOCUMENT_END_EVENT)
-        break;
     }
     return {};
   }
 
-private:
+  // Merge values are a mapping, an alias of one or a sequence of either,
+  // earlier mappings in a sequence take precedence
+  Expected mergeNode(std::uint32_t index, std::size_t frameIndex) {
+    auto event = _tape[index];
+    switch (event.kind) {
+    case NodeEvent::Alias:
+      return mergeNode(_anchors[event.offset].begin, frameIndex);
+    case NodeEvent::MappingStart:
+      return mergeMapping(index, frameIndex);
+    case NodeEvent::SequenceStart: {
+      auto end = nodeEnd(index) - 1;
+      for (auto element = index + 1; element < end;
+           element = nodeEnd(element)) {
+        if (auto result = mergeNode(element, frameIndex); !result) {
+          return result;
+        }
+      }
+      return {};
+    }
+    default:
+      break;
+    }
+    return std::unexpected("YAML merge key values must be mappings");
+  }
+
+  void addKey(std::string_view key) {
+    _mappingKeys.push_back(MappingKey{
+        hashKey(key), static_cast<std::uint32_t>(_keyText.size()),
+        static_cast<std::uint32_t>(key.size())});
+    _keyText.append(key);
+  }
+
+  bool hasKey(std::size_t frameIndex, std::string_view key) const {
+    auto hash = hashKey(key);
+    for (auto index = _frames[frameIndex].keysBegin;
+         index < _mappingKeys.size(); ++index) {
+      auto &mappingKey = _mappingKeys[index];
+      if (mappingKey.hash == hash &&
+          std::string_view{_keyText}.substr(mappingKey.offset,
+                                            mappingKey.length) == key) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Expected finishMapping() {
+    auto frameIndex = _frames.size() - 1;
+    auto frame = _frames.back();
+    auto mergesEnd = static_cast<std::uint32_t>(_merges.size());
+    for (auto merge = frame.mergesBegin; merge < mergesEnd; ++merge) {
+      if (auto result = mergeNode(_merges[merge], frameIndex); !result) {
+        return result;
+      }
+    }
+    if (frame.keysBegin < _mappingKeys.size()) {
+      _keyText.resize(_mappingKeys[frame.keysBegin].offset);
+      _mappingKeys.resize(frame.keysBegin);
+    }
+    _merges.resize(frame.mergesBegin);
+    _frames.pop_back();
+    if (auto result = _eventDispatch.onObjectFinish(); !result) {
+      return result;
+    }
+    valueComplete();
+    return {};
+  }
+
+  // Dispatches a parsed or replayed event
+  Expected dispatchEvent(NodeEvent kind, std::string_view value, bool plain,
+                         std::uint32_t anchorIndex) {
+    if (_capturing) {
+      captureEvent(kind, value, plain, anchorIndex);
+      return {};
+    }
+    switch (kind) {
+    case NodeEvent::MappingStart:
+    case NodeEvent::SequenceStart: {
+      bool mapping = kind == NodeEvent::MappingStart;
+      auto result = mapping ? _eventDispatch.onObjectStart()
+                            : _eventDispatch.onArrayStart();
+      if (!result) {
+        return result;
+      }
+      _frames.push_back(Frame{mapping, false,
+                              static_cast<std::uint32_t>(_mappingKeys.size()),
+                              static_cast<std::uint32_t>(_merges.size())});
+      return {};
+    }
+    case NodeEvent::MappingEnd:
+      return finishMapping();
+    case NodeEvent::SequenceEnd: {
+      _frames.pop_back();
+      if (auto result = _eventDispatch.onArrayFinish(); !result) {
+        return result;
+      }
+      valueComplete();
+      return {};
+    }
+    case NodeEvent::Alias:
+      return replayRange(_anchors[anchorIndex].begin,
+                         _anchors[anchorIndex].end);
+    case NodeEvent::Scalar:
+      break;
+    }
+    // Are we in a mapping and expecting a key?
+    if (!_frames.empty() && _frames.back().mapping &&
+        !_frames.back().expectingValue) {
+      _frames.back().expectingValue = true;
+      if (isMergeKey(value, plain)) {
+        _merges.push_back(static_cast<std::uint32_t>(_tape.size()));
+        _capturing = true;
+        _captureNesting = 0;
+        return {};
+      }
+      addKey(value);
+      return _eventDispatch.onMember(value);
+    }
+    // Value position (either mapping value or sequence element)
+    if (auto result = dispatchScalarValue(_eventDispatch, value, plain); !result) {
+      return result;
+    }
+    valueComplete();
+    return {};
+  }
+
+  std::expected<std::uint32_t, ParseError> findAnchor(const char *name) const {
+    for (auto index = _anchors.size(); index-- > 0;) {
+      if (_anchors[index].name == name) {
+        if (_anchors[index].end == Recording) {
+          return std::unexpected(
+              ParseError{"YAML alias refers to its own anchored node",
+                         std::string{name}});
+        }
+        return static_cast<std::uint32_t>(index);
+      }
+    }
+    return std::unexpected(
+        ParseError{"Undefined YAML alias", std::string{name}});
+  }
+
+  // Records events of anchored nodes as they pass, then dispatches them
+  Expected onParsedEvent() {
+    NodeEvent kind;
+    std::string_view value;
+    bool plain = false;
+    std::uint32_t anchorIndex = 0;
+    const yaml_char_t *anchor = nullptr;
+    switch (_event.type) {
+    case YAML_MAPPING_START_EVENT:
+      kind = NodeEvent::MappingStart;
+      anchor = _event.data.mapping_start.anchor;
+      break;
+    case YAML_MAPPING_END_EVENT:
+      kind = NodeEvent::MappingEnd;
+      break;
+    case YAML_SEQUENCE_START_EVENT:
+      kind = NodeEvent::SequenceStart;
+      anchor = _event.data.sequence_start.anchor;
+      break;
+    case YAML_SEQUENCE_END_EVENT:
+      kind = NodeEvent::SequenceEnd;
+      break;
+    case YAML_SCALAR_EVENT:
+      kind = NodeEvent::Scalar;
+      anchor = _event.data.scalar.anchor;
+      value = std::string_view{
+          reinterpret_cast<const char *>(_event.data.scalar.value),
+          _event.data.scalar.length};
+      plain = _event.data.scalar.style == YAML_PLAIN_SCALAR_STYLE;
+      break;
+    case YAML_ALIAS_EVENT: {
+      kind = NodeEvent::Alias;
+      auto found = findAnchor(
+          reinterpret_cast<const char *>(_event.data.alias.anchor));
+      if (!found) {
+        return std::unexpected(found.error());
+      }
+      anchorIndex = *found;
+      break;
+    }
+    default:
+      return {};
+    }
+
+    if (anchor != nullptr) {
+      _openAnchors.push_back(static_cast<std::uint32_t>(_anchors.size()));
+      _anchors.push_back(Anchor{reinterpret_cast<const char *>(anchor),
+                                static_cast<std::uint32_t>(_tape.size()),
+                                Recording, _nesting});
+    }
+    if (!_openAnchors.empty() && !_capturing) {
+      appendTape(kind, value, plain, anchorIndex);
+    }
+    if (auto result = dispatchEvent(kind, value, plain, anchorIndex);
+        !result) {
+      return result;
+    }
+
+    if (kind == NodeEvent::MappingStart || kind == NodeEvent::SequenceStart) {
+      ++_nesting;
+      return {};
+    }
+    if (kind == NodeEvent::MappingEnd || kind == NodeEvent::SequenceEnd) {
+      --_nesting;
+    }
+    while (!_openAnchors.empty() &&
+           _anchors[_openAnchors.back()].nesting == _nesting) {
+      _anchors[_openAnchors.back()].end =
+          static_cast<std::uint32_t>(_tape.size());
+      _openAnchors.pop_back();
+    }
+    return {};
+  }
+
+  // Dispatches the events of the first non-empty document in the input
+  Expected parseDocument() {
+    if (auto result = parseNextDocument(); !result) {
+      return std::unexpected(result.error());
+    }
+    return {};
+  }
+
+  ParseError parseError() const {
+    if (_parser.problem == nullptr) {
+      return ParseError{getErrorText()};
+    }
+    return ParseError{getErrorText(),
+                      std::format("{} at line {} column {}", _parser.problem,
+                                  _parser.problem_mark.line + 1,
+                                  _parser.problem_mark.column + 1)};
+  }
+
   yaml_parser_t _parser;
   yaml_event_t _event;
+  bool _inputSet{false};
+  bool _streamEnded{false};
+  int _fileDescriptor{-1};
   ParseEventDispatchT _eventDispatch;
 
-  const char* getErrorText() {
+  std::vector<Frame> _frames;
+  std::vector<MappingKey> _mappingKeys;
+  std::string _keyText;
+  std::vector<std::uint32_t> _merges;
+  std::vector<TapeEvent> _tape;
+  std::string _tapeText;
+  std::vector<Anchor> _anchors;
+  std::vector<std::uint32_t> _openAnchors;
+  std::uint32_t _nesting{0};
+  bool _capturing{false};
+  int _captureNesting{0};
+  std::size_t _replayedEvents{0};
+  std::size_t _aliasExpansionLimit{DefaultAliasExpansionLimit};
+
+  const char *getErrorText() const {
     switch (_parser.error) {
     case YAML_NO_ERROR:
       return "NO ERROR";
@@ -177,4 +640,4 @@ private:
   }
 };
 
-} // namespace moped
\ No newline at end of file
+} // namespace moped
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ParserBase.hpp"
+#include "concepts.hpp"
+#include <string_view>
+
+namespace moped {
+
+// Scalar resolution shared by the YAML parsers. Only plain scalars resolve
+// to booleans, null or numbers, quoted scalars are always strings.
+class YAMLParserBase : public ParserBase {
+protected:
+  static bool isBoolean(std::string_view value, bool &result) {
+    if (value == "true" || value == "True" || value == "TRUE") {
+      result = true;
+      return true;
+    }
+    if (value == "false" || value == "False" || value == "FALSE") {
+      result = false;
+      return true;
+    }
+    return false;
+  }
+
+  static bool isNull(std::string_view value) {
+    return value == "null" || value == "Null" || value == "NULL" ||
+           value == "~";
+  }
+
+  template <IParserEventDispatchC ParseEventDispatchT>
+  static Expected dispatchScalarValue(ParseEventDispatchT &eventDispatch,
+                                      std::string_view value, bool plain) {
+    if (!plain) {
+      return eventDispatch.onStringValue(value);
+    }
+    bool booleanValue;
+    if (isBoolean(value, booleanValue)) {
+      return eventDispatch.onBooleanValue(booleanValue);
+    }
+    if (isNull(value)) {
+      return eventDispatch.onNullValue();
+    }
+    if (isNumericText(value)) {
+      return eventDispatch.onNumericValue(value);
+    }
+    return eventDispatch.onStringValue(value);
+  }
+};
+
+} // namespace moped
@@ -0,0 +1,560 @@
+#pragma once
+
+#include "concepts.hpp"
+#include "moped/YAMLParserBase.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+
+namespace moped {
+
+// Parses the block YAML subset configuration files are written in straight
+// from the input view, without libyaml: indented mappings and "- "
+// sequences, plain, single and double quoted scalars on one line, flow
+// sequences of scalars and comments. Scalars are dispatched as views into
+// the input, quoted scalars are unescaped into a reused buffer only when
+// they hold escapes.
+//
+// Anything outside the subset (anchors, aliases, tags, block scalars,
+// multi-line scalars, flow mappings, tabs) stops the parse with
+// unsupported() set, so the input can be handed to YAMLParser instead.
+// Errors raised by the dispatcher leave unsupported() clear.
+template <IParserEventDispatchC ParseEventDispatchT>
+class YAMLViewParser : public YAMLParserBase {
+public:
+  YAMLViewParser(ParseEventDispatchT &eventDispatch)
+      : _eventDispatch(eventDispatch) {}
+
+  // Dispatches the first non-empty document in 'yaml', a later "---" or
+  // "..." ends it
+  Expected parse(std::string_view yaml) {
+    _input = yaml;
+    _next = 0;
+    _indent = 0;
+    _content = {};
+    _atEnd = false;
+    _inDocument = false;
+    _unsupported = false;
+    if (_input.starts_with("\xEF\xBB\xBF")) {
+      _next = 3;
+    }
+    if (auto result = nextLine(); !result) {
+      return result;
+    }
+    if (_atEnd) {
+      return {};
+    }
+    if (auto result = parseBlockNode(); !result) {
+      return result;
+    }
+    if (!_atEnd) {
+      return unsupported("Unexpected indentation in YAML document");
+    }
+    return {};
+  }
+
+  // True when the last parse stopped at input outside the native subset
+  bool unsupported() const { return _unsupported; }
+
+  auto &getDispatcher() { return _eventDispatch; }
+
+private:
+  static constexpr auto npos = std::string_view::npos;
+
+  Expected unsupported(const char *message) {
+    _unsupported = true;
+    return std::unexpected(ParseError{message, _content});
+  }
+
+  // Moves to the next line holding content, skipping blank and comment
+  // lines, and sets _atEnd when the document ends
+  Expected nextLine() {
+    while (_next < _input.size()) {
+      auto lineEnd = _input.find('\n', _next);
+      if (lineEnd == npos) {
+        lineEnd = _input.size();
+      }
+      auto line = _input.substr(_next, lineEnd - _next);
+      _next = lineEnd + 1;
+      if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+      }
+      auto indent = line.find_first_not_of(' ');
+      if (indent == npos || line[indent] == '#') {
+        continue;
+      }
+      _content = line.substr(indent);
+      if (line.find('\t') != npos) {
+        return unsupported("Tabs are outside the native YAML subset");
+      }
+      if (indent == 0 && (isMarker(line, "---") || isMarker(line, "..."))) {
+        if (_inDocument) {
+          break;
+        }
+        if (!isLineEnd(line.substr(3))) {
+          return unsupported("Content after a YAML document marker");
+        }
+        continue;
+      }
+      _inDocument = true;
+      _indent = indent;
+      return {};
+    }
+    _atEnd = true;
+    _next = _input.size();
+    return {};
+  }
+
+  static bool isMarker(std::string_view line, std::string_view marker) {
+    return line.starts_with(marker) &&
+           (line.size() == 3 || line[3] == ' ' || line[3] == '#');
+  }
+
+  // Only whitespace or a comment remains
+  static bool isLineEnd(std::string_view rest) {
+    auto position = rest.find_first_not_of(' ');
+    return position == npos || (rest[position] == '#' && position > 0);
+  }
+
+  static bool isSequenceEntry(std::string_view content) {
+    return content[0] == '-' && (content.size() == 1 || content[1] == ' ');
+  }
+
+  // Indicators starting a node the native parser leaves to libyaml, or
+  // that can't start a plain scalar
+  static bool isUnsupportedStart(char c) {
+    switch (c) {
+    case '&':
+    case '*':
+    case '!':
+    case '|':
+    case '>':
+    case '?':
+    case ':':
+    case '%':
+    case '@':
+    case '`':
+    case ',':
+    case ']':
+    case '}':
+    case '#':
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // Position of the ':' ending a plain key, npos when the text isn't a
+  // mapping entry
+  static std::size_t findKeyIndicator(std::string_view text) {
+    for (std::size_t position = 0; position < text.size(); ++position) {
+      auto c = text[position];
+      if (c == ':' &&
+          (position + 1 == text.size() || text[position + 1] == ' ')) {
+        return position;
+      }
+      if (c == '#' && position > 0 && text[position - 1] == ' ') {
+        return npos;
+      }
+    }
+    return npos;
+  }
+
+  bool isBlockCollection(std::string_view content) const {
+    if (isSequenceEntry(content)) {
+      return true;
+    }
+    if (content[0] == '"' || content[0] == '\'') {
+      std::size_t length;
+      auto quote = content[0];
+      if (!findQuoteEnd(content, quote, length)) {
+        return false;
+      }
+      auto rest = content.substr(length);
+      auto colon = rest.find_first_not_of(' ');
+      return colon != npos && rest[colon] == ':' &&
+             (colon + 1 == rest.size() || rest[colon + 1] == ' ');
+    }
+    return !isUnsupportedStart(content[0]) && content[0] != '[' &&
+           content[0] != '{' && findKeyIndicator(content) != npos;
+  }
+
+  // Finds the closing quote on the line, 'length' is set one past it
+  static bool findQuoteEnd(std::string_view text, char quote,
+                           std::size_t &length) {
+    for (std::size_t position = 1; position < text.size(); ++position) {
+      if (quote == '"' && text[position] == '\\') {
+        ++position;
+      } else if (text[position] == quote) {
+        if (quote == '\'' && position + 1 < text.size() &&
+            text[position + 1] == '\'') {
+          ++position;
+          continue;
+        }
+        length = position + 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The block collection on the current line, at the current indentation
+  Expected parseBlockNode() {
+    if (isSequenceEntry(_content)) {
+      return parseSequence(_indent);
+    }
+    if (!isBlockCollection(_content)) {
+      return unsupported("YAML node outside the native subset");
+    }
+    return parseMapping(_indent);
+  }
+
+  // The value of a key or dash with nothing after it on the line: a more
+  // indented block, a sequence at the key's own indentation or an empty
+  // scalar
+  Expected parseNestedNode(std::size_t indent, bool allowSequence) {
+    if (auto result = nextLine(); !result) {
+      return result;
+    }
+    if (!_atEnd && _indent > indent) {
+      return parseBlockNode();
+    }
+    if (!_atEnd && allowSequence && _indent == indent &&
+        isSequenceEntry(_content)) {
+      return parseSequence(indent);
+    }
+    // An empty plain scalar, resolved as libyaml's would be
+    return dispatchScalarValue(_eventDispatch, std::string_view{}, true);
+  }
+
+  Expected parseMapping(std::size_t indent) {
+    if (auto result = _eventDispatch.onObjectStart(); !result) {
+      return result;
+    }
+    while (true) {
+      if (isSequenceEntry(_content) || !isBlockCollection(_content)) {
+        return unsupported("Expected a YAML mapping key");
+      }
+      std::string_view rest;
+      if (auto result = dispatchKey(rest); !result) {
+        return result;
+      }
+      if (auto result = isLineEnd(rest) ? parseNestedNode(indent, true)
+                                        : parseLineValue(rest);
+          !result) {
+        return result;
+      }
+      if (_atEnd || _indent < indent) {
+        break;
+      }
+      if (_indent > indent) {
+        return unsupported("Unexpected indentation in YAML mapping");
+      }
+    }
+    return _eventDispatch.onObjectFinish();
+  }
+
+  Expected parseSequence(std::size_t indent) {
+    if (auto result = _eventDispatch.onArrayStart(); !result) {
+      return result;
+    }
+    while (true) {
+      auto offset = _content.find_first_not_of(' ', 1);
+      if (offset == npos || _content[offset] == '#') {
+        if (auto result = parseNestedNode(indent, false); !result) {
+          return result;
+        }
+      } else {
+        // The entry's content is read as a line of its own at its column,
+        // covering "- key: value" and "- - value"
+        _indent = indent + offset;
+        _content.remove_prefix(offset);
+        auto result = isBlockCollection(_content)
+                          ? parseBlockNode()
+                          : parseLineValue(_content);
+        if (!result) {
+          return result;
+        }
+      }
+      if (_atEnd || _indent < indent) {
+        break;
+      }
+      if (_indent > indent) {
+        return unsupported("Unexpected indentation in YAML sequence");
+      }
+      if (!isSequenceEntry(_content)) {
+        // A sequence at its key's indentation ends at the next key
+        break;
+      }
+    }
+    return _eventDispatch.onArrayFinish();
+  }
+
+  // Dispatches the key on the current line, 'rest' is set to the text
+  // after its ':'
+  Expected dispatchKey(std::string_view &rest) {
+    std::string_view key;
+    std::size_t keyEnd;
+    if (_content[0] == '"' || _content[0] == '\'') {
+      auto text = readQuoted(_content, keyEnd, _keyScratch);
+      if (!text) {
+        return std::unexpected(text.error());
+      }
+      key = *text;
+      keyEnd = _content.find(':', keyEnd);
+    } else {
+      keyEnd = findKeyIndicator(_content);
+      key = _content.substr(0, keyEnd);
+      key.remove_suffix(key.size() - key.find_last_not_of(' ') - 1);
+      if (key == "<<") {
+        return unsupported("YAML merge keys are outside the native subset");
+      }
+    }
+    rest = _content.substr(keyEnd + 1);
+    return _eventDispatch.onMember(key);
+  }
+
+  // A scalar or flow collection ending on the current line, which is then
+  // left behind
+  Expected parseLineValue(std::string_view text) {
+    text.remove_prefix(text.find_first_not_of(' '));
+    std::size_t length;
+    if (text[0] == '"' || text[0] == '\'') {
+      auto value = readQuoted(text, length, _valueScratch);
+      if (!value) {
+        return std::unexpected(value.error());
+      }
+      if (auto result = _eventDispatch.onStringValue(*value); !result) {
+        return result;
+      }
+    } else if (text[0] == '[') {
+      if (auto result = parseFlowSequence(text, length); !result) {
+        return result;
+      }
+    } else if (text[0] == '{') {
+      length = text.find_first_not_of(' ', 1);
+      if (length == npos || text[length] != '}') {
+        return unsupported("YAML flow mappings are outside the native subset");
+      }
+      if (auto result = _eventDispatch.onObjectStart(); !result) {
+        return result;
+      }
+      if (auto result = _eventDispatch.onObjectFinish(); !result) {
+        return result;
+      }
+      ++length;
+    } else {
+      if (isUnsupportedStart(text[0]) || isSequenceEntry(text) ||
+          findKeyIndicator(text) != npos) {
+        return unsupported("YAML value outside the native subset");
+      }
+      auto comment = text.find(" #");
+      auto value = text.substr(0, comment);
+      value.remove_suffix(value.size() - value.find_last_not_of(' ') - 1);
+      if (auto result = dispatchScalarValue(_eventDispatch, value, true);
+          !result) {
+        return result;
+      }
+      length = text.size();
+    }
+    if (!isLineEnd(text.substr(length))) {
+      return unsupported("Unexpected text after a YAML value");
+    }
+    return nextLine();
+  }
+
+  // A flow sequence of scalars closed on the same line
+  Expected parseFlowSequence(std::string_view text, std::size_t &length) {
+    if (auto result = _eventDispatch.onArrayStart(); !result) {
+      return result;
+    }
+    std::size_t position = 1;
+    auto skipSpaces = [&]() {
+      while (position < text.size() && text[position] == ' ') {
+        ++position;
+      }
+    };
+    skipSpaces();
+    while (position < text.size() && text[position] != ']') {
+      auto c = text[position];
+      if (c == '"' || c == '\'') {
+        std::size_t quotedLength;
+        auto value =
+            readQuoted(text.substr(position), quotedLength, _valueScratch);
+        if (!value) {
+          return std::unexpected(value.error());
+        }
+        if (auto result = _eventDispatch.onStringValue(*value); !result) {
+          return result;
+        }
+        position += quotedLength;
+      } else {
+        auto end = text.find_first_of(",]", position);
+        if (end == npos || isUnsupportedStart(c) || c == '[' || c == '{') {
+          return unsupported("YAML flow sequence outside the native subset");
+        }
+        auto value = text.substr(position, end - position);
+        if (value.find_first_of(":#{}[") != npos) {
+          return unsupported("YAML flow sequence outside the native subset");
+        }
+        value.remove_suffix(value.size() - value.find_last_not_of(' ') - 1);
+        if (auto result = dispatchScalarValue(_eventDispatch, value, true);
+            !result) {
+          return result;
+        }
+        position = end;
+      }
+      skipSpaces();
+      if (position < text.size() && text[position] == ',') {
+        ++position;
+        skipSpaces();
+      } else if (position >= text.size() || text[position] != ']') {
+        return unsupported("YAML flow sequence outside the native subset");
+      }
+    }
+    if (position >= text.size()) {
+      return unsupported("YAML flow sequence outside the native subset");
+    }
+    length = position + 1;
+    return _eventDispatch.onArrayFinish();
+  }
+
+  // The quoted scalar opening 'text', a view into the input unless it
+  // holds escapes. 'length' is set one past the closing quote.
+  std::expected<std::string_view, ParseError>
+  readQuoted(std::string_view text, std::size_t &length,
+             std::string &scratch) {
+    auto quote = text[0];
+    if (!findQuoteEnd(text, quote, length)) {
+      return std::unexpected(
+          unsupported("Multi-line YAML scalars are outside the native subset")
+              .error());
+    }
+    auto body = text.substr(1, length - 2);
+    auto escape = quote == '"' ? '\\' : '\'';
+    if (body.find(escape) == npos) {
+      return body;
+    }
+    scratch.clear();
+    for (std::size_t position = 0; position < body.size(); ++position) {
+      auto c = body[position];
+      if (c != escape) {
+        scratch += c;
+      } else if (quote == '\'') {
+        scratch += '\'';
+        ++position;
+      } else if (!appendEscape(body, ++position, scratch)) {
+        return std::unexpected(
+            unsupported("YAML escape outside the native subset").error());
+      }
+    }
+    return std::string_view{scratch};
+  }
+
+  // Appends the escape whose letter is at 'position', leaving 'position' on
+  // its last character
+  static bool appendEscape(std::string_view body, std::size_t &position,
+                           std::string &scratch) {
+    switch (body[position]) {
+    case '0':
+      scratch += '\0';
+      return true;
+    case 'a':
+      scratch += '\a';
+      return true;
+    case 'b':
+      scratch += '\b';
+      return true;
+    case 't':
+      scratch += '\t';
+      return true;
+    case 'n':
+      scratch += '\n';
+      return true;
+    case 'v':
+      scratch += '\v';
+      return true;
+    case 'f':
+      scratch += '\f';
+      return true;
+    case 'r':
+      scratch += '\r';
+      return true;
+    case 'e':
+      scratch += '\x1b';
+      return true;
+    case ' ':
+    case '"':
+    case '/':
+    case '\\':
+      scratch += body[position];
+      return true;
+    case 'x':
+      return appendCodePoint(body, position, 2, scratch);
+    case 'u':
+      return appendCodePoint(body, position, 4, scratch);
+    case 'U':
+      return appendCodePoint(body, position, 8, scratch);
+    default:
+      return false;
+    }
+  }
+
+  // Appends the UTF-8 encoding of the 'digits' hex digits after 'position'
+  static bool appendCodePoint(std::string_view body, std::size_t &position,
+                              std::size_t digits, std::string &scratch) {
+    if (body.size() - position <= digits) {
+      return false;
+    }
+    std::uint32_t codePoint = 0;
+    for (std::size_t index = 0; index < digits; ++index) {
+      auto c = body[++position];
+      std::uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return false;
+      }
+      codePoint = codePoint << 4 | digit;
+    }
+    if (codePoint < 0x80) {
+      scratch += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+      scratch += static_cast<char>(0xc0 | codePoint >> 6);
+      scratch += static_cast<char>(0x80 | (codePoint & 0x3f));
+    } else if (codePoint < 0x10000) {
+      scratch += static_cast<char>(0xe0 | codePoint >> 12);
+      scratch += static_cast<char>(0x80 | (codePoint >> 6 & 0x3f));
+      scratch += static_cast<char>(0x80 | (codePoint & 0x3f));
+    } else if (codePoint < 0x110000) {
+      scratch += static_cast<char>(0xf0 | codePoint >> 18);
+      scratch += static_cast<char>(0x80 | (codePoint >> 12 & 0x3f));
+      scratch += static_cast<char>(0x80 | (codePoint >> 6 & 0x3f));
+      scratch += static_cast<char>(0x80 | (codePoint & 0x3f));
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  ParseEventDispatchT &_eventDispatch;
+  std::string_view _input;
+  // Start of the line after the current one
+  std::size_t _next{0};
+  // The current line's content from its indentation, without the line
+  // break. Sequence entries move both past their "- ".
+  std::size_t _indent{0};
+  std::string_view _content;
+  bool _atEnd{false};
+  bool _inDocument{false};
+  bool _unsupported{false};
+  std::string _keyScratch;
+  std::string _valueScratch;
+};
+
+} // namespace moped
@@ -0,0 +1,133 @@
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/MsgPackEmitterContext.hpp"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Snapshot fan-out: encoding a book snapshot whole against encoding only
+// what changed since the previous snapshot, in JSON and MsgPack.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DFTF = moped::DurationSinceEpochFormatter<>;
+using moped::MergePolicy;
+
+struct Level {
+  double price;
+  double quantity;
+  std::uint32_t orders;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Level>(
+        "price", &Level::price, "quantity", &Level::quantity, "orders",
+        &Level::orders);
+  }
+};
+
+struct VenueStats {
+  std::string venue;
+  double volume;
+  std::uint64_t trades;
+  bool halted;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, VenueStats>(
+        "venue", &VenueStats::venue, "volume", &VenueStats::volume, "trades",
+        &VenueStats::trades, "halted", &VenueStats::halted);
+  }
+};
+
+struct BookSnapshot {
+  std::string symbol;
+  std::uint64_t sequence;
+  std::vector<Level> bids;
+  std::vector<Level> asks;
+  std::map<std::string, VenueStats> venues;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, BookSnapshot>(
+        "symbol", &BookSnapshot::symbol, "sequence", &BookSnapshot::sequence,
+        moped::mergeAs<MergePolicy::Upsert>("bids"), &BookSnapshot::bids,
+        moped::mergeAs<MergePolicy::Upsert>("asks"), &BookSnapshot::asks,
+        moped::mergeAs<MergePolicy::Upsert>("venues"),
+        &BookSnapshot::venues);
+  }
+};
+
+BookSnapshot makeSnapshot(std::size_t levels, std::size_t venues) {
+  BookSnapshot snapshot{"BTCUSDT", 1, {}, {}, {}};
+  for (std::size_t level = 0; level < levels; ++level) {
+    snapshot.bids.push_back(Level{100.0 - level * 0.5, 1.0 + level, 3});
+    snapshot.asks.push_back(Level{100.5 + level * 0.5, 2.0 + level, 4});
+  }
+  for (std::size_t venue = 0; venue < venues; ++venue) {
+    auto name = std::format("VENUE{}", venue);
+    snapshot.venues[name] = VenueStats{name, 1000.0 * venue, venue, false};
+  }
+  return snapshot;
+}
+
+// Each round moves the book on by one update: a sequence bump, one level
+// and one venue's statistics
+void update(BookSnapshot &snapshot, std::size_t round) {
+  ++snapshot.sequence;
+  auto &level = snapshot.bids[round % snapshot.bids.size()];
+  level.quantity += 1;
+  auto &stats = std::next(snapshot.venues.begin(),
+                          round % snapshot.venues.size())
+                    ->second;
+  stats.volume += 10;
+  ++stats.trades;
+}
+
+template <typename EncodeFn>
+void run(std::string_view label, std::size_t rounds, EncodeFn encode) {
+  auto snapshot = makeSnapshot(200, 40);
+  std::size_t bytes = 0;
+  auto start = Clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    auto baseline = snapshot;
+    update(snapshot, round);
+    bytes += encode(snapshot, baseline);
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<14} {:>8.2f} us/snapshot  {:>8.0f} bytes\n",
+                           label, elapsed.count() * 1e6 / rounds,
+                           double(bytes) / rounds);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t rounds = argc > 1 ? std::stoul(argv[1]) : 20'000;
+  // Copying the baseline is common to every run so it doesn't skew the
+  // comparison
+  run("JSON full", rounds, [](auto &snapshot, auto &) {
+    return moped::encodeToJSONString(snapshot, DFTF{}).size();
+  });
+  run("JSON delta", rounds, [](auto &snapshot, auto &baseline) {
+    return moped::encodeDeltaToJSONString(snapshot, baseline, DFTF{})
+        .value()
+        .size();
+  });
+  std::string buffer;
+  run("MsgPack full", rounds, [&buffer](auto &snapshot, auto &) {
+    buffer.clear();
+    moped::encodeToMsgPack(snapshot, buffer, DFTF{});
+    return buffer.size();
+  });
+  run("MsgPack delta", rounds, [&buffer](auto &snapshot, auto &baseline) {
+    buffer.clear();
+    moped::encodeDeltaToMsgPack(snapshot, baseline, buffer, DFTF{});
+    return buffer.size();
+  });
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include "moped/ScaledInteger.hpp"
+#include "moped/mopedFIX.hpp"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Encode throughput of FIXEmitterContext against formatting each message
+// with std::format and summing the checksum afterwards, plus FIXParser
+// throughput over the encoded messages.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Price = moped::ScaledInteger<std::int64_t, 8>;
+using TimestampTF = moped::UTCTimestampFormatter<std::chrono::microseconds>;
+
+struct NewOrder {
+  std::string_view clOrdId;
+  std::string_view symbol;
+  char side;
+  std::int64_t quantity;
+  Price price;
+  moped::TimePoint transactTime;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, NewOrder>(
+        "11", &NewOrder::clOrdId, "55", &NewOrder::symbol, "54",
+        &NewOrder::side, "38", &NewOrder::quantity, "44", &NewOrder::price,
+        "60", &NewOrder::transactTime);
+  }
+};
+
+std::vector<NewOrder> makeOrders(std::size_t count) {
+  std::vector<NewOrder> orders;
+  orders.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    orders.push_back(NewOrder{
+        "ORD-00001", "BTCUSDT", index % 2 == 0 ? '1' : '2',
+        static_cast<std::int64_t>(index % 17 + 1),
+        Price{std::format("{}.{:02}", 60000 + index % 500, index % 100)},
+        moped::TimePoint{std::chrono::milliseconds{1748461268460 + index}}});
+  }
+  return orders;
+}
+
+// Formats every field of every message, session fields included
+std::size_t encodeWithFormat(const NewOrder &order, std::uint64_t sequence,
+                             std::string &buffer) {
+  auto body = std::format(
+      "35=D\x01" "49=CLIENT\x01" "56=VENUE\x01" "34={}\x01" "11={}\x01"
+      "55={}\x01" "54={}\x01" "38={}\x01" "44={}\x01" "60={}\x01",
+      sequence, order.clOrdId, order.symbol, order.side, order.quantity,
+      order.price, TimestampTF::format(order.transactTime));
+  buffer = std::format("8=FIX.4.4\x01" "9={}\x01{}", body.size(), body);
+  unsigned sum = 0;
+  for (unsigned char c : buffer) {
+    sum += c;
+  }
+  buffer += std::format("10={:03}\x01", sum % 256);
+  return buffer.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  auto orders = makeOrders(count);
+
+  std::string formatted;
+  std::size_t totalSize = 0;
+  auto start = Clock::now();
+  for (std::size_t index = 0; index < count; ++index) {
+    totalSize += encodeWithFormat(orders[index], index + 1, formatted);
+  }
+  auto formatElapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<12} encode {:>12.0f} msgs/s  ({} bytes)\n",
+                           "std::format", count / formatElapsed.count(),
+                           totalSize);
+
+  moped::fix::MessageTemplate<TimestampTF> messageTemplate{"FIX.4.4"};
+  messageTemplate.setField(35, std::string_view{"D"});
+  messageTemplate.setField(49, std::string_view{"CLIENT"});
+  messageTemplate.setField(56, std::string_view{"VENUE"});
+  moped::FIXEmitterContext<TimestampTF> context{messageTemplate};
+  totalSize = 0;
+  start = Clock::now();
+  for (std::size_t index = 0; index < count; ++index) {
+    messageTemplate.setField(34, index + 1);
+    auto message = moped::encodeToFIX(orders[index], context);
+    totalSize += message ? message->size() : 0;
+  }
+  auto mopedElapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<12} encode {:>12.0f} msgs/s  ({} bytes)\n",
+                           "moped", count / mopedElapsed.count(), totalSize);
+  std::cout << std::format("moped/std::format encode time {:.2f}\n",
+                           mopedElapsed / formatElapsed);
+
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<NewOrder,
+                                            moped::FIXDecodingTraits<TimestampTF>>;
+  auto dictionary = moped::makeFIXDictionary<NewOrder>(TimestampTF{});
+  if (!dictionary) {
+    std::cerr << dictionary.error() << '\n';
+    return 1;
+  }
+  DispatcherT dispatcher;
+  moped::FIXParser<DispatcherT> parser{dispatcher, *dictionary};
+  std::int64_t checksum = 0;
+  start = Clock::now();
+  for (std::size_t index = 0; index < count; ++index) {
+    auto message = moped::encodeToFIX(orders[index], context);
+    if (auto result = parser.parse(*message); !result) {
+      std::cerr << result.error() << '\n';
+      return 1;
+    }
+    checksum += dispatcher.getComposite().quantity;
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format(
+      "{:<12} encode+parse {:>12.0f} msgs/s  (checksum {})\n", "moped",
+      count / elapsed.count(), checksum);
+  return 0;
+}
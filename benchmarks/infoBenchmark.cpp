@@ -0,0 +1,94 @@
+#include "moped/mopedInfo.hpp"
+#include "moped/tests/mdConfigSampleDefns.hpp"
+
+#include <boost/property_tree/info_parser.hpp>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Decode time of a large INFO config: moped's direct INFO parser into an
+// MDConfig against boost's read_info building its property tree alone.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+std::string makeConfig(std::size_t sessions, std::size_t subscriptions) {
+  std::string info = "; Market data service\nMarketDataService\n{\n"
+                     "  sessions\n  {\n";
+  for (std::size_t session = 0; session < sessions; ++session) {
+    info += std::format("    session{}\n    {{\n"
+                        "      enabled true\n"
+                        "      venue VENUE{}\n"
+                        "      runContext \"spot\"\n"
+                        "      serviceContext aeronPubSub ; transport\n"
+                        "      maxRequestPerSecond 4\n"
+                        "      maxSymbolsPerConnection 50\n"
+                        "      subscriptions\n      {{\n",
+                        session, session);
+    for (std::size_t symbol = 0; symbol < subscriptions; ++symbol) {
+      info += std::format("        SYM{}USDT\n        {{\n"
+                          "          id {}\n"
+                          "          subscribeFlags {{ \"\" TopOfBook \"\" "
+                          "Trade }}\n"
+                          "          bookUpdateSettings\n          {{\n"
+                          "            levels 20\n"
+                          "            arbTrades true\n"
+                          "            removeRestingOrders false\n"
+                          "          }}\n        }}\n",
+                          symbol, symbol + 1);
+    }
+    info += "      }\n    }\n";
+  }
+  info += "  }\n}\n";
+  return info;
+}
+
+template <typename ParseFn>
+void run(std::string_view label, const std::string &info, std::size_t rounds,
+         ParseFn parse) {
+  std::size_t checksum = 0;
+  auto start = Clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    checksum += parse();
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<22} {:>8.2f} ms/doc  {:>7.1f} MB/s  "
+                           "(checksum {})\n",
+                           label, elapsed.count() * 1e3 / rounds,
+                           rounds * info.size() / elapsed.count() / 1e6,
+                           checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t subscriptions = argc > 1 ? std::stoul(argv[1]) : 2'000;
+  std::size_t rounds = argc > 2 ? std::stoul(argv[2]) : 10;
+  auto info = makeConfig(4, subscriptions);
+  std::cout << std::format("{} subscriptions, {} bytes\n", 4 * subscriptions,
+                           info.size());
+
+  run("moped INFO parser", info, rounds, [&info]() -> std::size_t {
+    auto result =
+        moped::parseCompositeFromInfoView<moped::tests::MDConfig>(DFTF{},
+                                                                  info);
+    if (!result) {
+      std::cerr << result.error() << '\n';
+      return 0;
+    }
+    return result->marketDataService.sessions.at("session0")
+        .subscriptions.size();
+  });
+  run("boost read_info (tree)", info, rounds, [&info]() -> std::size_t {
+    std::istringstream input{info};
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_info(input, tree);
+    return tree.get_child("MarketDataService.sessions.session0.subscriptions")
+        .size();
+  });
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/MappedEnum.hpp"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// JSON encode throughput of an order update with descriptive member names
+// and mapped enum values, written into one reused stream so the emitter's
+// own cost isn't hidden behind stream construction.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+
+inline constexpr char Buy[] = "BUY";
+inline constexpr char Sell[] = "SELL";
+inline constexpr char New[] = "NEW";
+inline constexpr char PartiallyFilled[] = "PARTIALLY_FILLED";
+inline constexpr char Filled[] = "FILLED";
+inline constexpr char Limit[] = "LIMIT";
+inline constexpr char Market[] = "MARKET";
+
+enum class SideT : std::uint8_t { Buy, Sell };
+enum class StatusT : std::uint8_t { New, PartiallyFilled, Filled };
+enum class OrderTypeT : std::uint8_t { Limit, Market };
+
+using Side = moped::MappedEnum<Buy, SideT::Buy, Sell, SideT::Sell>;
+using Status =
+    moped::MappedEnum<New, StatusT::New, PartiallyFilled,
+                      StatusT::PartiallyFilled, Filled, StatusT::Filled>;
+using OrderType =
+    moped::MappedEnum<Limit, OrderTypeT::Limit, Market, OrderTypeT::Market>;
+
+struct Fill {
+  double fillPrice;
+  double fillQuantity;
+  std::int64_t tradeIdentifier;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Fill>(
+        "fillPrice", &Fill::fillPrice, "fillQuantity", &Fill::fillQuantity,
+        "tradeIdentifier", &Fill::tradeIdentifier);
+  }
+};
+
+struct OrderUpdate {
+  std::string symbol;
+  std::int64_t orderIdentifier;
+  std::string clientOrderIdentifier;
+  Side side;
+  OrderType orderType;
+  Status orderStatus;
+  double originalQuantity;
+  double executedQuantity;
+  double limitPrice;
+  bool reduceOnly;
+  moped::TimePoint transactionTime;
+  std::vector<Fill> fills;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, OrderUpdate>(
+        "symbol", &OrderUpdate::symbol, "orderIdentifier",
+        &OrderUpdate::orderIdentifier, "clientOrderIdentifier",
+        &OrderUpdate::clientOrderIdentifier, "side", &OrderUpdate::side,
+        "orderType", &OrderUpdate::orderType, "orderStatus",
+        &OrderUpdate::orderStatus, "originalQuantity",
+        &OrderUpdate::originalQuantity, "executedQuantity",
+        &OrderUpdate::executedQuantity, "limitPrice",
+        &OrderUpdate::limitPrice, "reduceOnly", &OrderUpdate::reduceOnly,
+        "transactionTime", &OrderUpdate::transactionTime, "fills",
+        &OrderUpdate::fills);
+  }
+};
+
+std::vector<OrderUpdate> makeUpdates(std::size_t count) {
+  std::vector<OrderUpdate> updates;
+  updates.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    OrderUpdate update{"BTCUSDT",
+                       static_cast<std::int64_t>(1'000'000 + index),
+                       std::format("client-{}", index),
+                       index % 2 ? SideT::Buy : SideT::Sell,
+                       index % 3 ? OrderTypeT::Limit : OrderTypeT::Market,
+                       static_cast<StatusT>(index % 3),
+                       1.5,
+                       0.5 * (index % 4),
+                       60000.0 + index % 500,
+                       index % 5 == 0,
+                       moped::TimePoint{
+                           std::chrono::milliseconds{1748461268460 + index}},
+                       {}};
+    for (std::size_t fill = 0; fill < index % 3; ++fill) {
+      update.fills.push_back(
+          Fill{60000.0 + fill, 0.25, static_cast<std::int64_t>(index + fill)});
+    }
+    updates.push_back(std::move(update));
+  }
+  return updates;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+  auto updates = makeUpdates(count);
+  std::ostringstream output;
+  std::size_t bytes = 0;
+  auto start = Clock::now();
+  for (auto &update : updates) {
+    output.str({});
+    moped::encodeToJSONStream(update, output, DFTF{});
+    bytes += output.view().size();
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("JSON encode {:>10.0f} docs/s  {:>7.1f} MB/s  "
+                           "avg size {:>6.1f} bytes\n",
+                           count / elapsed.count(),
+                           bytes / elapsed.count() / 1e6,
+                           double(bytes) / count);
+  std::cout << output.view() << '\n';
+  return 0;
+}
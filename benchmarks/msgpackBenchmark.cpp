@@ -0,0 +1,105 @@
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/mopedJSON.hpp"
+#include "moped/mopedMsgPack.hpp"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// Decode/encode throughput and encoded size of MessagePack against JSON for
+// the same moped mapping.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Price = moped::ScaledInteger<std::int64_t, 8>;
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+
+struct Trade {
+  std::string symbol;
+  Price price;
+  std::int64_t quantity;
+  std::int64_t tradeId;
+  bool buyerMaker;
+  moped::TimePoint tradeTime;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Trade>(
+        "s", &Trade::symbol, "p", &Trade::price, "q", &Trade::quantity, "t",
+        &Trade::tradeId, "m", &Trade::buyerMaker, "T", &Trade::tradeTime);
+  }
+};
+
+std::vector<Trade> makeTrades(std::size_t count) {
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    trades.push_back(Trade{
+        "BTCUSDT",
+        Price{std::format("{}.{:02}", 60000 + index % 500, index % 100)},
+        static_cast<std::int64_t>(index % 17 + 1),
+        static_cast<std::int64_t>(1'000'000'000 + index), index % 2 == 0,
+        moped::TimePoint{std::chrono::milliseconds{1748461268460 + index}}});
+  }
+  return trades;
+}
+
+template <typename EncodeFn, typename DecodeFn>
+void runFormat(std::string_view label, const std::vector<Trade> &trades,
+               EncodeFn encode, DecodeFn decode) {
+  std::vector<std::string> documents;
+  documents.reserve(trades.size());
+
+  auto start = Clock::now();
+  std::size_t totalSize = 0;
+  for (auto &trade : trades) {
+    documents.push_back(encode(trade));
+    totalSize += documents.back().size();
+  }
+  auto encodeElapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  start = Clock::now();
+  std::int64_t checksum = 0;
+  for (auto &document : documents) {
+    auto result = decode(document);
+    if (!result) {
+      std::cerr << result.error() << '\n';
+      return;
+    }
+    checksum += result->quantity;
+  }
+  auto decodeElapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  std::cout << std::format(
+      "{:<12} encode {:>12.0f} docs/s  decode {:>12.0f} docs/s  "
+      "avg size {:>6.1f} bytes  (checksum {})\n",
+      label, trades.size() / encodeElapsed.count(),
+      trades.size() / decodeElapsed.count(),
+      static_cast<double>(totalSize) / trades.size(), checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  auto trades = makeTrades(count);
+
+  runFormat(
+      "JSON", trades,
+      [](const Trade &trade) { return moped::encodeToJSONString(trade, DFTF{}); },
+      [](const std::string &document) {
+        return moped::parseCompositeFromJSONView<Trade>(DFTF{}, document);
+      });
+  runFormat(
+      "MessagePack", trades,
+      [](const Trade &trade) {
+        return moped::encodeToMsgPackString(trade, DFTF{});
+      },
+      [](const std::string &document) {
+        return moped::parseCompositeFromMsgPack<Trade>(DFTF{}, document);
+      });
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include "moped/CompositePipelineStage.hpp"
+#include "moped/ScaledInteger.hpp"
+#include "moped/mopedJSON.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Throughput and latency of the parse to consumer pipeline. A producer thread
+// decodes trade documents straight into ring slots while the consumer thread
+// drains them, latency is measured from the start of each decode to the
+// moment the consumer observes the published slot.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Price = moped::ScaledInteger<std::int64_t, 8>;
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+using Traits = moped::StringDecodingTraits<DFTF>;
+
+struct Trade {
+  std::string symbol;
+  Price price;
+  std::int64_t quantity;
+  std::int64_t tradeId;
+  moped::TimePoint tradeTime;
+  Clock::time_point decodeStart;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Trade>(
+        "s", &Trade::symbol, "p", &Trade::price, "q", &Trade::quantity, "t",
+        &Trade::tradeId, "T", &Trade::tradeTime);
+  }
+};
+
+std::vector<std::string> makeDocuments(std::size_t count) {
+  std::vector<std::string> documents;
+  documents.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    documents.push_back(std::format(
+        R"({{"s":"BTCUSDT","p":"{}.{:02}","q":{},"t":{},"T":1748461268460}})",
+        60000 + index % 500, index % 100, index % 17 + 1, index));
+  }
+  return documents;
+}
+
+template <moped::RingProducers Producers, std::size_t Capacity>
+void runPipeline(const std::vector<std::string> &documents,
+                 std::string_view label) {
+  using StageT = moped::CompositePipelineStage<Trade, Traits, Capacity,
+                                               Producers>;
+  typename StageT::RingT ring;
+  std::vector<std::int64_t> latencies;
+  latencies.reserve(documents.size());
+
+  // Set when the producer stops, after its last document or on a failure
+  std::atomic<bool> producerDone{false};
+  auto start = Clock::now();
+  std::thread producer{[&] {
+    StageT stage{ring};
+    for (auto &document : documents) {
+      auto decodeStart = Clock::now();
+      auto result = stage.produce([&](auto &dispatcher) -> moped::Expected {
+        moped::JSONViewParser<std::decay_t<decltype(dispatcher)>> parser{
+            dispatcher};
+        auto parsed = parser.parse(document);
+        dispatcher.getComposite().decodeStart = decodeStart;
+        return parsed;
+      });
+      if (!result) {
+        std::cerr << result.error() << '\n';
+        break;
+      }
+    }
+    producerDone.store(true, std::memory_order_release);
+  }};
+
+  std::int64_t checksum = 0;
+  for (bool finished = false; !finished;) {
+    finished = producerDone.load(std::memory_order_acquire);
+    ring.consumeAll([&](const Trade &trade) {
+      latencies.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              Clock::now() - trade.decodeStart)
+              .count());
+      checksum += trade.quantity;
+    });
+  }
+  producer.join();
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  if (latencies.size() != documents.size()) {
+    std::cerr << label << ": producer stopped early\n";
+    return;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double fraction) {
+    return latencies[static_cast<std::size_t>(fraction *
+                                              (latencies.size() - 1))];
+  };
+  std::cout << std::format(
+      "{:<28} {:>12.0f} docs/s  p50 {:>7}ns  p99 {:>8}ns  p99.9 {:>9}ns  "
+      "(checksum {})\n",
+      label, documents.size() / elapsed, percentile(0.5), percentile(0.99),
+      percentile(0.999), checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  auto documents = makeDocuments(count);
+
+  runPipeline<moped::RingProducers::Single, 64>(documents, "SPSC ring (64 slots)");
+  runPipeline<moped::RingProducers::Single, 1024>(documents,
+                                                  "SPSC ring (1024 slots)");
+  runPipeline<moped::RingProducers::Multiple, 64>(documents,
+                                                  "MPSC ring (64 slots)");
+  return 0;
+}
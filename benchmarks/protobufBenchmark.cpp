@@ -0,0 +1,157 @@
+#include "moped/mopedMsgPack.hpp"
+#include "moped/mopedProtobuf.hpp"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Decode/encode throughput of protobuf against MessagePack for the same
+// moped mapping, and packed varint decode throughput for short and mixed
+// length values.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+
+struct Trade {
+  std::string symbol;
+  std::int64_t price;
+  std::int64_t quantity;
+  std::int64_t tradeId;
+  bool buyerMaker;
+  moped::TimePoint tradeTime;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    if constexpr (std::is_same_v<DecodingTraits,
+                                 moped::ProtobufDecodingTraits<DFTF>> ||
+                  std::is_same_v<DecodingTraits,
+                                 moped::ProtobufDecodingTraits<>>) {
+      return moped::mopedHandler<DecodingTraits, Trade>(
+          "1", &Trade::symbol, "2:sint", &Trade::price, "3", &Trade::quantity,
+          "4", &Trade::tradeId, "5", &Trade::buyerMaker, "6",
+          &Trade::tradeTime);
+    } else {
+      return moped::mopedHandler<DecodingTraits, Trade>(
+          "s", &Trade::symbol, "p", &Trade::price, "q", &Trade::quantity, "t",
+          &Trade::tradeId, "m", &Trade::buyerMaker, "T", &Trade::tradeTime);
+    }
+  }
+};
+
+struct Levels {
+  std::vector<std::int64_t> values;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Levels>("1", &Levels::values);
+  }
+};
+
+std::vector<Trade> makeTrades(std::size_t count) {
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    trades.push_back(Trade{
+        "BTCUSDT", static_cast<std::int64_t>(6'000'000 + index % 50'000),
+        static_cast<std::int64_t>(index % 17 + 1),
+        static_cast<std::int64_t>(1'000'000'000 + index), index % 2 == 0,
+        moped::TimePoint{std::chrono::milliseconds{1748461268460 + index}}});
+  }
+  return trades;
+}
+
+template <typename EncodeFn, typename DecodeFn>
+void runFormat(std::string_view label, const std::vector<Trade> &trades,
+               EncodeFn encode, DecodeFn decode) {
+  std::vector<std::string> documents;
+  documents.reserve(trades.size());
+
+  auto start = Clock::now();
+  std::size_t totalSize = 0;
+  for (auto &trade : trades) {
+    documents.push_back(encode(trade));
+    totalSize += documents.back().size();
+  }
+  auto encodeElapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  start = Clock::now();
+  std::int64_t checksum = 0;
+  for (auto &document : documents) {
+    auto result = decode(document);
+    if (!result) {
+      std::cerr << result.error() << '\n';
+      return;
+    }
+    checksum += result->quantity;
+  }
+  auto decodeElapsed = std::chrono::duration<double>(Clock::now() - start);
+
+  std::cout << std::format(
+      "{:<12} encode {:>12.0f} docs/s  decode {:>12.0f} docs/s  "
+      "avg size {:>6.1f} bytes  (checksum {})\n",
+      label, trades.size() / encodeElapsed.count(),
+      trades.size() / decodeElapsed.count(),
+      static_cast<double>(totalSize) / trades.size(), checksum);
+}
+
+void runPacked(std::string_view label, std::int64_t maxValue) {
+  std::mt19937_64 random{42};
+  std::uniform_int_distribution<std::int64_t> distribution{0, maxValue};
+  Levels levels;
+  for (int index = 0; index < 100'000; ++index) {
+    levels.values.push_back(distribution(random));
+  }
+  moped::ProtobufEmitterContext context;
+  std::string message{*moped::encodeToProtobuf(levels, context)};
+
+  constexpr int Rounds = 200;
+  auto start = Clock::now();
+  std::int64_t checksum = 0;
+  for (int round = 0; round < Rounds; ++round) {
+    auto result = moped::parseCompositeFromProtobuf<Levels>(DFTF{}, message);
+    if (!result) {
+      std::cerr << result.error() << '\n';
+      return;
+    }
+    checksum += result->values.back();
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format(
+      "packed {:<10} {:>8.1f} M values/s  {:>8.1f} MB/s  (checksum {})\n",
+      label, Rounds * levels.values.size() / elapsed.count() / 1e6,
+      Rounds * message.size() / elapsed.count() / 1e6, checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  auto trades = makeTrades(count);
+
+  moped::ProtobufEmitterContext context;
+  runFormat(
+      "Protobuf", trades,
+      [&context](const Trade &trade) {
+        return std::string{*moped::encodeToProtobuf(trade, context)};
+      },
+      [](const std::string &document) {
+        return moped::parseCompositeFromProtobuf<Trade>(DFTF{}, document);
+      });
+  runFormat(
+      "MessagePack", trades,
+      [](const Trade &trade) {
+        return moped::encodeToMsgPackString(trade, DFTF{});
+      },
+      [](const std::string &document) {
+        return moped::parseCompositeFromMsgPack<Trade>(DFTF{}, document);
+      });
+
+  runPacked("1 byte", 127);
+  runPacked("1-2 bytes", 1 << 10);
+  runPacked("1-4 bytes", 1 << 24);
+  return 0;
+}
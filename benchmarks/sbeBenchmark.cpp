@@ -0,0 +1,170 @@
+#include "moped/ScaledInteger.hpp"
+#include "moped/mopedSBE.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <vector>
+
+// Encode throughput of SBEEmitterContext against a hand written encoder for
+// the same message layout, plus SBEDecoder throughput over the result.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Price = moped::ScaledInteger<std::int64_t, 8>;
+using NanosTF = moped::DurationSinceEpochFormatter<std::chrono::nanoseconds>;
+using moped::sbe::PrimitiveType;
+
+struct Fill {
+  Price price;
+  std::int64_t quantity;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Fill>("price", &Fill::price,
+                                                     "quantity", &Fill::quantity);
+  }
+};
+
+struct Trade {
+  std::string_view symbol;
+  Price price;
+  std::int64_t quantity;
+  std::int64_t tradeId;
+  bool buyerMaker;
+  moped::TimePoint tradeTime;
+  std::vector<Fill> fills;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Trade>(
+        "symbol", &Trade::symbol, "price", &Trade::price, "quantity",
+        &Trade::quantity, "tradeId", &Trade::tradeId, "buyerMaker",
+        &Trade::buyerMaker, "tradeTime", &Trade::tradeTime, "fills",
+        &Trade::fills);
+  }
+};
+
+const moped::sbe::MessageLayout tradeLayout{
+    .templateId = 1,
+    .schemaId = 1,
+    .block = {.fields = {{"symbol", PrimitiveType::Char, 0, 8},
+                         {"price", PrimitiveType::Int64, 8, 1, -8},
+                         {"quantity", PrimitiveType::Int64, 16},
+                         {"tradeId", PrimitiveType::Int64, 24},
+                         {"buyerMaker", PrimitiveType::UInt8, 32},
+                         {"tradeTime", PrimitiveType::UInt64, 33}},
+              .groups = {{"fills",
+                          {.fields = {{"price", PrimitiveType::Int64, 0, 1,
+                                       -8},
+                                      {"quantity", PrimitiveType::Int64,
+                                       8}}}}}}};
+
+template <typename T> void store(char *target, T value) {
+  std::memcpy(target, &value, sizeof(T));
+}
+
+// What an application would write by hand for tradeLayout on a little
+// endian host
+std::size_t encodeByHand(const Trade &trade, char *buffer) {
+  store<std::uint16_t>(buffer, 41);
+  store<std::uint16_t>(buffer + 2, 1);
+  store<std::uint16_t>(buffer + 4, 1);
+  store<std::uint16_t>(buffer + 6, 0);
+  char *block = buffer + 8;
+  std::memset(block, 0, 8);
+  std::memcpy(block, trade.symbol.data(), trade.symbol.size());
+  store<std::int64_t>(block + 8, trade.price.getRawIntegerValue());
+  store<std::int64_t>(block + 16, trade.quantity);
+  store<std::int64_t>(block + 24, trade.tradeId);
+  store<std::uint8_t>(block + 32, trade.buyerMaker);
+  store<std::uint64_t>(block + 33,
+                       NanosTF::getTimeUnits(trade.tradeTime));
+  char *group = block + 41;
+  store<std::uint16_t>(group, 16);
+  store<std::uint16_t>(group + 2, trade.fills.size());
+  char *entry = group + 4;
+  for (auto &fill : trade.fills) {
+    store<std::int64_t>(entry, fill.price.getRawIntegerValue());
+    store<std::int64_t>(entry + 8, fill.quantity);
+    entry += 16;
+  }
+  return entry - buffer;
+}
+
+std::vector<Trade> makeTrades(std::size_t count) {
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    Price price{std::format("{}.{:02}", 60000 + index % 500, index % 100)};
+    trades.push_back(Trade{
+        "BTCUSDT", price, static_cast<std::int64_t>(index % 17 + 1),
+        static_cast<std::int64_t>(1'000'000'000 + index), index % 2 == 0,
+        moped::TimePoint{std::chrono::milliseconds{1748461268460 + index}},
+        std::vector<Fill>(index % 4, Fill{price, 1})});
+  }
+  return trades;
+}
+
+template <typename EncodeFn>
+double runEncoder(std::string_view label, const std::vector<Trade> &trades,
+                  EncodeFn encode) {
+  std::array<char, 256> buffer;
+  std::size_t totalSize = 0;
+  auto start = Clock::now();
+  for (auto &trade : trades) {
+    totalSize += encode(trade, buffer);
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<12} encode {:>12.0f} msgs/s  ({} bytes)\n",
+                           label, trades.size() / elapsed.count(), totalSize);
+  return elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  auto trades = makeTrades(count);
+  auto encoding = moped::sbe::makeMessageEncoding(tradeLayout);
+
+  auto handElapsed = runEncoder(
+      "Hand written", trades,
+      [](const Trade &trade, auto &buffer) {
+        return encodeByHand(trade, buffer.data());
+      });
+  auto mopedElapsed = runEncoder(
+      "moped", trades, [&](const Trade &trade, auto &buffer) {
+        auto length = moped::encodeToSBE(trade, encoding, buffer, NanosTF{});
+        return length ? *length : 0;
+      });
+  std::cout << std::format("moped/hand written encode time {:.2f}\n",
+                           mopedElapsed / handElapsed);
+
+  std::array<char, 256> buffer;
+  auto decoder = moped::makeSBEDecoder<Trade>(NanosTF{}, tradeLayout);
+  if (!decoder) {
+    std::cerr << decoder.error() << '\n';
+    return 1;
+  }
+  Trade decoded;
+  std::int64_t checksum = 0;
+  auto start = Clock::now();
+  for (auto &trade : trades) {
+    auto length = encodeByHand(trade, buffer.data());
+    auto result = decoder->decode({buffer.data(), length}, decoded);
+    if (!result) {
+      std::cerr << result.error() << '\n';
+      return 1;
+    }
+    checksum += decoded.quantity;
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format(
+      "{:<12} encode+decode {:>12.0f} msgs/s  (checksum {})\n", "moped",
+      trades.size() / elapsed.count(), checksum);
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include "moped/mopedFIX.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Member activation cost on a 101 field message, decoding the same events
+// through integer ids (FIX tags) and through member names. Fields arrive in
+// a shuffled order so the lookup can't lean on mapping order.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#define WIDE_MESSAGE_FIELDS(X) \
+  X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) \
+  X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20) X(21) \
+  X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) X(31) \
+  X(32) X(33) X(34) X(35) X(36) X(37) X(38) X(39) X(40) X(41) \
+  X(42) X(43) X(44) X(45) X(46) X(47) X(48) X(49) X(50) X(51) \
+  X(52) X(53) X(54) X(55) X(56) X(57) X(58) X(59) X(60) X(61) \
+  X(62) X(63) X(64) X(65) X(66) X(67) X(68) X(69) X(70) X(71) \
+  X(72) X(73) X(74) X(75) X(76) X(77) X(78) X(79) X(80) X(81) \
+  X(82) X(83) X(84) X(85) X(86) X(87) X(88) X(89) X(90) X(91) \
+  X(92) X(93) X(94) X(95) X(96) X(97) X(98) X(99) X(100) X(101)
+
+struct WideMessage {
+  std::int64_t field1{};
+#define WIDE_MESSAGE_MEMBER(N) std::int64_t field##N{};
+  WIDE_MESSAGE_FIELDS(WIDE_MESSAGE_MEMBER)
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+#define WIDE_MESSAGE_MAPPING(N) , #N, &WideMessage::field##N
+    return moped::mopedHandler<DecodingTraits, WideMessage>(
+        "1", &WideMessage::field1 WIDE_MESSAGE_FIELDS(WIDE_MESSAGE_MAPPING));
+  }
+};
+
+template <typename DecodingTraits>
+bool decodeMessages(std::string_view label,
+                    const std::vector<std::uint32_t> &tags,
+                    std::size_t count) {
+  std::vector<std::string> names;
+  for (auto tag : tags) {
+    names.push_back(std::to_string(tag));
+  }
+  moped::CompositeParserEventDispatcher<WideMessage, DecodingTraits>
+      dispatcher;
+  std::int64_t checksum = 0;
+  auto start = Clock::now();
+  for (std::size_t index = 0; index < count; ++index) {
+    dispatcher.onObjectStart();
+    for (std::size_t field = 0; field < tags.size(); ++field) {
+      if constexpr (std::is_same_v<typename DecodingTraits::MemberIdType,
+                                   std::string_view>) {
+        dispatcher.onMember(std::string_view{names[field]});
+      } else {
+        dispatcher.onMember(tags[field]);
+      }
+      if (auto result = dispatcher.onIntegerValue(
+              static_cast<std::int64_t>(index + field));
+          !result) {
+        std::cerr << result.error() << '\n';
+        return false;
+      }
+    }
+    dispatcher.onObjectFinish();
+    checksum += dispatcher.getComposite().field100;
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format("{:<8} {:>12.0f} msgs/s {:>8.1f} ns/field  "
+                           "(checksum {})\n",
+                           label, count / elapsed.count(),
+                           elapsed.count() * 1e9 / (count * tags.size()),
+                           checksum);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+  std::vector<std::uint32_t> tags(101);
+  std::iota(tags.begin(), tags.end(), 1u);
+  std::shuffle(tags.begin(), tags.end(), std::mt19937{42});
+
+  if (!decodeMessages<moped::FIXDecodingTraits<>>("tags", tags, count) ||
+      !decodeMessages<moped::StringDecodingTraits<>>("names", tags, count)) {
+    return 1;
+  }
+  return 0;
+}
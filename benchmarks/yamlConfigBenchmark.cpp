@@ -0,0 +1,165 @@
+#include "moped/mopedYAML.hpp"
+#include "moped/tests/mdConfigSampleDefns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Start-up cost of loading a directory of YAML config files into moped
+// composites, read and parsed with libyaml against the native block-YAML
+// parser. Takes a directory of MDConfig files, or generates one.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DFTF = moped::DurationSinceEpochFormatter<>;
+using MDConfig = moped::tests::MDConfig;
+using DispatcherT =
+    moped::CompositeParserEventDispatcher<MDConfig,
+                                          moped::StringDecodingTraits<DFTF>>;
+
+// A hand written looking config: comments, quoted strings and flow
+// sequences among the block mappings
+std::string makeConfig(std::size_t file, std::size_t sessions,
+                       std::size_t subscriptions) {
+  std::string yaml = std::format("# Market data config {}\n---\n"
+                                 "MarketDataService:\n  sessions:\n",
+                                 file);
+  for (std::size_t session = 0; session < sessions; ++session) {
+    yaml += std::format(
+        "    session{}:\n"
+        "      enabled: {}\n"
+        "      venue: VENUE{}\n"
+        "      runContext: \"spot{}\"\n"
+        "      serviceContext: aeronPubSub # transport\n"
+        "      maxRequestPerSecond: {}\n"
+        "      maxSymbolsPerConnection: 50\n"
+        "      subscriptions:\n",
+        session, session % 2 == 0, session, file, session + 4);
+    for (std::size_t symbol = 0; symbol < subscriptions; ++symbol) {
+      yaml += std::format("        SYM{}USDT:\n"
+                          "          id: {}\n"
+                          "          subscribeFlags: [TopOfBook, Trade]\n"
+                          "          bookUpdateSettings:\n"
+                          "            levels: 20\n"
+                          "            arbTrades: true\n"
+                          "            removeRestingOrders: false\n",
+                          symbol, symbol + 1);
+    }
+    for (auto endpoint : {"subscriptionEndpoint", "snapshotEndpoint",
+                          "instrumentDataEndpoint"}) {
+      yaml += std::format("      {}:\n"
+                          "        name: '{}{}'\n"
+                          "        host: \"api{}.example.com\"\n"
+                          "        port: 443\n"
+                          "        uri: /api/v3/{}\n",
+                          endpoint, endpoint, session, session, endpoint);
+    }
+  }
+  return yaml;
+}
+
+std::vector<std::filesystem::path>
+listConfigs(const std::filesystem::path &directory) {
+  std::vector<std::filesystem::path> files;
+  for (auto &entry : std::filesystem::directory_iterator{directory}) {
+    auto extension = entry.path().extension();
+    if (entry.is_regular_file() &&
+        (extension == ".yaml" || extension == ".yml")) {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+std::string readFile(const std::filesystem::path &path) {
+  std::ifstream input{path, std::ios::binary};
+  std::ostringstream text;
+  text << input.rdbuf();
+  return std::move(text).str();
+}
+
+// Reads and parses every file 'rounds' times, as a service start-up would
+template <typename ParseFn>
+void runStartup(std::string_view label,
+                const std::vector<std::filesystem::path> &files,
+                std::size_t rounds, ParseFn parse) {
+  std::size_t bytes = 0;
+  std::size_t checksum = 0;
+  auto start = Clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (auto &file : files) {
+      auto yaml = readFile(file);
+      bytes += yaml.size();
+      auto result = parse(yaml);
+      if (!result) {
+        std::cerr << file << ": " << result.error() << '\n';
+        return;
+      }
+      checksum += result->marketDataService.sessions.size();
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  std::cout << std::format(
+      "{:<8} start-up {:>8.2f} ms  {:>9.0f} files/s  {:>7.1f} MB/s  "
+      "(checksum {})\n",
+      label, elapsed.count() * 1e3 / rounds,
+      rounds * files.size() / elapsed.count(), bytes / elapsed.count() / 1e6,
+      checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::filesystem::path directory;
+  if (argc > 1) {
+    directory = argv[1];
+  } else {
+    directory =
+        std::filesystem::temp_directory_path() / "moped_yaml_configs";
+    std::filesystem::create_directories(directory);
+    for (std::size_t file = 0; file < 200; ++file) {
+      std::ofstream{directory / std::format("config{:03}.yaml", file)}
+          << makeConfig(file, 4, 25);
+    }
+  }
+  std::size_t rounds = argc > 2 ? std::stoul(argv[2]) : 10;
+  auto files = listConfigs(directory);
+  if (files.empty()) {
+    std::cerr << "No .yaml files in " << directory << '\n';
+    return 1;
+  }
+
+  // Files outside the native subset are parsed by libyaml
+  std::size_t fallbacks = 0;
+  for (auto &file : files) {
+    auto yaml = readFile(file);
+    DispatcherT dispatcher;
+    moped::YAMLViewParser<DispatcherT> parser{dispatcher};
+    fallbacks += !parser.parse(yaml) && parser.unsupported();
+  }
+  std::cout << std::format("{} files in {}, {} outside the native subset\n",
+                           files.size(), directory.string(), fallbacks);
+
+  moped::YAMLParser<DispatcherT> libyamlParser;
+  runStartup("libyaml", files, rounds,
+             [&libyamlParser](std::string_view yaml)
+                 -> std::expected<MDConfig, moped::ParseError> {
+               if (auto result = libyamlParser.parseInputView(yaml);
+                   !result) {
+                 return std::unexpected(result.error());
+               }
+               return libyamlParser.getDispatcher().moveComposite();
+             });
+  runStartup("native", files, rounds, [](std::string_view yaml) {
+    return moped::parseCompositeFromYAMLView<MDConfig>(DFTF{}, yaml);
+  });
+  return 0;
+}
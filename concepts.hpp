@@ -1,7 +1,9 @@
 #pragma once
 
+#include <charconv>
 #include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <expected>
 #include <format>
 #include <ostream>
@@ -63,6 +65,13 @@ struct ParseError {
     return os;
   }
 };
+
+// Base 10 fraction delivered by binary formats with a native decimal type,
+// value is mantissa * 10^exponent
+struct DecimalFraction {
+  std::int64_t mantissa;
+  std::int32_t exponent;
+};
 } // namespace moped
 template <>
 struct std::formatter<moped::ParseError> : std::formatter<std::string> {
@@ -71,6 +80,13 @@ struct std::formatter<moped::ParseError> : std::formatter<std::string> {
   }
 };
 
+template <> struct std::formatter<moped::DecimalFraction> {
+  constexpr auto parse(auto &ctx) { return ctx.begin(); }
+  auto format(const moped::DecimalFraction &value, auto &ctx) const {
+    return std::format_to(ctx.out(), "{}e{}", value.mantissa, value.exponent);
+  }
+};
+
 namespace moped {
 
 using Expected = std::expected<void, ParseError>;
@@ -87,6 +103,16 @@ concept DecodingTraitsC = requires(T t) {
   } -> std::same_as<std::string>;
 };
 
+template <typename T>
+concept UsesAdaptiveCollectionReserveC = requires {
+  requires T::AdaptiveCollectionReserve;
+};
+
+// Traits of text formats carrying char members as a single character rather
+// than as a number
+template <typename T>
+concept UsesCharTextValuesC = requires { requires T::CharTextValues; };
+
 template <typename T>
 concept PayloadHandlerC = requires(T t) {
   { t(std::string{}) } -> std::same_as<Expected>;
@@ -131,6 +157,13 @@ template <DecodingTraitsC DecodingTraits> struct IMOPEDHandler {
     return std::unexpected("Unhandled array finish event");
   }
 
+  // Advisory event delivered ahead of onArrayStart by parsers that can
+  // determine the element count of the upcoming array. Handlers that own a
+  // reservable collection use it to size their storage once.
+  virtual Expected onArraySizeHint(MOPEDHandlerStack &, std::size_t) {
+    return {};
+  }
+
   virtual Expected onStringValue(std::string_view) {
     return std::unexpected("Unhandled string value event");
   }
@@ -139,6 +172,36 @@ template <DecodingTraitsC DecodingTraits> struct IMOPEDHandler {
     return std::unexpected("Unhandled numeric value event");
   }
 
+  // Numbers delivered already decoded by binary parsers. Handlers without a
+  // typed conversion receive them as text through onNumericValue.
+  virtual Expected onIntegerValue(std::int64_t value) {
+    return onNumericText(value);
+  }
+
+  virtual Expected onUnsignedValue(std::uint64_t value) {
+    return onNumericText(value);
+  }
+
+  virtual Expected onFloatValue(double value) { return onNumericText(value); }
+
+  // Whole seconds since epoch, or microseconds when fractional, are digit
+  // counts epoch time formatters recognize
+  virtual Expected onTimeValue(TimePoint value) {
+    using namespace std::chrono;
+    auto sinceEpoch = value.time_since_epoch();
+    if (sinceEpoch % seconds{1} == sinceEpoch.zero()) {
+      return onNumericText(duration_cast<seconds>(sinceEpoch).count());
+    }
+    return onNumericText(duration_cast<microseconds>(sinceEpoch).count());
+  }
+
+  virtual Expected onDecimalValue(DecimalFraction value) {
+    char buffer[48];
+    auto end = std::format_to(buffer, "{}e{}", value.mantissa, value.exponent);
+    return onNumericValue(
+        std::string_view{buffer, static_cast<std::size_t>(end - buffer)});
+  }
+
   virtual Expected onBooleanValue(bool) {
     return std::unexpected("Unhandled boolean value event");
   }
@@ -150,6 +213,16 @@ template <DecodingTraitsC DecodingTraits> struct IMOPEDHandler {
   virtual Expected onRawBinary(void *) {
     return std::unexpected("Unhandled binary value event");
   }
+
+protected:
+  Expected onNumericText(auto value) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    if (ec != std::errc{}) {
+      return std::unexpected("Failed to format binary numeric value");
+    }
+    return onNumericValue(std::string_view{buffer, end});
+  }
 };
 
 template <typename T, typename DecodingTraits>
@@ -253,6 +326,13 @@ concept IsMOPEDMapCollectionC = requires(T t) {
             std::declval<typename T::mapped_type>());
 };
 
+template <typename T>
+concept IsMOPEDMapDispatcherC = requires(T t) {
+  { t.setCurrentKey(std::declval<const typename T::key_type &>()) };
+  { t.dispatchLastCapture() };
+  { t.resetCapture() } -> std::same_as<typename T::mapped_type &>;
+};
+
 template <typename T>
 concept IsMOPEDInsertCollectionC = requires(T t) {
   { t.insert(std::declval<typename T::value_type>()) };
@@ -3,13 +3,16 @@
 #include "ScaledInteger.hpp"
 #include "moped/concepts.hpp"
 #include <charconv>
+#include <cmath>
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <limits>
 #include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace moped {
 
@@ -25,6 +28,37 @@ inline std::expected<NumericT, ParseError> ston(std::string_view value) {
   return result;
 }
 
+// std::in_range rejects char, so ranges of char are checked against the
+// signed or unsigned char type with the same range
+template <typename IntegralT>
+using InRangeT = std::conditional_t<
+    std::is_same_v<IntegralT, char>,
+    std::conditional_t<std::is_signed_v<char>, signed char, unsigned char>,
+    IntegralT>;
+
+// Whether an integer survives conversion to 'IntegralT', which may be a
+// narrower, unsigned or 128 bit raw type
+template <typename IntegralT, typename ValueT>
+constexpr bool fitsIntegral(ValueT value) {
+  auto converted = static_cast<IntegralT>(value);
+  return static_cast<ValueT>(converted) == value &&
+         (converted < IntegralT{0}) == (value < ValueT{0});
+}
+
+// Floating point values convert to 'IntegralT' when within
+// [lower, upper). The bounds are powers of two so they are exact, unlike
+// max() which rounds up to 2^63 as a double for 64 bit targets.
+template <typename IntegralT, typename FloatT>
+constexpr bool floatFitsIntegral(FloatT value) {
+  constexpr bool isSigned = IntegralT(-1) < IntegralT(0);
+  FloatT upper = 1;
+  for (std::size_t bit = isSigned; bit < sizeof(IntegralT) * 8; ++bit) {
+    upper *= 2;
+  }
+  FloatT lower = isSigned ? -upper : FloatT{0};
+  return value >= lower && value < upper; // NaN fails both
+}
+
 template <typename TargetT, typename DecodingTraits>
 std::expected<TargetT, ParseError> getValueFor(std::string_view value) {
   if constexpr (std::is_same_v<TargetT, bool>) {
@@ -46,6 +80,13 @@ std::expected<TargetT, ParseError> getValueFor(std::string_view value) {
     return TargetT{value};
   } else if constexpr (std::is_same_v<TargetT, const char *>) {
     return value.data();
+  } else if constexpr (std::is_same_v<TargetT, char> &&
+                       UsesCharTextValuesC<DecodingTraits>) {
+    if (value.size() != 1) {
+      return std::unexpected(
+          ParseError{"Expected a single character value", value});
+    }
+    return value.front();
   } else if constexpr ((std::is_integral_v<TargetT>) ||
                        (std::is_floating_point_v<TargetT>)) {
     return ston<TargetT>(value);
@@ -81,4 +122,182 @@ std::expected<bool, ParseError> getValueFor(bool value) {
   return value;
 }
 
-} // namespace moped
\ No newline at end of file
+// Numbers decoded by binary parsers convert directly rather than being
+// formatted to text and parsed again
+template <typename TargetT, typename DecodingTraits, typename NumericT>
+  requires(std::is_arithmetic_v<NumericT> && !std::is_same_v<NumericT, bool>)
+std::expected<TargetT, ParseError> getValueFor(NumericT value) {
+  if constexpr (std::is_same_v<TargetT, bool>) {
+    return value != 0;
+  } else if constexpr (std::is_integral_v<TargetT>) {
+    if constexpr (std::is_floating_point_v<NumericT>) {
+      if (value != std::trunc(value) ||
+          !floatFitsIntegral<TargetT>(value)) {
+        return std::unexpected(ParseError{
+            "Floating point value not representable by integral member",
+            std::format("{}", value)});
+      }
+    } else if (!std::in_range<InRangeT<TargetT>>(value)) {
+      return std::unexpected(ParseError{
+          "Numeric value out of range for integral member",
+          std::format("{}", value)});
+    }
+    return static_cast<TargetT>(value);
+  } else if constexpr (std::is_floating_point_v<TargetT>) {
+    return static_cast<TargetT>(value);
+  } else if constexpr (std::is_same_v<TargetT, TimePoint> &&
+                       std::is_integral_v<NumericT> && requires {
+                         DecodingTraits::TimePointFormaterT::getTimeUnits(
+                             TimePoint{});
+                       }) {
+    return DecodingTraits::TimePointFormaterT::getTimeValue(
+        static_cast<std::int64_t>(value));
+  } else if constexpr (is_optional<TargetT>) {
+    auto result =
+        getValueFor<typename TargetT::value_type, DecodingTraits>(value);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    return result.value();
+  } else if constexpr (is_scaled_int<TargetT>) {
+    using IntegralT = typename TargetT::IntegralT;
+    if constexpr (std::is_floating_point_v<NumericT>) {
+      // Rounded as floatToScaledInt does, then range checked before the cast
+      auto scaled = std::round(value * scale10<IntegralT>(TargetT::Scale));
+      if (!floatFitsIntegral<IntegralT>(scaled)) {
+        return std::unexpected(
+            ParseError{"Numeric value out of range for scaled integer member",
+                       std::format("{}", value)});
+      }
+      return TargetT::fromRawIntegerValue(static_cast<IntegralT>(scaled));
+    } else {
+      IntegralT rawValue;
+      if (!fitsIntegral<IntegralT>(value) ||
+          __builtin_mul_overflow(static_cast<IntegralT>(value),
+                                 TargetT::Divisor, &rawValue)) {
+        return std::unexpected(
+            ParseError{"Numeric value out of range for scaled integer member",
+                       std::format("{}", value)});
+      }
+      return TargetT::fromRawIntegerValue(rawValue);
+    }
+  } else if constexpr (is_mapped_enum<TargetT> &&
+                       std::is_integral_v<NumericT>) {
+    // Binary formats carry mapped enums as their underlying integral value
+    using EnumT = typename TargetT::EnumType;
+    if (!std::in_range<InRangeT<std::underlying_type_t<EnumT>>>(value)) {
+      return std::unexpected(ParseError{
+          "Numeric value out of range for mapped enum member",
+          std::format("{}", value)});
+    }
+    return TargetT{static_cast<EnumT>(value)};
+  } else if constexpr (std::is_same_v<TargetT, std::string_view> ||
+                       std::is_same_v<TargetT, const char *>) {
+    return std::unexpected(ParseError{
+        "Binary numeric value can not be referenced as text",
+        std::format("{}", value)});
+  } else {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return getValueFor<TargetT, DecodingTraits>(
+        std::string_view{buffer, static_cast<std::size_t>(end - buffer)});
+  }
+}
+
+template <typename TargetT, typename DecodingTraits>
+std::expected<TargetT, ParseError> getValueFor(TimePoint value) {
+  if constexpr (std::is_same_v<TargetT, TimePoint>) {
+    return value;
+  } else if constexpr (is_optional<TargetT>) {
+    auto result =
+        getValueFor<typename TargetT::value_type, DecodingTraits>(value);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    return result.value();
+  } else {
+    return std::unexpected(ParseError{
+        "Time value can not be assigned to a non time point member",
+        std::format("{}", value)});
+  }
+}
+
+template <typename T> struct DecimalRawIntegral {
+  using type = std::int64_t;
+};
+
+template <is_scaled_int T> struct DecimalRawIntegral<T> {
+  using type = typename T::IntegralT;
+};
+
+template <typename TargetT, typename DecodingTraits>
+std::expected<TargetT, ParseError> getValueFor(DecimalFraction value) {
+  if constexpr (is_optional<TargetT>) {
+    auto result =
+        getValueFor<typename TargetT::value_type, DecodingTraits>(value);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    return result.value();
+  } else if constexpr (std::is_floating_point_v<TargetT>) {
+    // Negative powers of ten aren't exact, dividing by the positive power
+    // keeps values like 450125e-2 exact
+    if (value.exponent < 0) {
+      return static_cast<TargetT>(value.mantissa /
+                                  std::pow(10.0, -value.exponent));
+    }
+    return static_cast<TargetT>(value.mantissa *
+                                std::pow(10.0, value.exponent));
+  } else if constexpr (is_scaled_int<TargetT> || std::is_integral_v<TargetT>) {
+    // Shift the mantissa to the target's scale, digits below it truncate
+    // for scaled integers and are rejected for plain integers
+    using IntegralT = typename DecimalRawIntegral<TargetT>::type;
+    int shift = value.exponent;
+    if constexpr (is_scaled_int<TargetT>) {
+      shift += TargetT::Scale;
+    }
+    if (shift > std::numeric_limits<std::int64_t>::digits10 ||
+        -shift > std::numeric_limits<std::int64_t>::digits10) {
+      return std::unexpected(ParseError{
+          "Decimal fraction exponent out of range", std::format("{}", value)});
+    }
+    // Shifted in 128 bits, which holds any 64 bit mantissa times 10^18, and
+    // checked against the target's range afterwards
+    int128_t rawValue = value.mantissa;
+    if (shift >= 0) {
+      rawValue *= scale10<int128_t>(shift);
+    } else {
+      auto divisor = scale10<int128_t>(-shift);
+      if constexpr (!is_scaled_int<TargetT>) {
+        if (rawValue % divisor != 0) {
+          return std::unexpected(
+              ParseError{"Fractional value not representable by integral "
+                         "member",
+                         std::format("{}", value)});
+        }
+      }
+      rawValue /= divisor;
+    }
+    if (!fitsIntegral<IntegralT>(rawValue)) {
+      return std::unexpected(ParseError{
+          "Decimal fraction out of range for member",
+          std::format("{}", value)});
+    }
+    if constexpr (is_scaled_int<TargetT>) {
+      return TargetT::fromRawIntegerValue(static_cast<IntegralT>(rawValue));
+    } else {
+      return getValueFor<TargetT, DecodingTraits>(
+          static_cast<IntegralT>(rawValue));
+    }
+  } else if constexpr (std::is_same_v<TargetT, std::string_view> ||
+                       std::is_same_v<TargetT, const char *>) {
+    return std::unexpected(
+        ParseError{"Binary decimal value can not be referenced as text",
+                   std::format("{}", value)});
+  } else {
+    auto text = std::format("{}", value);
+    return getValueFor<TargetT, DecodingTraits>(std::string_view{text});
+  }
+}
+
+} // namespace moped
@@ -4,6 +4,7 @@
 #include "moped/AutoTypeSelectingParserHandler.hpp"
 #include "moped/CollectionFunctionDispatcher.hpp"
 #include "moped/CompositeParseEventDispatcher.hpp"
+#include "moped/MappedCollectionFunctionDispatcher.hpp"
 #include "moped/MappedEnum.hpp"
 #include "moped/MappedObjectParseEncoderDispatcher.hpp"
 #include "moped/PivotMemberTypeSelector.hpp"
@@ -29,4 +30,17 @@ struct StringDecodingTraits {
 static_assert(DecodingTraitsC<StringDecodingTraits<>>,
               "StringDecodingTraits should satisfy DecodingTraitsC concept");
 
+// Opts push collections into adaptive reservation, each collection handler
+// remembers the largest size it has decoded and reserves to it at the start
+// of subsequent arrays for the same member.
+template <DecodingTraitsC BaseTraits>
+struct AdaptiveReserveDecodingTraits : BaseTraits {
+  static constexpr bool AdaptiveCollectionReserve = true;
+};
+
+static_assert(
+    UsesAdaptiveCollectionReserveC<
+        AdaptiveReserveDecodingTraits<StringDecodingTraits<>>>,
+    "AdaptiveReserveDecodingTraits should enable adaptive reservation");
+
 } // namespace moped
\ No newline at end of file
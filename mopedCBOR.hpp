@@ -0,0 +1,36 @@
+#pragma once
+#include "CBOREmitterContext.hpp"
+#include "CBORParser.hpp"
+#include "moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TFT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromCBOR(TFT, std::string_view document, Args &&...args) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, StringDecodingTraits<TFT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  CBORParser<DispatcherT> parser{dispatcher};
+  if (auto result = parser.parse(document); !result) {
+    return std::unexpected(result.error());
+  }
+  return dispatcher.moveComposite();
+}
+
+template <typename CompositeT, typename TFT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromCBORStream(TFT, std::istream &stream, Args &&...args) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, StringDecodingTraits<TFT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  CBORParser<DispatcherT> parser{dispatcher};
+  if (auto result = parser.parse(stream); !result) {
+    return std::unexpected(result.error());
+  }
+  return dispatcher.moveComposite();
+}
+
+} // namespace moped
@@ -0,0 +1,32 @@
+#pragma once
+#include "FIXEmitterContext.hpp"
+#include "FIXParser.hpp"
+#include "moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, FIXDecodingTraits<TFT>>
+std::expected<fix::Dictionary, ParseError> makeFIXDictionary(TFT) {
+  return fix::Dictionary::create<CompositeT, FIXDecodingTraits<TFT>>();
+}
+
+template <typename CompositeT, typename TFT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, FIXDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromFIX(TFT tft, std::string_view message, Args &&...args) {
+  static const auto dictionary = makeFIXDictionary<CompositeT>(tft);
+  if (!dictionary) {
+    return std::unexpected(dictionary.error());
+  }
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, FIXDecodingTraits<TFT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  FIXParser<DispatcherT> parser{dispatcher, *dictionary};
+  if (auto result = parser.parse(message); !result) {
+    return std::unexpected(result.error());
+  }
+  return dispatcher.moveComposite();
+}
+
+} // namespace moped
@@ -0,0 +1,42 @@
+#pragma once
+#include "moped/InfoParser.hpp"
+#include "moped/moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TimeFormatterT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromInfoView(TimeFormatterT, std::string_view infoView,
+                           Args &&...args) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT,
+                                     StringDecodingTraits<TimeFormatterT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  InfoParser<DispatcherT> parser{dispatcher};
+  if (auto result = parser.parse(infoView); !result) {
+    return std::unexpected(result.error());
+  }
+  return parser.getDispatcher().moveComposite();
+}
+
+// Relative #include paths in the file resolve against its directory
+template <typename CompositeT, typename TimeFormatterT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromInfoFile(TimeFormatterT,
+                           const std::filesystem::path &filePath,
+                           Args &&...args) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT,
+                                     StringDecodingTraits<TimeFormatterT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  InfoParser<DispatcherT> parser{dispatcher};
+  parser.setIncludeDirectory(filePath.parent_path());
+  if (auto result = parser.parseFile(filePath); !result) {
+    return std::unexpected(result.error());
+  }
+  return parser.getDispatcher().moveComposite();
+}
+
+} // namespace moped
@@ -42,4 +42,20 @@ parseCompositeFromJSONView(TFT, std::string_view jsonView, Args &&...args) {
   return parser.getDispatcher().moveComposite();
 }
 
+// Applies a partial object onto 'target': members absent from the input keep
+// their value, null resets optional members and collections follow the
+// MergePolicy given to their name in mopedHandler(...). Hot paths can keep a
+// dispatcher and call setTargetComposite per update to the same effect.
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+Expected mergeCompositeFromJSONView(TFT, std::string_view jsonView,
+                                    CompositeT &target) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, StringDecodingTraits<TFT>>;
+  DispatcherT dispatcher;
+  dispatcher.setTargetComposite(target);
+  JSONViewParser<DispatcherT> parser{dispatcher};
+  return parser.parse(jsonView);
+}
+
 } // namespace moped
\ No newline at end of file
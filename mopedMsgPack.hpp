@@ -0,0 +1,35 @@
+#pragma once
+#include "MsgPackEmitterContext.hpp"
+#include "MsgPackParser.hpp"
+#include "moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TFT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromMsgPack(TFT, std::string_view document, Args &&...args) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, StringDecodingTraits<TFT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  MsgPackParser<DispatcherT> parser{dispatcher};
+  if (auto result = parser.parse(document); !result) {
+    return std::unexpected(result.error());
+  }
+  return dispatcher.moveComposite();
+}
+
+// Applies a partial map onto 'target', see mergeCompositeFromJSONView
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+Expected mergeCompositeFromMsgPack(TFT, std::string_view document,
+                                   CompositeT &target) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, StringDecodingTraits<TFT>>;
+  DispatcherT dispatcher;
+  dispatcher.setTargetComposite(target);
+  MsgPackParser<DispatcherT> parser{dispatcher};
+  return parser.parse(document);
+}
+
+} // namespace moped
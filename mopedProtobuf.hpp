@@ -0,0 +1,32 @@
+#pragma once
+#include "ProtobufEmitterContext.hpp"
+#include "ProtobufParser.hpp"
+#include "moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, ProtobufDecodingTraits<TFT>>
+std::expected<protobuf::Schema, ParseError> makeProtobufSchema(TFT) {
+  return protobuf::Schema::create<CompositeT, ProtobufDecodingTraits<TFT>>();
+}
+
+template <typename CompositeT, typename TFT, typename... Args>
+  requires IsMOPEDCompositeC<CompositeT, ProtobufDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromProtobuf(TFT tft, std::string_view message, Args &&...args) {
+  static const auto schema = makeProtobufSchema<CompositeT>(tft);
+  if (!schema) {
+    return std::unexpected(schema.error());
+  }
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT, ProtobufDecodingTraits<TFT>>;
+  DispatcherT dispatcher{std::forward<Args>(args)...};
+  ProtobufParser<DispatcherT> parser{dispatcher, *schema};
+  if (auto result = parser.parse(message); !result) {
+    return std::unexpected(result.error());
+  }
+  return dispatcher.moveComposite();
+}
+
+} // namespace moped
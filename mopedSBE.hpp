@@ -0,0 +1,27 @@
+#pragma once
+#include "SBEDecoder.hpp"
+#include "SBEEmitterContext.hpp"
+#include "moped.hpp"
+
+namespace moped {
+
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+std::expected<SBEDecoder<CompositeT, StringDecodingTraits<TFT>>, ParseError>
+makeSBEDecoder(TFT, const sbe::MessageLayout &layout) {
+  return SBEDecoder<CompositeT, StringDecodingTraits<TFT>>::create(layout);
+}
+
+template <typename CompositeT, typename TFT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TFT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromSBE(TFT tft, const sbe::MessageLayout &layout,
+                      std::string_view buffer) {
+  auto decoder = makeSBEDecoder<CompositeT>(tft, layout);
+  if (!decoder) {
+    return std::unexpected(decoder.error());
+  }
+  return decoder->decode(buffer);
+}
+
+} // namespace moped
@@ -1,9 +1,15 @@
 #pragma once
+#include "moped/YAMLEmitterContext.hpp"
 #include "moped/YAMLParser.hpp"
+#include "moped/YAMLViewParser.hpp"
 #include "moped/moped.hpp"
+#include <type_traits>
+#include <vector>
 
 namespace moped {
 
+// Block YAML in the native subset is parsed straight from the view, other
+// documents are handed to libyaml
 template <typename CompositeT, typename TimeFormatterT, typename... Args>
   requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
 std::expected<CompositeT, ParseError>
@@ -12,12 +18,104 @@ parseCompositeFromYAMLView(TimeFormatterT, std::string_view yamlView,
   using DispatcherT =
       CompositeParserEventDispatcher<CompositeT,
                                      StringDecodingTraits<TimeFormatterT>>;
-  DispatcherT dispatcher{std::forward<Args>(args)...};
+  // 'args' may be needed again for the libyaml fallback, so they're only
+  // forwarded there
+  DispatcherT dispatcher{args...};
+  YAMLViewParser<DispatcherT> viewParser{dispatcher};
+  if (auto result = viewParser.parse(yamlView); result) {
+    return dispatcher.moveComposite();
+  } else if (!viewParser.unsupported()) {
+    return std::unexpected(result.error());
+  }
   YAMLParser<DispatcherT> parser{};
+  parser.getDispatcher().reset(std::forward<Args>(args)...);
   if (auto result = parser.parseInputView(yamlView); !result) {
     return std::unexpected(result.error());
   }
   return parser.getDispatcher().moveComposite();
 }
 
-} // namespace moped
\ No newline at end of file
+template <typename CompositeT, typename TimeFormatterT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+std::expected<CompositeT, ParseError>
+parseCompositeFromYAMLStream(TimeFormatterT, std::istream &yamlStream) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT,
+                                     StringDecodingTraits<TimeFormatterT>>;
+  YAMLParser<DispatcherT> parser{};
+  if (auto result = parser.parse(yamlStream); !result) {
+    return std::unexpected(result.error());
+  }
+  return parser.getDispatcher().moveComposite();
+}
+
+// Decodes each document of a multi-document stream in turn through one
+// parser and dispatcher, handing the composite to 'onDocument' before it's
+// reset for the next document. An error returned by 'onDocument' ends the
+// stream.
+template <typename ParserT, typename DocumentFn>
+Expected dispatchYAMLDocuments(ParserT &parser, DocumentFn &onDocument) {
+  auto &dispatcher = parser.getDispatcher();
+  while (true) {
+    auto parsed = parser.parseNextDocument();
+    if (!parsed) {
+      return std::unexpected(parsed.error());
+    }
+    if (!*parsed) {
+      return {};
+    }
+    if constexpr (std::is_void_v<
+                      std::invoke_result_t<DocumentFn &,
+                                           decltype(dispatcher.getComposite())>>) {
+      onDocument(dispatcher.getComposite());
+    } else if (auto result = onDocument(dispatcher.getComposite()); !result) {
+      return result;
+    }
+    dispatcher.reset();
+  }
+}
+
+template <typename CompositeT, typename TimeFormatterT, typename DocumentFn>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+Expected parseCompositesFromYAMLView(TimeFormatterT, std::string_view yamlView,
+                                     DocumentFn &&onDocument) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT,
+                                     StringDecodingTraits<TimeFormatterT>>;
+  YAMLParser<DispatcherT> parser{};
+  parser.setInputView(yamlView);
+  return dispatchYAMLDocuments(parser, onDocument);
+}
+
+template <typename CompositeT, typename TimeFormatterT, typename DocumentFn>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+Expected parseCompositesFromYAMLStream(TimeFormatterT,
+                                       std::istream &yamlStream,
+                                       DocumentFn &&onDocument) {
+  using DispatcherT =
+      CompositeParserEventDispatcher<CompositeT,
+                                     StringDecodingTraits<TimeFormatterT>>;
+  YAMLParser<DispatcherT> parser{};
+  parser.setInput(yamlStream);
+  return dispatchYAMLDocuments(parser, onDocument);
+}
+
+// Every document of the stream, in order
+template <typename CompositeT, typename TimeFormatterT>
+  requires IsMOPEDCompositeC<CompositeT, StringDecodingTraits<TimeFormatterT>>
+std::expected<std::vector<CompositeT>, ParseError>
+parseCompositesFromYAMLView(TimeFormatterT timeFormatter,
+                            std::string_view yamlView) {
+  std::vector<CompositeT> composites;
+  if (auto result = parseCompositesFromYAMLView<CompositeT>(
+          timeFormatter, yamlView,
+          [&composites](CompositeT &composite) {
+            composites.push_back(std::move(composite));
+          });
+      !result) {
+    return std::unexpected(result.error());
+  }
+  return composites;
+}
+
+} // namespace moped
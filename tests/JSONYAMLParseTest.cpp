@@ -7,6 +7,9 @@
 
 #include "moped/tests/mdConfigSampleDefns.hpp"
 #include <optional>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
 #include <string>
 #include <vector>
 
@@ -225,3 +228,461 @@ TEST_CASE("Same definition, Same mapping but now loading with JSON"
       DFTF{}, jsonTestMDConfig);
   TestCompositeValues(result);
 }
+
+TEST_CASE("Loading the YAML config from a stream and a file descriptor"
+          "[YAML STREAM INPUT]") {
+  std::istringstream yamlStream{std::string{yamlTestMDConfig}};
+  auto result = moped::parseCompositeFromYAMLStream<moped::tests::MDConfig>(
+      DFTF{}, yamlStream);
+  TestCompositeValues(result);
+
+  int pipeEnds[2];
+  REQUIRE(::pipe(pipeEnds) == 0);
+  bool written = true;
+  std::thread writer{[&]() {
+    // Written in small pieces so the document arrives over several reads
+    for (std::size_t offset = 0; offset < yamlTestMDConfig.size();
+         offset += 64) {
+      auto piece = yamlTestMDConfig.substr(offset, 64);
+      written &= ::write(pipeEnds[1], piece.data(), piece.size()) ==
+                 static_cast<ssize_t>(piece.size());
+    }
+    ::close(pipeEnds[1]);
+  }};
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<moped::tests::MDConfig,
+                                            moped::StringDecodingTraits<DFTF>>;
+  moped::YAMLParser<DispatcherT> parser;
+  auto parsed = parser.parseFileDescriptor(pipeEnds[0]);
+  writer.join();
+  ::close(pipeEnds[0]);
+  REQUIRE(written);
+  REQUIRE(parsed.has_value());
+  std::expected<moped::tests::MDConfig, moped::ParseError> fromPipe{
+      parser.getDispatcher().moveComposite()};
+  TestCompositeValues(fromPipe);
+}
+
+namespace {
+
+struct YamlScalars {
+  std::string code;
+  std::string flag;
+  std::optional<int> count;
+  double ratio;
+  bool enabled;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlScalars>(
+        "code", &YamlScalars::code, "flag", &YamlScalars::flag, "count",
+        &YamlScalars::count, "ratio", &YamlScalars::ratio, "enabled",
+        &YamlScalars::enabled);
+  }
+};
+
+} // namespace
+
+TEST_CASE("YAML quoted scalars stay strings [YAML SCALAR STYLES]") {
+  auto result = moped::parseCompositeFromYAMLView<YamlScalars>(
+      DFTF{}, "code: '007'\nflag: \"true\"\ncount: 12\nratio: -1.5e3\n"
+              "enabled: True\n");
+  REQUIRE(result.has_value());
+  REQUIRE(result->code == "007");
+  REQUIRE(result->flag == "true");
+  REQUIRE(result->count == 12);
+  REQUIRE(result->ratio == -1500.0);
+  REQUIRE(result->enabled);
+
+  // The parser is reusable and reports where malformed input fails
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<YamlScalars,
+                                            moped::StringDecodingTraits<DFTF>>;
+  moped::YAMLParser<DispatcherT> parser;
+  REQUIRE(parser.parseInputView("code: abc\n").has_value());
+  auto failed = parser.parseInputView("code: abc\nflag: \"x\n");
+  REQUIRE(!failed.has_value());
+  auto *position = std::get_if<std::string>(&failed.error().referenceValue);
+  REQUIRE(position != nullptr);
+  REQUIRE(position->find(" at line ") != std::string::npos);
+}
+
+namespace {
+
+// Built with the source it was loaded from
+struct YamlSourced {
+  std::string source;
+  std::string code;
+
+  explicit YamlSourced(std::string loadedFrom = {})
+      : source{std::move(loadedFrom)} {}
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlSourced>("code",
+                                                           &YamlSourced::code);
+  }
+};
+
+} // namespace
+
+TEST_CASE("YAML composite constructor arguments reach the libyaml fallback "
+          "[YAML SCALAR STYLES]") {
+  std::string source{"config.yaml"};
+  auto native = moped::parseCompositeFromYAMLView<YamlSourced>(
+      DFTF{}, "code: a\n", source);
+  REQUIRE(native.has_value());
+  REQUIRE(native->source == "config.yaml");
+  REQUIRE(native->code == "a");
+
+  // Flow mappings are outside the native subset
+  auto fallback = moped::parseCompositeFromYAMLView<YamlSourced>(
+      DFTF{}, "{code: b}\n", source);
+  REQUIRE(fallback.has_value());
+  REQUIRE(fallback->source == "config.yaml");
+  REQUIRE(fallback->code == "b");
+}
+
+TEST_CASE("YAML documents read one at a time from a file descriptor "
+          "[YAML STREAM INPUT]") {
+  int pipeEnds[2];
+  REQUIRE(::pipe(pipeEnds) == 0);
+  std::string_view documents = "code: a\ncount: 1\n---\ncode: b\ncount: 2\n"
+                               "---\ncode: c\ncount: 3\n";
+  bool written = ::write(pipeEnds[1], documents.data(), documents.size()) ==
+                 static_cast<ssize_t>(documents.size());
+  ::close(pipeEnds[1]);
+  REQUIRE(written);
+
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<YamlScalars,
+                                            moped::StringDecodingTraits<DFTF>>;
+  moped::YAMLParser<DispatcherT> parser;
+  // The descriptor outlives the call that sets it, libyaml keeps reading
+  // through it document by document
+  parser.setInputFileDescriptor(pipeEnds[0]);
+  std::vector<std::string> codes;
+  std::vector<int> counts;
+  auto onDocument = [&](YamlScalars &document) {
+    codes.push_back(document.code);
+    counts.push_back(document.count.value_or(0));
+  };
+  auto parsed = moped::dispatchYAMLDocuments(parser, onDocument);
+  ::close(pipeEnds[0]);
+  REQUIRE(parsed.has_value());
+  REQUIRE(codes == std::vector<std::string>{"a", "b", "c"});
+  REQUIRE(counts == std::vector<int>{1, 2, 3});
+}
+
+namespace {
+
+struct YamlEndpoints {
+  std::map<std::string, moped::tests::Endpoint> endpoints;
+  std::vector<int> ports;
+  std::vector<std::vector<std::string>> nested;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlEndpoints>(
+        "endpoints", &YamlEndpoints::endpoints, "ports",
+        &YamlEndpoints::ports, "nested", &YamlEndpoints::nested);
+  }
+};
+
+// Accepts any document, counting the scalars it receives
+struct YamlScalarCounter {
+  std::size_t scalars{0};
+
+  moped::Expected onMember(std::string_view) { return {}; }
+  moped::Expected onObjectStart() { return {}; }
+  moped::Expected onObjectFinish() { return {}; }
+  moped::Expected onArrayStart() { return {}; }
+  moped::Expected onArrayFinish() { return {}; }
+  moped::Expected onStringValue(std::string_view) { return count(); }
+  moped::Expected onBooleanValue(bool) { return count(); }
+  moped::Expected onNullValue() { return count(); }
+  moped::Expected onNumericValue(std::string_view) { return count(); }
+
+  moped::Expected count() {
+    ++scalars;
+    return {};
+  }
+};
+
+auto parseEndpoints(std::string_view yaml) {
+  return moped::parseCompositeFromYAMLView<YamlEndpoints>(DFTF{}, yaml);
+}
+
+} // namespace
+
+TEST_CASE("YAML anchors and aliases replay recorded nodes "
+          "[YAML ANCHORS]") {
+  auto result = parseEndpoints(R"(
+ports: &ports [80, 443]
+nested:
+  - &pair [a, b]
+  - *pair
+endpoints:
+  primary: &primary
+    name: primary
+    host: &host api.example.com
+    port: 443
+    uri: /v1
+  copy: *primary
+  hostOnly:
+    host: *host
+)");
+  REQUIRE(result.has_value());
+  REQUIRE(result->ports == std::vector<int>{80, 443});
+  REQUIRE(result->nested ==
+          std::vector<std::vector<std::string>>{{"a", "b"}, {"a", "b"}});
+  auto &copy = result->endpoints.at("copy");
+  REQUIRE(copy.name == "primary");
+  REQUIRE(copy.host == "api.example.com");
+  REQUIRE(copy.port == 443);
+  REQUIRE(copy.uri == "/v1");
+  REQUIRE(result->endpoints.at("hostOnly").host == "api.example.com");
+}
+
+TEST_CASE("YAML merge keys give explicit keys precedence [YAML ANCHORS]") {
+  auto result = parseEndpoints(R"(
+endpoints:
+  base: &base
+    host: base.example.com
+    port: 80
+    uri: /base
+  secure: &secure
+    port: 443
+    <<: *base
+  before:
+    name: before
+    port: 8080
+    <<: *base
+  after:
+    <<: *base
+    name: after
+    uri: /after
+  several:
+    <<: [*secure, {name: inline, uri: /inline}]
+)");
+  REQUIRE(result.has_value());
+  auto &before = result->endpoints.at("before");
+  REQUIRE(before.name == "before");
+  REQUIRE(before.host == "base.example.com");
+  REQUIRE(before.port == 8080);
+  REQUIRE(before.uri == "/base");
+  auto &after = result->endpoints.at("after");
+  REQUIRE(after.name == "after");
+  REQUIRE(after.port == 80);
+  REQUIRE(after.uri == "/after");
+  // Earlier mappings in a merge sequence win, the secure mapping's own
+  // port outranks the port it merges
+  auto &several = result->endpoints.at("several");
+  REQUIRE(several.name == "inline");
+  REQUIRE(several.host == "base.example.com");
+  REQUIRE(several.port == 443);
+  REQUIRE(several.uri == "/base");
+}
+
+TEST_CASE("YAML alias errors and expansion limit [YAML ANCHORS]") {
+  REQUIRE(!parseEndpoints("ports: *missing\n").has_value());
+  REQUIRE(!parseEndpoints("nested: &loop [*loop]\n").has_value());
+  REQUIRE(!parseEndpoints("endpoints:\n  a:\n    <<: 1\n").has_value());
+
+  // Each level doubles the expansion, the limit stops it early
+  std::string bomb = "- &l0 [x, x]\n";
+  for (int level = 1; level < 30; ++level) {
+    bomb += std::format("- &l{} [*l{}, *l{}]\n", level, level - 1,
+                        level - 1);
+  }
+  moped::YAMLParser<YamlScalarCounter> parser;
+  auto limited = std::string_view{bomb}.substr(0, bomb.find("- &l10"));
+  REQUIRE(parser.parseInputView(limited).has_value());
+  REQUIRE(parser.getDispatcher().scalars == 2 * 1023);
+  parser.setAliasExpansionLimit(10'000);
+  auto failed = parser.parseInputView(bomb);
+  REQUIRE(!failed.has_value());
+  REQUIRE(std::string_view{failed.error().message} ==
+          "YAML alias expansion exceeds its limit");
+}
+
+namespace {
+
+// Records the events it receives as text
+struct YamlEventLog {
+  std::string events;
+
+  moped::Expected onMember(std::string_view name) {
+    return log(std::format("member({})", name));
+  }
+  moped::Expected onObjectStart() { return log("{"); }
+  moped::Expected onObjectFinish() { return log("}"); }
+  moped::Expected onArrayStart() { return log("["); }
+  moped::Expected onArrayFinish() { return log("]"); }
+  moped::Expected onStringValue(std::string_view value) {
+    return log(std::format("string({})", value));
+  }
+  moped::Expected onBooleanValue(bool value) {
+    return log(value ? "true" : "false");
+  }
+  moped::Expected onNullValue() { return log("null"); }
+  moped::Expected onNumericValue(std::string_view value) {
+    return log(std::format("number({})", value));
+  }
+
+  moped::Expected log(std::string_view event) {
+    events += event;
+    events += ' ';
+    return {};
+  }
+};
+
+// The events of the native parse, which must match libyaml's
+std::string nativeYamlEvents(std::string_view yaml) {
+  YamlEventLog log;
+  moped::YAMLViewParser<YamlEventLog> parser{log};
+  auto result = parser.parse(yaml);
+  REQUIRE(result.has_value());
+  moped::YAMLParser<YamlEventLog> reference;
+  REQUIRE(reference.parseInputView(yaml).has_value());
+  REQUIRE(log.events == reference.getDispatcher().events);
+  return log.events;
+}
+
+bool nativeYamlUnsupported(std::string_view yaml) {
+  YamlEventLog log;
+  moped::YAMLViewParser<YamlEventLog> parser{log};
+  return !parser.parse(yaml).has_value() && parser.unsupported();
+}
+
+} // namespace
+
+TEST_CASE("Native YAML parser matches libyaml on the block subset "
+          "[YAML VIEW PARSER]") {
+  using DispatcherT = moped::CompositeParserEventDispatcher<
+      moped::tests::MDConfig, moped::StringDecodingTraits<DFTF>>;
+  DispatcherT dispatcher;
+  moped::YAMLViewParser<DispatcherT> parser{dispatcher};
+  REQUIRE(parser.parse(yamlTestMDConfig).has_value());
+  auto result = std::expected<moped::tests::MDConfig, moped::ParseError>{
+      dispatcher.moveComposite()};
+  TestCompositeValues(result);
+
+  nativeYamlEvents(yamlTestMDConfig);
+  ASSERT_EQ(nativeYamlEvents("--- # config\n"
+                             "name: 'it''s' # comment\n"
+                             "quoted: \"a\\tb \\\"c\\\" \\u00e9\"\n"
+                             "\"quoted key\" : 1\n"
+                             "flags: [a, 'b', \"c\", 2, true]\n"
+                             "empty: []\n"
+                             "none: {}\n"
+                             "blank:\n"
+                             "list:\n"
+                             "- - 1\n"
+                             "  - 2\n"
+                             "- key: x#y\n"
+                             "  other: null\n"
+                             "-\n"
+                             "  nested: ~\n"
+                             "url: http://host:80/a\r\n"
+                             "...\n"
+                             "ignored: after the end\n"),
+            "{ member(name) string(it's) member(quoted) string(a\tb \"c\" é) "
+            "member(quoted key) number(1) member(flags) [ string(a) "
+            "string(b) string(c) number(2) true ] member(empty) [ ] "
+            "member(none) { } member(blank) string() member(list) [ [ "
+            "number(1) number(2) ] { member(key) string(x#y) member(other) "
+            "null } { member(nested) null } ] member(url) "
+            "string(http://host:80/a) } ");
+
+  // Text the emitter had to quote reads back the same way
+  YamlEndpoints endpoints;
+  endpoints.endpoints["a b"] = {"line\nbreak", "  padded", 1, "true"};
+  endpoints.ports = {1, 2};
+  endpoints.nested = {{"1.5", "- x", "a: b", "it's"}, {}};
+  nativeYamlEvents(moped::encodeToYAMLString(endpoints, DFTF{}));
+}
+
+TEST_CASE("Native YAML parser leaves the rest of YAML to libyaml "
+          "[YAML VIEW PARSER]") {
+  REQUIRE(nativeYamlUnsupported("a: &anchor 1\nb: *anchor\n"));
+  REQUIRE(nativeYamlUnsupported("a:\n  <<: {b: 1}\n"));
+  REQUIRE(nativeYamlUnsupported("text: |\n  block\n"));
+  REQUIRE(nativeYamlUnsupported("text: plain\n  continued\n"));
+  REQUIRE(nativeYamlUnsupported("text: \"open\n  quote\"\n"));
+  REQUIRE(nativeYamlUnsupported("map: {a: 1}\n"));
+  REQUIRE(nativeYamlUnsupported("seq: [[1]]\n"));
+  REQUIRE(nativeYamlUnsupported("tag: !!str 1\n"));
+  REQUIRE(nativeYamlUnsupported("a:\tb\n"));
+  REQUIRE(nativeYamlUnsupported("scalar\n"));
+
+  // The composite entry point falls back to libyaml for these
+  auto result = parseEndpoints("ports: &ports [80, 443]\nnested: [[a]]\n");
+  REQUIRE(result.has_value());
+  REQUIRE(result->ports == std::vector<int>{80, 443});
+  REQUIRE(result->nested == std::vector<std::vector<std::string>>{{"a"}});
+
+  // Errors raised by the dispatcher are returned as they are
+  REQUIRE(!parseEndpoints("ports: [80, x]\n").has_value());
+}
+
+namespace {
+
+std::string_view yamlEndpointDocuments = R"(---
+name: first
+host: one.example.com
+port: 1
+uri: &uri /first
+---
+# An empty document is skipped
+---
+name: second
+port: 2
+...
+---
+name: third
+host: &host three.example.com
+uri: *host
+)";
+
+} // namespace
+
+TEST_CASE("YAML multi-document streams decode one composite per document "
+          "[YAML DOCUMENTS]") {
+  auto endpoints = moped::parseCompositesFromYAMLView<moped::tests::Endpoint>(
+      DFTF{}, yamlEndpointDocuments);
+  REQUIRE(endpoints.has_value());
+  REQUIRE(endpoints->size() == 3);
+  REQUIRE((*endpoints)[0].uri == "/first");
+  // Each document starts from a fresh composite
+  REQUIRE((*endpoints)[1].name == "second");
+  REQUIRE((*endpoints)[1].host.empty());
+  REQUIRE((*endpoints)[1].port == 2);
+  REQUIRE((*endpoints)[2].uri == "three.example.com");
+
+  std::istringstream yamlStream{std::string{yamlEndpointDocuments}};
+  std::vector<std::string> names;
+  auto result = moped::parseCompositesFromYAMLStream<moped::tests::Endpoint>(
+      DFTF{}, yamlStream,
+      [&names](moped::tests::Endpoint &endpoint) -> moped::Expected {
+        names.push_back(endpoint.name);
+        if (names.size() == 2) {
+          return std::unexpected("stop");
+        }
+        return {};
+      });
+  REQUIRE(!result.has_value());
+  REQUIRE(std::string_view{result.error().message} == "stop");
+  REQUIRE(names == std::vector<std::string>{"first", "second"});
+
+  // Anchors don't carry over into later documents
+  auto unscoped = moped::parseCompositesFromYAMLView<moped::tests::Endpoint>(
+      DFTF{}, "name: &name a\n---\nname: *name\n");
+  REQUIRE(!unscoped.has_value());
+
+  // The single document entry points decode the first non-empty document
+  auto first = moped::parseCompositeFromYAMLView<moped::tests::Endpoint>(
+      DFTF{}, yamlEndpointDocuments.substr(yamlEndpointDocuments.find("#")));
+  REQUIRE(first.has_value());
+  REQUIRE(first->name == "second");
+}
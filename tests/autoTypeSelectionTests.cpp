@@ -0,0 +1,214 @@
+#include <catch2/catch.hpp>
+
+#include "moped/moped.hpp"
+#include "moped/mopedJSON.hpp"
+
+#include <format>
+#include <sstream>
+#include <string>
+
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+using SelectionTraits = moped::StringDecodingTraits<DFTF>;
+using S8Int = moped::ScaledInteger<std::int64_t, 8>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct TradeEvent {
+  std::string eventType;
+  std::string symbol;
+  S8Int price;
+  std::int64_t quantity;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, TradeEvent>(
+        "e", &TradeEvent::eventType, "s", &TradeEvent::symbol, "p",
+        &TradeEvent::price, "q", &TradeEvent::quantity);
+  }
+};
+
+struct QuoteEvent {
+  std::string eventType;
+  std::string symbol;
+  S8Int bid;
+  S8Int ask;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, QuoteEvent>(
+        "e", &QuoteEvent::eventType, "s", &QuoteEvent::symbol, "b",
+        &QuoteEvent::bid, "a", &QuoteEvent::ask);
+  }
+};
+
+struct Header {
+  std::string source;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Header>("source",
+                                                       &Header::source);
+  }
+};
+
+struct EnvelopeEvent {
+  std::int64_t sequence;
+  Header header;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, EnvelopeEvent>(
+        "seq", &EnvelopeEvent::sequence, "", &EnvelopeEvent::header);
+  }
+};
+
+using EventDispatcher = moped::AutoTypeSelectingParserDispatcher<
+    moped::CandidateTypeHarness<SelectionTraits, TradeEvent, QuoteEvent>>;
+
+} // namespace
+
+TEST_CASE("Candidate types are selected from the members they declare",
+          "[AUTO TYPE SELECTION]") {
+  EventDispatcher dispatcher;
+
+  std::string selected;
+  auto captureSelection = [&](auto &composite) -> moped::Expected {
+    using CompositeT = std::decay_t<decltype(composite)>;
+    if constexpr (std::is_same_v<CompositeT, TradeEvent>) {
+      selected = "trade:" + composite.symbol;
+      ASSERT_EQ(composite.quantity, 2);
+    } else {
+      selected = "quote:" + composite.symbol;
+      ASSERT_EQ(composite.ask, S8Int{"101.5"});
+    }
+    return {};
+  };
+
+  REQUIRE(dispatcher
+              .parseAndDispatchJSONView(
+                  R"({"e":"trade","s":"BTCUSD","p":"100.25","q":2})",
+                  captureSelection)
+              .has_value());
+  ASSERT_EQ(selected, "trade:BTCUSD");
+
+  dispatcher.reset();
+  REQUIRE(dispatcher
+              .parseAndDispatchJSONView(
+                  R"({"e":"quote","s":"ETHUSD","b":"101","a":"101.5"})",
+                  captureSelection)
+              .has_value());
+  ASSERT_EQ(selected, "quote:ETHUSD");
+}
+
+TEST_CASE("Members unknown to every candidate fail on the member event",
+          "[AUTO TYPE SELECTION]") {
+  EventDispatcher dispatcher;
+  auto result = dispatcher.parseAndDispatchJSONView(
+      R"({"e":"trade","x":1})", [](auto &) -> moped::Expected { return {}; });
+  REQUIRE(!result);
+  ASSERT_EQ(std::string_view{result.error().message},
+            "Member not declared by any candidate type");
+}
+
+TEST_CASE("Candidates with embedded composites accept undeclared members",
+          "[AUTO TYPE SELECTION]") {
+  moped::AutoTypeSelectingParserDispatcher<moped::CandidateTypeHarness<
+      SelectionTraits, TradeEvent, EnvelopeEvent>>
+      dispatcher;
+
+  std::string source;
+  auto result = dispatcher.parseAndDispatchJSONView(
+      R"({"seq":7,"source":"gateway"})", [&](auto &composite) -> moped::Expected {
+        if constexpr (std::is_same_v<std::decay_t<decltype(composite)>,
+                                     EnvelopeEvent>) {
+          source = composite.header.source;
+          ASSERT_EQ(composite.sequence, 7);
+        }
+        return {};
+      });
+  REQUIRE(result.has_value());
+  ASSERT_EQ(source, "gateway");
+}
+
+namespace {
+
+constexpr char eventTypeMember[] = "e";
+constexpr char tradeEventType[] = "trade";
+constexpr char quoteEventType[] = "quote";
+
+using EventTypePivot =
+    moped::PivotMap<eventTypeMember,
+                    moped::ValueMapEntry<tradeEventType, TradeEvent>,
+                    moped::ValueMapEntry<quoteEventType, QuoteEvent>>;
+
+using PivotEventDispatcher = moped::AutoTypeSelectingParserDispatcher<
+    moped::CandidateTypeHarness<SelectionTraits, TradeEvent, QuoteEvent>,
+    EventTypePivot>;
+
+} // namespace
+
+TEST_CASE("Event tape defers candidate parsing until the pivot selects a type",
+          "[AUTO TYPE SELECTION]") {
+  PivotEventDispatcher dispatcher;
+  dispatcher.useEventTape(true);
+
+  std::string selected;
+  auto captureSelection = [&](auto &composite) -> moped::Expected {
+    using CompositeT = std::decay_t<decltype(composite)>;
+    if constexpr (std::is_same_v<CompositeT, TradeEvent>) {
+      selected = std::format("trade:{}:{}", composite.symbol,
+                             composite.quantity);
+    } else {
+      selected = std::format("quote:{}:{}", composite.symbol,
+                             composite.bid.getRawIntegerValue());
+    }
+    return {};
+  };
+
+  // Pivot after other members, recorded events are replayed on selection
+  REQUIRE(dispatcher
+              .parseAndDispatchJSONView(
+                  R"({"s":"BTCUSD","p":"100.25","e":"trade","q":3})",
+                  captureSelection)
+              .has_value());
+  ASSERT_EQ(selected, "trade:BTCUSD:3");
+
+  dispatcher.reset();
+  std::stringstream quoteStream{
+      R"({"s":"ETHUSD","e":"quote","b":"2","a":"2.5"})"};
+  REQUIRE(dispatcher.parseAndDispatchJSONSteam(quoteStream, captureSelection)
+              .has_value());
+  ASSERT_EQ(selected, "quote:ETHUSD:200000000");
+
+  // Without a pivot member the recorded document is parsed speculatively
+  dispatcher.reset();
+  REQUIRE(dispatcher
+              .parseAndDispatchJSONView(R"({"s":"XRPUSD","b":"1","a":"1.5"})",
+                                        captureSelection)
+              .has_value());
+  ASSERT_EQ(selected, "quote:XRPUSD:100000000");
+}
+
+TEST_CASE("Parse event tape replays recorded events in order",
+          "[AUTO TYPE SELECTION]") {
+  moped::ParseEventTape tape;
+  std::string memberName = "s";
+  REQUIRE(tape.onObjectStart());
+  REQUIRE(tape.onMember(memberName));
+  REQUIRE(tape.onStringValue("BTCUSD"));
+  memberName = "q"; // copied text must not alias the caller's buffer
+  REQUIRE(tape.onMember(memberName));
+  REQUIRE(tape.onNumericValue("5"));
+  REQUIRE(tape.onObjectFinish());
+  ASSERT_EQ(tape.eventCount(), 6);
+
+  moped::CompositeParserEventDispatcher<TradeEvent, SelectionTraits> dispatcher;
+  REQUIRE(tape.replay(dispatcher).has_value());
+  ASSERT_EQ(dispatcher.getComposite().symbol, "BTCUSD");
+  ASSERT_EQ(dispatcher.getComposite().quantity, 5);
+
+  tape.clear();
+  REQUIRE(tape.empty());
+}
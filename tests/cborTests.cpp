@@ -0,0 +1,221 @@
+#include <catch2/catch.hpp>
+
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/mopedCBOR.hpp"
+#include "moped/mopedJSON.hpp"
+#include "moped/tests/mopedTestTypes.hpp"
+
+#include <initializer_list>
+#include <sstream>
+
+// Shared with jsonViewParseTest.cpp
+extern std::string_view instrumentData_view;
+
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+
+using namespace moped::tests::stream;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct Fill {
+  std::string venue;
+  moped::TimePoint time;
+  moped::ScaledInteger<std::int64_t, 4> price;
+  double rate;
+  std::vector<int> sizes;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Fill>(
+        "venue", &Fill::venue, "time", &Fill::time, "price", &Fill::price,
+        "rate", &Fill::rate, "sizes", &Fill::sizes);
+  }
+};
+
+// Scaled integers whose values exceed 64 bit signed range
+struct WideAmounts {
+  moped::ScaledInteger<std::uint64_t, 0> volume;
+  moped::ScaledInteger<int128_t, 4> notional;
+  moped::ScaledInteger<int128_t, 4> small;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, WideAmounts>(
+        "volume", &WideAmounts::volume, "notional", &WideAmounts::notional,
+        "small", &WideAmounts::small);
+  }
+};
+
+void append(std::string &document, std::initializer_list<int> bytes) {
+  for (auto byte : bytes) {
+    document.push_back(static_cast<char>(byte));
+  }
+}
+
+// Indefinite length map, text string and array holding tagged values
+std::string chunkedFillDocument() {
+  std::string document;
+  append(document, {0xbf, 0x65});
+  document += "venue";
+  append(document, {0x7f, 0x62});
+  document += "NY";
+  append(document, {0x63});
+  document += "SE1";
+  append(document, {0xff, 0x64});
+  document += "time";
+  append(document, {0xc1, 0x1a, 0x65, 0x53, 0xf1, 0x00}); // 1700000000
+  append(document, {0x65});
+  document += "price";
+  append(document, {0xc4, 0x82, 0x21, 0x19, 0x30, 0x39}); // 12345e-2
+  append(document, {0x64});
+  document += "rate";
+  append(document, {0xc4, 0x82, 0x20, 0x18, 0x19}); // 25e-1
+  append(document, {0x65});
+  document += "sizes";
+  append(document, {0x9f, 0x01, 0x02, 0x18, 0x64, 0xff, 0xff});
+  return document;
+}
+
+} // namespace
+
+TEST_CASE("CBOR round trip preserves every mapped member", "[CBOR]") {
+  auto original = moped::parseCompositeFromJSONView<ExchangeInfo>(
+      DFTF{}, instrumentData_view);
+  REQUIRE(original.has_value());
+
+  auto encoded = moped::encodeToCBORString(original.value(), DFTF{});
+  REQUIRE(encoded.size() < instrumentData_view.size());
+
+  auto decoded = moped::parseCompositeFromCBOR<ExchangeInfo>(DFTF{}, encoded);
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->serverTime, original->serverTime);
+  ASSERT_EQ(moped::encodeToJSONString(decoded.value(), DFTF{}),
+            moped::encodeToJSONString(original.value(), DFTF{}));
+}
+
+TEST_CASE("CBOR indefinite lengths and tagged values decode directly",
+          "[CBOR]") {
+  auto fill =
+      moped::parseCompositeFromCBOR<Fill>(DFTF{}, chunkedFillDocument());
+  REQUIRE(fill.has_value());
+  ASSERT_EQ(fill->venue, "NYSE1");
+  ASSERT_EQ(fill->time, moped::TimePoint{std::chrono::seconds{1700000000}});
+  ASSERT_EQ(fill->price, (moped::ScaledInteger<std::int64_t, 4>{"123.45"}));
+  ASSERT_EQ(fill->rate, 2.5);
+  ASSERT_EQ(fill->sizes, (std::vector<int>{1, 2, 100}));
+
+  // Decimal fractions keep their exact value through emit and parse
+  Fill emitted;
+  emitted.venue = "LSE";
+  emitted.time = moped::TimePoint{std::chrono::milliseconds{1500}};
+  emitted.price = moped::ScaledInteger<std::int64_t, 4>{"-0.0125"};
+  emitted.rate = 0.25;
+  auto reparsed = moped::parseCompositeFromCBOR<Fill>(
+      DFTF{}, moped::encodeToCBORString(emitted, DFTF{}));
+  REQUIRE(reparsed.has_value());
+  ASSERT_EQ(reparsed->price, emitted.price);
+  ASSERT_EQ(reparsed->time, emitted.time);
+}
+
+TEST_CASE("CBOR documents stream one after another", "[CBOR]") {
+  std::stringstream stream;
+  stream << chunkedFillDocument();
+  Fill second;
+  second.venue = "CME";
+  second.time = moped::TimePoint{std::chrono::seconds{42}};
+  second.price = moped::ScaledInteger<std::int64_t, 4>{"7"};
+  second.rate = 1.0;
+  second.sizes = {5};
+  moped::encodeToCBORStream(second, stream, DFTF{});
+
+  auto first = moped::parseCompositeFromCBORStream<Fill>(DFTF{}, stream);
+  REQUIRE(first.has_value());
+  ASSERT_EQ(first->venue, "NYSE1");
+  auto next = moped::parseCompositeFromCBORStream<Fill>(DFTF{}, stream);
+  REQUIRE(next.has_value());
+  ASSERT_EQ(next->venue, "CME");
+  ASSERT_EQ(next->sizes[0], 5);
+
+  REQUIRE(!moped::parseCompositeFromCBORStream<Fill>(DFTF{}, stream));
+}
+
+TEST_CASE("CBOR malformed input fails without exhausting resources",
+          "[CBOR]") {
+  // A long run of skipped tags ahead of a value
+  std::string tagged;
+  append(tagged, {0xa1, 0x64});
+  tagged += "rate";
+  tagged.append(500'000, static_cast<char>(0xc6));
+  append(tagged, {0x01});
+  auto fill = moped::parseCompositeFromCBOR<Fill>(DFTF{}, tagged);
+  REQUIRE(fill.has_value());
+  ASSERT_EQ(fill->rate, 1.0);
+
+  // Text claiming an enormous length is a parse error, not an allocation
+  std::string oversized;
+  append(oversized, {0xa1, 0x65});
+  oversized += "venue";
+  append(oversized, {0x7b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0});
+  oversized += "NYSE";
+  std::stringstream stream{oversized};
+  REQUIRE(!moped::parseCompositeFromCBORStream<Fill>(DFTF{}, stream));
+
+  // Decimal fractions beyond the scaled integer's range
+  std::string overflowing;
+  append(overflowing, {0xa1, 0x65});
+  overflowing += "price";
+  append(overflowing, {0xc4, 0x82, 0x00, 0x1b, 0x0d, 0xe0, 0xb6, 0xb3, 0xa7,
+                       0x64, 0x00, 0x00}); // 10^18
+  REQUIRE(!moped::parseCompositeFromCBOR<Fill>(DFTF{}, overflowing));
+
+  // Epoch times the clock can't represent
+  auto parseTime = [](std::initializer_list<int> time) {
+    std::string document;
+    append(document, {0xa1, 0x64});
+    document += "time";
+    append(document, time);
+    return moped::parseCompositeFromCBOR<Fill>(DFTF{}, document);
+  };
+  REQUIRE(parseTime({0xc1, 0x3a, 0x65, 0x53, 0xf0, 0xff}).has_value());
+  REQUIRE(!parseTime({0xc1, 0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                      0xff}));
+  REQUIRE(!parseTime({0xc1, 0x3b, 0x00, 0x00, 0x00, 0x02, 0x54, 0x0b, 0xe4,
+                      0x00})); // -(10^10) - 1
+  REQUIRE(!parseTime({0xc1, 0xfb, 0x7f, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00,
+                      0x00})); // NaN
+  REQUIRE(!parseTime({0xc1, 0xf9, 0x7c, 0x00})); // Infinity
+  REQUIRE(!parseTime({0xc1, 0xfb, 0x43, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00,
+                      0x00})); // 2^63
+
+  // Mantissas past int64 are written as text rather than truncated
+  WideAmounts amounts{{"18000000000000000000"},
+                      {"-123456789012345678901234567890"},
+                      {"-42"}};
+  auto wide = moped::parseCompositeFromCBOR<WideAmounts>(
+      DFTF{}, moped::encodeToCBORString(amounts, DFTF{}));
+  REQUIRE(wide.has_value());
+  ASSERT_EQ(wide->volume, amounts.volume);
+  ASSERT_EQ(wide->notional, amounts.notional);
+  ASSERT_EQ(wide->small, amounts.small);
+
+  using Traits = moped::StringDecodingTraits<DFTF>;
+  using Narrow = moped::ScaledInteger<std::int32_t, 2>;
+  // Decimal fractions shift into targets wider than 64 bits
+  using Volume = moped::ScaledInteger<std::uint64_t, 2>;
+  auto volume = moped::getValueFor<Volume, Traits>(
+      moped::DecimalFraction{180'000'000'000'000'000, 0});
+  REQUIRE(volume.has_value());
+  ASSERT_EQ(*volume, Volume{"180000000000000000"});
+  REQUIRE(!moped::getValueFor<Narrow, Traits>(
+               moped::DecimalFraction{std::int64_t{1} << 40, 0})
+               .has_value());
+  REQUIRE(!moped::getValueFor<Narrow, Traits>(
+               moped::DecimalFraction{30'000'000, 0})
+               .has_value());
+  auto narrow =
+      moped::getValueFor<Narrow, Traits>(moped::DecimalFraction{-12345, -3});
+  REQUIRE(narrow.has_value());
+  ASSERT_EQ(*narrow, Narrow{"-12.34"});
+}
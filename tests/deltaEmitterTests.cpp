@@ -0,0 +1,209 @@
+#include <catch2/catch.hpp>
+
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/mopedJSON.hpp"
+#include "moped/mopedMsgPack.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+using moped::MergePolicy;
+
+struct Quote {
+  double price;
+  double quantity;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Quote>(
+        "price", &Quote::price, "quantity", &Quote::quantity);
+  }
+};
+
+struct Venue {
+  std::string name;
+  bool enabled;
+  std::optional<Quote> best;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Venue>(
+        "name", &Venue::name, "enabled", &Venue::enabled, "best",
+        &Venue::best);
+  }
+};
+
+struct Snapshot {
+  std::string symbol;
+  std::uint64_t sequence;
+  std::optional<int> limit;
+  Venue primary;
+  std::vector<Quote> bids;
+  std::vector<int> trades;
+  std::vector<std::string> tags;
+  std::map<std::string, double> marks;
+  std::map<std::string, Venue> venues;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Snapshot>(
+        "symbol", &Snapshot::symbol, "sequence", &Snapshot::sequence, "limit",
+        &Snapshot::limit, "primary", &Snapshot::primary,
+        moped::mergeAs<MergePolicy::Upsert>("bids"), &Snapshot::bids,
+        "trades", &Snapshot::trades,
+        moped::mergeAs<MergePolicy::Replace>("tags"), &Snapshot::tags,
+        moped::mergeAs<MergePolicy::Upsert>("marks"), &Snapshot::marks,
+        moped::mergeAs<MergePolicy::Upsert>("venues"), &Snapshot::venues);
+  }
+};
+
+Snapshot baselineSnapshot() {
+  return Snapshot{"BTCUSDT",
+                  1,
+                  10,
+                  Venue{"BINANCE", true, Quote{100, 1}},
+                  {Quote{100, 1}, Quote{99, 2}},
+                  {1, 2},
+                  {"spot"},
+                  {{"spot", 100.5}, {"perp", 101}},
+                  {{"a", Venue{"A", true, std::nullopt}},
+                   {"b", Venue{"B", false, Quote{98, 3}}}}};
+}
+
+std::string jsonDelta(const Snapshot &current, const Snapshot &baseline) {
+  auto delta = moped::encodeDeltaToJSONString(current, baseline, DFTF{});
+  REQUIRE(delta.has_value());
+  return delta.value();
+}
+
+// The delta merged onto the baseline has to reproduce the current snapshot
+void requireRoundTrip(const Snapshot &current, const Snapshot &baseline) {
+  auto delta = jsonDelta(current, baseline);
+  auto merged = baseline;
+  auto result = moped::mergeCompositeFromJSONView(DFTF{}, delta, merged);
+  INFO(delta);
+  REQUIRE(result.has_value());
+  ASSERT_EQ(moped::encodeToJSONString(merged, DFTF{}),
+            moped::encodeToJSONString(current, DFTF{}));
+}
+
+} // namespace
+
+TEST_CASE("Delta encoding writes only changed members", "[Delta]") {
+  auto baseline = baselineSnapshot();
+  ASSERT_EQ(jsonDelta(baseline, baseline), "{}");
+
+  auto current = baseline;
+  current.sequence = 2;
+  current.primary.best->quantity = 4;
+  ASSERT_EQ(jsonDelta(current, baseline),
+            R"({"sequence": 2,"primary": {"best": {"quantity": 4}}})");
+
+  current = baseline;
+  current.limit.reset();
+  current.primary.best.reset();
+  ASSERT_EQ(jsonDelta(current, baseline),
+            R"({"limit": null,"primary": {"best": null}})");
+}
+
+TEST_CASE("Delta encoding follows collection merge policies", "[Delta]") {
+  auto baseline = baselineSnapshot();
+  auto current = baseline;
+  current.bids[1].quantity = 5;
+  current.bids.push_back(Quote{97, 1});
+  current.trades.push_back(3);
+  current.marks.erase("spot");
+  current.marks["perp"] = 102;
+  current.marks["index"] = 100;
+  current.venues["b"].best->price = 97.5;
+  current.venues["c"] = Venue{"C", true, std::nullopt};
+  ASSERT_EQ(jsonDelta(current, baseline),
+            R"({"bids": [{},{"quantity": 5},{"price": 97,"quantity": 1}],)"
+            R"("trades": [3],)"
+            R"("marks": {"index": 100,"perp": 102,"spot": null},)"
+            R"("venues": {"b": {"best": {"price": 97.5}},)"
+            R"("c": {"name": "C","enabled": true}}})");
+  requireRoundTrip(current, baseline);
+
+  // Replaced sequences are sent whole, an emptied one as []
+  current = baseline;
+  current.tags = {"perp", "index"};
+  ASSERT_EQ(jsonDelta(current, baseline),
+            R"({"tags": ["perp","index"]})");
+  requireRoundTrip(current, baseline);
+
+  current.tags.clear();
+  ASSERT_EQ(jsonDelta(current, baseline),
+            R"({"tags": []})");
+  requireRoundTrip(current, baseline);
+
+  current = baseline;
+  current.venues.erase("a");
+  current.venues["b"].enabled = true;
+  current.symbol = "ETHUSDT";
+  requireRoundTrip(current, baseline);
+}
+
+TEST_CASE("Delta encoding to MsgPack merges back in place", "[Delta]") {
+  auto baseline = baselineSnapshot();
+  auto current = baseline;
+  current.sequence = 7;
+  current.limit.reset();
+  current.marks.erase("perp");
+  current.bids[0].price = 100.5;
+
+  std::string delta;
+  REQUIRE(moped::encodeDeltaToMsgPack(current, baseline, delta, DFTF{})
+              .has_value());
+  std::string full = moped::encodeToMsgPackString(current, DFTF{});
+  REQUIRE(delta.size() < full.size() / 2);
+
+  auto merged = baseline;
+  REQUIRE(
+      moped::mergeCompositeFromMsgPack(DFTF{}, delta, merged).has_value());
+  ASSERT_EQ(moped::encodeToJSONString(merged, DFTF{}),
+            moped::encodeToJSONString(current, DFTF{}));
+}
+
+TEST_CASE("Delta encoding fails for changes the merge policy can't reproduce",
+          "[Delta]") {
+  auto baseline = baselineSnapshot();
+  baseline.trades = {1, 2, 3};
+
+  // Appended sequences only ever grow on merge
+  auto current = baseline;
+  current.trades = {5};
+  REQUIRE(!moped::encodeDeltaToJSONString(current, baseline, DFTF{})
+               .has_value());
+  current.trades = {1, 5, 3, 4};
+  REQUIRE(!moped::encodeDeltaToJSONString(current, baseline, DFTF{})
+               .has_value());
+  current.trades = {1, 2, 3, 4};
+  requireRoundTrip(current, baseline);
+
+  // Upserted sequences keep elements past the end of the update
+  current = baseline;
+  current.bids.pop_back();
+  REQUIRE(!moped::encodeDeltaToJSONString(current, baseline, DFTF{})
+               .has_value());
+
+  std::string delta = "unchanged";
+  REQUIRE(!moped::encodeDeltaToMsgPack(current, baseline, delta, DFTF{})
+               .has_value());
+  ASSERT_EQ(delta, "unchanged");
+
+  // Replaced sequences shrink like any other change
+  current = baseline;
+  current.tags.clear();
+  current.bids[0].quantity = 3;
+  current.bids.push_back(Quote{98, 1});
+  requireRoundTrip(current, baseline);
+}
@@ -0,0 +1,443 @@
+#include <catch2/catch.hpp>
+
+#include "moped/CollectionFunctionDispatcher.hpp"
+#include "moped/mopedFIX.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <optional>
+#include <string>
+#include <vector>
+
+using Price = moped::ScaledInteger<std::int64_t, 4>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct FixHeader {
+  std::string senderCompId;
+  std::string targetCompId;
+  std::uint64_t msgSeqNum;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixHeader>(
+        "49", &FixHeader::senderCompId, "56", &FixHeader::targetCompId, "34",
+        &FixHeader::msgSeqNum);
+  }
+};
+
+struct FixPartySubId {
+  std::string id;
+  int type;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixPartySubId>(
+        "523", &FixPartySubId::id, "803", &FixPartySubId::type);
+  }
+};
+
+inline constexpr char fixBid[] = "0";
+inline constexpr char fixOffer[] = "1";
+inline constexpr char fixTrade[] = "2";
+
+enum class MDEntryType : char { Bid = '0', Offer = '1', Trade = '2' };
+
+using FixMDEntryType =
+    moped::MappedEnum<fixBid, MDEntryType::Bid, fixOffer, MDEntryType::Offer,
+                      fixTrade, MDEntryType::Trade>;
+
+struct FixMDEntry {
+  FixMDEntryType type;
+  Price price;
+  std::int64_t size;
+  std::vector<FixPartySubId> subIds;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixMDEntry>(
+        "269", &FixMDEntry::type, "270", &FixMDEntry::price, "271",
+        &FixMDEntry::size, "802", &FixMDEntry::subIds);
+  }
+};
+
+// Header fields arrive ahead of the body, so the header is a base whose
+// mapping is joined onto the message's rather than an embedded member
+struct FixSnapshot : FixHeader {
+  std::string msgType;
+  std::string symbol;
+  std::vector<FixMDEntry> entries;
+  int checkSum;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixSnapshot>(
+               "35", &FixSnapshot::msgType, "55", &FixSnapshot::symbol, "268",
+               &FixSnapshot::entries, "10", &FixSnapshot::checkSum) +
+           FixHeader::getMOPEDHandler<DecodingTraits>();
+  }
+};
+
+struct FixLeg {
+  std::string symbol;
+  int ratio;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixLeg>(
+        "600", &FixLeg::symbol, "623", &FixLeg::ratio);
+  }
+};
+
+struct FixMultiLegOrder {
+  std::string clOrdId;
+  moped::CollectionFunctionDispatcher<FixLeg> legs;
+  std::string text;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixMultiLegOrder>(
+        "11", &FixMultiLegOrder::clOrdId, "555", &FixMultiLegOrder::legs, "58",
+        &FixMultiLegOrder::text);
+  }
+};
+
+// Frames a '|' delimited body with BeginString, BodyLength and CheckSum
+std::string makeFIXMessage(std::string body) {
+  std::replace(body.begin(), body.end(), '|', moped::fix::SOH);
+  auto message = std::format("8=FIX.4.4\x01" "9={}\x01{}", body.size(), body);
+  unsigned sum = 0;
+  for (unsigned char c : message) {
+    sum += c;
+  }
+  return message + std::format("10={:03}\x01", sum % 256);
+}
+
+} // namespace
+
+TEST_CASE("FIX snapshot with nested repeating groups") {
+  auto message = makeFIXMessage(
+      "35=W|49=VENUE|56=CLIENT|34=42|52=20250528-12:34:56.789|55=BTCUSD|"
+      "268=3|269=0|270=60000.5|271=12|802=2|523=A|803=1|523=B|803=2|"
+      "269=1|270=60001|271=3|269=2|270=60000.75|271=1|802=1|523=C|803=3|");
+  auto snapshot =
+      moped::parseCompositeFromFIX<FixSnapshot>(moped::DurationSinceEpochFormatter<>{},
+                                                message);
+  REQUIRE(snapshot.has_value());
+  ASSERT_EQ(snapshot->senderCompId, "VENUE");
+  ASSERT_EQ(snapshot->targetCompId, "CLIENT");
+  ASSERT_EQ(snapshot->msgSeqNum, 42u);
+  ASSERT_EQ(snapshot->msgType, "W");
+  ASSERT_EQ(snapshot->symbol, "BTCUSD");
+  REQUIRE(snapshot->entries.size() == 3);
+  ASSERT_EQ(snapshot->entries[0].type, FixMDEntryType{MDEntryType::Bid});
+  ASSERT_EQ(snapshot->entries[0].price, Price{"60000.5"});
+  ASSERT_EQ(snapshot->entries[0].size, 12);
+  REQUIRE(snapshot->entries[0].subIds.size() == 2);
+  ASSERT_EQ(snapshot->entries[0].subIds[1].id, "B");
+  ASSERT_EQ(snapshot->entries[0].subIds[1].type, 2);
+  ASSERT_EQ(snapshot->entries[1].type, FixMDEntryType{MDEntryType::Offer});
+  ASSERT_EQ(snapshot->entries[1].subIds.size(), 0u);
+  ASSERT_EQ(snapshot->entries[2].price, Price{"60000.75"});
+  REQUIRE(snapshot->entries[2].subIds.size() == 1);
+  ASSERT_EQ(snapshot->entries[2].subIds[0].id, "C");
+  ASSERT_EQ(std::format("{:03}", snapshot->checkSum),
+            std::string_view{message}.substr(message.size() - 4, 3));
+}
+
+TEST_CASE("FIX repeating group dispatched per entry") {
+  std::vector<std::string> legSymbols;
+  auto order = moped::parseCompositeFromFIX<FixMultiLegOrder>(
+      moped::DurationSinceEpochFormatter<>{},
+      makeFIXMessage("35=AB|11=ORD1|555=2|600=ESM5|623=1|600=ESU5|623=-1|"
+                     "58=calendar|"),
+      "", moped::CollectionFunctionDispatcher<FixLeg>{[&](const FixLeg &leg) {
+        legSymbols.push_back(leg.symbol);
+        return moped::Expected{};
+      }},
+      "");
+  REQUIRE(order.has_value());
+  ASSERT_EQ(order->clOrdId, "ORD1");
+  ASSERT_EQ(order->text, "calendar");
+  ASSERT_EQ(legSymbols, (std::vector<std::string>{"ESM5", "ESU5"}));
+}
+
+TEST_CASE("FIX messages parsed back to back") {
+  auto first = makeFIXMessage("35=W|55=A|268=0|");
+  auto stream = first + makeFIXMessage("35=W|55=B|268=1|269=0|270=1|271=1|");
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<FixSnapshot,
+                                            moped::FIXDecodingTraits<>>;
+  auto dictionary = moped::makeFIXDictionary<FixSnapshot>(
+      moped::DurationSinceEpochFormatter<>{});
+  REQUIRE(dictionary.has_value());
+  DispatcherT dispatcher;
+  moped::FIXParser<DispatcherT> parser{dispatcher, *dictionary};
+  auto length = parser.parse(stream);
+  REQUIRE(length.has_value());
+  ASSERT_EQ(*length, first.size());
+  ASSERT_EQ(dispatcher.getComposite().symbol, "A");
+  ASSERT_EQ(dispatcher.getComposite().entries.size(), 0u);
+  dispatcher.reset();
+  REQUIRE(parser.parse(std::string_view{stream}.substr(*length)).has_value());
+  ASSERT_EQ(dispatcher.getComposite().symbol, "B");
+  ASSERT_EQ(dispatcher.getComposite().entries.size(), 1u);
+}
+
+TEST_CASE("FIX message validation errors") {
+  auto parse = [](std::string message) {
+    return moped::parseCompositeFromFIX<FixSnapshot>(
+        moped::DurationSinceEpochFormatter<>{}, message);
+  };
+  auto valid = makeFIXMessage("35=W|55=ETHUSD|268=1|269=0|270=1|271=1|");
+  REQUIRE(parse(valid).has_value());
+
+  auto badCheckSum = valid;
+  badCheckSum[badCheckSum.size() - 2] =
+      badCheckSum[badCheckSum.size() - 2] == '0' ? '1' : '0';
+  REQUIRE(!parse(badCheckSum).has_value());
+
+  auto badBodyLength = valid;
+  badBodyLength.replace(badBodyLength.find("9=") + 2, 2, "30");
+  REQUIRE(!parse(badBodyLength).has_value());
+
+  REQUIRE(!parse(makeFIXMessage("35=W|268=2|269=0|270=1|271=1|55=X|"))
+               .has_value());
+  REQUIRE(!parse(makeFIXMessage("35=W|268=1|270=1|269=0|")).has_value());
+  REQUIRE(!parse(makeFIXMessage("35=W|268=two|269=0|")).has_value());
+  REQUIRE(!parse(makeFIXMessage("35=W|5x5=X|")).has_value());
+  REQUIRE(!parse(makeFIXMessage("35=W|55|")).has_value());
+  // Counts the rest of the body can't hold are rejected before any storage
+  // is reserved for them
+  auto hugeCount = parse(makeFIXMessage("35=W|268=99999999999|269=0|"));
+  REQUIRE(!hugeCount.has_value());
+  REQUIRE(std::string_view{hugeCount.error().message}.starts_with(
+      "FIX repeating group count exceeds"));
+  REQUIRE(!parse(makeFIXMessage("35=W|268=18446744073709551615|269=0|"))
+               .has_value());
+  REQUIRE(!parse("9=5\x01" "35=W\x01" "10=000\x01").has_value());
+}
+
+namespace {
+
+struct FixUserDefined {
+  std::string text;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixUserDefined>(
+        "9001", &FixUserDefined::text);
+  }
+};
+
+struct FixRate {
+  double rate;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixRate>("1", &FixRate::rate);
+  }
+};
+
+// Tag 5000000 is beyond the member index table and resolves linearly
+struct FixWideTags {
+  std::string account;
+  std::string venueTag;
+  FixUserDefined userDefined;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixWideTags>(
+        "1", &FixWideTags::account, "5000000", &FixWideTags::venueTag, "",
+        &FixWideTags::userDefined);
+  }
+};
+
+} // namespace
+
+TEST_CASE("FIX tag member ids resolve through the member index table") {
+  moped::CompositeParserEventDispatcher<FixWideTags,
+                                        moped::FIXDecodingTraits<>>
+      dispatcher;
+  REQUIRE(dispatcher.onObjectStart().has_value());
+  REQUIRE(dispatcher.onMember(5000000u).has_value());
+  REQUIRE(dispatcher.onStringValue("XNAS").has_value());
+  REQUIRE(dispatcher.onMember(1u).has_value());
+  REQUIRE(dispatcher.onStringValue("ACC-7").has_value());
+  REQUIRE(dispatcher.onMember(9001u).has_value());
+  REQUIRE(dispatcher.onStringValue("note").has_value());
+  REQUIRE(dispatcher.onObjectFinish().has_value());
+
+  ASSERT_EQ(dispatcher.getComposite().account, "ACC-7");
+  ASSERT_EQ(dispatcher.getComposite().venueTag, "XNAS");
+  ASSERT_EQ(dispatcher.getComposite().userDefined.text, "note");
+
+  dispatcher.reset();
+  REQUIRE(dispatcher.onObjectStart().has_value());
+  auto unknown = dispatcher.onMember(77u);
+  REQUIRE(!unknown.has_value());
+  REQUIRE(std::format("{}", unknown.error()).find("77") != std::string::npos);
+}
+
+namespace {
+
+struct FixParty {
+  std::string id;
+  int role;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixParty>(
+        "448", &FixParty::id, "452", &FixParty::role);
+  }
+};
+
+struct FixNewOrder {
+  std::string clOrdId;
+  std::string symbol;
+  char side;
+  std::int64_t quantity;
+  Price price;
+  moped::TimePoint transactTime;
+  std::vector<FixParty> parties;
+  std::optional<std::string> text;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixNewOrder>(
+        "11", &FixNewOrder::clOrdId, "55", &FixNewOrder::symbol, "54",
+        &FixNewOrder::side, "38", &FixNewOrder::quantity, "44",
+        &FixNewOrder::price, "60", &FixNewOrder::transactTime, "453",
+        &FixNewOrder::parties, "58", &FixNewOrder::text);
+  }
+};
+
+// Named by field rather than tag, which FIX traits can't map
+struct FixNamedMembers {
+  std::string symbol;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixNamedMembers>(
+        "Symbol", &FixNamedMembers::symbol);
+  }
+};
+
+struct FixNamedGroup {
+  std::vector<FixParty> parties;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, FixNamedGroup>(
+        "NoPartyIDs", &FixNamedGroup::parties);
+  }
+};
+
+std::string fromPipes(std::string message) {
+  std::replace(message.begin(), message.end(), '|', moped::fix::SOH);
+  return message;
+}
+
+} // namespace
+
+TEST_CASE("FIX emitter renders header template, body and trailer") {
+  moped::fix::MessageTemplate<> messageTemplate{"FIX.4.4"};
+  REQUIRE(messageTemplate.setField(35, std::string_view{"D"}));
+  REQUIRE(messageTemplate.setField(49, std::string_view{"CLIENT"}));
+  REQUIRE(messageTemplate.setField(56, std::string_view{"VENUE"}));
+  REQUIRE(messageTemplate.setField(34, 1));
+  moped::FIXEmitterContext<> context{messageTemplate};
+
+  FixNewOrder order{"ORD-1",
+                    "BTCUSD",
+                    '1',
+                    25,
+                    Price{"60000.25"},
+                    moped::TimePoint{std::chrono::milliseconds{1748435696789}},
+                    {{"DESK1", 3}, {"TRADER7", 11}},
+                    std::nullopt};
+  auto message = moped::encodeToFIX(order, context);
+  REQUIRE(message.has_value());
+  ASSERT_EQ(std::string{*message},
+            makeFIXMessage("35=D|49=CLIENT|56=VENUE|34=1|11=ORD-1|55=BTCUSD|"
+                           "54=1|38=25|44=60000.25|60=20250528-12:34:56.789|"
+                           "453=2|448=DESK1|452=3|448=TRADER7|452=11|"));
+
+  // Only the changed session field is rendered again
+  REQUIRE(messageTemplate.setField(34, 2));
+  order.parties.clear();
+  order.text = "reduce only";
+  order.price = Price{"-0.0001"};
+  message = moped::encodeToFIX(order, context);
+  REQUIRE(message.has_value());
+  ASSERT_EQ(std::string{*message},
+            makeFIXMessage("35=D|49=CLIENT|56=VENUE|34=2|11=ORD-1|55=BTCUSD|"
+                           "54=1|38=25|44=-0.0001|60=20250528-12:34:56.789|"
+                           "58=reduce only|"));
+}
+
+TEST_CASE("FIX emitter output parses back") {
+  moped::fix::MessageTemplate<> messageTemplate{"FIXT.1.1"};
+  REQUIRE(messageTemplate.setField(35, std::string_view{"D"}));
+  moped::FIXEmitterContext<> context{messageTemplate};
+
+  std::vector<FixParty> parties;
+  for (int index = 0; index < 12; ++index) {
+    parties.push_back({std::format("P{}", index), index});
+  }
+  FixNewOrder order{"ORD-2", "ETHUSD", '2', 7, Price{"3000"},
+                    moped::TimePoint{std::chrono::milliseconds{1748435696000}},
+                    parties, "hello"};
+  auto message = moped::encodeToFIX(order, context);
+  REQUIRE(message.has_value());
+  auto decoded = moped::parseCompositeFromFIX<FixNewOrder>(
+      moped::UTCTimestampFormatter<>{}, *message);
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->clOrdId, "ORD-2");
+  ASSERT_EQ(decoded->side, '2');
+  ASSERT_EQ(decoded->price, Price{"3000"});
+  ASSERT_EQ(decoded->transactTime, order.transactTime);
+  REQUIRE(decoded->parties.size() == 12);
+  ASSERT_EQ(decoded->parties[11].id, "P11");
+  ASSERT_EQ(decoded->parties[11].role, 11);
+  ASSERT_EQ(decoded->text, std::optional<std::string>{"hello"});
+}
+
+TEST_CASE("FIX emitter errors") {
+  moped::fix::MessageTemplate<> messageTemplate{"FIX.4.4"};
+  REQUIRE(!messageTemplate.setField(58, std::string_view{"a\x01" "b"}));
+  moped::FIXEmitterContext<> context{messageTemplate};
+  FixNewOrder order{};
+  order.symbol = fromPipes("BAD|SYMBOL");
+  REQUIRE(!moped::encodeToFIX(order, context).has_value());
+  order.symbol = "GOOD";
+  REQUIRE(moped::encodeToFIX(order, context).has_value());
+
+  FixNamedMembers named{"BTCUSD"};
+  REQUIRE(!moped::encodeToFIX(named, context).has_value());
+  FixNamedGroup namedGroup{{{"DESK1", 3}}};
+  REQUIRE(!moped::encodeToFIX(namedGroup, context).has_value());
+  REQUIRE(moped::encodeToFIX(order, context).has_value());
+
+  // Tags past the prefix cache are rendered per field
+  FixWideTags wide{"ACC-7", "XNAS", {"note"}};
+  auto message = moped::encodeToFIX(wide, context);
+  REQUIRE(message.has_value());
+  ASSERT_EQ(std::string{*message},
+            makeFIXMessage("1=ACC-7|5000000=XNAS|9001=note|"));
+
+  // Floats are written without exponents, non finite ones are rejected
+  auto small = moped::encodeToFIX(FixRate{1e-07}, context);
+  REQUIRE(small.has_value());
+  ASSERT_EQ(std::string{*small}, makeFIXMessage("1=0.0000001|"));
+  auto large = moped::encodeToFIX(FixRate{1e21}, context);
+  REQUIRE(large.has_value());
+  ASSERT_EQ(std::string{*large}, makeFIXMessage("1=1000000000000000000000|"));
+  REQUIRE(!moped::encodeToFIX(FixRate{std::nan("")}, context).has_value());
+  REQUIRE(!moped::encodeToFIX(FixRate{-HUGE_VAL}, context).has_value());
+  REQUIRE(!messageTemplate.setField(44, std::nan("")));
+}
@@ -0,0 +1,193 @@
+#include <catch2/catch.hpp>
+
+#include "moped/mopedInfo.hpp"
+#include "moped/tests/mdConfigSampleDefns.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+std::string_view infoTestMDConfig = R"(; Market data service
+MarketDataService
+{
+  sessions
+  {
+    binanceSessionMDAws
+    {
+      enabled true
+      venue BINANCE
+      runContext "binanceSpot"
+      serviceContext aeronPubSub   ; transport
+      maxRequestPerSecond 4
+      maxSymbolsPerConnection 50
+      subscriptions {
+        BTCUSDT {
+          id 1
+          subscribeFlags {
+            "" TopOfBook
+            "" Trade
+          }
+          bookUpdateSettings { levels 20
+            arbTrades true
+            removeRestingOrders false }
+        }
+      }
+      subscriptionEndpoint
+      {
+        name binanceSpotMD
+        host "stream.binance.com"
+        port 9443
+        uri /ws
+      }
+    }
+  }
+}
+)";
+
+struct InfoSettings {
+  std::string name;
+  std::string note;
+  std::optional<int> limit;
+  double ratio;
+  std::vector<int> levels;
+  std::map<std::string, std::string> tags;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, InfoSettings>(
+        "name", &InfoSettings::name, "note", &InfoSettings::note, "limit",
+        &InfoSettings::limit, "ratio", &InfoSettings::ratio, "levels",
+        &InfoSettings::levels, "tags", &InfoSettings::tags);
+  }
+};
+
+auto parseSettings(std::string_view info) {
+  return moped::parseCompositeFromInfoView<InfoSettings>(DFTF{}, info);
+}
+
+std::string errorText(const moped::ParseError &error) {
+  return to_string(error);
+}
+
+} // namespace
+
+TEST_CASE("INFO config decodes straight into a composite", "[INFO]") {
+  auto result = moped::parseCompositeFromInfoView<moped::tests::MDConfig>(
+      DFTF{}, infoTestMDConfig);
+  REQUIRE(result.has_value());
+  auto &session =
+      result->marketDataService.sessions.at("binanceSessionMDAws");
+  REQUIRE(session.enabled);
+  ASSERT_EQ(session.venue, "BINANCE");
+  ASSERT_EQ(session.runContext, "binanceSpot");
+  ASSERT_EQ(session.serviceContext, "aeronPubSub");
+  ASSERT_EQ(session.maxRequestPerSecond, 4);
+  auto &subscription = session.subscriptions.at("BTCUSDT");
+  ASSERT_EQ(subscription.id, 1);
+  REQUIRE(subscription.subscribeFlags.has_value(
+      moped::tests::SubscriptionFlags::Trade));
+  REQUIRE(!subscription.subscribeFlags.has_value(
+      moped::tests::SubscriptionFlags::DepthOfBook));
+  ASSERT_EQ(subscription.bookUpdateSettings.levels, 20);
+  REQUIRE(!subscription.bookUpdateSettings.removeRestingOrders);
+  ASSERT_EQ(session.subscriptionEndpoint.host, "stream.binance.com");
+  ASSERT_EQ(session.subscriptionEndpoint.port, 9443);
+  ASSERT_EQ(session.subscriptionEndpoint.uri, "/ws");
+}
+
+TEST_CASE("INFO strings, continuations, null data and arrays", "[INFO]") {
+  auto result = parseSettings(R"(
+name "tab\there \"quoted\""
+note "first " \
+     "second"
+limit
+ratio -1.5e3
+levels { "" 1 "" 2 "" 3 }
+tags
+{
+  "key with space" value
+  empty ""
+}
+)");
+  REQUIRE(result.has_value());
+  ASSERT_EQ(result->name, "tab\there \"quoted\"");
+  ASSERT_EQ(result->note, "first second");
+  REQUIRE(!result->limit.has_value());
+  ASSERT_EQ(result->ratio, -1500.0);
+  ASSERT_EQ(result->levels, (std::vector<int>{1, 2, 3}));
+  ASSERT_EQ(result->tags.at("key with space"), "value");
+  ASSERT_EQ(result->tags.at("empty"), "");
+}
+
+TEST_CASE("INFO errors name their line", "[INFO]") {
+  auto unknown = parseSettings("name a\n\nunknown 1\n");
+  REQUIRE(!unknown.has_value());
+  REQUIRE(errorText(unknown.error()).find("line 3") != std::string::npos);
+
+  auto badValue = parseSettings("name a\nlevels\n{\n  \"\" 1\n  \"\" x\n}\n");
+  REQUIRE(!badValue.has_value());
+  REQUIRE(errorText(badValue.error()).find("line 5") != std::string::npos);
+
+  auto mixed = parseSettings("levels\n{\n  \"\" 1\n  two 2\n}\n");
+  REQUIRE(!mixed.has_value());
+  ASSERT_EQ(std::string_view{mixed.error().message},
+            "INFO block mixes keyed and unkeyed entries");
+
+  REQUIRE(!parseSettings("name \"open\n").has_value());
+  REQUIRE(!parseSettings("tags {\n").has_value());
+  REQUIRE(!parseSettings("}\n").has_value());
+  REQUIRE(!parseSettings("{\n}\n").has_value());
+  REQUIRE(!parseSettings("name \"bad \\q escape\"\n").has_value());
+}
+
+TEST_CASE("INFO #include directives parse files in place", "[INFO]") {
+  auto directory =
+      std::filesystem::temp_directory_path() / "moped_info_include_test";
+  std::filesystem::create_directories(directory);
+  std::ofstream{directory / "main.info"} << "name main\n"
+                                            "#include \"levels.info\"\n"
+                                            "tags\n"
+                                            "{\n"
+                                            "  #include tags.info\n"
+                                            "}\n";
+  std::ofstream{directory / "levels.info"} << "levels { \"\" 7 }\n";
+  std::ofstream{directory / "tags.info"} << "a 1\nb 2\n";
+  std::ofstream{directory / "broken.info"} << "name x\n#include bad.info\n";
+  std::ofstream{directory / "bad.info"} << "\n\nlimit nope\n";
+  std::ofstream{directory / "loop.info"} << "#include loop.info\n";
+
+  auto result = moped::parseCompositeFromInfoFile<InfoSettings>(
+      DFTF{}, directory / "main.info");
+  REQUIRE(result.has_value());
+  ASSERT_EQ(result->name, "main");
+  ASSERT_EQ(result->levels, std::vector<int>{7});
+  ASSERT_EQ(result->tags.size(), 2);
+  ASSERT_EQ(result->tags.at("b"), "2");
+
+  // Errors name the included file and its line
+  auto broken = moped::parseCompositeFromInfoFile<InfoSettings>(
+      DFTF{}, directory / "broken.info");
+  REQUIRE(!broken.has_value());
+  auto text = errorText(broken.error());
+  REQUIRE(text.find("bad.info line 3") != std::string::npos);
+
+  auto loop = moped::parseCompositeFromInfoFile<InfoSettings>(
+      DFTF{}, directory / "loop.info");
+  REQUIRE(!loop.has_value());
+  ASSERT_EQ(std::string_view{loop.error().message},
+            "INFO includes nested too deeply");
+
+  REQUIRE(!moped::parseCompositeFromInfoFile<InfoSettings>(
+               DFTF{}, directory / "missing.info")
+               .has_value());
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/MappedEnum.hpp"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+inline constexpr char Buy[] = "BUY";
+inline constexpr char Sell[] = "SELL";
+inline constexpr char Quoted[] = "say \"hi\"\n";
+
+enum class SideT : std::uint8_t { Buy, Sell, Quoted };
+
+using Side = moped::MappedEnum<Buy, SideT::Buy, Sell, SideT::Sell, Quoted,
+                               SideT::Quoted>;
+
+static_assert(std::string_view{moped::QuotedJSONText<Buy>.data(),
+                               moped::QuotedJSONText<Buy>.size()} ==
+              "\"BUY\"");
+static_assert(std::string_view{moped::QuotedJSONText<Quoted>.data(),
+                               moped::QuotedJSONText<Quoted>.size()} ==
+              R"("say \"hi\"\n")");
+
+struct Order {
+  std::string symbol;
+  Side side;
+  std::vector<Side> history;
+  std::map<std::string, int> limits;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Order>(
+        "symbol", &Order::symbol, "odd \"side\"", &Order::side, "history",
+        &Order::history, "limits", &Order::limits);
+  }
+};
+
+} // namespace
+
+TEST_CASE("JSON emitter writes pre-rendered member names and enums [JSON]") {
+  Order order{"BTC\tUSDT\x01", SideT::Sell, {SideT::Buy, SideT::Quoted},
+              {{"a\\b", 1}}};
+  std::string expected =
+      R"({"symbol": "BTC\tUSDT\u0001","odd \"side\"": "SELL",)"
+      R"("history": ["BUY","say \"hi\"\n"],"limits": {"a\\b": 1}})";
+  // Rendered fragments are reused by later encodes
+  ASSERT_EQ(moped::encodeToJSONString(order, DFTF{}), expected);
+  ASSERT_EQ(moped::encodeToJSONString(order, DFTF{}), expected);
+}
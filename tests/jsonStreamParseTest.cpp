@@ -122,4 +122,107 @@ TEST_CASE("Instrument Data load Test with streaming parser and  "
   ASSERT_EQ(sym.allowedSelfTradePreventionModes.size(), 3);
 
   ASSERT_EQ(capturedSymbols.size(), 3);
-}
\ No newline at end of file
+}
+TEST_CASE("Instrument Data load Test with streaming parser and "
+          "recycling dispatch handlers for symbols",
+          "[JSON STREAMING PARSER_DISPATCH]") {
+
+  std::vector<Symbol> capturedSymbols;
+  std::vector<const Filter *> filterStorage;
+  auto result =
+      moped::parseCompositeFromJSONStream<ExchangeInfoWithRecycledSymbols>(
+          DFTF{}, instrumentData, SymbolSink{&capturedSymbols, &filterStorage});
+  if (!result) {
+    FAIL(result.error());
+  }
+
+  ASSERT_EQ(capturedSymbols.size(), 3);
+  ASSERT_EQ(capturedSymbols[0].symbol, "BTCUSD4");
+  ASSERT_EQ(capturedSymbols[1].symbol, "ETHUSD4");
+  ASSERT_EQ(capturedSymbols[2].symbol, "XRPUSD4");
+  ASSERT_EQ(capturedSymbols[0].filters.size(), 9);
+  ASSERT_EQ(capturedSymbols[1].filters.size(), 9);
+  ASSERT_EQ(capturedSymbols[2].filters.size(), 10);
+  ASSERT_EQ(capturedSymbols[1].orderTypes.size(), 5);
+  ASSERT_EQ(capturedSymbols[1].quoteCommissionPrecision, 4);
+
+  // The recycled capture keeps its filter storage between symbols
+  ASSERT_EQ(filterStorage[0], filterStorage[1]);
+}
+
+TEST_CASE("Instrument Data load Test with streaming parser and "
+          "batched span delivery for symbols",
+          "[JSON STREAMING PARSER_DISPATCH]") {
+
+  std::vector<Symbol> capturedSymbols;
+  std::vector<std::size_t> batchSizes;
+  auto result =
+      moped::parseCompositeFromJSONStream<ExchangeInfoWithBatchedSymbols>(
+          DFTF{}, instrumentData,
+          SymbolBatchSink{&capturedSymbols, &batchSizes});
+  if (!result) {
+    FAIL(result.error());
+  }
+
+  ASSERT_EQ(batchSizes, (std::vector<std::size_t>{2, 1}));
+  ASSERT_EQ(capturedSymbols.size(), 3);
+  ASSERT_EQ(capturedSymbols[0].symbol, "BTCUSD4");
+  ASSERT_EQ(capturedSymbols[1].symbol, "ETHUSD4");
+  ASSERT_EQ(capturedSymbols[2].symbol, "XRPUSD4");
+  ASSERT_EQ(capturedSymbols[2].filters.size(), 10);
+}
+
+// std::string keys are handed over as views of the reused key buffer
+static_assert(std::is_same_v<decltype(MarketSnapshot::volumes)::KeyViewT,
+                             std::string_view>);
+
+TEST_CASE("Streaming parser dispatching map shaped collections per entry",
+          "[JSON STREAMING PARSER_DISPATCH]") {
+  std::string_view snapshot =
+      R"({"quotes":{"BTCUSD":{"bid":"100.5","ask":"101","depth":4},)"
+      R"("ETHUSD":{"bid":"20.25","ask":"20.5"}},)"
+      R"("volumes":{"BTCUSD":1200,"ETHUSD":300}})";
+
+  std::vector<std::pair<std::string, Quote>> quotes;
+  std::vector<std::pair<std::string, int>> volumes;
+  auto result = moped::parseCompositeFromJSONStream<MarketSnapshot>(
+      DFTF{}, snapshot, QuoteSink{&quotes}, VolumeSink{&volumes});
+  if (!result) {
+    FAIL(result.error());
+  }
+
+  ASSERT_EQ(quotes.size(), 2);
+  ASSERT_EQ(quotes[0].first, "BTCUSD");
+  ASSERT_EQ(quotes[0].second.bid, "100.5");
+  ASSERT_EQ(quotes[0].second.depth, 4);
+  ASSERT_EQ(quotes[1].first, "ETHUSD");
+  ASSERT_EQ(quotes[1].second.ask, "20.5");
+  // Recycled capture must not leak the previous entry's optional member
+  REQUIRE(!quotes[1].second.depth.has_value());
+
+  ASSERT_EQ(volumes.size(), 2);
+  ASSERT_EQ(volumes[0], (std::pair<std::string, int>{"BTCUSD", 1200}));
+  ASSERT_EQ(volumes[1], (std::pair<std::string, int>{"ETHUSD", 300}));
+}
+
+TEST_CASE("Streaming parser reports errors from scalar element dispatch",
+          "[JSON STREAMING PARSER_DISPATCH]") {
+  std::vector<int> sequences;
+  auto parse = [&](std::string_view document) {
+    sequences.clear();
+    return moped::parseCompositeFromJSONStream<SequenceStream>(
+        DFTF{}, document, SequenceSink{&sequences});
+  };
+  REQUIRE(parse(R"({"sequences":[1,2,3]})").has_value());
+  ASSERT_EQ(sequences, (std::vector<int>{1, 2, 3}));
+
+  // The handler stops the parse
+  auto stopped = parse(R"({"sequences":[1,-2,3]})");
+  REQUIRE(!stopped.has_value());
+  ASSERT_EQ(std::string_view{stopped.error().message},
+            "Negative sequence number");
+  ASSERT_EQ(sequences, (std::vector<int>{1}));
+
+  // Elements that don't convert to the element type
+  REQUIRE(!parse(R"({"sequences":[1,"two"]})").has_value());
+}
@@ -80,3 +80,42 @@ TEST_CASE("Instrument Data load Test with full payload parser and full "
   REQUIRE(filter.tickSize.has_value());
   ASSERT_EQ(filter.tickSize.value(), S8Int{"0.0100"});
 }
+
+TEST_CASE("Array size hints reserve push collections exactly once",
+          "[JSON FULL PAYLOAD (VIEW) PARSER]") {
+  using DispatcherT =
+      moped::CompositeParserEventDispatcher<ExchangeInfo,
+                                            moped::StringDecodingTraits<DFTF>>;
+  DispatcherT dispatcher{};
+  moped::JSONViewParser<DispatcherT, true> parser{dispatcher};
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+
+  const ExchangeInfo &info = dispatcher.getComposite();
+  ASSERT_EQ(info.symbols.size(), 3);
+  ASSERT_EQ(info.symbols.capacity(), 3);
+  ASSERT_EQ(info.rateLimits.capacity(), 4);
+  ASSERT_EQ(info.symbols[0].filters.capacity(), 9);
+  ASSERT_EQ(info.symbols[2].filters.capacity(), 10);
+  ASSERT_EQ(info.symbols[0].orderTypes.capacity(), 5);
+  ASSERT_EQ(info.symbols[0].filters[1].filterType, "PERCENT_PRICE");
+}
+
+TEST_CASE("Adaptive reservation carries collection sizes across parses",
+          "[JSON FULL PAYLOAD (VIEW) PARSER]") {
+  using DispatcherT = moped::CompositeParserEventDispatcher<
+      ExchangeInfo,
+      moped::AdaptiveReserveDecodingTraits<moped::StringDecodingTraits<DFTF>>>;
+  DispatcherT dispatcher{};
+  moped::JSONViewParser<DispatcherT> parser{dispatcher};
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+  ASSERT_EQ(dispatcher.getComposite().symbols.size(), 3);
+
+  dispatcher.reset();
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+
+  const ExchangeInfo &info = dispatcher.getComposite();
+  ASSERT_EQ(info.symbols.size(), 3);
+  ASSERT_EQ(info.symbols.capacity(), 3);
+  ASSERT_EQ(info.symbols[0].filters.size(), 9);
+  ASSERT_EQ(info.symbols[0].filters.capacity(), 10);
+}
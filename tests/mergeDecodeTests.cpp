@@ -0,0 +1,175 @@
+#include <catch2/catch.hpp>
+
+#include "moped/mopedJSON.hpp"
+#include "moped/mopedMsgPack.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+using moped::MergePolicy;
+
+struct Level {
+  double price;
+  double quantity;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Level>(
+        "price", &Level::price, "quantity", &Level::quantity);
+  }
+};
+
+struct Position {
+  std::string account;
+  double quantity;
+  std::optional<double> averagePrice;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Position>(
+        "account", &Position::account, "quantity", &Position::quantity,
+        "averagePrice", &Position::averagePrice);
+  }
+};
+
+struct BookState {
+  std::string symbol;
+  std::uint64_t sequence;
+  std::optional<int> limit;
+  std::optional<Position> position;
+  std::vector<Level> bids;
+  std::vector<int> trades;
+  std::vector<std::string> venues;
+  std::map<std::string, double> marks;
+  std::map<std::string, Level> bestLevels;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, BookState>(
+        "symbol", &BookState::symbol, "sequence", &BookState::sequence,
+        "limit", &BookState::limit, "position", &BookState::position,
+        moped::mergeAs<MergePolicy::Upsert>("bids"), &BookState::bids,
+        "trades", &BookState::trades,
+        moped::mergeAs<MergePolicy::Replace>("venues"), &BookState::venues,
+        moped::mergeAs<MergePolicy::Upsert>("marks"), &BookState::marks,
+        moped::mergeAs<MergePolicy::Upsert>("bestLevels"),
+        &BookState::bestLevels);
+  }
+};
+
+BookState initialBook() {
+  BookState book;
+  auto result = moped::mergeCompositeFromJSONView(DFTF{}, R"({
+    "symbol": "BTCUSDT", "sequence": 1, "limit": 10,
+    "position": {"account": "main", "quantity": 2, "averagePrice": 100},
+    "bids": [{"price": 100, "quantity": 1}, {"price": 99, "quantity": 2}],
+    "trades": [1, 2],
+    "venues": ["A", "B"],
+    "marks": {"spot": 100.5, "perp": 101},
+    "bestLevels": {"spot": {"price": 100, "quantity": 1}}
+  })",
+                                                  book);
+  REQUIRE(result.has_value());
+  return book;
+}
+
+} // namespace
+
+TEST_CASE("Merge decode leaves members absent from the update untouched",
+          "[Merge]") {
+  auto book = initialBook();
+  REQUIRE(moped::mergeCompositeFromJSONView(
+              DFTF{}, R"({"sequence": 2, "position": {"quantity": 3}})", book)
+              .has_value());
+  ASSERT_EQ(book.symbol, "BTCUSDT");
+  ASSERT_EQ(book.sequence, 2);
+  ASSERT_EQ(book.limit, 10);
+  // Engaged optional composites merge in place
+  REQUIRE(book.position.has_value());
+  ASSERT_EQ(book.position->account, "main");
+  ASSERT_EQ(book.position->quantity, 3.0);
+  ASSERT_EQ(book.position->averagePrice, 100.0);
+  ASSERT_EQ(book.bids.size(), 2);
+  ASSERT_EQ(book.trades, (std::vector<int>{1, 2}));
+  ASSERT_EQ(book.marks.size(), 2);
+}
+
+TEST_CASE("Merge decode null resets optional members", "[Merge]") {
+  auto book = initialBook();
+  REQUIRE(moped::mergeCompositeFromJSONView(
+              DFTF{}, R"({"limit": null, "position": {"averagePrice": null}})",
+              book)
+              .has_value());
+  REQUIRE(!book.limit.has_value());
+  REQUIRE(book.position.has_value());
+  REQUIRE(!book.position->averagePrice.has_value());
+  ASSERT_EQ(book.position->account, "main");
+
+  REQUIRE(moped::mergeCompositeFromJSONView(DFTF{}, R"({"position": null})",
+                                            book)
+              .has_value());
+  REQUIRE(!book.position.has_value());
+
+  // Null still isn't a value for required members
+  REQUIRE(!moped::mergeCompositeFromJSONView(DFTF{}, R"({"symbol": null})",
+                                             book)
+               .has_value());
+}
+
+TEST_CASE("Merge decode applies per collection policies", "[Merge]") {
+  auto book = initialBook();
+  REQUIRE(moped::mergeCompositeFromJSONView(DFTF{}, R"({
+    "bids": [{"quantity": 5}, {"price": 98.5}, {"price": 97, "quantity": 4}],
+    "trades": [3],
+    "venues": ["C"],
+    "marks": {"perp": 102, "index": 100, "spot": null},
+    "bestLevels": {"spot": {"quantity": 7}, "perp": {"price": 101}}
+  })",
+                                            book)
+              .has_value());
+
+  // Upserted sequence elements merge by position, extras are appended
+  ASSERT_EQ(book.bids.size(), 3);
+  ASSERT_EQ(book.bids[0].price, 100.0);
+  ASSERT_EQ(book.bids[0].quantity, 5.0);
+  ASSERT_EQ(book.bids[1].price, 98.5);
+  ASSERT_EQ(book.bids[1].quantity, 2.0);
+  ASSERT_EQ(book.bids[2].price, 97.0);
+
+  ASSERT_EQ(book.trades, (std::vector<int>{1, 2, 3}));
+  ASSERT_EQ(book.venues, (std::vector<std::string>{"C"}));
+
+  // Upserted maps assign by key and erase keys set to null
+  ASSERT_EQ(book.marks.size(), 2);
+  ASSERT_EQ(book.marks.at("perp"), 102.0);
+  ASSERT_EQ(book.marks.at("index"), 100.0);
+  REQUIRE(!book.marks.contains("spot"));
+  ASSERT_EQ(book.bestLevels.at("spot").price, 100.0);
+  ASSERT_EQ(book.bestLevels.at("spot").quantity, 7.0);
+  ASSERT_EQ(book.bestLevels.at("perp").price, 101.0);
+}
+
+TEST_CASE("Merge decode from MsgPack updates in place", "[Merge]") {
+  auto book = initialBook();
+  BookState update{};
+  update.symbol = "BTCUSDT";
+  update.sequence = 3;
+  update.trades = {4};
+  update.marks = {{"spot", 99.0}};
+  auto encoded = moped::encodeToMsgPackString(update, DFTF{});
+  REQUIRE(moped::mergeCompositeFromMsgPack(DFTF{}, encoded, book).has_value());
+  ASSERT_EQ(book.sequence, 3);
+  ASSERT_EQ(book.limit, 10);
+  ASSERT_EQ(book.trades, (std::vector<int>{1, 2, 4}));
+  ASSERT_EQ(book.marks.at("spot"), 99.0);
+  ASSERT_EQ(book.marks.at("perp"), 101.0);
+  ASSERT_EQ(book.bids.size(), 2);
+}
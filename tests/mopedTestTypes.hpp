@@ -1,4 +1,5 @@
 #include "moped/CollectionFunctionDispatcher.hpp"
+#include "moped/MappedCollectionFunctionDispatcher.hpp"
 #include "moped/MappedObjectParseEncoderDispatcher.hpp"
 #include "moped/ScaledInteger.hpp"
 #include "moped/mopedJSON.hpp"
@@ -308,6 +309,139 @@ struct ExchangeInfoWithSymbolDispatch {
         &ExchangeInfoWithSymbolDispatch::symbols);
   }
 };
+struct SymbolSink {
+  std::vector<Symbol> *captured = nullptr;
+  std::vector<const Filter *> *filterStorage = nullptr;
+
+  moped::Expected operator()(const Symbol &symbol) {
+    captured->push_back(symbol);
+    filterStorage->push_back(symbol.filters.data());
+    return {};
+  }
+};
+
+struct ExchangeInfoWithRecycledSymbols {
+  std::string timezone;
+  moped::TimePoint serverTime;
+  std::vector<RateLimit> rateLimits;
+  std::vector<std::string> exchangeFilters;
+  moped::RecyclingCollectionFunctionDispatcher<Symbol, SymbolSink> symbols;
+
+  ExchangeInfoWithRecycledSymbols(SymbolSink sink) : symbols(sink) {}
+
+  ExchangeInfoWithRecycledSymbols() = default;
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits,
+                               ExchangeInfoWithRecycledSymbols>(
+        "timezone", &ExchangeInfoWithRecycledSymbols::timezone, "serverTime",
+        &ExchangeInfoWithRecycledSymbols::serverTime, "rateLimits",
+        &ExchangeInfoWithRecycledSymbols::rateLimits, "exchangeFilters",
+        &ExchangeInfoWithRecycledSymbols::exchangeFilters, "symbols",
+        &ExchangeInfoWithRecycledSymbols::symbols);
+  }
+};
+struct SymbolBatchSink {
+  std::vector<Symbol> *captured = nullptr;
+  std::vector<std::size_t> *batchSizes = nullptr;
+
+  moped::Expected operator()(std::span<const Symbol> batch) {
+    captured->insert(captured->end(), batch.begin(), batch.end());
+    batchSizes->push_back(batch.size());
+    return {};
+  }
+};
+
+struct ExchangeInfoWithBatchedSymbols {
+  std::string timezone;
+  moped::TimePoint serverTime;
+  std::vector<RateLimit> rateLimits;
+  std::vector<std::string> exchangeFilters;
+  moped::BatchingCollectionFunctionDispatcher<Symbol, 2, SymbolBatchSink>
+      symbols;
+
+  ExchangeInfoWithBatchedSymbols(SymbolBatchSink sink) : symbols(sink) {}
+
+  ExchangeInfoWithBatchedSymbols() = default;
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, ExchangeInfoWithBatchedSymbols>(
+        "timezone", &ExchangeInfoWithBatchedSymbols::timezone, "serverTime",
+        &ExchangeInfoWithBatchedSymbols::serverTime, "rateLimits",
+        &ExchangeInfoWithBatchedSymbols::rateLimits, "exchangeFilters",
+        &ExchangeInfoWithBatchedSymbols::exchangeFilters, "symbols",
+        &ExchangeInfoWithBatchedSymbols::symbols);
+  }
+};
+
+struct Quote {
+  std::string bid;
+  std::string ask;
+  std::optional<int> depth;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Quote>(
+        "bid", &Quote::bid, "ask", &Quote::ask, "depth", &Quote::depth);
+  }
+};
+
+struct QuoteSink {
+  std::vector<std::pair<std::string, Quote>> *captured = nullptr;
+  moped::Expected operator()(std::string_view key, const Quote &quote) {
+    captured->emplace_back(key, quote);
+    return {};
+  }
+};
+
+struct VolumeSink {
+  std::vector<std::pair<std::string, int>> *captured = nullptr;
+  moped::Expected operator()(std::string_view key, int volume) {
+    captured->emplace_back(key, volume);
+    return {};
+  }
+};
+
+struct MarketSnapshot {
+  moped::MappedCollectionFunctionDispatcher<std::string_view, Quote, QuoteSink>
+      quotes;
+  moped::MappedCollectionFunctionDispatcher<std::string, int, VolumeSink>
+      volumes;
+
+  MarketSnapshot(QuoteSink quoteSink, VolumeSink volumeSink)
+      : quotes(quoteSink), volumes(volumeSink) {}
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, MarketSnapshot>(
+        "quotes", &MarketSnapshot::quotes, "volumes", &MarketSnapshot::volumes);
+  }
+};
+
+// Stops the parse at the first negative sequence number
+struct SequenceSink {
+  std::vector<int> *captured = nullptr;
+
+  moped::Expected operator()(int sequence) {
+    if (sequence < 0) {
+      return std::unexpected("Negative sequence number");
+    }
+    captured->push_back(sequence);
+    return {};
+  }
+};
+
+struct SequenceStream {
+  moped::RecyclingCollectionFunctionDispatcher<int, SequenceSink> sequences;
+
+  SequenceStream(SequenceSink sink) : sequences(sink) {}
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SequenceStream>(
+        "sequences", &SequenceStream::sequences);
+  }
+};
 } // namespace stream
 
 } // namespace moped::tests
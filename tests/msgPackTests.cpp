@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/mopedJSON.hpp"
+#include "moped/mopedMsgPack.hpp"
+#include "moped/tests/mopedTestTypes.hpp"
+
+// Shared with jsonViewParseTest.cpp
+extern std::string_view instrumentData_view;
+
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+
+using namespace moped::tests::stream;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct PriceLevels {
+  std::vector<std::int32_t> levels;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PriceLevels>(
+        "", &PriceLevels::levels);
+  }
+};
+
+struct Tick {
+  std::uint8_t venue;
+  double price;
+  moped::ScaledInteger<std::int64_t, 4> size;
+  std::optional<std::int64_t> sequence;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, Tick>(
+        "venue", &Tick::venue, "price", &Tick::price, "size", &Tick::size,
+        "sequence", &Tick::sequence);
+  }
+};
+
+// Scaled integers whose values exceed 64 bit signed range
+struct WideAmounts {
+  moped::ScaledInteger<std::uint64_t, 0> volume;
+  moped::ScaledInteger<int128_t, 4> notional;
+  moped::ScaledInteger<int128_t, 4> small;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, WideAmounts>(
+        "volume", &WideAmounts::volume, "notional", &WideAmounts::notional,
+        "small", &WideAmounts::small);
+  }
+};
+
+} // namespace
+
+TEST_CASE("MessagePack round trip preserves every mapped member",
+          "[MESSAGEPACK]") {
+  auto original =
+      moped::parseCompositeFromJSONView<ExchangeInfo>(DFTF{}, instrumentData_view);
+  REQUIRE(original.has_value());
+
+  auto encoded = moped::encodeToMsgPackString(original.value(), DFTF{});
+  REQUIRE(encoded.size() < instrumentData_view.size());
+
+  auto decoded = moped::parseCompositeFromMsgPack<ExchangeInfo>(DFTF{}, encoded);
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->serverTime, original->serverTime);
+  ASSERT_EQ(decoded->symbols[2].filters[5].maxQty,
+            original->symbols[2].filters[5].maxQty);
+  ASSERT_EQ(moped::encodeToJSONString(decoded.value(), DFTF{}),
+            moped::encodeToJSONString(original.value(), DFTF{}));
+}
+
+TEST_CASE("MessagePack root arrays and binary numeric conversions",
+          "[MESSAGEPACK]") {
+  PriceLevels levels;
+  for (std::int32_t level = -40; level < 40; level += 3) {
+    levels.levels.push_back(level * 1000);
+  }
+  auto encoded = moped::encodeToMsgPackString(levels, DFTF{});
+  ASSERT_EQ(static_cast<std::uint8_t>(encoded[0]), 0xdc); // array16 header
+  auto decoded = moped::parseCompositeFromMsgPack<PriceLevels>(DFTF{}, encoded);
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->levels, levels.levels);
+
+  Tick tick{7, 101.25, moped::ScaledInteger<std::int64_t, 4>{"12.5"}, 99};
+  auto tickEncoded = moped::encodeToMsgPackString(tick, DFTF{});
+  auto tickDecoded =
+      moped::parseCompositeFromMsgPack<Tick>(DFTF{}, tickEncoded);
+  REQUIRE(tickDecoded.has_value());
+  ASSERT_EQ(tickDecoded->venue, 7);
+  ASSERT_EQ(tickDecoded->price, 101.25);
+  ASSERT_EQ(tickDecoded->size, tick.size);
+  ASSERT_EQ(tickDecoded->sequence, 99);
+
+  // {"venue": 300} does not fit the uint8_t member
+  std::string outOfRange{"\x81\xa5venue\xcd\x01\x2c", 10};
+  auto rejected = moped::parseCompositeFromMsgPack<Tick>(DFTF{}, outOfRange);
+  REQUIRE(!rejected);
+  ASSERT_EQ(std::string_view{rejected.error().message},
+            "Numeric value out of range for integral member");
+
+  REQUIRE(!moped::parseCompositeFromMsgPack<Tick>(
+      DFTF{}, std::string_view{tickEncoded}.substr(0, tickEncoded.size() - 2)));
+}
+
+TEST_CASE("MessagePack numeric conversions reject values out of range",
+          "[MESSAGEPACK]") {
+  using Traits = moped::StringDecodingTraits<DFTF>;
+  // 2^63 rounds from int64 max, it is the first value past the range
+  REQUIRE(!moped::getValueFor<std::int64_t, Traits>(0x1p63).has_value());
+  REQUIRE(!moped::getValueFor<std::uint64_t, Traits>(0x1p64).has_value());
+  REQUIRE(!moped::getValueFor<std::int32_t, Traits>(0x1p31).has_value());
+  REQUIRE(!moped::getValueFor<std::int64_t, Traits>(std::nan("")));
+  auto lowest = moped::getValueFor<std::int64_t, Traits>(-0x1p63);
+  ASSERT_EQ(lowest.value(), std::numeric_limits<std::int64_t>::min());
+  auto unsignedHigh = moped::getValueFor<std::uint64_t, Traits>(0x1p63);
+  ASSERT_EQ(unsignedHigh.value(), std::uint64_t{1} << 63);
+
+  using Price = moped::ScaledInteger<std::int64_t, 4>;
+  using Narrow = moped::ScaledInteger<std::int32_t, 2>;
+  REQUIRE(!moped::getValueFor<Price, Traits>(
+               std::int64_t{1'000'000'000'000'000}).has_value());
+  REQUIRE(!moped::getValueFor<Price, Traits>(
+               std::numeric_limits<std::uint64_t>::max()).has_value());
+  REQUIRE(!moped::getValueFor<Narrow, Traits>(std::int64_t{30'000'000})
+               .has_value());
+  REQUIRE(!moped::getValueFor<Narrow, Traits>(3e7).has_value());
+  auto narrow = moped::getValueFor<Narrow, Traits>(std::int64_t{-21'474'836});
+  ASSERT_EQ(narrow.value(), Narrow{"-21474836"});
+  auto price = moped::getValueFor<Price, Traits>(12.5);
+  ASSERT_EQ(price.value(), Price{"12.5"});
+
+  // Whole values past int64 go out unsigned, past uint64 as text
+  WideAmounts amounts{{"18000000000000000000"},
+                      {"-123456789012345678901234567890"},
+                      {"-42"}};
+  auto encoded = moped::encodeToMsgPackString(amounts, DFTF{});
+  auto decoded = moped::parseCompositeFromMsgPack<WideAmounts>(DFTF{}, encoded);
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->volume, amounts.volume);
+  ASSERT_EQ(decoded->notional, amounts.notional);
+  ASSERT_EQ(decoded->small, amounts.small);
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "moped/ParseEventTape.hpp"
+#include "moped/tests/mopedTestTypes.hpp"
+
+// Shared with jsonViewParseTest.cpp
+extern std::string_view instrumentData_view;
+
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+using TapeTraits = moped::StringDecodingTraits<DFTF>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+using ViewDispatcher =
+    moped::CompositeParserEventDispatcher<moped::tests::view::ExchangeInfo,
+                                          TapeTraits>;
+using StreamDispatcher =
+    moped::CompositeParserEventDispatcher<moped::tests::stream::ExchangeInfo,
+                                          TapeTraits>;
+
+} // namespace
+
+TEST_CASE("One tokenization fans out to several composite types",
+          "[PARSE EVENT TAPE]") {
+  moped::ParseEventTape tape;
+  moped::JSONViewParser<moped::ParseEventTape> parser{tape};
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+
+  ViewDispatcher viewDispatcher;
+  StreamDispatcher streamDispatcher;
+  REQUIRE(tape.replay(viewDispatcher, streamDispatcher).has_value());
+
+  auto &viewInfo = viewDispatcher.getComposite();
+  auto &streamInfo = streamDispatcher.getComposite();
+  ASSERT_EQ(viewInfo.symbols.size(), 3);
+  ASSERT_EQ(streamInfo.symbols.size(), 3);
+  ASSERT_EQ(viewInfo.symbols[1].symbol, "ETHUSD4");
+  ASSERT_EQ(streamInfo.symbols[1].symbol, "ETHUSD4");
+  ASSERT_EQ(streamInfo.rateLimits[3].limit, 6100);
+  ASSERT_EQ(viewInfo.serverTime, streamInfo.serverTime);
+  REQUIRE(streamInfo.symbols[0].icebergAllowed);
+}
+
+TEST_CASE("Exported tape bytes replay after reload", "[PARSE EVENT TAPE]") {
+  moped::ParseEventTape tape;
+  moped::JSONViewParser<moped::ParseEventTape> parser{tape};
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+
+  auto encoded = tape.bytes();
+  std::vector<char> stored{encoded.begin(), encoded.end()};
+  REQUIRE(!stored.empty());
+
+  moped::ParseEventTape reloaded;
+  REQUIRE(reloaded.loadBytes(stored).has_value());
+  ASSERT_EQ(reloaded.eventCount(), tape.eventCount());
+
+  StreamDispatcher dispatcher;
+  REQUIRE(reloaded.replay(dispatcher).has_value());
+  ASSERT_EQ(dispatcher.getComposite().symbols[2].filters.size(), 10);
+  ASSERT_EQ(dispatcher.getComposite().timezone, "UTC");
+
+  // Truncated and corrupt encodings are rejected without modifying the tape
+  std::vector<char> truncated{stored.begin(), stored.begin() + 3};
+  REQUIRE(!reloaded.loadBytes(truncated));
+  std::vector<char> corrupt{stored};
+  corrupt[0] = 0x7f;
+  REQUIRE(!reloaded.loadBytes(corrupt));
+  ASSERT_EQ(reloaded.eventCount(), tape.eventCount());
+}
+
+TEST_CASE("Exported tape lengths are little endian", "[PARSE EVENT TAPE]") {
+  moped::ParseEventTape tape;
+  moped::JSONViewParser<moped::ParseEventTape> parser{tape};
+  REQUIRE(parser.parse(R"({"ab":true})").has_value());
+
+  auto encoded = tape.bytes();
+  std::vector<char> stored{encoded.begin(), encoded.end()};
+  std::vector<char> expected{
+      char(moped::ParseEventKind::ObjectStart),
+      char(moped::ParseEventKind::Member), 2, 0, 0, 0, 'a', 'b',
+      char(moped::ParseEventKind::BooleanValue), 1,
+      char(moped::ParseEventKind::ObjectFinish)};
+  REQUIRE(stored == expected);
+}
+
+TEST_CASE("Tapes referencing source text cannot be exported",
+          "[PARSE EVENT TAPE]") {
+  moped::ParseEventTape tape{false};
+  moped::JSONViewParser<moped::ParseEventTape> parser{tape};
+  REQUIRE(parser.parse(instrumentData_view).has_value());
+  REQUIRE(tape.bytes().empty());
+
+  ViewDispatcher dispatcher;
+  REQUIRE(tape.replay(dispatcher).has_value());
+  // Views resolve straight into the source document
+  auto symbol = dispatcher.getComposite().symbols[0].symbol;
+  REQUIRE(symbol.data() >= instrumentData_view.data());
+  REQUIRE(symbol.data() <
+          instrumentData_view.data() + instrumentData_view.size());
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+
+#include "moped/CompositePipelineStage.hpp"
+#include "moped/SlotPublishingCollectionDispatcher.hpp"
+#include "moped/tests/mopedTestTypes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <thread>
+
+using DFTF = moped::DurationSinceEpochFormatter<std::chrono::milliseconds>;
+using PipelineTraits = moped::StringDecodingTraits<DFTF>;
+
+using namespace moped::tests::stream;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+std::string rateLimitDocument(int limit) {
+  return std::format(R"({{"rateLimitType":"ORDERS","interval":"SECOND",)"
+                     R"("intervalNum":{},"limit":{}}})",
+                     limit % 60, limit);
+}
+
+constexpr int DocumentCount = 2000;
+
+// Drains the ring until every producer has finished, successfully or not.
+// Slots published before a producer finished are seen by the final drain.
+void consumeUntilDone(auto &ring, const std::atomic<int> &producersRunning,
+                      auto &&handler) {
+  for (;;) {
+    bool finished = producersRunning.load(std::memory_order_acquire) == 0;
+    ring.consumeAll(handler);
+    if (finished) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+using SymbolRing = moped::CompositeSlotRing<Symbol, 4>;
+
+struct SymbolStream {
+  std::string timezone;
+  moped::SlotPublishingCollectionDispatcher<Symbol, 4> symbols;
+
+  SymbolStream(SymbolRing &ring) : symbols(ring) {}
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SymbolStream>(
+        "timezone", &SymbolStream::timezone, "symbols", &SymbolStream::symbols);
+  }
+};
+
+} // namespace
+
+TEST_CASE("Single producer pipeline stage hands composites to a consumer",
+          "[PIPELINE STAGE]") {
+  using StageT = moped::CompositePipelineStage<RateLimit, PipelineTraits, 8>;
+  StageT::RingT ring;
+
+  std::vector<std::string> documents;
+  for (int index = 0; index < DocumentCount; ++index) {
+    documents.push_back(rateLimitDocument(index));
+  }
+
+  // Catch assertions are not thread safe, producers only record failures
+  std::atomic<int> failures{0};
+  std::atomic<int> producersRunning{1};
+  std::thread producer{[&] {
+    StageT stage{ring};
+    for (auto &document : documents) {
+      if (!stage.produceFromJSONView(document)) {
+        ++failures;
+        break;
+      }
+    }
+    producersRunning.fetch_sub(1, std::memory_order_release);
+  }};
+
+  std::vector<int> limits;
+  consumeUntilDone(ring, producersRunning, [&](const RateLimit &rateLimit) {
+    limits.push_back(rateLimit.limit);
+    ASSERT_EQ(rateLimit.intervalNum, rateLimit.limit % 60);
+  });
+  producer.join();
+
+  ASSERT_EQ(failures.load(), 0);
+  REQUIRE(limits.size() == DocumentCount);
+  for (int index = 0; index < DocumentCount; ++index) {
+    ASSERT_EQ(limits[index], index);
+  }
+  REQUIRE(ring.consume() == nullptr);
+}
+
+TEST_CASE("Multiple producer pipeline stages share one ring",
+          "[PIPELINE STAGE]") {
+  using StageT = moped::CompositePipelineStage<RateLimit, PipelineTraits, 16,
+                                               moped::RingProducers::Multiple>;
+  StageT::RingT ring;
+
+  std::atomic<int> failures{0};
+  std::atomic<int> producersRunning{2};
+  auto produceRange = [&](int first, int last) {
+    StageT stage{ring};
+    for (int index = first; index < last; ++index) {
+      if (!stage.produceFromJSONView(rateLimitDocument(index))) {
+        ++failures;
+        break;
+      }
+    }
+    producersRunning.fetch_sub(1, std::memory_order_release);
+  };
+  std::thread firstProducer{produceRange, 0, DocumentCount / 2};
+  std::thread secondProducer{produceRange, DocumentCount / 2, DocumentCount};
+
+  std::vector<bool> seen(DocumentCount, false);
+  consumeUntilDone(ring, producersRunning, [&](const RateLimit &rateLimit) {
+    REQUIRE(!seen[rateLimit.limit]);
+    seen[rateLimit.limit] = true;
+  });
+  firstProducer.join();
+  secondProducer.join();
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(std::count(seen.begin(), seen.end(), true), DocumentCount);
+}
+
+TEST_CASE("Failed decode keeps its slot unpublished", "[PIPELINE STAGE]") {
+  using StageT = moped::CompositePipelineStage<RateLimit, PipelineTraits, 2>;
+  StageT::RingT ring;
+  StageT stage{ring};
+
+  REQUIRE(!stage.produceFromJSONView(R"({"limit":"not a number"})"));
+  REQUIRE(ring.consume() == nullptr);
+
+  REQUIRE(stage.produceFromJSONView(rateLimitDocument(7)).has_value());
+  auto *slot = ring.consume();
+  REQUIRE(slot != nullptr);
+  ASSERT_EQ(slot->value.limit, 7);
+  ASSERT_EQ(slot->value.rateLimitType, "ORDERS");
+  ring.release(*slot);
+}
+
+TEST_CASE("Collection elements published to a ring while parsing",
+          "[PIPELINE STAGE]") {
+  SymbolRing ring;
+  std::string_view document =
+      R"({"timezone":"UTC","symbols":[)"
+      R"({"symbol":"BTCUSD4","orderTypes":["LIMIT","MARKET"]},)"
+      R"({"symbol":"ETHUSD4","orderTypes":["LIMIT"]},)"
+      R"({"symbol":"XRPUSD4"},{"symbol":"LTCUSD4"},{"symbol":"ADAUSD4"},)"
+      R"({"symbol":"SOLUSD4","orderTypes":["MARKET"]}]})";
+
+  bool parsed = false;
+  std::atomic<int> producersRunning{1};
+  std::thread producer{[&] {
+    parsed = moped::parseCompositeFromJSONView<SymbolStream>(DFTF{}, document,
+                                                             ring)
+                 .has_value();
+    producersRunning.fetch_sub(1, std::memory_order_release);
+  }};
+
+  std::vector<Symbol> symbols;
+  consumeUntilDone(ring, producersRunning,
+                   [&](const Symbol &symbol) { symbols.push_back(symbol); });
+  producer.join();
+
+  REQUIRE(parsed);
+  REQUIRE(symbols.size() == 6);
+  ASSERT_EQ(symbols[0].symbol, "BTCUSD4");
+  ASSERT_EQ(symbols[0].orderTypes.size(), 2);
+  ASSERT_EQ(symbols[2].symbol, "XRPUSD4");
+  // Slots are recycled, members absent from the document start out cleared
+  REQUIRE(symbols[4].orderTypes.empty());
+  ASSERT_EQ(symbols[5].orderTypes[0], "MARKET");
+}
@@ -0,0 +1,267 @@
+#include <catch2/catch.hpp>
+
+#include "moped/mopedProtobuf.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using Price = moped::ScaledInteger<std::int64_t, 4>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+inline constexpr char pbNew[] = "new";
+inline constexpr char pbFilled[] = "filled";
+inline constexpr char pbCancelled[] = "cancelled";
+
+enum class PbOrderStatus : std::int32_t { New = 0, Filled = 2, Cancelled = 9 };
+
+using PbOrderStatusT =
+    moped::MappedEnum<pbNew, PbOrderStatus::New, pbFilled,
+                      PbOrderStatus::Filled, pbCancelled,
+                      PbOrderStatus::Cancelled>;
+
+struct PbFill {
+  std::int64_t quantity;
+  double price;
+
+  bool operator==(const PbFill &) const = default;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbFill>(
+        "1", &PbFill::quantity, "2", &PbFill::price);
+  }
+};
+
+struct PbVenue {
+  std::string name;
+  std::uint32_t id;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbVenue>("20", &PbVenue::name,
+                                                        "21", &PbVenue::id);
+  }
+};
+
+struct PbOrder {
+  std::int32_t id;
+  std::int64_t delta;
+  std::uint32_t checksum;
+  std::int64_t sequence;
+  bool active;
+  float ratio;
+  std::string symbol;
+  moped::TimePoint time;
+  Price price;
+  PbOrderStatusT status;
+  std::optional<std::string> note;
+  PbFill best;
+  std::vector<PbFill> fills;
+  std::vector<std::int32_t> levels;
+  std::vector<std::int64_t> offsets;
+  std::vector<double> weights;
+  std::vector<std::string> tags;
+  PbVenue venue;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbOrder>(
+        "1", &PbOrder::id, "2:sint", &PbOrder::delta, "3:fixed",
+        &PbOrder::checksum, "4:fixed", &PbOrder::sequence, "5",
+        &PbOrder::active, "6", &PbOrder::ratio, "7", &PbOrder::symbol, "8",
+        &PbOrder::time, "9", &PbOrder::price, "10", &PbOrder::status, "11",
+        &PbOrder::note, "12", &PbOrder::best, "13", &PbOrder::fills, "14",
+        &PbOrder::levels, "15:sint", &PbOrder::offsets, "16",
+        &PbOrder::weights, "17", &PbOrder::tags, "", &PbOrder::venue);
+  }
+};
+
+struct PbSimple {
+  std::int32_t a;
+  std::string b;
+  std::optional<PbFill> c;
+  std::vector<std::int32_t> d;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbSimple>(
+        "1", &PbSimple::a, "2", &PbSimple::b, "3", &PbSimple::c, "4",
+        &PbSimple::d);
+  }
+};
+
+struct PbBadName {
+  int value;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbBadName>("value",
+                                                          &PbBadName::value);
+  }
+};
+
+struct PbStamp {
+  moped::TimePoint time;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, PbStamp>("1", &PbStamp::time);
+  }
+};
+
+std::string bytes(std::initializer_list<std::uint8_t> values) {
+  return std::string{values.begin(), values.end()};
+}
+
+auto parseSimple(std::string_view message) {
+  return moped::parseCompositeFromProtobuf<PbSimple>(
+      moped::DurationSinceEpochFormatter<>{}, message);
+}
+
+} // namespace
+
+TEST_CASE("Protobuf emitter writes the canonical wire format") {
+  PbSimple simple{150, "testing", PbFill{150, 0}, {3, 270, 86942}};
+  moped::ProtobufEmitterContext context;
+  auto message = moped::encodeToProtobuf(simple, context);
+  REQUIRE(message.has_value());
+  ASSERT_EQ(std::string{*message},
+            bytes({0x08, 0x96, 0x01, 0x12, 0x07, 't', 'e', 's', 't', 'i', 'n',
+                   'g', 0x1a, 0x0c, 0x08, 0x96, 0x01, 0x11, 0, 0, 0, 0, 0, 0,
+                   0, 0, 0x22, 0x06, 0x03, 0x8e, 0x02, 0x9e, 0xa7, 0x05}));
+
+  // Disengaged optionals and empty repeated fields are omitted, the context
+  // is reused for the next message
+  simple = PbSimple{-1, "", std::nullopt, {}};
+  message = moped::encodeToProtobuf(simple, context);
+  REQUIRE(message.has_value());
+  ASSERT_EQ(std::string{*message},
+            bytes({0x08, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                   0x01, 0x12, 0x00}));
+}
+
+TEST_CASE("Protobuf round trip of every value kind") {
+  PbOrder order;
+  order.id = -42;
+  order.delta = -3;
+  order.checksum = 0xdeadbeef;
+  order.sequence = -7;
+  order.active = true;
+  order.ratio = 0.5f;
+  order.symbol = "ETHUSD";
+  order.time = moped::TimePoint{std::chrono::nanoseconds{-1'500'000'001}};
+  order.price = Price{"1234.5678"};
+  order.status = PbOrderStatusT{PbOrderStatus::Cancelled};
+  order.note = "first";
+  order.best = PbFill{10, 2.25};
+  order.fills = {{1, 1.5}, {-2, 2.5}, {3, 3.5}};
+  // A run of single byte varints followed by mixed lengths
+  for (int level = 0; level < 20; ++level) {
+    order.levels.push_back(level);
+  }
+  for (int level = 0; level < 40; ++level) {
+    order.levels.push_back(level * (level % 3 == 0 ? 1000 : 1));
+  }
+  order.levels.push_back(-1);
+  order.offsets = {-1, 1, -100000, std::numeric_limits<std::int64_t>::min()};
+  order.weights = {0.25, -8.0};
+  order.tags = {"a", "", "bc"};
+  order.venue = PbVenue{"XNAS", 77};
+
+  moped::ProtobufEmitterContext context;
+  auto message = moped::encodeToProtobuf(order, context);
+  REQUIRE(message.has_value());
+
+  auto parsed = moped::parseCompositeFromProtobuf<PbOrder>(
+      moped::DurationSinceEpochFormatter<>{}, *message);
+  REQUIRE(parsed.has_value());
+  ASSERT_EQ(parsed->id, order.id);
+  ASSERT_EQ(parsed->delta, order.delta);
+  ASSERT_EQ(parsed->checksum, order.checksum);
+  ASSERT_EQ(parsed->sequence, order.sequence);
+  ASSERT_EQ(parsed->active, order.active);
+  ASSERT_EQ(parsed->ratio, order.ratio);
+  ASSERT_EQ(parsed->symbol, order.symbol);
+  ASSERT_EQ(parsed->time, order.time);
+  ASSERT_EQ(parsed->price, order.price);
+  ASSERT_EQ(parsed->status, order.status);
+  ASSERT_EQ(parsed->note, order.note);
+  ASSERT_EQ(parsed->best, order.best);
+  ASSERT_EQ(parsed->fills, order.fills);
+  ASSERT_EQ(parsed->levels, order.levels);
+  ASSERT_EQ(parsed->offsets, order.offsets);
+  ASSERT_EQ(parsed->weights, order.weights);
+  ASSERT_EQ(parsed->tags, order.tags);
+  ASSERT_EQ(parsed->venue.name, order.venue.name);
+  ASSERT_EQ(parsed->venue.id, order.venue.id);
+}
+
+TEST_CASE("Protobuf parser accepts unpacked records and skips unknown "
+          "fields") {
+  // Repeated scalars one record per value, split around an unknown field
+  // of every wire type, and a group
+  auto message = bytes({0x20, 0x01, 0x20, 0x02,             // 4: 1, 2
+                        0x28, 0x05,                         // 5 varint
+                        0x31, 1, 2, 3, 4, 5, 6, 7, 8,       // 6 i64
+                        0x3a, 0x02, 'x', 'y',               // 7 len
+                        0x45, 1, 2, 3, 4,                   // 8 i32
+                        0x4b, 0x08, 0x01, 0x4c,             // 9 group
+                        0x22, 0x02, 0x03, 0x04,             // 4: packed 3, 4
+                        0x08, 0x07});                       // 1: 7
+  auto parsed = parseSimple(message);
+  REQUIRE(parsed.has_value());
+  ASSERT_EQ(parsed->a, 7);
+  ASSERT_EQ(parsed->d, (std::vector<std::int32_t>{1, 2, 3, 4}));
+  REQUIRE(!parsed->c.has_value());
+
+  // Consecutive records of one repeated field form a single array
+  parsed = parseSimple(bytes({0x20, 0x05, 0x22, 0x01, 0x06, 0x20, 0x07}));
+  REQUIRE(parsed.has_value());
+  ASSERT_EQ(parsed->d, (std::vector<std::int32_t>{5, 6, 7}));
+}
+
+TEST_CASE("Protobuf decoding errors") {
+  REQUIRE(parseSimple(bytes({0x08, 0x96, 0x01})).has_value());
+  // Field 1 mapped as a varint but carried as length delimited
+  REQUIRE(!parseSimple(bytes({0x0a, 0x01, 0x00})).has_value());
+  // Truncated varint, length and fixed value
+  REQUIRE(!parseSimple(bytes({0x08, 0x96})).has_value());
+  REQUIRE(!parseSimple(bytes({0x12, 0x05, 'a'})).has_value());
+  REQUIRE(!parseSimple(bytes({0x31, 1, 2, 3})).has_value());
+  // Field number 0 and invalid wire types
+  REQUIRE(!parseSimple(bytes({0x00, 0x01})).has_value());
+  REQUIRE(!parseSimple(bytes({0x2e, 0x01})).has_value());
+
+  // Timestamps the clock can't represent and nanos outside a second
+  auto parseStamp = [](std::string_view message) {
+    return moped::parseCompositeFromProtobuf<PbStamp>(
+        moped::DurationSinceEpochFormatter<>{}, message);
+  };
+  auto stamp = parseStamp(bytes({0x0a, 0x04, 0x08, 0x01, 0x10, 0x01}));
+  REQUIRE(stamp.has_value());
+  std::chrono::nanoseconds sinceEpoch{1'000'000'001};
+  ASSERT_EQ(stamp->time.time_since_epoch(), sinceEpoch);
+  REQUIRE(!parseStamp(bytes({0x0a, 0x06, 0x08, 0x80, 0xc8, 0xaf, 0xa0, 0x25}))
+               .has_value());
+  REQUIRE(!parseStamp(bytes({0x0a, 0x06, 0x10, 0x80, 0x94, 0xeb, 0xdc, 0x03}))
+               .has_value());
+  REQUIRE(!parseStamp(bytes({0x0a, 0x0b, 0x10, 0xff, 0xff, 0xff, 0xff, 0xff,
+                             0xff, 0xff, 0xff, 0xff, 0x01}))
+               .has_value());
+
+  auto schema =
+      moped::makeProtobufSchema<PbBadName>(moped::DurationSinceEpochFormatter<>{});
+  REQUIRE(!schema.has_value());
+}
+
+TEST_CASE("Protobuf emitter rejects names that aren't field numbers") {
+  moped::ProtobufEmitterContext context;
+  auto message = moped::encodeToProtobuf(PbBadName{1}, context);
+  REQUIRE(!message.has_value());
+}
@@ -0,0 +1,339 @@
+#include <catch2/catch.hpp>
+
+#include "moped/CollectionFunctionDispatcher.hpp"
+#include "moped/mopedSBE.hpp"
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+using NanosTF = moped::DurationSinceEpochFormatter<std::chrono::nanoseconds>;
+using Price = moped::ScaledInteger<std::int64_t, 4>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct SbeFill {
+  double price;
+  int quantity;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SbeFill>(
+        "price", &SbeFill::price, "quantity", &SbeFill::quantity);
+  }
+};
+
+struct SbeLeg {
+  std::int32_t ratio;
+  std::optional<std::int32_t> bias;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SbeLeg>(
+        "ratio", &SbeLeg::ratio, "bias", &SbeLeg::bias);
+  }
+};
+
+struct SbeExecution {
+  std::int64_t sequence;
+  moped::TimePoint time;
+  std::string_view symbol;
+  Price price;
+  std::uint32_t quantity;
+  char side;
+  std::optional<std::int32_t> venue;
+  std::vector<SbeFill> fills;
+  moped::CollectionFunctionDispatcher<SbeLeg> legs;
+  std::string_view text;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SbeExecution>(
+        "sequence", &SbeExecution::sequence, "time", &SbeExecution::time,
+        "symbol", &SbeExecution::symbol, "price", &SbeExecution::price,
+        "quantity", &SbeExecution::quantity, "side", &SbeExecution::side,
+        "venue", &SbeExecution::venue, "fills", &SbeExecution::fills, "legs",
+        &SbeExecution::legs, "text", &SbeExecution::text);
+  }
+};
+
+using moped::sbe::PrimitiveType;
+
+const moped::sbe::MessageLayout executionLayout{
+    .templateId = 7,
+    .schemaId = 1,
+    .block = {
+        .fields = {{"sequence", PrimitiveType::Int64, 0},
+                   {"time", PrimitiveType::UInt64, 8},
+                   {"symbol", PrimitiveType::Char, 16, 8},
+                   {"price", PrimitiveType::Int64, 24, 1, -4},
+                   {"quantity", PrimitiveType::UInt32, 32},
+                   {"side", PrimitiveType::Char, 36},
+                   {"venue", PrimitiveType::Int32, 37, 1, 0, true}},
+        .groups = {{"fills",
+                    {.fields = {{"price", PrimitiveType::Int64, 0, 1, -2},
+                                {"quantity", PrimitiveType::UInt32, 8}}}},
+                   {"legs",
+                    {.fields = {{"ratio", PrimitiveType::Int32, 0},
+                                {"bias", PrimitiveType::Int32, 4, 1, 0,
+                                 true}}}}},
+        .varData = {{"text"}}}};
+
+// Raw values wider than the 64 bit wire field
+struct SbeNotional {
+  moped::ScaledInteger<int128_t, 4> notional;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SbeNotional>(
+        "notional", &SbeNotional::notional);
+  }
+};
+
+const moped::sbe::MessageLayout notionalLayout{
+    .templateId = 11,
+    .schemaId = 1,
+    .block = {.fields = {{"notional", PrimitiveType::Int64, 0, 1, -2}}}};
+
+template <typename T> void put(std::string &buffer, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  buffer.append(bytes, sizeof(T));
+}
+
+// Block length 44 carries three bytes of extension beyond the layout
+std::string executionMessage() {
+  std::string buffer;
+  put<std::uint16_t>(buffer, 44);
+  put<std::uint16_t>(buffer, 7);
+  put<std::uint16_t>(buffer, 1);
+  put<std::uint16_t>(buffer, 0);
+
+  put<std::int64_t>(buffer, 1001);
+  put<std::uint64_t>(buffer, 1700000000123456789);
+  buffer.append("ESZ4\0\0\0\0", 8);
+  put<std::int64_t>(buffer, 45012500);
+  put<std::uint32_t>(buffer, 25);
+  buffer.push_back('B');
+  put<std::int32_t>(buffer, std::numeric_limits<std::int32_t>::min());
+  buffer.append(3, '\xee');
+
+  put<std::uint16_t>(buffer, 12);
+  put<std::uint16_t>(buffer, 2);
+  put<std::int64_t>(buffer, 450125);
+  put<std::uint32_t>(buffer, 10);
+  put<std::int64_t>(buffer, 450150);
+  put<std::uint32_t>(buffer, 15);
+
+  put<std::uint16_t>(buffer, 8);
+  put<std::uint16_t>(buffer, 2);
+  put<std::int32_t>(buffer, 1);
+  put<std::int32_t>(buffer, -3);
+  put<std::int32_t>(buffer, 2);
+  put<std::int32_t>(buffer, std::numeric_limits<std::int32_t>::min());
+
+  put<std::uint16_t>(buffer, 6);
+  buffer.append("filled");
+  return buffer;
+}
+
+inline constexpr char SideBuy[] = "Buy";
+inline constexpr char SideSell[] = "Sell";
+
+enum class Side : std::uint8_t { Buy = 1, Sell = 2 };
+
+using SideT = moped::MappedEnum<SideBuy, Side::Buy, SideSell, Side::Sell>;
+
+struct SbeOrder {
+  std::int64_t sequence;
+  moped::TimePoint time;
+  std::string symbol;
+  Price price;
+  SideT side;
+  std::optional<std::int32_t> venue;
+  std::vector<SbeFill> fills;
+  std::vector<SbeLeg> legs;
+  std::string text;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, SbeOrder>(
+        "sequence", &SbeOrder::sequence, "time", &SbeOrder::time, "symbol",
+        &SbeOrder::symbol, "price", &SbeOrder::price, "side", &SbeOrder::side,
+        "venue", &SbeOrder::venue, "fills", &SbeOrder::fills, "legs",
+        &SbeOrder::legs, "text", &SbeOrder::text);
+  }
+};
+
+const moped::sbe::MessageLayout orderLayout{
+    .templateId = 9,
+    .schemaId = 1,
+    .version = 2,
+    .block = {
+        .fields = {{"sequence", PrimitiveType::Int64, 0},
+                   {"time", PrimitiveType::UInt64, 8},
+                   {"symbol", PrimitiveType::Char, 16, 8},
+                   {"price", PrimitiveType::Int64, 24, 1, -4},
+                   {"side", PrimitiveType::UInt8, 32},
+                   {"venue", PrimitiveType::Int32, 33, 1, 0, true}},
+        .groups = {{"fills",
+                    {.fields = {{"price", PrimitiveType::Int64, 0, 1, -2},
+                                {"quantity", PrimitiveType::UInt32, 8}}}},
+                   {"legs",
+                    {.fields = {{"ratio", PrimitiveType::Int32, 0},
+                                {"bias", PrimitiveType::Int32, 4, 1, 0,
+                                 true}}}}},
+        .varData = {{"text"}}}};
+
+template <typename T> T load(const char *source) {
+  T value;
+  std::memcpy(&value, source, sizeof(T));
+  return value;
+}
+
+} // namespace
+
+TEST_CASE("SBE decoder reads fixed blocks, groups and var data", "[SBE]") {
+  auto decoder =
+      moped::makeSBEDecoder<SbeExecution>(NanosTF{}, executionLayout);
+  REQUIRE(decoder.has_value());
+
+  std::vector<std::pair<std::int32_t, std::optional<std::int32_t>>> legs;
+  SbeExecution execution;
+  execution.venue = 3;
+  execution.legs.setHandler([&](const SbeLeg &leg) -> moped::Expected {
+    legs.emplace_back(leg.ratio, leg.bias);
+    return {};
+  });
+
+  auto message = executionMessage();
+  auto consumed = decoder->decode(message, execution);
+  REQUIRE(consumed.has_value());
+  ASSERT_EQ(consumed.value(), message.size());
+
+  ASSERT_EQ(execution.sequence, 1001);
+  ASSERT_EQ(execution.time,
+            moped::TimePoint{std::chrono::nanoseconds{1700000000123456789}});
+  ASSERT_EQ(execution.symbol, "ESZ4");
+  ASSERT_EQ(execution.price, Price{"4501.25"});
+  ASSERT_EQ(execution.quantity, 25u);
+  ASSERT_EQ(execution.side, 'B');
+  REQUIRE(!execution.venue.has_value());
+
+  REQUIRE(execution.fills.size() == 2);
+  ASSERT_EQ(execution.fills[0].price, 4501.25);
+  ASSERT_EQ(execution.fills[1].quantity, 15);
+
+  REQUIRE(legs.size() == 2);
+  ASSERT_EQ(legs[0].second, std::optional<std::int32_t>{-3});
+  ASSERT_EQ(legs[1].first, 2);
+  REQUIRE(!legs[1].second.has_value());
+
+  // Var data and fixed width text are views of the receive buffer
+  ASSERT_EQ(execution.text, "filled");
+  REQUIRE(execution.text.data() >= message.data());
+  REQUIRE(execution.symbol.data() < message.data() + message.size());
+}
+
+TEST_CASE("SBE decoder reports layout and buffer errors", "[SBE]") {
+  auto badLayout = executionLayout;
+  badLayout.block.fields.push_back({"missing", PrimitiveType::Int32, 40});
+  REQUIRE(!moped::makeSBEDecoder<SbeExecution>(NanosTF{}, badLayout));
+
+  auto groupOnScalar = executionLayout;
+  groupOnScalar.block.groups[0].name = "quantity";
+  REQUIRE(!moped::makeSBEDecoder<SbeExecution>(NanosTF{}, groupOnScalar));
+
+  auto message = executionMessage();
+  message.resize(message.size() - 3);
+  REQUIRE(!moped::parseCompositeFromSBE<SbeExecution>(NanosTF{},
+                                                      executionLayout,
+                                                      message));
+
+  auto otherTemplate = executionMessage();
+  otherTemplate[2] = 8;
+  REQUIRE(!moped::parseCompositeFromSBE<SbeExecution>(
+      NanosTF{}, executionLayout, otherTemplate));
+}
+
+TEST_CASE("SBE emitter context writes messages the decoder reads back",
+          "[SBE]") {
+  auto encoding = moped::sbe::makeMessageEncoding(orderLayout);
+  moped::TimePoint time{std::chrono::nanoseconds{1700000000000000001}};
+  SbeOrder order{1002,
+                 time,
+                 "NQH5",
+                 Price{"21034.75"},
+                 Side::Sell,
+                 std::nullopt,
+                 {{21034.5, 3}, {21035.0, 4}},
+                 {},
+                 "ack"};
+
+  std::array<char, 128> buffer;
+  auto length = moped::encodeToSBE(order, encoding, buffer, NanosTF{});
+  REQUIRE(length.has_value());
+  // Header, 37 byte block, two 12 byte fills, empty legs and 3 bytes of text
+  ASSERT_EQ(length.value(), 8u + 37 + 4 + 24 + 4 + 2 + 3);
+
+  ASSERT_EQ(load<std::uint16_t>(&buffer[0]), 37);
+  ASSERT_EQ(load<std::uint16_t>(&buffer[2]), 9);
+  ASSERT_EQ(load<std::uint16_t>(&buffer[6]), 2);
+  // Scaled integers and mapped enums are written as raw integral values
+  ASSERT_EQ(load<std::int64_t>(&buffer[8 + 24]), 210347500);
+  ASSERT_EQ(load<std::uint8_t>(&buffer[8 + 32]), 2);
+  ASSERT_EQ(load<std::int32_t>(&buffer[8 + 33]),
+            std::numeric_limits<std::int32_t>::min());
+
+  auto decoded = moped::parseCompositeFromSBE<SbeOrder>(
+      NanosTF{}, orderLayout, std::string_view{buffer.data(), *length});
+  REQUIRE(decoded.has_value());
+  ASSERT_EQ(decoded->sequence, order.sequence);
+  ASSERT_EQ(decoded->time, order.time);
+  ASSERT_EQ(decoded->symbol, "NQH5");
+  ASSERT_EQ(decoded->price, order.price);
+  ASSERT_EQ(decoded->side, order.side);
+  REQUIRE(!decoded->venue.has_value());
+  REQUIRE(decoded->fills.size() == 2);
+  ASSERT_EQ(decoded->fills[1].price, 21035.0);
+  ASSERT_EQ(decoded->fills[1].quantity, 4);
+  REQUIRE(decoded->legs.empty());
+  ASSERT_EQ(decoded->text, "ack");
+}
+
+TEST_CASE("SBE emitter context reports layout and buffer errors", "[SBE]") {
+  auto encoding = moped::sbe::makeMessageEncoding(orderLayout);
+  SbeOrder order{};
+  order.symbol = "NQH5";
+  order.side = Side::Buy;
+
+  std::array<char, 40> shortBuffer;
+  REQUIRE(!moped::encodeToSBE(order, encoding, shortBuffer, NanosTF{}));
+
+  std::array<char, 128> buffer;
+  order.symbol = "TOO LONG SYMBOL";
+  REQUIRE(!moped::encodeToSBE(order, encoding, buffer, NanosTF{}));
+
+  order.symbol = "NQH5";
+  auto missingField = orderLayout;
+  missingField.block.fields.pop_back();
+  order.venue = 4;
+  REQUIRE(!moped::encodeToSBE(
+      order, moped::sbe::makeMessageEncoding(missingField), buffer,
+      NanosTF{}));
+
+  // 128 bit raw values are range checked rather than truncated to 64 bits
+  auto notionalEncoding = moped::sbe::makeMessageEncoding(notionalLayout);
+  SbeNotional notional{{"12.34"}};
+  REQUIRE(moped::encodeToSBE(notional, notionalEncoding, buffer, NanosTF{}));
+  ASSERT_EQ(load<std::int64_t>(&buffer[8]), 1234);
+  notional.notional = decltype(notional.notional){"1844674407370955.1616"};
+  auto wide = moped::encodeToSBE(notional, notionalEncoding, buffer, NanosTF{});
+  REQUIRE(!wide);
+  ASSERT_EQ(std::string_view{wide.error().message},
+            "Value out of range for SBE field");
+}
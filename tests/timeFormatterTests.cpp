@@ -302,4 +302,35 @@ TEST_CASE("Edge cases and error conditions", "[TimeFormatters]") {
         duration_cast<milliseconds>(result->time_since_epoch()).count() % 1000;
     REQUIRE(ms == 999);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("UTCTimestampFormatter", "[TimeFormatters][UTCTimestampFormatter]") {
+  // January 1, 2023 12:30:45.123 UTC
+  auto timePoint =
+      system_clock::time_point(seconds(1672576245) + milliseconds(123));
+
+  SECTION("Format with precision of the fractional duration") {
+    REQUIRE(UTCTimestampFormatter<milliseconds>::format(timePoint) ==
+            "20230101-12:30:45.123");
+    REQUIRE(UTCTimestampFormatter<microseconds>::format(timePoint) ==
+            "20230101-12:30:45.123000");
+    REQUIRE(UTCTimestampFormatter<seconds>::format(timePoint) ==
+            "20230101-12:30:45");
+  }
+
+  SECTION("Parse any fractional precision") {
+    using Formatter = UTCTimestampFormatter<milliseconds>;
+    REQUIRE(Formatter::getTimeValue(std::string("20230101-12:30:45.123")) ==
+            timePoint);
+    REQUIRE(Formatter::getTimeValue(std::string("20230101-12:30:45.123000")) ==
+            timePoint);
+    REQUIRE(Formatter::getTimeValue(std::string("20230101-12:30:45")) ==
+            system_clock::time_point(seconds(1672576245)));
+  }
+
+  SECTION("Invalid timestamps") {
+    using Formatter = UTCTimestampFormatter<milliseconds>;
+    REQUIRE(!Formatter::getTimeValue(std::string("2023-01-01T12:30:45")));
+    REQUIRE(!Formatter::getTimeValue(std::string("20231301-12:30:45")));
+    REQUIRE(!Formatter::getTimeValue(std::string("20230101-12:30:45.")));
+  }
+}
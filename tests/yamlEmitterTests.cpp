@@ -0,0 +1,196 @@
+#include "moped/JSONEmitterContext.hpp"
+#include "moped/YAMLEmitterContext.hpp"
+#include "moped/mopedJSON.hpp"
+#include "moped/mopedYAML.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "moped/tests/mdConfigSampleDefns.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using DFTF = moped::DurationSinceEpochFormatter<>;
+
+#define ASSERT_EQ(A, B) REQUIRE(A == B)
+
+namespace {
+
+struct YamlPoint {
+  int x;
+  int y;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlPoint>("x", &YamlPoint::x,
+                                                          "y", &YamlPoint::y);
+  }
+};
+
+struct YamlEmpty {
+  std::optional<int> value;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlEmpty>("value",
+                                                          &YamlEmpty::value);
+  }
+};
+
+struct YamlShape {
+  std::string name;
+  double scale;
+  bool visible;
+  YamlPoint origin;
+  std::vector<YamlPoint> points;
+  std::vector<std::vector<int>> grid;
+  std::map<std::string, int> weights;
+  YamlEmpty empty;
+  std::vector<std::string> labels;
+
+  template <moped::DecodingTraitsC DecodingTraits>
+  static auto getMOPEDHandler() {
+    return moped::mopedHandler<DecodingTraits, YamlShape>(
+        "name", &YamlShape::name, "scale", &YamlShape::scale, "visible",
+        &YamlShape::visible, "origin", &YamlShape::origin, "points",
+        &YamlShape::points, "grid", &YamlShape::grid, "weights",
+        &YamlShape::weights, "empty", &YamlShape::empty, "labels",
+        &YamlShape::labels);
+  }
+};
+
+} // namespace
+
+TEST_CASE("YAML emitter writes block style documents") {
+  YamlShape shape{"triangle",
+                  1.5,
+                  true,
+                  {0, -1},
+                  {{1, 2}, {3, 4}},
+                  {{1, 2}, {3}},
+                  {{"a", 1}, {"b", 2}},
+                  {},
+                  {"plain text"}};
+  moped::YAMLEmitterContext<DFTF> context;
+  ASSERT_EQ(std::string{moped::encodeToYAML(shape, context)},
+            "name: triangle\n"
+            "scale: 1.5\n"
+            "visible: true\n"
+            "origin:\n"
+            "  x: 0\n"
+            "  y: -1\n"
+            "points:\n"
+            "  - x: 1\n"
+            "    y: 2\n"
+            "  - x: 3\n"
+            "    y: 4\n"
+            "grid:\n"
+            "  - - 1\n"
+            "    - 2\n"
+            "  - - 3\n"
+            "weights:\n"
+            "  a: 1\n"
+            "  b: 2\n"
+            "empty: {}\n"
+            "labels:\n"
+            "  - plain text\n");
+
+  // The context's buffer is reused for the next document, empty sequences
+  // are omitted and empty maps written as {}
+  shape.points.clear();
+  shape.grid.clear();
+  shape.weights.clear();
+  shape.labels.clear();
+  ASSERT_EQ(std::string{moped::encodeToYAML(shape, context)},
+            "name: triangle\n"
+            "scale: 1.5\n"
+            "visible: true\n"
+            "origin:\n"
+            "  x: 0\n"
+            "  y: -1\n"
+            "weights: {}\n"
+            "empty: {}\n");
+}
+
+TEST_CASE("YAML emitter quotes scalars only when required") {
+  YamlShape shape{};
+  shape.labels = {"plain",        "with space",  "",          "true",
+                  "No",           "null",        "~",         "42",
+                  "-1",           "3rd",         ".5",        "- item",
+                  "key: value",   "a # comment", "a#b",       "trailing:",
+                  " padded",      "quote\"d",    "line\nbreak", "tab\there",
+                  "*alias",       "&anchor",     "[list]",    "url:http"};
+  auto document = moped::encodeToYAMLString(shape, DFTF{});
+  auto labels = document.substr(document.find("labels:\n"));
+  ASSERT_EQ(labels, "labels:\n"
+                    "  - plain\n"
+                    "  - with space\n"
+                    "  - \"\"\n"
+                    "  - \"true\"\n"
+                    "  - \"No\"\n"
+                    "  - \"null\"\n"
+                    "  - \"~\"\n"
+                    "  - \"42\"\n"
+                    "  - \"-1\"\n"
+                    "  - \"3rd\"\n"
+                    "  - \".5\"\n"
+                    "  - \"- item\"\n"
+                    "  - \"key: value\"\n"
+                    "  - \"a # comment\"\n"
+                    "  - a#b\n"
+                    "  - \"trailing:\"\n"
+                    "  - \" padded\"\n"
+                    "  - \"quote\\\"d\"\n"
+                    "  - \"line\\nbreak\"\n"
+                    "  - \"tab\\there\"\n"
+                    "  - \"*alias\"\n"
+                    "  - \"&anchor\"\n"
+                    "  - \"[list]\"\n"
+                    "  - url:http\n");
+}
+
+TEST_CASE("YAML emitter output parses back to the same document") {
+  std::string_view json = R"({
+    "MarketDataService": {
+      "sessions": {
+        "binanceSessionMDAws": {
+          "enabled": true,
+          "venue": "BINANCE",
+          "runContext": "binanceSpot",
+          "serviceContext": "aeronPubSub",
+          "maxRequestPerSecond": 4,
+          "maxSymbolsPerConnection": 50,
+          "subscriptions": {
+            "BTCUSDT": {
+              "bookUpdateSettings": {
+                "levels": 20,
+                "arbTrades": true,
+                "removeRestingOrders": false
+              },
+              "id": 1,
+              "subscribeFlags": ["TopOfBook", "Trade"]
+            }
+          },
+          "subscriptionEndpoint": {
+            "name": "binanceSpotWS",
+            "host": "stream.binance.com",
+            "port": 9443,
+            "uri": "/ws"
+          }
+        }
+      }
+    }
+  })";
+  auto config =
+      moped::parseCompositeFromJSONView<moped::tests::MDConfig>(DFTF{}, json);
+  REQUIRE(config.has_value());
+  auto document = moped::encodeToYAMLString(*config, DFTF{});
+
+  auto parsed = moped::parseCompositeFromYAMLView<moped::tests::MDConfig>(
+      DFTF{}, document);
+  REQUIRE(parsed.has_value());
+  ASSERT_EQ(moped::encodeToYAMLString(*parsed, DFTF{}), document);
+  ASSERT_EQ(moped::encodeToJSONString(*parsed, DFTF{}),
+            moped::encodeToJSONString(*config, DFTF{}));
+}